@@ -0,0 +1,59 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkSurfaceMesh.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \brief Square cloth of dim x dim vertices, 1 unit wide, lying in the xz plane
+///
+inline std::shared_ptr<SurfaceMesh>
+makeCloth(const int dim)
+{
+    auto         vertices = std::make_shared<VecDataArray<double, 3>>(dim * dim);
+    auto         indices  = std::make_shared<VecDataArray<int, 3>>();
+    const double spacing  = 1.0 / (dim - 1);
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j = 0; j < dim; j++)
+        {
+            (*vertices)[i * dim + j] = Vec3d(spacing * i, 0.0, spacing * j);
+        }
+    }
+    for (int i = 0; i < dim - 1; i++)
+    {
+        for (int j = 0; j < dim - 1; j++)
+        {
+            const int index1 = i * dim + j;
+            const int index2 = index1 + dim;
+            indices->push_back(Vec3i(index1, index2, index1 + 1));
+            indices->push_back(Vec3i(index2 + 1, index1 + 1, index2));
+        }
+    }
+    auto clothMesh = std::make_shared<SurfaceMesh>();
+    clothMesh->initialize(vertices, indices);
+    return clothMesh;
+}
+} // namespace imstk
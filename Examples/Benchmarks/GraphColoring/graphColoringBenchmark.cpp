@@ -0,0 +1,139 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkGraph.h"
+#include "imstkLogger.h"
+#include "imstkTimer.h"
+
+#include <iomanip>
+
+using namespace imstk;
+
+///
+/// \brief Vertex ids of the tetrahedra of a dim^3 grid of cells split in 6 tets
+/// in the form used by Graph::setEdgesFromSharedKeys
+///
+static void
+makeTetGrid(const size_t dim, std::vector<size_t>& tetOffsets, std::vector<size_t>& tetVertices)
+{
+    static const size_t cellTets[6][4] = {
+        { 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 },
+        { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 } };
+    const size_t numVerts = dim + 1;
+
+    tetOffsets   = { 0 };
+    tetVertices.clear();
+    for (size_t z = 0; z < dim; z++)
+    {
+        for (size_t y = 0; y < dim; y++)
+        {
+            for (size_t x = 0; x < dim; x++)
+            {
+                size_t corners[8];
+                for (size_t c = 0; c < 8; c++)
+                {
+                    corners[c] = (x + (c & 1)) + numVerts * ((y + ((c >> 1) & 1)) + numVerts * (z + ((c >> 2) & 1)));
+                }
+                for (size_t t = 0; t < 6; t++)
+                {
+                    for (size_t k = 0; k < 4; k++)
+                    {
+                        tetVertices.push_back(corners[cellTets[t][k]]);
+                    }
+                    tetOffsets.push_back(tetVertices.size());
+                }
+            }
+        }
+    }
+}
+
+///
+/// \brief This benchmark compares the construction of the constraint graph of a
+/// tetrahedral mesh edge by edge and in CSR form, and the coloring methods
+///
+int
+main()
+{
+    Logger::startLogger();
+
+    std::cout << std::setw(6) << "cells" << std::setw(10) << "tets"
+              << std::setw(14) << "addEdge(ms)" << std::setw(12) << "CSR(ms)"
+              << std::setw(20) << "Greedy(ms/colors)" << std::setw(24) << "WelshPowell(ms/colors)"
+              << std::setw(27) << "JonesPlassmann(ms/colors)" << std::endl;
+
+    for (const size_t dim : { 8, 16, 24, 32 })
+    {
+        std::vector<size_t> tetOffsets;
+        std::vector<size_t> tetVertices;
+        makeTetGrid(dim, tetOffsets, tetVertices);
+        const size_t numTets = tetOffsets.size() - 1;
+
+        StopWatch timer;
+
+        // Edge by edge, every pair of tets sharing a vertex
+        timer.start();
+        {
+            std::vector<std::vector<size_t>> vertexTets((dim + 1) * (dim + 1) * (dim + 1));
+            for (size_t i = 0; i < numTets; i++)
+            {
+                for (size_t j = tetOffsets[i]; j < tetOffsets[i + 1]; j++)
+                {
+                    vertexTets[tetVertices[j]].push_back(i);
+                }
+            }
+            Graph graph(numTets);
+            for (const auto& tets : vertexTets)
+            {
+                for (size_t i = 0; i < tets.size(); i++)
+                {
+                    for (size_t j = i + 1; j < tets.size(); j++)
+                    {
+                        graph.addEdge(tets[i], tets[j]);
+                    }
+                }
+            }
+        }
+        const double addEdgeTime = timer.getTimeElapsed();
+
+        timer.start();
+        Graph graph(numTets);
+        graph.setEdgesFromSharedKeys(tetOffsets, tetVertices);
+        const double csrTime = timer.getTimeElapsed();
+
+        std::cout << std::setw(6) << dim * dim * dim << std::setw(10) << numTets
+                  << std::setw(14) << addEdgeTime << std::setw(12) << csrTime;
+        const int widths[3] = { 20, 24, 27 };
+        int       i = 0;
+        for (const auto method : { Graph::ColoringMethod::Greedy, Graph::ColoringMethod::WelshPowell, Graph::ColoringMethod::JonesPlassmann })
+        {
+            timer.start();
+            const auto   coloring = graph.doColoring(method);
+            const double time     = timer.getTimeElapsed();
+
+            std::ostringstream result;
+            result << std::fixed << std::setprecision(2) << time << "/" << coloring.second;
+            std::cout << std::setw(widths[i++]) << result.str();
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "BenchmarkUtils.h"
+#include "imstkLogger.h"
+#include "imstkLooseOctree.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTimer.h"
+#include "imstkVecDataArray.h"
+
+#include <iomanip>
+
+using namespace imstk;
+
+///
+/// \brief Waves the cloth along x, the phase advancing with the frame. Vertices move at most
+/// 0.002 per frame, about half the width of the smallest nodes for 100k triangles
+///
+static void
+wave(SurfaceMesh& clothMesh, const VecDataArray<double, 3>& initPositions, const int frame)
+{
+    VecDataArray<double, 3>& positions = *clothMesh.getVertexPositions();
+    for (int i = 0; i < positions.size(); i++)
+    {
+        positions[i] = initPositions[i] + Vec3d(0.0, 0.1 * std::sin(10.0 * initPositions[i][0] + 0.02 * frame), 0.0);
+    }
+}
+
+///
+/// \brief Average time of an octree update over the frames of a waving cloth
+///
+static double
+timeUpdates(const int dim, const bool alwaysRebuild, const int numFrames)
+{
+    std::shared_ptr<SurfaceMesh>  clothMesh     = makeCloth(dim);
+    const VecDataArray<double, 3> initPositions = *clothMesh->getVertexPositions();
+
+    LooseOctree octree(Vec3d(0.5, 0.0, 0.5), 2.0, 0.01);
+    octree.addTriangleMesh(clothMesh);
+    octree.setAlwaysRebuild(alwaysRebuild);
+    wave(*clothMesh, initPositions, 0);
+    octree.build();
+
+    double    time = 0.0;
+    StopWatch timer;
+    for (int i = 1; i <= numFrames; i++)
+    {
+        wave(*clothMesh, initPositions, i);
+        timer.start();
+        octree.update();
+        time += timer.getTimeElapsed();
+    }
+    return time / numFrames;
+}
+
+///
+/// \brief This benchmark updates a LooseOctree holding a waving cloth, from a few thousand
+/// up to 100k triangles, incrementally and by a full rebuild every frame (setAlwaysRebuild).
+/// Reported is the time per update
+///
+int
+main()
+{
+    Logger::startLogger();
+
+    const int numFrames = 50;
+
+    std::cout << std::setw(6) << "dim" << std::setw(12) << "triangles"
+              << std::setw(20) << "incremental(ms)" << std::setw(16) << "rebuild(ms)" << std::endl;
+
+    for (const int dim : { 32, 64, 128, 224 })
+    {
+        const double incrementalTime = timeUpdates(dim, false, numFrames);
+        const double rebuildTime     = timeUpdates(dim, true, numFrames);
+        std::cout << std::setw(6) << dim << std::setw(12) << 2 * (dim - 1) * (dim - 1)
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(20) << incrementalTime << std::setw(16) << rebuildTime
+                  << std::defaultfloat << std::endl;
+    }
+
+    return 0;
+}
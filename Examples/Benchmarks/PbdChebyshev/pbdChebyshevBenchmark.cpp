@@ -0,0 +1,115 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "BenchmarkUtils.h"
+#include "imstkLogger.h"
+#include "imstkPbdModel.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTaskNode.h"
+#include "imstkTimer.h"
+
+#include <iomanip>
+
+using namespace imstk;
+
+///
+/// \brief Mean relative elongation of the edges of the grid
+///
+static double
+getStretch(const SurfaceMesh& clothMesh, const int dim)
+{
+    const VecDataArray<double, 3>& positions = *clothMesh.getVertexPositions();
+    const double                   spacing   = 1.0 / (dim - 1);
+    double                         stretch   = 0.0;
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j = 0; j < dim - 1; j++)
+        {
+            stretch += (positions[i * dim + j + 1] - positions[i * dim + j]).norm() / spacing - 1.0;
+            stretch += (positions[(j + 1) * dim + i] - positions[j * dim + i]).norm() / spacing - 1.0;
+        }
+    }
+    return stretch / (2.0 * dim * (dim - 1));
+}
+
+///
+/// \brief This benchmark hangs a PBD cloth by two corners, as in the PBDCloth example,
+/// and compares the plain solver iterations against the Chebyshev accelerated ones for
+/// both execution modes and several resolutions. Reported are the time per step and the
+/// mean stretch of the edges after the cloth settled, the lower the stiffer it looks
+///
+int
+main()
+{
+    Logger::startLogger();
+
+    const int numSteps = 300;
+
+    std::cout << std::setw(6) << "dim" << std::setw(13) << "execution" << std::setw(12) << "iterations"
+              << std::setw(12) << "chebyshev" << std::setw(12) << "ms/step" << std::setw(14) << "stretch(%)" << std::endl;
+
+    for (const int dim : { 32, 64 })
+    {
+        for (const PbdSolver::ExecutionMode mode : { PbdSolver::ExecutionMode::GaussSeidel, PbdSolver::ExecutionMode::Jacobi })
+        {
+            for (const unsigned int numIterations : { 5u, 10u, 20u, 40u })
+            {
+                for (const bool chebyshev : { false, true })
+                {
+                    std::shared_ptr<SurfaceMesh> clothMesh = makeCloth(dim);
+
+                    auto config = std::make_shared<PbdModelConfig>();
+                    config->enableConstraint(PbdModelConfig::ConstraintGenType::Distance, 1.0);
+                    config->enableConstraint(PbdModelConfig::ConstraintGenType::Dihedral, 0.1);
+                    config->m_fixedNodeIds          = { 0, static_cast<size_t>(dim - 1) };
+                    config->m_solverType            = PbdConstraint::SolverType::PBD;
+                    config->m_executionMode         = mode;
+                    config->m_iterations            = numIterations;
+                    config->m_chebyshevAcceleration = chebyshev;
+                    config->m_dt = 0.01;
+
+                    auto model = std::make_shared<PbdModel>();
+                    model->setModelGeometry(clothMesh);
+                    model->configure(config);
+                    model->initialize();
+
+                    StopWatch timer;
+                    timer.start();
+                    for (int i = 0; i < numSteps; i++)
+                    {
+                        model->getIntegratePositionNode()->execute();
+                        model->getSolveNode()->execute();
+                        model->getUpdateVelocityNode()->execute();
+                    }
+                    const double timePerStep = timer.getTimeElapsed() / numSteps;
+
+                    std::cout << std::setw(6) << dim
+                              << std::setw(13) << (mode == PbdSolver::ExecutionMode::Jacobi ? "Jacobi" : "GaussSeidel")
+                              << std::setw(12) << numIterations << std::setw(12) << (chebyshev ? "on" : "off")
+                              << std::setw(12) << std::fixed << std::setprecision(3) << timePerStep
+                              << std::setw(14) << getStretch(*clothMesh, dim) * 100.0 << std::defaultfloat << std::endl;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdFEMTetConstraint.h"
+#include "imstkTimer.h"
+
+#include <atomic>
+#include <iomanip>
+#include <new>
+
+using namespace imstk;
+
+namespace
+{
+std::atomic<size_t> numAllocations(0);
+std::atomic<size_t> numBytesAllocated(0);
+
+///
+/// \brief Per constraint storage before the vertex ids and gradients were stored inline,
+/// kept here only to compare the footprints
+///
+struct VectorStorageConstraint
+{
+    virtual ~VectorStorageConstraint() = default;
+
+    std::vector<size_t> m_vertexIds;
+    double              m_epsilon    = 1.0e-16;
+    double              m_stiffness  = 1.0;
+    double              m_compliance = 1e-7;
+    double              m_lambda     = 0.0;
+    std::vector<Vec3d>  m_dcdx;
+    double              m_restLength = 0.0;
+};
+
+///
+/// \brief Allocations and bytes requested while creating numConstraints constraints with create,
+/// which keeps them alive such that their destruction is not measured
+///
+template<typename CreateFunc>
+void
+measure(const std::string& name, const size_t numConstraints, CreateFunc create)
+{
+    const size_t startAllocations = numAllocations;
+    const size_t startBytes       = numBytesAllocated;
+
+    StopWatch timer;
+    timer.start();
+    create();
+    const double time = timer.getTimeElapsed();
+
+    const double allocationsPerConstraint = static_cast<double>(numAllocations - startAllocations) / numConstraints;
+    const double bytesPerConstraint       = static_cast<double>(numBytesAllocated - startBytes) / numConstraints;
+    std::cout << std::setw(28) << name
+              << std::setw(14) << std::fixed << std::setprecision(2) << allocationsPerConstraint
+              << std::setw(14) << bytesPerConstraint
+              << std::setw(14) << bytesPerConstraint * numConstraints / (1024.0 * 1024.0)
+              << std::setw(14) << time << std::endl;
+}
+}
+
+void*
+operator new(size_t size)
+{
+    numAllocations++;
+    numBytesAllocated += size;
+    if (void* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+///
+/// \brief This benchmark creates the distance constraints of a cloth grid of about 1M edges,
+/// as PbdModel does, and reports the number of heap allocations and the bytes requested per
+/// constraint, compared to the former layout where the vertex ids and the gradients of every
+/// constraint were held in two std::vector. The time of one projection sweep over all
+/// constraints is given for reference
+///
+int
+main()
+{
+    const size_t dim            = 708;
+    const size_t numConstraints = 2 * dim * (dim - 1);
+
+    VecDataArray<double, 3> vertices(static_cast<int>(dim * dim));
+    DataArray<double>       invMasses(static_cast<int>(dim * dim));
+    for (size_t i = 0; i < dim; i++)
+    {
+        for (size_t j = 0; j < dim; j++)
+        {
+            vertices[i * dim + j]  = Vec3d(static_cast<double>(i), 0.0, static_cast<double>(j)) * 0.01;
+            invMasses[i * dim + j] = 1.0;
+        }
+    }
+    auto forEachEdge = [&](auto&& func)
+                       {
+                           for (size_t i = 0; i < dim; i++)
+                           {
+                               for (size_t j = 0; j < dim - 1; j++)
+                               {
+                                   func(i * dim + j, i * dim + j + 1);
+                                   func(j * dim + i, (j + 1) * dim + i);
+                               }
+                           }
+                       };
+
+    std::cout << "sizeof(PbdDistanceConstraint) = " << sizeof(PbdDistanceConstraint) << std::endl;
+    std::cout << "sizeof(PbdFEMTetConstraint)   = " << sizeof(PbdFEMTetConstraint) << std::endl;
+    std::cout << numConstraints << " distance constraints" << std::endl;
+    std::cout << std::setw(28) << "layout" << std::setw(14) << "allocs/constr" << std::setw(14) << "bytes/constr"
+              << std::setw(14) << "total (MB)" << std::setw(14) << "create (ms)" << std::endl;
+
+    std::vector<std::shared_ptr<VectorStorageConstraint>> vectorConstraints;
+    measure("std::vector (former)", numConstraints, [&]()
+        {
+            vectorConstraints.reserve(numConstraints);
+            forEachEdge([&](const size_t a, const size_t b)
+                {
+                    auto constraint = std::make_shared<VectorStorageConstraint>();
+                    constraint->m_vertexIds  = { a, b };
+                    constraint->m_dcdx       = std::vector<Vec3d>(2);
+                    constraint->m_restLength = (vertices[b] - vertices[a]).norm();
+                    vectorConstraints.push_back(constraint);
+                });
+        });
+
+    std::vector<std::shared_ptr<PbdConstraint>> constraints;
+    measure("inline (PbdConstraintN)", numConstraints, [&]()
+        {
+            constraints.reserve(numConstraints);
+            forEachEdge([&](const size_t a, const size_t b)
+                {
+                    auto constraint = std::make_shared<PbdDistanceConstraint>();
+                    constraint->initConstraint(vertices, a, b, 1.0);
+                    constraints.push_back(constraint);
+                });
+        });
+
+    // Stretch the grid so that every constraint has something to correct
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        vertices[i] *= 1.1;
+    }
+    StopWatch timer;
+    timer.start();
+    for (const auto& constraint : constraints)
+    {
+        constraint->projectConstraint(invMasses, 0.01, PbdConstraint::SolverType::PBD, vertices);
+    }
+    std::cout << "projection sweep (ms): " << timer.getTimeElapsed() << std::endl;
+
+    return 0;
+}
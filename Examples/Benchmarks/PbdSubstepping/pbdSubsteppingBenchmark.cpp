@@ -0,0 +1,110 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "BenchmarkUtils.h"
+#include "imstkLogger.h"
+#include "imstkPbdModel.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTaskNode.h"
+#include "imstkTimer.h"
+
+#include <iomanip>
+
+using namespace imstk;
+
+///
+/// \brief This benchmark hangs a cloth by two corners and compares, at the same number
+/// of solver iterations per step, iterating over the whole step against substepping
+/// with a single iteration per substep. Reported are the time per step, the mean
+/// stretch of the edges and the kinetic energy left at the end
+///
+int
+main()
+{
+    Logger::startLogger();
+
+    const int    dim       = 32;
+    const int    numSteps  = 300;
+    const double stiffness = 1.0e6;
+
+    std::cout << std::setw(12) << "iterations" << std::setw(10) << "mode"
+              << std::setw(14) << "ms/step" << std::setw(14) << "stretch(%)"
+              << std::setw(16) << "kinetic energy" << std::endl;
+
+    for (const unsigned int numIterations : { 5u, 10u, 20u })
+    {
+        for (const bool substep : { false, true })
+        {
+            std::shared_ptr<SurfaceMesh> clothMesh = makeCloth(dim);
+
+            auto config = std::make_shared<PbdModelConfig>();
+            config->enableConstraint(PbdModelConfig::ConstraintGenType::Distance, stiffness);
+            config->enableConstraint(PbdModelConfig::ConstraintGenType::Dihedral, 1.0);
+            config->m_fixedNodeIds = { 0, static_cast<size_t>(dim - 1) };
+            config->m_iterations   = substep ? 1 : numIterations;
+            config->m_numSubsteps  = substep ? numIterations : 1;
+            config->m_dt = 0.01;
+
+            auto model = std::make_shared<PbdModel>();
+            model->setModelGeometry(clothMesh);
+            model->configure(config);
+            model->initialize();
+
+            StopWatch timer;
+            timer.start();
+            for (int i = 0; i < numSteps; i++)
+            {
+                model->getIntegratePositionNode()->execute();
+                model->getSolveNode()->execute();
+                model->getUpdateVelocityNode()->execute();
+            }
+            const double timePerStep = timer.getTimeElapsed() / numSteps;
+
+            // Mean relative elongation of the grid edges
+            const VecDataArray<double, 3>& positions  = *clothMesh->getVertexPositions();
+            const VecDataArray<double, 3>& velocities = *model->getCurrentState()->getVelocities();
+            const double                   spacing    = 1.0 / (dim - 1);
+            double                         stretch    = 0.0;
+            for (int i = 0; i < dim; i++)
+            {
+                for (int j = 0; j < dim - 1; j++)
+                {
+                    stretch += (positions[i * dim + j + 1] - positions[i * dim + j]).norm() / spacing - 1.0;
+                    stretch += (positions[(j + 1) * dim + i] - positions[j * dim + i]).norm() / spacing - 1.0;
+                }
+            }
+            stretch /= 2.0 * dim * (dim - 1);
+
+            double kineticEnergy = 0.0;
+            for (int i = 0; i < velocities.size(); i++)
+            {
+                kineticEnergy += 0.5 * config->m_uniformMassValue * velocities[i].squaredNorm();
+            }
+
+            std::cout << std::setw(12) << numIterations << std::setw(10) << (substep ? "substep" : "iterate")
+                      << std::setw(14) << std::fixed << std::setprecision(3) << timePerStep
+                      << std::setw(14) << stretch * 100.0
+                      << std::setw(16) << std::scientific << kineticEnergy << std::defaultfloat << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "BenchmarkUtils.h"
+#include "imstkCollisionData.h"
+#include "imstkCollisionUtils.h"
+#include "imstkLogger.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkSurfaceMeshToSurfaceMeshCD.h"
+#include "imstkTimer.h"
+#include "imstkVecDataArray.h"
+
+#include <iomanip>
+
+using namespace imstk;
+
+///
+/// \brief Waves the cloth along x, the phase advancing with the frame
+///
+static void
+wave(SurfaceMesh& clothMesh, const VecDataArray<double, 3>& initPositions, const int frame)
+{
+    VecDataArray<double, 3>& positions = *clothMesh.getVertexPositions();
+    for (int i = 0; i < positions.size(); i++)
+    {
+        positions[i] = initPositions[i] + Vec3d(0.0, 0.05 * std::sin(10.0 * initPositions[i][0] + 0.1 * frame), 0.0);
+    }
+}
+
+///
+/// \brief Number of intersecting triangle pairs, testing every triangle against every triangle
+///
+static int
+countBruteForce(const SurfaceMesh& meshA, const SurfaceMesh& meshB)
+{
+    const VecDataArray<double, 3>& verticesA = *meshA.getVertexPositions();
+    const VecDataArray<int, 3>&    indicesA  = *meshA.getTriangleIndices();
+    const VecDataArray<double, 3>& verticesB = *meshB.getVertexPositions();
+    const VecDataArray<int, 3>&    indicesB  = *meshB.getTriangleIndices();
+    int                            count     = 0;
+    for (int i = 0; i < indicesA.size(); i++)
+    {
+        const Vec3i& cellA = indicesA[i];
+        for (int j = 0; j < indicesB.size(); j++)
+        {
+            const Vec3i&            cellB = indicesB[j];
+            std::pair<Vec2i, Vec2i> eeContact;
+            std::pair<int, Vec3i>   vtContact;
+            std::pair<Vec3i, int>   tvContact;
+            count += CollisionUtils::triangleToTriangle(cellA, cellB,
+                verticesA[cellA[0]], verticesA[cellA[1]], verticesA[cellA[2]],
+                verticesB[cellB[0]], verticesB[cellB[1]], verticesB[cellB[2]],
+                eeContact, vtContact, tvContact) != -1;
+        }
+    }
+    return count;
+}
+
+///
+/// \brief This benchmark collides two waving cloths crossing each other, from a few thousand
+/// up to 50k triangles each, with SurfaceMeshToSurfaceMeshCD. Reported are the time per
+/// update, trees refit every frame, and the number of contacts. The all pairs test, which
+/// SurfaceMeshToSurfaceMeshCD did before, is timed once on the smaller sizes for reference
+///
+int
+main()
+{
+    Logger::startLogger();
+
+    const int numFrames = 20;
+
+    std::cout << std::setw(6) << "dim" << std::setw(12) << "triangles" << std::setw(12) << "contacts"
+              << std::setw(12) << "ms/update" << std::setw(16) << "all pairs(ms)" << std::endl;
+
+    for (const int dim : { 32, 64, 128, 160 })
+    {
+        std::shared_ptr<SurfaceMesh> meshA = makeCloth(dim);
+        std::shared_ptr<SurfaceMesh> meshB = makeCloth(dim);
+        meshB->rotate(Vec3d(1.0, 0.2, 0.0).normalized(), -0.3);
+        meshB->translate(Vec3d(0.1, -0.1, 0.05));
+        meshB->updatePostTransformData();
+        const VecDataArray<double, 3> initPositionsA = *meshA->getVertexPositions();
+
+        SurfaceMeshToSurfaceMeshCD cd;
+        cd.setInputGeometryA(meshA);
+        cd.setInputGeometryB(meshB);
+
+        StopWatch timer;
+        timer.start();
+        for (int i = 0; i < numFrames; i++)
+        {
+            wave(*meshA, initPositionsA, i);
+            cd.update();
+        }
+        const double timePerUpdate = timer.getTimeElapsed() / numFrames;
+
+        std::cout << std::setw(6) << dim << std::setw(12) << meshA->getNumTriangles()
+                  << std::setw(12) << cd.getCollisionData()->elementsA.size()
+                  << std::setw(12) << std::fixed << std::setprecision(3) << timePerUpdate;
+        if (dim <= 64)
+        {
+            timer.start();
+            countBruteForce(*meshA, *meshB);
+            std::cout << std::setw(16) << timer.getTimeElapsed();
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    return 0;
+}
@@ -159,6 +159,8 @@ makeClothObj(const std::string& name,
     pbdParams->m_gravity    = Vec3d(0.0, -9.8, 0.0);
     pbdParams->m_dt         = 0.005;
     pbdParams->m_iterations = 5;
+    // Distance and dihedral constraints are solved in simd batches
+    pbdParams->m_batchConstraints = true;
 
     // Setup the Model
     imstkNew<PbdModel> pbdModel;
@@ -254,7 +254,7 @@ InflatableObject::findAffectedConstraint(const Vec3d& toolTip, const double radi
     double              minDistance = LONG_MAX;
     for (auto& c : m_constraintContainer->getConstraints())
     {
-        auto& ids = c->getVertexIds();
+        auto ids = c->getVertexIds();
 
         Vec3d center(0.0, 0.0, 0.0);
         for (auto i : ids)
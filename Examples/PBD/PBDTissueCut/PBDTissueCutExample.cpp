@@ -397,7 +397,7 @@ main()
                         // Find and remove the associated constraints
                         for (auto j = constraints.begin(); j != constraints.end(); j++)
                         {
-                            std::vector<size_t>& vertexIds = (*j)->getVertexIds();
+                            auto vertexIds = (*j)->getVertexIds();
                             bool isSameTet = true;
                             for (int k = 0; k < 4; k++)
                             {
@@ -0,0 +1,129 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkCollisionData.h"
+
+#include <tbb/enumerable_thread_specific.h>
+
+namespace imstk
+{
+///
+/// \class CollisionElementBuffers
+///
+/// \brief Per thread append buffers for the collision elements produced in a parallel loop.
+/// Each thread pushes to its own buffers, without locking, and the buffers of all threads
+/// are appended to the output elements once the loop is done. Elements pushed together
+/// by push_back stay at the same index in the A and B outputs.
+/// The buffers keep their memory from one detection to the next
+///
+class CollisionElementBuffers
+{
+public:
+    ///
+    /// \brief Push a pair of elements, one for each side, to the buffers of the calling thread
+    ///
+    void push_back(const CollisionElement& elementA, const CollisionElement& elementB)
+    {
+        Buffers& buffers = m_buffers.local();
+        buffers.elementsA.push_back(elementA);
+        buffers.elementsB.push_back(elementB);
+    }
+
+    ///
+    /// \brief Push an element of side A to the buffers of the calling thread
+    ///
+    void pushBackA(const CollisionElement& elementA) { m_buffers.local().elementsA.push_back(elementA); }
+
+    ///
+    /// \brief Push an element of side B to the buffers of the calling thread
+    ///
+    void pushBackB(const CollisionElement& elementB) { m_buffers.local().elementsB.push_back(elementB); }
+
+    ///
+    /// \brief Append the elements of all threads to the outputs and empty the buffers,
+    /// must not be called during the parallel loop
+    ///
+    void appendTo(std::vector<CollisionElement>& elementsA, std::vector<CollisionElement>& elementsB)
+    {
+        size_t numElementsA = elementsA.size();
+        size_t numElementsB = elementsB.size();
+        for (const Buffers& buffers : m_buffers)
+        {
+            numElementsA += buffers.elementsA.size();
+            numElementsB += buffers.elementsB.size();
+        }
+        elementsA.reserve(numElementsA);
+        elementsB.reserve(numElementsB);
+
+        // Both sides are appended in the same thread order, pairs stay aligned
+        for (Buffers& buffers : m_buffers)
+        {
+            elementsA.insert(elementsA.end(), buffers.elementsA.begin(), buffers.elementsA.end());
+            elementsB.insert(elementsB.end(), buffers.elementsB.begin(), buffers.elementsB.end());
+            buffers.elementsA.clear();
+            buffers.elementsB.clear();
+        }
+    }
+
+    ///
+    /// \brief Append the elements of side A of all threads to the output and empty their
+    /// buffers, the elements of side B stay buffered
+    ///
+    void appendToA(std::vector<CollisionElement>& elementsA) { appendSide(&Buffers::elementsA, elementsA); }
+
+    ///
+    /// \brief Append the elements of side B of all threads to the output and empty their
+    /// buffers, the elements of side A stay buffered
+    ///
+    void appendToB(std::vector<CollisionElement>& elementsB) { appendSide(&Buffers::elementsB, elementsB); }
+
+protected:
+    struct Buffers
+    {
+        std::vector<CollisionElement> elementsA;
+        std::vector<CollisionElement> elementsB;
+    };
+
+    tbb::enumerable_thread_specific<Buffers> m_buffers; ///> Buffers of each thread
+
+private:
+    ///
+    /// \brief Append the given side of the buffers of all threads to the output and empty it
+    ///
+    void appendSide(std::vector<CollisionElement> Buffers::* side, std::vector<CollisionElement>& elements)
+    {
+        size_t numElements = elements.size();
+        for (const Buffers& buffers : m_buffers)
+        {
+            numElements += (buffers.*side).size();
+        }
+        elements.reserve(numElements);
+
+        for (Buffers& buffers : m_buffers)
+        {
+            elements.insert(elements.end(), (buffers.*side).begin(), (buffers.*side).end());
+            (buffers.*side).clear();
+        }
+    }
+};
+}
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "imstkCollisionData.h"
+#include "imstkCollisionElementBuffers.h"
 #include "imstkGeometryAlgorithm.h"
 
 namespace imstk
@@ -123,6 +124,10 @@ protected:
 protected:
     std::shared_ptr<CollisionData> m_colData = nullptr;     ///> Collision data
 
+    /// Per thread buffers subclasses push their elements to from a parallel loop, instead of
+    /// locking the output elements
+    CollisionElementBuffers m_elementBuffers;
+
     bool m_flipOutput   = false;
     bool m_generateCD_A = true;
     bool m_generateCD_B = true;
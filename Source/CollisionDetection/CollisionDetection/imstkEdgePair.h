@@ -0,0 +1,84 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace imstk
+{
+///
+/// \struct EdgePair
+///
+/// \brief An edge of mesh A and an edge of mesh B, used to report an edge-edge contact
+/// only once when it is found from several triangle pairs
+///
+struct EdgePair
+{
+    EdgePair(uint32_t a1, uint32_t a2, uint32_t b1, uint32_t b2) :
+        edgeAId(getId(a1, a2)), edgeBId(getId(b1, b2))
+    {
+    }
+
+    ///
+    /// \brief Reversible edges are equivalent, EdgePair(0,1,5,2)==EdgePair(1,0,5,2)==EdgePair(1,0,2,5)==...
+    /// Edge A and edge B belong to different meshes and are not interchangeable
+    ///
+    bool operator==(const EdgePair& other) const
+    {
+        return edgeAId == other.edgeAId && edgeBId == other.edgeBId;
+    }
+
+    ///
+    /// \brief Returns a unique id for an edge, order doesn't matter
+    /// ie: f(vertexId1, vertexId2)=f(vertexId2, vertexId1). 64 bits such that it does
+    /// not overflow for any 32 bit vertex id
+    ///
+    static uint64_t getId(const uint32_t v1, const uint32_t v2)
+    {
+        const uint64_t max = std::max(v1, v2);
+        const uint64_t min = std::min(v1, v2);
+        return max * (max + 1) / 2 + min;
+    }
+
+    uint64_t edgeAId;
+    uint64_t edgeBId;
+};
+
+///
+/// \struct EdgePairHash
+///
+/// \brief Both 64 bit edge ids are mixed (splitmix64 finalizer) so that every bit
+/// of either id affects every bit of the hash
+///
+struct EdgePairHash
+{
+    std::size_t operator()(const EdgePair& k) const
+    {
+        uint64_t h = k.edgeAId * 0x9e3779b97f4a7c15ULL ^ k.edgeBId;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+}
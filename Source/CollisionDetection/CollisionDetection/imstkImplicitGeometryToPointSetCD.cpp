@@ -55,7 +55,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -76,12 +75,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataAB(
                 elemB.ptIndex = i;
                 elemB.penetrationDepth = std::abs(signedDistance);
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.push_back(elemA, elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 
 void
@@ -101,7 +98,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -117,11 +113,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataA(
                 elemA.pt  = pt;
                 elemA.penetrationDepth = std::abs(signedDistance);
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_elementBuffers.pushBackA(elemA);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToA(elementsA);
 }
 
 void
@@ -141,7 +136,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -157,10 +151,9 @@ ImplicitGeometryToPointSetCD::computeCollisionDataB(
                 elemB.ptIndex = i;
                 elemB.penetrationDepth = std::abs(signedDistance);
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.pushBackB(elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToB(elementsB);
 }
 }
\ No newline at end of file
@@ -21,84 +21,14 @@
 
 #include "imstkMeshToMeshBruteForceCD.h"
 #include "imstkCollisionUtils.h"
+#include "imstkEdgePair.h"
 #include "imstkLineMesh.h"
+#include "imstkParallelUtils.h"
 #include "imstkSurfaceMesh.h"
 #include "imstkVecDataArray.h"
 
 #include <unordered_set>
 
-namespace imstk
-{
-///
-/// \brief Hash together a pair of edges
-///
-struct EdgePair
-{
-    EdgePair(uint32_t a1, uint32_t a2, uint32_t b1, uint32_t b2)
-    {
-        edgeA[0] = a1;
-        edgeA[1] = a2;
-        edgeB[0] = b1;
-        edgeB[1] = b2;
-
-        edgeAId = getIdA();
-        edgeBId = getIdB();
-    }
-
-    ///
-    /// \brief Reversible edges are equivalent, reversible vertices in the edges are equivalent as well
-    /// EdgePair(0,1,5,2)==EdgePair(1,0,5,2)==EdgePair(1,0,2,5)==...
-    ///
-    bool operator==(const EdgePair& other) const
-    {
-        return (edgeAId == other.edgeAId && edgeBId == other.edgeBId)
-               || (edgeAId == other.edgeBId && edgeBId == other.edgeAId);
-    }
-
-    // These functions return a unique int for an edge, order doesn't matter
-    // ie: f(vertexId1, vertexId2)=f(vertexId2, vertexId1)
-    const uint32_t getIdA() const
-    {
-        const uint32_t max = std::max(edgeA[0], edgeA[1]);
-        const uint32_t min = std::min(edgeA[0], edgeA[1]);
-        return max * (max + 1) / 2 + min;
-    }
-
-    const uint32_t getIdB() const
-    {
-        const uint32_t max = std::max(edgeB[0], edgeB[1]);
-        const uint32_t min = std::min(edgeB[0], edgeB[1]);
-        return max * (max + 1) / 2 + min;
-    }
-
-    uint32_t edgeA[2];
-    uint32_t edgeAId;
-    uint32_t edgeB[2];
-    uint32_t edgeBId;
-};
-}
-
-namespace std
-{
-template<>
-struct hash<imstk::EdgePair>
-{
-    // EdgePair has 4 uints to hash, they bound the same range, 0 to max vertices of a mesh
-    // A complete unique hash split into 4, would limit us to 256 max vertices so we will have
-    // collisions but they will be unlikely given small portions of the mesh are in contact at
-    // any one time
-    std::size_t operator()(const imstk::EdgePair& k) const
-    {
-        // Shift by 8 each time, there will be overlap every 256 ints
-        //return ((k.edgeA[0] ^ (k.edgeA[1] << 8)) ^ (k.edgeB[0] << 16)) ^ (k.edgeB[1] << 24);
-
-        // The edge ids are more compact since f(1,0)=f(0,1) there are fewer permutations,
-        // This should allow up to ~360 max vertices..., not that much better
-        return (k.edgeAId ^ (k.edgeBId << 16));
-    }
-};
-}
-
 namespace imstk
 {
 struct PointSetData
@@ -112,7 +42,7 @@ struct PointSetData
 
 struct SurfMeshData
 {
-    SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh);
+    SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh, const AabbTree* cellTree);
 
     // Get geometry B data
     std::shared_ptr<SurfaceMesh> m_surfMesh;
@@ -120,6 +50,7 @@ struct SurfMeshData
     const VecDataArray<double, 3>& vertices;
     const std::vector<std::set<size_t>>& vertexFaces;
     const VecDataArray<double, 3>& faceNormals;
+    const AabbTree* tree; ///> Tree over the cells, nullptr to search them all
 };
 
 PointSetData::PointSetData(std::shared_ptr<PointSet> pointSet) :
@@ -128,12 +59,13 @@ PointSetData::PointSetData(std::shared_ptr<PointSet> pointSet) :
 {
 }
 
-SurfMeshData::SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh) :
+SurfMeshData::SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh, const AabbTree* cellTree) :
     m_surfMesh(surfMesh),
     cells(*surfMesh->getTriangleIndices()),
     vertices(*surfMesh->getVertexPositions()),
     vertexFaces(surfMesh->getVertexNeighborTriangles()),
-    faceNormals(*surfMesh->getCellNormals())
+    faceNormals(*surfMesh->getCellNormals()),
+    tree(cellTree)
 {
 }
 
@@ -223,24 +155,38 @@ polySignedDist(const Vec3d& pos, const SurfMeshData& surfMeshData,
     double minSqrDist      = IMSTK_DOUBLE_MAX;
     int    closestCellCase = -1;
 
-    // Find the closest point out of all elements
+    // Find the closest point out of all elements, ties go to the lowest cell index
+    // such that the tree search finds the same element as the linear one
     // \todo: We could early reject backface cull all triangles (this is effectively case 6 done early)
-    for (int j = 0; j < surfMeshData.cells.size(); j++)
+    auto visitCell = [&](const int j)
+                     {
+                         const Vec3i& cell = surfMeshData.cells[j];
+                         const Vec3d& x1   = surfMeshData.vertices[cell[0]];
+                         const Vec3d& x2   = surfMeshData.vertices[cell[1]];
+                         const Vec3d& x3   = surfMeshData.vertices[cell[2]];
+
+                         int          ptOnTriangleCaseType;
+                         const Vec3d  closestPtOnTri = CollisionUtils::closestPointOnTriangle(pos, x1, x2, x3, ptOnTriangleCaseType);
+                         const double sqrDist = (closestPtOnTri - pos).squaredNorm();
+                         if (sqrDist < minSqrDist || (sqrDist == minSqrDist && j < closestCell))
+                         {
+                             minSqrDist      = sqrDist;
+                             closestPt       = closestPtOnTri;
+                             closestCell     = j;
+                             closestCellCase = ptOnTriangleCaseType;
+                         }
+                         return minSqrDist;
+                     };
+    if (surfMeshData.tree != nullptr)
     {
-        const Vec3i& cell = surfMeshData.cells[j];
-        const Vec3d& x1   = surfMeshData.vertices[cell[0]];
-        const Vec3d& x2   = surfMeshData.vertices[cell[1]];
-        const Vec3d& x3   = surfMeshData.vertices[cell[2]];
-
-        int          ptOnTriangleCaseType;
-        const Vec3d  closestPtOnTri = CollisionUtils::closestPointOnTriangle(pos, x1, x2, x3, ptOnTriangleCaseType);
-        const double sqrDist = (closestPtOnTri - pos).squaredNorm();
-        if (sqrDist < minSqrDist)
+        surfMeshData.tree->visitNearest(Eigen::AlignedBox3d(pos, pos),
+            [&](const int j, const double) { return visitCell(j); });
+    }
+    else
+    {
+        for (int j = 0; j < surfMeshData.cells.size(); j++)
         {
-            minSqrDist      = sqrDist;
-            closestPt       = closestPtOnTri;
-            closestCell     = j;
-            closestCellCase = ptOnTriangleCaseType;
+            visitCell(j);
         }
     }
 
@@ -304,6 +250,84 @@ polySignedDist(const Vec3d& pos, const SurfMeshData& surfMeshData,
     }
 }
 
+static const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+
+///
+/// \brief Finds the edge of the SurfaceMesh nearest to the edge (a0, a1) whose nearest
+/// point on (a0, a1) is inside the SurfaceMesh. Ties go to the lowest (triangle, edge)
+/// Both vertices of the edge must be outside the SurfaceMesh
+/// \param first vertex of the edge
+/// \param second vertex of the edge
+/// \param SurfaceMesh to test against
+/// \return (triangle id, edge id in the triangle), -1 if none was found
+///
+static Vec2i
+closestInsideEdge(const Vec3d& a0, const Vec3d& a1, const SurfMeshData& surfMeshData)
+{
+    double minSqrDist    = IMSTK_DOUBLE_MAX;
+    int    closestTriId  = -1;
+    int    closestEdgeId = -1;
+
+    // For every edge of a triangle/cell of meshB
+    auto visitCell = [&](const int k)
+                     {
+                         const Vec3i& cellB = surfMeshData.cells[k];
+                         for (int l = 0; l < 3; l++)
+                         {
+                             const Vec2i edgeB(cellB[triEdgePattern[l][0]], cellB[triEdgePattern[l][1]]);
+
+                             // Compute the closest point on the two edges
+                             // Check the case, the edges must be within each others bounds/ranges
+                             Vec3d ptA, ptB;
+                             if (CollisionUtils::edgeToEdgeClosestPoints(
+                                 a0, a1,
+                                 surfMeshData.vertices[edgeB[0]], surfMeshData.vertices[edgeB[1]],
+                                 ptA, ptB) == 0)
+                             {
+                                 // Find the closest element to this point on the edge
+                                 const double sqrDist = (ptB - ptA).squaredNorm();
+                                 // Use the closest one only
+                                 if (sqrDist < minSqrDist
+                                     || (sqrDist == minSqrDist && (k < closestTriId || (k == closestTriId && l < closestEdgeId))))
+                                 {
+                                     // Check if the point on the oppositie edge nearest to edgeB is inside B
+                                     int          caseType   = -1;
+                                     Vec3i        vIds       = Vec3i::Zero();
+                                     const double signedDist = polySignedDist(ptA, surfMeshData, caseType, vIds);
+                                     if (signedDist <= 0.0)
+                                     {
+                                         minSqrDist    = sqrDist;
+                                         closestTriId  = k;
+                                         closestEdgeId = l;
+                                     }
+                                 }
+                             }
+                         }
+                         return minSqrDist;
+                     };
+    if (surfMeshData.tree != nullptr)
+    {
+        Eigen::AlignedBox3d edgeBox(a0, a0);
+        edgeBox.extend(a1);
+
+        // With both vertices outside, a point of the edge can only be inside if the
+        // edge crosses a triangle, whose box then overlaps the box of the edge
+        if (!surfMeshData.tree->intersects(edgeBox))
+        {
+            return Vec2i(-1, -1);
+        }
+        surfMeshData.tree->visitNearest(edgeBox, [&](const int k, const double) { return visitCell(k); });
+    }
+    else
+    {
+        for (int k = 0; k < surfMeshData.cells.size(); k++)
+        {
+            visitCell(k);
+        }
+    }
+    return Vec2i(closestTriId, closestEdgeId);
+}
+
 MeshToMeshBruteForceCD::MeshToMeshBruteForceCD()
 {
     setRequiredInputType<PointSet>(0);
@@ -324,6 +348,11 @@ MeshToMeshBruteForceCD::computeCollisionDataAB(
         auto surfMesh = std::dynamic_pointer_cast<SurfaceMesh>(geomB);
         surfMesh->computeTrianglesNormals();
         surfMesh->computeVertexNeighborTriangles();
+        if (!m_bruteForce)
+        {
+            AabbTree::computeCellBoxes(*surfMesh->getTriangleIndices(), *surfMesh->getVertexPositions(), m_cellBoxes);
+            m_cellTree.update(m_cellBoxes);
+        }
 
         // Narrow phase
         if (m_generateVertexTriangleContacts)
@@ -365,69 +394,74 @@ MeshToMeshBruteForceCD::vertexToTriangleTest(
     std::vector<CollisionElement>& elementsB)
 {
     PointSetData pointSetData(std::dynamic_pointer_cast<PointSet>(geomA));
-    SurfMeshData surfMeshData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_bruteForce ? nullptr : &m_cellTree);
+
+    // For every vertex find the nearest element in parallel, the elements are then
+    // output in vertex order
+    std::vector<std::pair<int, Vec3i>> nearest(pointSetData.vertices.size());
+    ParallelUtils::parallelFor(pointSetData.vertices.size(),
+        [&](const int i)
+        {
+            int          caseType   = -1;
+            Vec3i        vertexIds  = Vec3i::Zero();
+            const double signedDist = polySignedDist(pointSetData.vertices[i], surfMeshData, caseType, vertexIds);
+            nearest[i] = { (signedDist <= 0.0) ? caseType : -1, vertexIds };
+        });
 
-    // For every vertex
     for (int i = 0; i < pointSetData.vertices.size(); i++)
     {
-        const Vec3d& p = pointSetData.vertices[i];
-
-        int          caseType   = -1;
-        Vec3i        vertexIds  = Vec3i::Zero();
-        const double signedDist = polySignedDist(p, surfMeshData, caseType, vertexIds);
-        if (signedDist <= 0.0)
+        const int    caseType  = nearest[i].first;
+        const Vec3i& vertexIds = nearest[i].second;
+        if (caseType == 0)
         {
-            if (caseType == 0)
-            {
-                CellIndexElement elemA;
-                elemA.ids[0]   = i;
-                elemA.idCount  = 1;
-                elemA.cellType = IMSTK_VERTEX;
-
-                CellIndexElement elemB;
-                elemB.ids[0]   = vertexIds[0];
-                elemB.idCount  = 1;
-                elemB.cellType = IMSTK_VERTEX;
-
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                m_vertexInside[i] = true;
-            }
-            else if (caseType == 1)
-            {
-                CellIndexElement elemA;
-                elemA.ids[0]   = i;
-                elemA.idCount  = 1;
-                elemA.cellType = IMSTK_VERTEX;
-
-                CellIndexElement elemB;
-                elemB.ids[0]   = vertexIds[0];
-                elemB.ids[1]   = vertexIds[1];
-                elemB.idCount  = 2;
-                elemB.cellType = IMSTK_EDGE;
-
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                m_vertexInside[i] = true;
-            }
-            else if (caseType == 2)
-            {
-                CellIndexElement elemA;
-                elemA.ids[0]   = i;
-                elemA.idCount  = 1;
-                elemA.cellType = IMSTK_VERTEX;
-
-                CellIndexElement elemB;
-                elemB.ids[0]   = vertexIds[0];
-                elemB.ids[1]   = vertexIds[1];
-                elemB.ids[2]   = vertexIds[2];
-                elemB.idCount  = 3;
-                elemB.cellType = IMSTK_TRIANGLE;
-
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                m_vertexInside[i] = true;
-            }
+            CellIndexElement elemA;
+            elemA.ids[0]   = i;
+            elemA.idCount  = 1;
+            elemA.cellType = IMSTK_VERTEX;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = vertexIds[0];
+            elemB.idCount  = 1;
+            elemB.cellType = IMSTK_VERTEX;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
+            m_vertexInside[i] = true;
+        }
+        else if (caseType == 1)
+        {
+            CellIndexElement elemA;
+            elemA.ids[0]   = i;
+            elemA.idCount  = 1;
+            elemA.cellType = IMSTK_VERTEX;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = vertexIds[0];
+            elemB.ids[1]   = vertexIds[1];
+            elemB.idCount  = 2;
+            elemB.cellType = IMSTK_EDGE;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
+            m_vertexInside[i] = true;
+        }
+        else if (caseType == 2)
+        {
+            CellIndexElement elemA;
+            elemA.ids[0]   = i;
+            elemA.idCount  = 1;
+            elemA.cellType = IMSTK_VERTEX;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = vertexIds[0];
+            elemB.ids[1]   = vertexIds[1];
+            elemB.ids[2]   = vertexIds[2];
+            elemB.idCount  = 3;
+            elemB.cellType = IMSTK_TRIANGLE;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
+            m_vertexInside[i] = true;
         }
     }
 }
@@ -439,7 +473,7 @@ MeshToMeshBruteForceCD::lineMeshEdgeToTriangleTest(
     std::vector<CollisionElement>& elementsA,
     std::vector<CollisionElement>& elementsB)
 {
-    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_bruteForce ? nullptr : &m_cellTree);
 
     // Get geometry A data
     std::shared_ptr<LineMesh>                lineMesh = std::dynamic_pointer_cast<LineMesh>(geomA);
@@ -448,75 +482,43 @@ MeshToMeshBruteForceCD::lineMeshEdgeToTriangleTest(
     std::shared_ptr<VecDataArray<int, 2>>    meshACellsPtr    = lineMesh->getLinesIndices();
     VecDataArray<int, 2>&                    meshACells       = *meshACellsPtr;
 
-    const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
-
-    // For every edge/line segment of the line mesh
-    for (int i = 0; i < meshACells.size(); i++)
-    {
-        const Vec2i& edgeA = meshACells[i];
-
-        // Only check edges that don't exist totally inside
-        if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
+    // For every edge/line segment of the line mesh, in parallel
+    std::vector<Vec2i> closestEdges(meshACells.size());
+    ParallelUtils::parallelFor(meshACells.size(),
+        [&](const int i)
         {
-            double minSqrDist    = IMSTK_DOUBLE_MAX;
-            int    closestTriId  = -1;
-            int    closestEdgeId = -1;
+            const Vec2i& edgeA = meshACells[i];
 
-            // For every triangle/cell of meshB
-            for (int j = 0; j < surfMeshBData.cells.size(); j++)
+            // Only check edges that don't exist totally inside
+            closestEdges[i] = Vec2i(-1, -1);
+            if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
             {
-                const Vec3i& cellB = surfMeshBData.cells[j];
-
-                // For every edge of that triangle
-                for (int k = 0; k < 3; k++)
-                {
-                    const Vec2i edgeB(cellB[triEdgePattern[k][0]], cellB[triEdgePattern[k][1]]);
-
-                    // Compute the closest point on the two edges
-                    // Check the case, the edges must be within each others bounds/ranges
-                    Vec3d ptA, ptB;
-                    if (CollisionUtils::edgeToEdgeClosestPoints(
-                        meshAVertices[edgeA[0]], meshAVertices[edgeA[1]],
-                        surfMeshBData.vertices[edgeB[0]], surfMeshBData.vertices[edgeB[1]],
-                        ptA, ptB) == 0)
-                    {
-                        // Find the closest element to this point on the edge
-                        const double sqrDist = (ptB - ptA).squaredNorm();
-                        // Use the closest one only
-                        if (sqrDist < minSqrDist)
-                        {
-                            // Check if the point on the oppositie edge nearest to edgeB is inside B
-                            int          caseType   = -1;
-                            Vec3i        vIds       = Vec3i::Zero();
-                            const double signedDist = polySignedDist(ptA, surfMeshBData, caseType, vIds);
-                            if (signedDist <= 0.0)
-                            {
-                                minSqrDist    = sqrDist;
-                                closestTriId  = j;
-                                closestEdgeId = k;
-                            }
-                        }
-                    }
-                }
+                closestEdges[i] = closestInsideEdge(meshAVertices[edgeA[0]], meshAVertices[edgeA[1]], surfMeshBData);
             }
+        });
 
-            if (closestTriId != -1)
-            {
-                CellIndexElement elemA;
-                elemA.ids[0]   = edgeA[0];
-                elemA.ids[1]   = edgeA[1];
-                elemA.idCount  = 2;
-                elemA.cellType = IMSTK_EDGE;
-
-                CellIndexElement elemB;
-                elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
-                elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
-                elemB.idCount  = 2;
-                elemB.cellType = IMSTK_EDGE;
-
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-            }
+    for (int i = 0; i < meshACells.size(); i++)
+    {
+        const int closestTriId  = closestEdges[i][0];
+        const int closestEdgeId = closestEdges[i][1];
+        if (closestTriId != -1)
+        {
+            const Vec2i& edgeA = meshACells[i];
+
+            CellIndexElement elemA;
+            elemA.ids[0]   = edgeA[0];
+            elemA.ids[1]   = edgeA[1];
+            elemA.idCount  = 2;
+            elemA.cellType = IMSTK_EDGE;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
+            elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
+            elemB.idCount  = 2;
+            elemB.cellType = IMSTK_EDGE;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
         }
     }
 }
@@ -528,7 +530,7 @@ MeshToMeshBruteForceCD::surfMeshEdgeToTriangleTest(
     std::vector<CollisionElement>& elementsA,
     std::vector<CollisionElement>& elementsB)
 {
-    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_bruteForce ? nullptr : &m_cellTree);
 
     // Get geometry A data
     std::shared_ptr<SurfaceMesh>             surfMeshA = std::dynamic_pointer_cast<SurfaceMesh>(geomA);
@@ -537,92 +539,63 @@ MeshToMeshBruteForceCD::surfMeshEdgeToTriangleTest(
     std::shared_ptr<VecDataArray<int, 3>>    meshACellsPtr    = surfMeshA->getTriangleIndices();
     VecDataArray<int, 3>&                    meshACells       = *meshACellsPtr;
 
-    std::unordered_set<EdgePair> hashedEdges;
+    std::unordered_set<EdgePair, EdgePairHash> hashedEdges;
 
-    const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
     if (m_generateEdgeEdgeContacts)
     {
-        // For every edge/line segment of the line mesh
-        for (int i = 0; i < meshACells.size(); i++)
-        {
-            const Vec3i& cellA = meshACells[i];
-
-            // For every edge of triangle A
-            for (int j = 0; j < 3; j++)
+        // For every edge of every triangle A, in parallel
+        std::vector<Vec2i> closestEdges(3 * meshACells.size());
+        ParallelUtils::parallelFor(meshACells.size(),
+            [&](const int i)
             {
-                const Vec2i edgeA = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
-
-                // Only check edges that don't exist totally inside
-                if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
+                const Vec3i& cellA = meshACells[i];
+                for (int j = 0; j < 3; j++)
                 {
-                    double minSqrDist    = IMSTK_DOUBLE_MAX;
-                    int    closestTriId  = -1;
-                    int    closestEdgeId = -1;
+                    const Vec2i edgeA = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
 
-                    // For every triangle/cell of meshB
-                    for (int k = 0; k < surfMeshBData.cells.size(); k++)
+                    // Only check edges that don't exist totally inside
+                    closestEdges[3 * i + j] = Vec2i(-1, -1);
+                    if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
                     {
-                        const Vec3i& cellB = surfMeshBData.cells[k];
-
-                        // For every edge of that triangle
-                        for (int l = 0; l < 3; l++)
-                        {
-                            const Vec2i edgeB(cellB[triEdgePattern[l][0]], cellB[triEdgePattern[l][1]]);
-
-                            // Compute the closest point on the two edges
-                            // Check the case, the edges must be within each others bounds/ranges
-                            Vec3d ptA, ptB;
-                            if (CollisionUtils::edgeToEdgeClosestPoints(
-                                meshAVertices[edgeA[0]], meshAVertices[edgeA[1]],
-                                surfMeshBData.vertices[edgeB[0]], surfMeshBData.vertices[edgeB[1]],
-                                ptA, ptB) == 0)
-                            {
-                                // Find the closest element to this point on the edge
-                                const double sqrDist = (ptB - ptA).squaredNorm();
-                                // Use the closest one only
-                                if (sqrDist < minSqrDist)
-                                {
-                                    // Check if the point on the oppositie edge nearest to edgeB is inside B
-                                    int          caseType   = -1;
-                                    Vec3i        vIds       = Vec3i::Zero();
-                                    const double signedDist = polySignedDist(ptA, surfMeshBData, caseType, vIds);
-                                    if (signedDist <= 0.0)
-                                    {
-                                        minSqrDist    = sqrDist;
-                                        closestTriId  = k;
-                                        closestEdgeId = l;
-                                    }
-                                }
-                            }
-                        }
+                        closestEdges[3 * i + j] = closestInsideEdge(meshAVertices[edgeA[0]], meshAVertices[edgeA[1]], surfMeshBData);
                     }
+                }
+            });
 
-                    if (closestTriId != -1)
+        for (int i = 0; i < meshACells.size(); i++)
+        {
+            const Vec3i& cellA = meshACells[i];
+            for (int j = 0; j < 3; j++)
+            {
+                const int closestTriId  = closestEdges[3 * i + j][0];
+                const int closestEdgeId = closestEdges[3 * i + j][1];
+                if (closestTriId != -1)
+                {
+                    const Vec2i edgeA = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
+
+                    // Before inserting check if it already exists
+                    EdgePair edgePair(
+                        edgeA[0], edgeA[1],
+                        surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]],
+                        surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]]);
+                    if (hashedEdges.count(edgePair) == 0)
                     {
-                        // Before inserting check if it already exists
-                        EdgePair edgePair(
-                            edgeA[0], edgeA[1],
-                            surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]],
-                            surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]]);
-                        if (hashedEdges.count(edgePair) == 0)
-                        {
-                            CellIndexElement elemA;
-                            elemA.ids[0]   = edgeA[0];
-                            elemA.ids[1]   = edgeA[1];
-                            elemA.idCount  = 2;
-                            elemA.cellType = IMSTK_EDGE;
-
-                            CellIndexElement elemB;
-                            elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
-                            elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
-                            elemB.idCount  = 2;
-                            elemB.cellType = IMSTK_EDGE;
-
-                            elementsA.push_back(elemA);
-                            elementsB.push_back(elemB);
-
-                            hashedEdges.insert(edgePair);
-                        }
+                        CellIndexElement elemA;
+                        elemA.ids[0]   = edgeA[0];
+                        elemA.ids[1]   = edgeA[1];
+                        elemA.idCount  = 2;
+                        elemA.cellType = IMSTK_EDGE;
+
+                        CellIndexElement elemB;
+                        elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
+                        elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
+                        elemB.idCount  = 2;
+                        elemB.cellType = IMSTK_EDGE;
+
+                        elementsA.push_back(elemA);
+                        elementsB.push_back(elemB);
+
+                        hashedEdges.insert(edgePair);
                     }
                 }
             }
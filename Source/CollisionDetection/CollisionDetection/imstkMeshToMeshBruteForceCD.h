@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkAabbTree.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 
 namespace imstk
@@ -44,6 +45,10 @@ class SurfaceMesh;
 /// It produces edge-edge, vertex-triangle, vertex-edge, vertex-vertex data.
 /// Edge-edge is off by default due to cost and effectiveness
 ///
+/// The nearest elements of B are searched with an AabbTree over its triangles, refit
+/// every call. The brute force search over all of them remains selectable, it gives
+/// the same contacts and is kept for comparison
+///
 /// It's exact implementation follows roughly along with Pierre Terdiman's
 /// "Contact Generation for Meshes" but further described in with GJK instead
 /// of brute force closest point determination in "Game Physics Pearls"
@@ -78,6 +83,13 @@ public:
     ///
     void setGenerateVertexTriangleContacts(bool genVertexTriangleContacts) { m_generateVertexTriangleContacts = genVertexTriangleContacts; }
 
+    ///
+    /// \brief If true, every triangle of B is tested instead of searching its AabbTree
+    /// default false
+    ///
+    void setBruteForce(const bool bruteForce) { m_bruteForce = bruteForce; }
+    bool getBruteForce() const { return m_bruteForce; }
+
     ///
     /// \brief Set padding to the broad phase
     ///
@@ -123,6 +135,10 @@ private:
 
     bool m_generateEdgeEdgeContacts       = false;
     bool m_generateVertexTriangleContacts = true;
+    bool m_bruteForce                     = false;
+
+    AabbTree m_cellTree;                          ///> Tree over the triangles of B
+    std::vector<Eigen::AlignedBox3d> m_cellBoxes; ///> Bounding boxes of the triangles of B
 
     std::vector<bool> m_vertexInside;
     Vec3d m_padding = Vec3d(0.001, 0.001, 0.001);
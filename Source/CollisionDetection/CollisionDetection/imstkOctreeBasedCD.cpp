@@ -0,0 +1,296 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkOctreeBasedCD.h"
+#include "imstkCollisionUtils.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkSurfaceMesh.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+OctreeBasedCD::OctreeBasedCD(const Vec3d& center, const double width, const double minWidth,
+                             const double minWidthRatio, const std::string name) :
+    LooseOctree(center, width, minWidth, minWidthRatio, name)
+{
+}
+
+void
+OctreeBasedCD::clear()
+{
+    LooseOctree::clear();
+    m_collisionPairs.clear();
+    m_localIndices.clear();
+    m_numLocalGeometries = 0;
+    m_pairTable.clear();
+    m_isGeometryA.clear();
+}
+
+void
+OctreeBasedCD::addCollisionPair(std::shared_ptr<PointSet> geomA, std::shared_ptr<SurfaceMesh> geomB)
+{
+    CHECK(geomA != nullptr && geomB != nullptr) << "Invalid collision pair geometries";
+    CHECK(geomA != geomB) << "A geometry cannot collide with itself";
+    if (hasCollisionPair(geomA->getGlobalIndex(), geomB->getGlobalIndex()))
+    {
+        LOG(WARNING) << "Collision pair " << geomA->getName() << " vs " << geomB->getName() << " has previously been added";
+        return;
+    }
+
+    auto collisionPair = std::make_unique<CollisionPair>();
+    collisionPair->geomA          = geomA;
+    collisionPair->geomB          = geomB;
+    collisionPair->localIdxA      = addPairGeometry(geomA);
+    collisionPair->localIdxB      = addPairGeometry(geomB);
+    collisionPair->colData        = std::make_shared<CollisionData>();
+    collisionPair->colData->geomA = geomA;
+    collisionPair->colData->geomB = geomB;
+    m_isGeometryA[collisionPair->localIdxA] = true;
+    m_collisionPairs.push_back(std::move(collisionPair));
+
+    // Rebuild the pair table, the number of geometries may have changed
+    m_pairTable.assign(m_numLocalGeometries * m_numLocalGeometries, -1);
+    for (size_t i = 0; i < m_collisionPairs.size(); i++)
+    {
+        m_pairTable[m_collisionPairs[i]->localIdxA * m_numLocalGeometries + m_collisionPairs[i]->localIdxB] = static_cast<int>(i);
+    }
+}
+
+bool
+OctreeBasedCD::hasCollisionPair(const uint32_t geomIdxA, const uint32_t geomIdxB) const
+{
+    const int localIdxA = getLocalIndex(geomIdxA);
+    const int localIdxB = getLocalIndex(geomIdxB);
+    return localIdxA != -1 && localIdxB != -1 && m_pairTable[localIdxA * m_numLocalGeometries + localIdxB] != -1;
+}
+
+std::shared_ptr<CollisionData>
+OctreeBasedCD::getCollisionPairData(const uint32_t geomIdxA, const uint32_t geomIdxB) const
+{
+    if (!hasCollisionPair(geomIdxA, geomIdxB))
+    {
+        return nullptr;
+    }
+    return m_collisionPairs[m_pairTable[getLocalIndex(geomIdxA) * m_numLocalGeometries + getLocalIndex(geomIdxB)]]->colData;
+}
+
+int
+OctreeBasedCD::addPairGeometry(std::shared_ptr<PointSet> geom)
+{
+    const uint32_t geomIdx = geom->getGlobalIndex();
+    if (geomIdx >= m_localIndices.size())
+    {
+        m_localIndices.resize(geomIdx + 1, -1);
+    }
+    if (m_localIndices[geomIdx] != -1)
+    {
+        return m_localIndices[geomIdx];
+    }
+
+    if (auto surfMesh = std::dynamic_pointer_cast<SurfaceMesh>(geom))
+    {
+        addTriangleMesh(surfMesh);
+    }
+    else
+    {
+        addPointSet(geom);
+    }
+    // The new primitives are in no node yet, build again on the next update
+    m_bCompleteBuild = false;
+
+    m_localIndices[geomIdx] = m_numLocalGeometries++;
+    m_isGeometryA.push_back(false);
+    return m_localIndices[geomIdx];
+}
+
+void
+OctreeBasedCD::detectCollision()
+{
+    for (auto& collisionPair : m_collisionPairs)
+    {
+        collisionPair->contacts.resize(0);
+        collisionPair->colData->elementsA.resize(0);
+        collisionPair->colData->elementsB.resize(0);
+    }
+    if (m_collisionPairs.empty())
+    {
+        return;
+    }
+
+    update();
+
+    // Every primitive of the A geometries visits the tree once for all its pairs
+    for (const OctreePrimitiveType type : { OctreePrimitiveType::Point, OctreePrimitiveType::Triangle })
+    {
+        const std::vector<OctreePrimitive*>& vPrimitivePtrs = m_vPrimitivePtrs[type];
+        ParallelUtils::parallelFor(vPrimitivePtrs.size(),
+            [&](const size_t idx)
+            {
+                OctreePrimitive* const pPrimitive = vPrimitivePtrs[idx];
+                const int              localIdx   = getLocalIndex(pPrimitive->m_GeomIdx);
+                if (localIdx != -1 && m_isGeometryA[localIdx])
+                {
+                    checkPrimitive(pPrimitive, type);
+                }
+            });
+    }
+
+    ParallelUtils::parallelFor(m_collisionPairs.size(),
+        [&](const size_t i)
+        {
+            writeCollisionData(*m_collisionPairs[i]);
+        });
+}
+
+void
+OctreeBasedCD::checkPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type)
+{
+    const int localIdxA = getLocalIndex(pPrimitive->m_GeomIdx);
+
+    // Box of the primitive, a point is grown by the contact distance
+    std::array<double, 3> lowerCorner;
+    std::array<double, 3> upperCorner;
+    Vec3d                 point;
+    Vec3i                 cellA;
+    Vec3d                 cellAVertices[3];
+    if (type == OctreePrimitiveType::Point)
+    {
+        point = Vec3d(pPrimitive->m_Position[0], pPrimitive->m_Position[1], pPrimitive->m_Position[2]);
+        for (int dim = 0; dim < 3; dim++)
+        {
+            lowerCorner[dim] = point[dim] - m_pointTriangleContactDistance;
+            upperCorner[dim] = point[dim] + m_pointTriangleContactDistance;
+        }
+    }
+    else
+    {
+        lowerCorner = pPrimitive->m_LowerCorner;
+        upperCorner = pPrimitive->m_UpperCorner;
+        const auto surfMeshA = static_cast<SurfaceMesh*>(pPrimitive->m_pGeometry);
+        cellA = (*surfMeshA->getTriangleIndices())[pPrimitive->m_Idx];
+        for (int i = 0; i < 3; i++)
+        {
+            cellAVertices[i] = surfMeshA->getVertexPosition(cellA[i]);
+        }
+    }
+
+    // Depth first through the nodes whose loose bounds overlap the box, the root node
+    // also keeps the primitives outside of the tree
+    std::vector<OctreeNode*> stack = { m_pRootNode };
+    while (!stack.empty())
+    {
+        OctreeNode* const pNode = stack.back();
+        stack.pop_back();
+
+        for (OctreePrimitive* pPrimitiveB = pNode->m_pPrimitiveListHeads[OctreePrimitiveType::Triangle];
+             pPrimitiveB != nullptr; pPrimitiveB = pPrimitiveB->m_pNext)
+        {
+            const int localIdxB = getLocalIndex(pPrimitiveB->m_GeomIdx);
+            const int pairIdx   = (localIdxB != -1) ? m_pairTable[localIdxA * m_numLocalGeometries + localIdxB] : -1;
+            if (pairIdx == -1
+                || !CollisionUtils::testAABBToAABB(
+                    lowerCorner[0], upperCorner[0], lowerCorner[1], upperCorner[1], lowerCorner[2], upperCorner[2],
+                    pPrimitiveB->m_LowerCorner[0], pPrimitiveB->m_UpperCorner[0],
+                    pPrimitiveB->m_LowerCorner[1], pPrimitiveB->m_UpperCorner[1],
+                    pPrimitiveB->m_LowerCorner[2], pPrimitiveB->m_UpperCorner[2]))
+            {
+                continue;
+            }
+
+            const auto   surfMeshB = static_cast<SurfaceMesh*>(pPrimitiveB->m_pGeometry);
+            const Vec3i& cellB     = (*surfMeshB->getTriangleIndices())[pPrimitiveB->m_Idx];
+            const Vec3d  x1 = surfMeshB->getVertexPosition(cellB[0]);
+            const Vec3d  x2 = surfMeshB->getVertexPosition(cellB[1]);
+            const Vec3d  x3 = surfMeshB->getVertexPosition(cellB[2]);
+
+            PrimitiveContact primitiveContact;
+            primitiveContact.primitiveIdxA = pPrimitive->m_Idx;
+            primitiveContact.primitiveIdxB = pPrimitiveB->m_Idx;
+            TriangleContact& contact = primitiveContact.contact;
+            if (type == OctreePrimitiveType::Point)
+            {
+                // The vertex must project inside the triangle, behind it by less than the contact distance
+                int         caseType = -1;
+                const Vec3d closestPt  = CollisionUtils::closestPointOnTriangle(point, x1, x2, x3, caseType);
+                const Vec3d n          = (x2 - x1).cross(x3 - x1).normalized();
+                const double signedDist = (point - closestPt).dot(n);
+                if (caseType == 6 && signedDist <= 0.0 && signedDist >= -m_pointTriangleContactDistance)
+                {
+                    contact.type      = 1;
+                    contact.vtContact = { static_cast<int>(pPrimitive->m_Idx), cellB };
+                }
+            }
+            else
+            {
+                contact.type = CollisionUtils::triangleToTriangle(cellA, cellB,
+                    cellAVertices[0], cellAVertices[1], cellAVertices[2], x1, x2, x3,
+                    contact.eeContact, contact.vtContact, contact.tvContact);
+            }
+
+            if (contact.type != -1)
+            {
+                m_collisionPairs[pairIdx]->contactBuffers.local().push_back(primitiveContact);
+            }
+        }
+
+        if (!pNode->isLeaf())
+        {
+            for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+            {
+                OctreeNode* const pChild = &pNode->m_pChildren->m_Nodes[childIdx];
+                if (pChild->looselyOverlaps(lowerCorner, upperCorner))
+                {
+                    stack.push_back(pChild);
+                }
+            }
+        }
+    }
+}
+
+void
+OctreeBasedCD::writeCollisionData(CollisionPair& collisionPair)
+{
+    // Contacts were found in any order by the threads, sort them for a deterministic output
+    std::vector<PrimitiveContact>& contacts = collisionPair.contacts;
+    for (std::vector<PrimitiveContact>& buffer : collisionPair.contactBuffers)
+    {
+        contacts.insert(contacts.end(), buffer.begin(), buffer.end());
+        buffer.clear();
+    }
+    std::sort(contacts.begin(), contacts.end(),
+        [](const PrimitiveContact& a, const PrimitiveContact& b)
+        {
+            return a.primitiveIdxA < b.primitiveIdxA || (a.primitiveIdxA == b.primitiveIdxA && a.primitiveIdxB < b.primitiveIdxB);
+        });
+
+    std::vector<CollisionElement>& elementsA = collisionPair.colData->elementsA;
+    std::vector<CollisionElement>& elementsB = collisionPair.colData->elementsB;
+
+    // The same edge pair may be found from several triangle pairs
+    std::unordered_set<EdgePair, EdgePairHash> edges;
+    for (const PrimitiveContact& contact : contacts)
+    {
+        appendTriangleContact(contact.contact, edges, elementsA, elementsB);
+    }
+}
+} // imstk
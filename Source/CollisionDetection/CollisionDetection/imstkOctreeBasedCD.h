@@ -0,0 +1,159 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkCollisionData.h"
+#include "imstkLooseOctree.h"
+#include "imstkTriangleContact.h"
+
+#include <tbb/enumerable_thread_specific.h>
+
+namespace imstk
+{
+///
+/// \class OctreeBasedCD
+///
+/// \brief Collision detection of many geometry pairs at once, all sharing one LooseOctree.
+/// The point sets and surface meshes of the registered pairs are added to the octree,
+/// every detectCollision updates it (incrementally by default) then visits it once for
+/// every point or triangle of the A side of a pair, against the triangles of all its B
+/// geometries. This replaces a separate collision detection per pair.
+///
+/// Supported pairs:
+/// PointSet vs SurfaceMesh, a vertex is in contact with a triangle when it is behind
+/// the face by less than the point triangle contact distance, vertex-triangle data.
+/// SurfaceMesh vs SurfaceMesh, intersecting triangles as in SurfaceMeshToSurfaceMeshCD,
+/// vertex-triangle and edge-edge data.
+///
+/// The meshes must keep the same number of vertices and cells once added
+///
+class OctreeBasedCD : public LooseOctree
+{
+protected:
+    ///
+    /// \brief Contact found between a primitive of A and a triangle of B
+    ///
+    struct PrimitiveContact
+    {
+        uint32_t        primitiveIdxA;
+        uint32_t        primitiveIdxB;
+        TriangleContact contact;
+    };
+
+    ///
+    /// \brief A registered pair with its output and the contacts found during traversal
+    ///
+    struct CollisionPair
+    {
+        std::shared_ptr<Geometry> geomA;
+        std::shared_ptr<Geometry> geomB;
+        int localIdxA;
+        int localIdxB;
+        std::shared_ptr<CollisionData> colData;
+
+        std::vector<PrimitiveContact> contacts;
+        tbb::enumerable_thread_specific<std::vector<PrimitiveContact>> contactBuffers; ///> Contacts found by each thread
+    };
+
+public:
+    ///
+    /// \brief See LooseOctree
+    ///
+    explicit OctreeBasedCD(const Vec3d& center, const double width, const double minWidth,
+                           const double minWidthRatio = 1.0, const std::string name = "OctreeBasedCD");
+    virtual ~OctreeBasedCD() override = default;
+
+public:
+    ///
+    /// \brief Clear all the geometries and collision pairs
+    ///
+    virtual void clear() override;
+
+    ///
+    /// \brief Register a pair, its geometries are added to the octree if not already.
+    /// geomA may be a PointSet or a SurfaceMesh, geomB must be a SurfaceMesh
+    ///
+    void addCollisionPair(std::shared_ptr<PointSet> geomA, std::shared_ptr<SurfaceMesh> geomB);
+
+    ///
+    /// \brief Check if the pair of geometries with the given global indices was registered
+    ///
+    bool hasCollisionPair(const uint32_t geomIdxA, const uint32_t geomIdxB) const;
+
+    ///
+    /// \brief Get the collision data of a registered pair, nullptr if it was not registered
+    ///
+    std::shared_ptr<CollisionData> getCollisionPairData(const uint32_t geomIdxA, const uint32_t geomIdxB) const;
+
+    ///
+    /// \brief Get the number of registered pairs
+    ///
+    size_t getNumCollisionPairs() const { return m_collisionPairs.size(); }
+
+    ///
+    /// \brief Set/Get the maximum depth of a vertex behind a triangle for them to be in
+    /// contact. default 0.01
+    ///
+    void setPointTriangleContactDistance(const double distance) { m_pointTriangleContactDistance = distance; }
+    double getPointTriangleContactDistance() const { return m_pointTriangleContactDistance; }
+
+    ///
+    /// \brief Update the octree then compute the collision data of all the pairs
+    ///
+    void detectCollision();
+
+protected:
+    ///
+    /// \brief Add a geometry to the octree if it is not already, surface meshes as triangles
+    /// and other point sets as points, returns its local index
+    ///
+    int addPairGeometry(std::shared_ptr<PointSet> geom);
+
+    ///
+    /// \brief Returns the local index of a geometry from its global index, -1 if it is in no pair
+    ///
+    int getLocalIndex(const uint32_t geomIdx) const
+    {
+        return (geomIdx < m_localIndices.size()) ? m_localIndices[geomIdx] : -1;
+    }
+
+    ///
+    /// \brief Test a point or triangle primitive of A against the triangles of the nodes
+    /// its (loose) box overlaps
+    ///
+    void checkPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type);
+
+    ///
+    /// \brief Sort the contacts of a pair and write them in its collision data
+    ///
+    void writeCollisionData(CollisionPair& collisionPair);
+
+    std::vector<std::unique_ptr<CollisionPair>> m_collisionPairs;
+
+    std::vector<int> m_localIndices; ///> Local index of a geometry from its global index, -1 if absent
+    int m_numLocalGeometries = 0;
+    std::vector<int> m_pairTable;    ///> Index in m_collisionPairs of local geometry pair (A, B), -1 if none
+    std::vector<bool> m_isGeometryA; ///> Whether a local geometry is the A side of a pair
+
+    double m_pointTriangleContactDistance = 0.01;
+};
+} // imstk
@@ -52,7 +52,6 @@ PointSetToCapsuleCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -74,12 +73,10 @@ PointSetToCapsuleCD::computeCollisionDataAB(
                 elemB.pt  = capsuleContactPt;     // Contact point on surface of capsule
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.push_back(elemA, elemB);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 
 void
@@ -98,7 +95,6 @@ PointSetToCapsuleCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -115,11 +111,10 @@ PointSetToCapsuleCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_elementBuffers.pushBackA(elemA);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendToA(elementsA);
 }
 
 void
@@ -138,7 +133,6 @@ PointSetToCapsuleCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -155,10 +149,9 @@ PointSetToCapsuleCD::computeCollisionDataB(
                 elemB.pt  = capsuleContactPt;     // Contact point on surface of capsule
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.pushBackB(elemB);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendToB(elementsB);
 }
 }
\ No newline at end of file
@@ -51,7 +51,6 @@ PointSetToOrientedBoxCD::computeCollisionDataAB(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -73,12 +72,10 @@ PointSetToOrientedBoxCD::computeCollisionDataAB(
                 elemB.pt  = cubeContactPt;       // Contact point on surface of cube
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.push_back(elemA, elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 
 void
@@ -96,7 +93,6 @@ PointSetToOrientedBoxCD::computeCollisionDataA(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -113,11 +109,10 @@ PointSetToOrientedBoxCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_elementBuffers.pushBackA(elemA);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToA(elementsA);
 }
 
 void
@@ -135,7 +130,6 @@ PointSetToOrientedBoxCD::computeCollisionDataB(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -152,10 +146,9 @@ PointSetToOrientedBoxCD::computeCollisionDataB(
                 elemB.pt  = cubeContactPt;       // Contact point on surface of cube
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.pushBackB(elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToB(elementsB);
 }
 }
\ No newline at end of file
@@ -53,7 +53,6 @@ PointSetToPlaneCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -74,12 +73,10 @@ PointSetToPlaneCD::computeCollisionDataAB(
                 elemB.pt  = vertices[idx];
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.push_back(elemA, elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 
 void
@@ -96,7 +93,6 @@ PointSetToPlaneCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -112,11 +108,10 @@ PointSetToPlaneCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_elementBuffers.pushBackA(elemA);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToA(elementsA);
 }
 
 void
@@ -133,7 +128,6 @@ PointSetToPlaneCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -149,10 +143,9 @@ PointSetToPlaneCD::computeCollisionDataB(
                 elemB.pt  = vertices[idx];
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.pushBackB(elemB);
             }
         }, vertices.size() > 100);
+    m_elementBuffers.appendToB(elementsB);
 }
 }
\ No newline at end of file
@@ -49,7 +49,6 @@ PointSetToSphereCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -70,12 +69,10 @@ PointSetToSphereCD::computeCollisionDataAB(
                 elemB.pt  = sphereContactPt;
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.push_back(elemA, elemB);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 
 void
@@ -92,7 +89,6 @@ PointSetToSphereCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -108,11 +104,10 @@ PointSetToSphereCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_elementBuffers.pushBackA(elemA);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendToA(elementsA);
 }
 
 void
@@ -129,7 +124,6 @@ PointSetToSphereCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -145,10 +139,9 @@ PointSetToSphereCD::computeCollisionDataB(
                 elemB.pt  = sphereContactPt;
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_elementBuffers.pushBackB(elemB);
             }
                 }, vertices.size() > 100);
+    m_elementBuffers.appendToB(elementsB);
 }
 }
\ No newline at end of file
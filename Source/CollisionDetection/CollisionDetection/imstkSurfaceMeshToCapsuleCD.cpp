@@ -56,7 +56,6 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
     // \todo: Doesn't remove duplicate contacts (shared edges), refer to SurfaceMeshCD for easy method to do so
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec3i& cell = indices[i];
@@ -129,10 +128,7 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
                 else if (caseType == 2) // Triangle vs point on sphere
                 {
@@ -154,10 +150,7 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
                 else if (caseType == 3)
                 {
@@ -177,12 +170,10 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.dir = contactNormal;     // Direction to resolve point
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
             }
     });
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 }
@@ -53,7 +53,6 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
     // \todo: Doesn't remove duplicate contacts (shared edges), refer to SurfaceMeshCD for easy method to do so
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec3i& cell = indices[i];
@@ -102,10 +101,7 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
                 else if (caseType == 2) // Triangle vs point on sphere
                 {
@@ -127,10 +123,7 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
                 else if (caseType == 3)
                 {
@@ -150,12 +143,10 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.dir = contactNormal;     // Direction to resolve point
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
             }
         });
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 }
\ No newline at end of file
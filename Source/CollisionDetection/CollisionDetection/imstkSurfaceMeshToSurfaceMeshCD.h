@@ -21,7 +21,9 @@
 
 #pragma once
 
+#include "imstkAabbTree.h"
 #include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkTriangleContact.h"
 
 namespace imstk
 {
@@ -30,7 +32,9 @@ class SurfaceMesh;
 ///
 /// \class SurfaceMeshToSurfaceMeshCD
 ///
-/// \brief Collision detection for surface meshes
+/// \brief Collision detection for surface meshes. The triangles of each mesh are kept in
+/// an AabbTree, refit every update (rebuilt when the number of triangles changes), and the
+/// candidate triangle pairs found by traversing both trees are tested in parallel
 ///
 class SurfaceMeshToSurfaceMeshCD : public CollisionDetectionAlgorithm
 {
@@ -58,7 +62,12 @@ protected:
         std::vector<CollisionElement>& elementsB) override;
 
 protected:
-    std::vector<std::pair<int, int>> m_intersectingPairs;
-    int m_maxNumContacts = 1000;
+    std::vector<std::pair<int, int>> m_intersectingPairs; ///> Triangle pairs whose boxes overlap
+    std::vector<TriangleContact>     m_contacts;          ///> Contact of every intersecting pair
+    std::vector<Eigen::AlignedBox3d> m_boxesA;
+    std::vector<Eigen::AlignedBox3d> m_boxesB;
+    AabbTree m_treeA;
+    AabbTree m_treeB;
+    int      m_maxNumContacts = 1000;
 };
 }
\ No newline at end of file
@@ -54,37 +54,47 @@ TetraToLineMeshCD::computeCollisionDataAB(
     const VecDataArray<int, 2>&              lines       = *linesPtr;
     const VecDataArray<double, 3>&           lineVerts   = *verticesPtr;
 
-    // Brute force
-    ParallelUtils::SpinLock lock;
-    ParallelUtils::parallelFor(lines.size(), [&](int i)
+    // Broad phase, only the tetrahedrons whose boxes the segment boxes overlap are tested.
+    // Both meshes deform so the trees are refit every time
+    AabbTree::computeCellBoxes(tets, tetVerts, m_tetBoxes);
+    AabbTree::computeCellBoxes(lines, lineVerts, m_lineBoxes);
+    m_tetTree.update(m_tetBoxes);
+    m_lineTree.update(m_lineBoxes);
+    m_tetTree.computeOverlaps(m_lineTree, m_candidatePairs);
+
+    // Narrow phase of every pair, independent of each other
+    m_isIntersecting.resize(m_candidatePairs.size());
+    ParallelUtils::parallelFor(m_candidatePairs.size(), [&](const size_t i)
         {
-            const Vec3d& x0 = lineVerts[lines[i][0]];
-            const Vec3d& x1 = lineVerts[lines[i][1]];
-            for (int j = 0; j < tets.size(); j++)
-            {
-                std::array<Vec3d, 4> tet;
-                tet[0] = tetVerts[tets[j][0]];
-                tet[1] = tetVerts[tets[j][1]];
-                tet[2] = tetVerts[tets[j][2]];
-                tet[3] = tetVerts[tets[j][3]];
-                if (CollisionUtils::testTetToSegment(tet, x0, x1))
-                {
-                    CellIndexElement elemA;
-                    elemA.ids[0]   = j;
-                    elemA.idCount  = 1;
-                    elemA.cellType = IMSTK_TETRAHEDRON;
-
-                    CellIndexElement elemB;
-                    elemB.ids[0]   = i;
-                    elemB.idCount  = 1;
-                    elemB.cellType = IMSTK_EDGE;
-
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
-                }
-            }
+            const Vec4i& tetCell  = tets[m_candidatePairs[i].first];
+            const Vec2i& lineCell = lines[m_candidatePairs[i].second];
+
+            std::array<Vec3d, 4> tet;
+            tet[0] = tetVerts[tetCell[0]];
+            tet[1] = tetVerts[tetCell[1]];
+            tet[2] = tetVerts[tetCell[2]];
+            tet[3] = tetVerts[tetCell[3]];
+            m_isIntersecting[i] = CollisionUtils::testTetToSegment(tet, lineVerts[lineCell[0]], lineVerts[lineCell[1]]);
         });
+
+    // Report in pair order
+    for (size_t i = 0; i < m_candidatePairs.size(); i++)
+    {
+        if (m_isIntersecting[i])
+        {
+            CellIndexElement elemA;
+            elemA.ids[0]   = m_candidatePairs[i].first;
+            elemA.idCount  = 1;
+            elemA.cellType = IMSTK_TETRAHEDRON;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = m_candidatePairs[i].second;
+            elemB.idCount  = 1;
+            elemB.cellType = IMSTK_EDGE;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
+        }
+    }
 }
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkAabbTree.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 
 namespace imstk
@@ -28,7 +29,10 @@ namespace imstk
 ///
 /// \class TetraToLineMeshCD
 ///
-/// \brief Computes intersection points along a line mesh on the faces of the tetrahedrons
+/// \brief Computes intersection points along a line mesh on the faces of the tetrahedrons.
+/// The tetrahedrons and the segments are each kept in an AabbTree, refit every update
+/// (rebuilt when the number of cells changes), such that only the tetrahedron segment
+/// pairs whose boxes overlap are tested
 ///
 class TetraToLineMeshCD : public CollisionDetectionAlgorithm
 {
@@ -50,5 +54,13 @@ public:
         std::shared_ptr<Geometry>      geomB,
         std::vector<CollisionElement>& elementsA,
         std::vector<CollisionElement>& elementsB) override;
+
+protected:
+    std::vector<std::pair<int, int>> m_candidatePairs; ///> Tetrahedron segment pairs whose boxes overlap
+    std::vector<char> m_isIntersecting;                ///> Whether each candidate pair intersects
+    std::vector<Eigen::AlignedBox3d> m_tetBoxes;
+    std::vector<Eigen::AlignedBox3d> m_lineBoxes;
+    AabbTree m_tetTree;
+    AabbTree m_lineTree;
 };
 }
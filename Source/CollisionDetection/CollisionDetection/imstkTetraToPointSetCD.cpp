@@ -52,7 +52,6 @@ TetraToPointSetCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           verticesMeshB    = *verticesMeshBPtr;
 
     // For every tet in meshA, test if any points lie in it
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(tetMesh->getNumTetrahedra(),
         [&](const int tetIdA)
         {
@@ -83,12 +82,10 @@ TetraToPointSetCD::computeCollisionDataAB(
                     elemB.idCount  = 1;
                     elemB.cellType = IMSTK_VERTEX;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_elementBuffers.push_back(elemA, elemB);
                 }
             }
         });
+    m_elementBuffers.appendTo(elementsA, elementsB);
 }
 }
\ No newline at end of file
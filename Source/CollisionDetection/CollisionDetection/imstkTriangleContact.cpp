@@ -0,0 +1,96 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkTriangleContact.h"
+
+namespace imstk
+{
+void
+appendTriangleContact(const TriangleContact& contact, std::unordered_set<EdgePair, EdgePairHash>& edges,
+                      std::vector<CollisionElement>& elementsA, std::vector<CollisionElement>& elementsB)
+{
+    // Type 1, vertex-triangle contact
+    if (contact.type == 1)
+    {
+        CellIndexElement elemA;
+        elemA.idCount  = 1;
+        elemA.cellType = IMSTK_VERTEX;
+        elemA.ids[0]   = contact.vtContact.first;
+
+        CellIndexElement elemB;
+        elemB.idCount  = 3;
+        elemB.cellType = IMSTK_TRIANGLE;
+        elemB.ids[0]   = contact.vtContact.second[0];
+        elemB.ids[1]   = contact.vtContact.second[1];
+        elemB.ids[2]   = contact.vtContact.second[2];
+
+        elementsA.push_back(elemA);
+        elementsB.push_back(elemB);
+    }
+    // Type 0, edge-edge contact
+    else if (contact.type == 0)
+    {
+        // Create an edge pair and hash it to see if we already have this contact from
+        // another triangle
+        const std::pair<Vec2i, Vec2i>& eeContact = contact.eeContact;
+        const EdgePair                 edgePair  = {
+            static_cast<uint32_t>(eeContact.first[0]),
+            static_cast<uint32_t>(eeContact.first[1]),
+            static_cast<uint32_t>(eeContact.second[0]),
+            static_cast<uint32_t>(eeContact.second[1]) };
+        if (edges.insert(edgePair).second)
+        {
+            CellIndexElement elemA;
+            elemA.idCount  = 2;
+            elemA.cellType = IMSTK_EDGE;
+            elemA.ids[0]   = eeContact.first[0];
+            elemA.ids[1]   = eeContact.first[1];
+
+            CellIndexElement elemB;
+            elemB.idCount  = 2;
+            elemB.cellType = IMSTK_EDGE;
+            elemB.ids[0]   = eeContact.second[0];
+            elemB.ids[1]   = eeContact.second[1];
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
+        }
+    }
+    // Type 2, triangle-vertex contact
+    else if (contact.type == 2)
+    {
+        CellIndexElement elemA;
+        elemA.idCount  = 3;
+        elemA.cellType = IMSTK_TRIANGLE;
+        elemA.ids[0]   = contact.tvContact.first[0];
+        elemA.ids[1]   = contact.tvContact.first[1];
+        elemA.ids[2]   = contact.tvContact.first[2];
+
+        CellIndexElement elemB;
+        elemB.idCount  = 1;
+        elemB.cellType = IMSTK_VERTEX;
+        elemB.ids[0]   = contact.tvContact.second;
+
+        elementsA.push_back(elemA);
+        elementsB.push_back(elemB);
+    }
+}
+}
@@ -0,0 +1,51 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkCollisionData.h"
+#include "imstkEdgePair.h"
+
+#include <unordered_set>
+
+namespace imstk
+{
+///
+/// \struct TriangleContact
+///
+/// \brief Contact found between a pair of triangles, see CollisionUtils::triangleToTriangle
+///
+struct TriangleContact
+{
+    int type = -1; ///> -1=none, 0=ee, 1=vt, 2=tv
+    std::pair<Vec2i, Vec2i> eeContact;
+    std::pair<int, Vec3i>   vtContact;
+    std::pair<Vec3i, int>   tvContact;
+};
+
+///
+/// \brief Append the collision elements of a triangle contact. The same edge pair may be
+/// found from several triangle pairs, an edge-edge contact is only appended the first
+/// time its edge pair is inserted in edges
+///
+void appendTriangleContact(const TriangleContact& contact, std::unordered_set<EdgePair, EdgePairHash>& edges,
+                           std::vector<CollisionElement>& elementsA, std::vector<CollisionElement>& elementsB);
+}
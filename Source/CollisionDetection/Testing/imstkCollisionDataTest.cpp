@@ -22,6 +22,8 @@
 #include "gtest/gtest.h"
 
 #include "imstkCollisionData.h"
+#include "imstkCollisionElementBuffers.h"
+#include "imstkParallelUtils.h"
 
 using namespace imstk;
 
@@ -194,4 +196,57 @@ TEST_F(imstkCollisionElementTest, Assignment)
         EXPECT_EQ(pi.dir, e.m_element.m_PointIndexDirectionElement.dir);
         EXPECT_EQ(pi.ptIndex, e.m_element.m_PointIndexDirectionElement.ptIndex);
     }
-}
\ No newline at end of file
+}
+
+///
+/// \brief Test that elements pushed from a parallel loop are all appended, pairs staying aligned
+///
+TEST(imstkCollisionElementBuffersTest, ParallelAppend)
+{
+    CollisionElementBuffers       buffers;
+    std::vector<CollisionElement> elementsA;
+    std::vector<CollisionElement> elementsB;
+    for (int iter = 0; iter < 2; iter++)
+    {
+        ParallelUtils::parallelFor(10000,
+            [&](const int i)
+            {
+                if (i % 3 == 0)
+                {
+                    CellIndexElement elemA;
+                    elemA.ids[0]  = i;
+                    elemA.idCount = 1;
+
+                    PointIndexDirectionElement elemB;
+                    elemB.ptIndex = i;
+                    buffers.push_back(elemA, elemB);
+                }
+            });
+        buffers.appendTo(elementsA, elementsB);
+
+        // Buffers are emptied, a second loop appends after the first one
+        ASSERT_EQ(elementsA.size(), 3334 * (iter + 1));
+        ASSERT_EQ(elementsB.size(), elementsA.size());
+    }
+
+    std::vector<bool> found(10000, false);
+    for (size_t i = 0; i < elementsA.size(); i++)
+    {
+        const int id = elementsA[i].m_element.m_CellIndexElement.ids[0];
+        EXPECT_EQ(CollisionElementType::PointIndexDirection, elementsB[i].m_type);
+        EXPECT_EQ(id, elementsB[i].m_element.m_PointIndexDirectionElement.ptIndex);
+        EXPECT_EQ(i < 3334, !found[id]);
+        found[id] = true;
+    }
+
+    // One sided, appending a side leaves the other one buffered
+    buffers.pushBackA(CellIndexElement());
+    buffers.pushBackB(PointIndexDirectionElement());
+    std::vector<CollisionElement> elements;
+    buffers.appendToB(elements);
+    EXPECT_EQ(elements.size(), 1);
+    elements.clear();
+    buffers.appendToA(elements);
+    EXPECT_EQ(elements.size(), 1);
+    EXPECT_EQ(CollisionElementType::CellIndex, elements[0].m_type);
+}
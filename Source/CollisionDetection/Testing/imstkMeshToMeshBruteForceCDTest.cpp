@@ -25,9 +25,48 @@
 #include "imstkSurfaceMesh.h"
 #include "imstkMeshToMeshBruteForceCD.h"
 #include "imstkGeometryUtilities.h"
+#include "imstkVecDataArray.h"
 
 using namespace imstk;
 
+///
+/// \brief Closed latitude/longitude sphere with outward facing triangles
+///
+static std::shared_ptr<SurfaceMesh>
+makeSphere(const Vec3d& center, const double radius, const int numRings, const int numSegments)
+{
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    auto indicesPtr  = std::make_shared<VecDataArray<int, 3>>();
+    verticesPtr->push_back(center + Vec3d(0.0, radius, 0.0));
+    for (int i = 1; i < numRings; i++)
+    {
+        const double theta = PI * i / numRings;
+        for (int j = 0; j < numSegments; j++)
+        {
+            const double phi = 2.0 * PI * j / numSegments;
+            verticesPtr->push_back(center + radius * Vec3d(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    verticesPtr->push_back(center - Vec3d(0.0, radius, 0.0));
+
+    const int bottom = verticesPtr->size() - 1;
+    auto      ringId = [&](const int i, const int j) { return 1 + (i - 1) * numSegments + j % numSegments; };
+    for (int j = 0; j < numSegments; j++)
+    {
+        indicesPtr->push_back(Vec3i(0, ringId(1, j + 1), ringId(1, j)));
+        indicesPtr->push_back(Vec3i(bottom, ringId(numRings - 1, j), ringId(numRings - 1, j + 1)));
+        for (int i = 1; i < numRings - 1; i++)
+        {
+            indicesPtr->push_back(Vec3i(ringId(i, j), ringId(i, j + 1), ringId(i + 1, j)));
+            indicesPtr->push_back(Vec3i(ringId(i, j + 1), ringId(i + 1, j + 1), ringId(i + 1, j)));
+        }
+    }
+
+    auto surfMesh = std::make_shared<SurfaceMesh>();
+    surfMesh->initialize(verticesPtr, indicesPtr);
+    return surfMesh;
+}
+
 TEST(imstkMeshToMeshBruteForceCDTest, IntersectionTestAB_EdgeToEdge)
 {
     // Create two cubes
@@ -197,4 +236,77 @@ TEST(imstkMeshToMeshBruteForceCDTest, IntersectionTestAB_VertexToEdge)
 
     EXPECT_EQ(colData->elementsA[0].m_element.m_CellIndexElement.idCount, 2);
     EXPECT_EQ(colData->elementsB[0].m_element.m_CellIndexElement.idCount, 1);
-}
\ No newline at end of file
+}
+
+///
+/// \brief Test that searching the tree of B gives the contacts of the brute force search
+///
+TEST(imstkMeshToMeshBruteForceCDTest, IntersectionTestAB_TreeMatchesBruteForce)
+{
+    std::shared_ptr<SurfaceMesh> sphereA = makeSphere(Vec3d::Zero(), 0.5, 16, 24);
+    std::shared_ptr<SurfaceMesh> sphereB = makeSphere(Vec3d(0.4, 0.3, 0.1), 0.4, 12, 20);
+
+    std::shared_ptr<CollisionData> colData[2];
+    for (int i = 0; i < 2; i++)
+    {
+        MeshToMeshBruteForceCD cd;
+        cd.setInput(sphereA, 0);
+        cd.setInput(sphereB, 1);
+        cd.setGenerateCD(true, true);
+        cd.setGenerateEdgeEdgeContacts(true);
+        cd.setBruteForce(i == 0);
+        cd.update();
+        colData[i] = cd.getCollisionData();
+    }
+
+    ASSERT_GT(colData[0]->elementsA.size(), 0);
+    ASSERT_EQ(colData[0]->elementsA.size(), colData[1]->elementsA.size());
+    ASSERT_EQ(colData[0]->elementsB.size(), colData[1]->elementsB.size());
+    bool hasEdgeEdge = false;
+    for (size_t i = 0; i < colData[0]->elementsA.size(); i++)
+    {
+        const CellIndexElement& bruteForceA = colData[0]->elementsA[i].m_element.m_CellIndexElement;
+        const CellIndexElement& bruteForceB = colData[0]->elementsB[i].m_element.m_CellIndexElement;
+        const CellIndexElement& treeA       = colData[1]->elementsA[i].m_element.m_CellIndexElement;
+        const CellIndexElement& treeB       = colData[1]->elementsB[i].m_element.m_CellIndexElement;
+        EXPECT_EQ(bruteForceA.cellType, treeA.cellType);
+        EXPECT_EQ(bruteForceB.cellType, treeB.cellType);
+        ASSERT_EQ(bruteForceA.idCount, treeA.idCount);
+        ASSERT_EQ(bruteForceB.idCount, treeB.idCount);
+        for (int j = 0; j < bruteForceA.idCount; j++)
+        {
+            EXPECT_EQ(bruteForceA.ids[j], treeA.ids[j]);
+        }
+        for (int j = 0; j < bruteForceB.idCount; j++)
+        {
+            EXPECT_EQ(bruteForceB.ids[j], treeB.ids[j]);
+        }
+        hasEdgeEdge |= (bruteForceA.cellType == IMSTK_EDGE && bruteForceB.cellType == IMSTK_EDGE);
+    }
+    EXPECT_TRUE(hasEdgeEdge);
+}
+
+///
+/// \brief Test that meshes whose bounding boxes overlap but that don't touch have no
+/// contacts, with the edge-edge search of the tree rejecting every edge early
+///
+TEST(imstkMeshToMeshBruteForceCDTest, IntersectionTestAB_EdgeToEdgeNotTouching)
+{
+    std::shared_ptr<SurfaceMesh> sphereA = makeSphere(Vec3d::Zero(), 0.5, 16, 24);
+    std::shared_ptr<SurfaceMesh> sphereB = makeSphere(Vec3d(0.6, 0.6, 0.0), 0.3, 12, 20);
+
+    for (int i = 0; i < 2; i++)
+    {
+        MeshToMeshBruteForceCD cd;
+        cd.setInput(sphereA, 0);
+        cd.setInput(sphereB, 1);
+        cd.setGenerateCD(true, true);
+        cd.setGenerateEdgeEdgeContacts(true);
+        cd.setBruteForce(i == 0);
+        cd.update();
+
+        std::shared_ptr<CollisionData> colData = cd.getCollisionData();
+        EXPECT_TRUE(colData->elementsA.empty());
+        EXPECT_TRUE(colData->elementsB.empty());
+    }
+}
@@ -0,0 +1,123 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkCollisionTestingUtils.h"
+#include "imstkOctreeBasedCD.h"
+#include "imstkSurfaceMeshToSurfaceMeshCD.h"
+
+#include <algorithm>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Contacts of the pairwise collision detection
+///
+std::vector<Contact>
+getPairwiseContacts(std::shared_ptr<SurfaceMesh> meshA, std::shared_ptr<SurfaceMesh> meshB)
+{
+    SurfaceMeshToSurfaceMeshCD cd;
+    cd.setInput(meshA, 0);
+    cd.setInput(meshB, 1);
+    cd.update();
+    return getContacts(*cd.getCollisionData());
+}
+}
+
+///
+/// \brief Test that the octree gives the contacts of the pairwise collision detection
+/// for several surface mesh pairs at once, also once a mesh moved
+///
+TEST(imstkOctreeBasedCDTest, TestSurfaceMeshPairs)
+{
+    const Mat3d rotation = Rotd(-0.3, Vec3d(1.0, 0.2, 0.0).normalized()).toRotationMatrix();
+    std::shared_ptr<SurfaceMesh> meshA = makeGrid(30, Mat3d::Identity(), Vec3d::Zero());
+    std::shared_ptr<SurfaceMesh> meshB = makeGrid(25, rotation, Vec3d(0.1, -0.1, 0.05));
+    std::shared_ptr<SurfaceMesh> meshC = makeGrid(10, Mat3d::Identity(), Vec3d(0.0, 0.5, 0.0));
+
+    OctreeBasedCD octreeCD(Vec3d(0.5, 0.0, 0.5), 2.0, 0.1);
+    octreeCD.addCollisionPair(meshA, meshB);
+    octreeCD.addCollisionPair(meshC, meshA);
+    EXPECT_EQ(octreeCD.getNumCollisionPairs(), 2);
+    EXPECT_TRUE(octreeCD.hasCollisionPair(meshA->getGlobalIndex(), meshB->getGlobalIndex()));
+    EXPECT_FALSE(octreeCD.hasCollisionPair(meshB->getGlobalIndex(), meshA->getGlobalIndex()));
+    EXPECT_EQ(octreeCD.getCollisionPairData(meshB->getGlobalIndex(), meshC->getGlobalIndex()), nullptr);
+
+    octreeCD.detectCollision();
+    const std::vector<Contact> expectedContacts = getPairwiseContacts(meshA, meshB);
+    EXPECT_FALSE(expectedContacts.empty());
+    EXPECT_EQ(getContacts(*octreeCD.getCollisionPairData(meshA->getGlobalIndex(), meshB->getGlobalIndex())), expectedContacts);
+    EXPECT_TRUE(octreeCD.getCollisionPairData(meshC->getGlobalIndex(), meshA->getGlobalIndex())->elementsA.empty());
+
+    // Move C into A and deform B, the octree is updated incrementally
+    VecDataArray<double, 3>& verticesB = *meshB->getVertexPositions();
+    for (int i = 0; i < verticesB.size(); i++)
+    {
+        verticesB[i] += Vec3d(0.0, 0.05 * std::sin(10.0 * verticesB[i][0]), 0.0);
+    }
+    meshC->translate(Vec3d(0.05, -0.5, 0.05), Geometry::TransformType::ApplyToData);
+    meshC->rotate(Vec3d(0.0, 0.0, 1.0), 0.2, Geometry::TransformType::ApplyToData);
+    meshC->translate(Vec3d(0.0, -0.1, 0.0), Geometry::TransformType::ApplyToData);
+    meshC->updatePostTransformData();
+    octreeCD.detectCollision();
+    EXPECT_EQ(getContacts(*octreeCD.getCollisionPairData(meshA->getGlobalIndex(), meshB->getGlobalIndex())),
+        getPairwiseContacts(meshA, meshB));
+    const std::vector<Contact> expectedContactsCA = getPairwiseContacts(meshC, meshA);
+    EXPECT_FALSE(expectedContactsCA.empty());
+    EXPECT_EQ(getContacts(*octreeCD.getCollisionPairData(meshC->getGlobalIndex(), meshA->getGlobalIndex())), expectedContactsCA);
+}
+
+///
+/// \brief Test that a vertex is in contact with a triangle only when it is behind it
+/// by less than the contact distance
+///
+TEST(imstkOctreeBasedCDTest, TestPointSetToSurfaceMesh)
+{
+    std::shared_ptr<SurfaceMesh> surfMesh = makeGrid(10, Mat3d::Identity(), Vec3d::Zero());
+
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>(4);
+    (*verticesPtr)[0] = Vec3d(0.33, 0.005, 0.52);  // Behind, in contact
+    (*verticesPtr)[1] = Vec3d(0.33, -0.005, 0.52); // In front
+    (*verticesPtr)[2] = Vec3d(0.71, 0.05, 0.16);   // Too far behind
+    (*verticesPtr)[3] = Vec3d(1.5, 0.005, 0.5);    // Outside of the mesh
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(verticesPtr);
+
+    OctreeBasedCD octreeCD(Vec3d(0.5, 0.0, 0.5), 2.0, 0.1);
+    octreeCD.setPointTriangleContactDistance(0.01);
+    octreeCD.addCollisionPair(pointSet, surfMesh);
+    octreeCD.detectCollision();
+
+    std::shared_ptr<CollisionData> colData = octreeCD.getCollisionPairData(pointSet->getGlobalIndex(), surfMesh->getGlobalIndex());
+    ASSERT_EQ(colData->elementsA.size(), 1);
+    ASSERT_EQ(colData->elementsB.size(), 1);
+    EXPECT_EQ(colData->elementsA[0].m_element.m_CellIndexElement.cellType, IMSTK_VERTEX);
+    EXPECT_EQ(colData->elementsA[0].m_element.m_CellIndexElement.ids[0], 0);
+    EXPECT_EQ(colData->elementsB[0].m_element.m_CellIndexElement.cellType, IMSTK_TRIANGLE);
+
+    // Push the second vertex behind
+    (*verticesPtr)[1] = Vec3d(0.33, 0.002, 0.52);
+    octreeCD.detectCollision();
+    EXPECT_EQ(colData->elementsA.size(), 2);
+}
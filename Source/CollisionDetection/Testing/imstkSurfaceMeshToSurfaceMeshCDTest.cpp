@@ -0,0 +1,115 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkCollisionTestingUtils.h"
+#include "imstkCollisionUtils.h"
+#include "imstkSurfaceMeshToSurfaceMeshCD.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Every triangle against every triangle, edge pairs reported once
+///
+std::vector<Contact>
+getBruteForceContacts(const SurfaceMesh& meshA, const SurfaceMesh& meshB)
+{
+    const VecDataArray<double, 3>& verticesA = *meshA.getVertexPositions();
+    const VecDataArray<int, 3>&    indicesA  = *meshA.getTriangleIndices();
+    const VecDataArray<double, 3>& verticesB = *meshB.getVertexPositions();
+    const VecDataArray<int, 3>&    indicesB  = *meshB.getTriangleIndices();
+
+    std::set<Contact> edgeContacts;
+    std::vector<Contact> contacts;
+    auto sorted = [](std::vector<int> ids) { std::sort(ids.begin(), ids.end()); return ids; };
+    for (int i = 0; i < indicesA.size(); i++)
+    {
+        const Vec3i& cellA = indicesA[i];
+        for (int j = 0; j < indicesB.size(); j++)
+        {
+            const Vec3i&            cellB = indicesB[j];
+            std::pair<Vec2i, Vec2i> eeContact;
+            std::pair<int, Vec3i>   vtContact;
+            std::pair<Vec3i, int>   tvContact;
+            const int               contactType = CollisionUtils::triangleToTriangle(cellA, cellB,
+                verticesA[cellA[0]], verticesA[cellA[1]], verticesA[cellA[2]],
+                verticesB[cellB[0]], verticesB[cellB[1]], verticesB[cellB[2]],
+                eeContact, vtContact, tvContact);
+            if (contactType == 0)
+            {
+                const Contact contact(sorted({ eeContact.first[0], eeContact.first[1] }),
+                    sorted({ eeContact.second[0], eeContact.second[1] }));
+                if (edgeContacts.insert(contact).second)
+                {
+                    contacts.push_back(contact);
+                }
+            }
+            else if (contactType == 1)
+            {
+                contacts.emplace_back(std::vector<int>{ vtContact.first },
+                    sorted({ vtContact.second[0], vtContact.second[1], vtContact.second[2] }));
+            }
+            else if (contactType == 2)
+            {
+                contacts.emplace_back(sorted({ tvContact.first[0], tvContact.first[1], tvContact.first[2] }),
+                    std::vector<int>{ tvContact.second });
+            }
+        }
+    }
+    std::sort(contacts.begin(), contacts.end());
+    return contacts;
+}
+}
+
+///
+/// \brief Test that two crossing grids give the contacts of the brute force test,
+/// also once one of them moved
+///
+TEST(imstkSurfaceMeshToSurfaceMeshCDTest, TestCrossingGrids)
+{
+    const Mat3d rotation = Rotd(-0.3, Vec3d(1.0, 0.2, 0.0).normalized()).toRotationMatrix();
+    std::shared_ptr<SurfaceMesh> meshA = makeGrid(30, Mat3d::Identity(), Vec3d::Zero());
+    std::shared_ptr<SurfaceMesh> meshB = makeGrid(25, rotation, Vec3d(0.1, -0.1, 0.05));
+
+    SurfaceMeshToSurfaceMeshCD cd;
+    cd.setInput(meshA, 0);
+    cd.setInput(meshB, 1);
+    cd.update();
+
+    const std::vector<Contact> expectedContacts = getBruteForceContacts(*meshA, *meshB);
+    EXPECT_FALSE(expectedContacts.empty());
+    EXPECT_EQ(getContacts(*cd.getCollisionData()), expectedContacts);
+
+    // Deform B, its tree is refit
+    VecDataArray<double, 3>& verticesB = *meshB->getVertexPositions();
+    for (int i = 0; i < verticesB.size(); i++)
+    {
+        verticesB[i] += Vec3d(0.0, 0.05 * std::sin(10.0 * verticesB[i][0]), 0.0);
+    }
+    cd.update();
+    EXPECT_EQ(getContacts(*cd.getCollisionData()), getBruteForceContacts(*meshA, *meshB));
+}
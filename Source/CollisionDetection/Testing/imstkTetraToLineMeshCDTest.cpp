@@ -19,6 +19,7 @@
 
 =========================================================================*/
 
+#include "imstkCollisionUtils.h"
 #include "imstkLineMesh.h"
 #include "imstkTetrahedralMesh.h"
 #include "imstkTetraToLineMeshCD.h"
@@ -26,6 +27,8 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 using namespace imstk;
 
 std::shared_ptr<TetrahedralMesh>
@@ -154,4 +157,115 @@ TEST(imstkTetraToLineMeshCDTest, NonIntersectionTestAB)
     // Should have no elements
     EXPECT_EQ(0, colData->elementsA.size());
     EXPECT_EQ(0, colData->elementsB.size());
-}
\ No newline at end of file
+}
+
+///
+/// \brief Unit cube of dim^3 cells, each cell split in 6 tetrahedrons
+///
+static std::shared_ptr<TetrahedralMesh>
+makeTetGrid(const int dim)
+{
+    auto         verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    auto         indicesPtr  = std::make_shared<VecDataArray<int, 4>>();
+    const double spacing     = 1.0 / dim;
+    for (int k = 0; k <= dim; k++)
+    {
+        for (int j = 0; j <= dim; j++)
+        {
+            for (int i = 0; i <= dim; i++)
+            {
+                verticesPtr->push_back(Vec3d(i, j, k) * spacing);
+            }
+        }
+    }
+    // The 6 tetrahedrons around the diagonal of a cell, from corner 0 to corner 7
+    const int cellTets[6][2] = { { 1, 3 }, { 1, 5 }, { 2, 3 }, { 2, 6 }, { 4, 5 }, { 4, 6 } };
+    for (int k = 0; k < dim; k++)
+    {
+        for (int j = 0; j < dim; j++)
+        {
+            for (int i = 0; i < dim; i++)
+            {
+                // Corner c of the cell is offset by the bits of c along x, y and z
+                auto corner = [&](const int c)
+                              {
+                                  return (i + (c & 1)) + (j + ((c >> 1) & 1)) * (dim + 1) + (k + ((c >> 2) & 1)) * (dim + 1) * (dim + 1);
+                              };
+                for (int t = 0; t < 6; t++)
+                {
+                    indicesPtr->push_back(Vec4i(corner(0), corner(cellTets[t][0]), corner(cellTets[t][1]), corner(7)));
+                }
+            }
+        }
+    }
+
+    auto tetMesh = std::make_shared<TetrahedralMesh>();
+    tetMesh->initialize(verticesPtr, indicesPtr);
+    return tetMesh;
+}
+
+///
+/// \brief Test that the pairs found match testing every segment against every tetrahedron,
+/// for a polyline going through a tetrahedral grid, moved between updates
+///
+TEST(imstkTetraToLineMeshCDTest, IntersectionTestAB_TreeMatchesBruteForce)
+{
+    auto tetMesh = makeTetGrid(6);
+
+    const int numSegments = 12;
+    auto      verxPtr     = std::make_shared<VecDataArray<double, 3>>(numSegments + 1);
+    auto      indicesPtr  = std::make_shared<VecDataArray<int, 2>>(numSegments);
+    for (int i = 0; i <= numSegments; i++)
+    {
+        const double t = static_cast<double>(i) / numSegments;
+        (*verxPtr)[i] = Vec3d(-0.2 + 1.4 * t, 0.3 + 0.2 * std::sin(6.0 * t), 0.5 + 0.3 * t);
+    }
+    for (int i = 0; i < numSegments; i++)
+    {
+        (*indicesPtr)[i] = Vec2i(i, i + 1);
+    }
+    auto lineMesh = std::make_shared<LineMesh>();
+    lineMesh->initialize(verxPtr, indicesPtr);
+
+    TetraToLineMeshCD cd;
+    cd.setInputGeometryA(tetMesh);
+    cd.setInputGeometryB(lineMesh);
+
+    const VecDataArray<int, 4>&    tets     = *tetMesh->getTetrahedraIndices();
+    const VecDataArray<double, 3>& tetVerts = *tetMesh->getVertexPositions();
+    for (int iter = 0; iter < 2; iter++)
+    {
+        cd.update();
+        std::shared_ptr<CollisionData> colData = cd.getCollisionData();
+        ASSERT_EQ(colData->elementsA.size(), colData->elementsB.size());
+
+        std::set<std::pair<int, int>> pairs;
+        for (size_t i = 0; i < colData->elementsA.size(); i++)
+        {
+            EXPECT_EQ(IMSTK_TETRAHEDRON, colData->elementsA[i].m_element.m_CellIndexElement.cellType);
+            EXPECT_EQ(IMSTK_EDGE, colData->elementsB[i].m_element.m_CellIndexElement.cellType);
+            pairs.insert({ colData->elementsA[i].m_element.m_CellIndexElement.ids[0],
+                           colData->elementsB[i].m_element.m_CellIndexElement.ids[0] });
+        }
+        EXPECT_EQ(pairs.size(), colData->elementsA.size());
+
+        const VecDataArray<double, 3>& lineVerts = *lineMesh->getVertexPositions();
+        std::set<std::pair<int, int>>  expectedPairs;
+        for (int i = 0; i < numSegments; i++)
+        {
+            for (int j = 0; j < tets.size(); j++)
+            {
+                const std::array<Vec3d, 4> tet = { tetVerts[tets[j][0]], tetVerts[tets[j][1]], tetVerts[tets[j][2]], tetVerts[tets[j][3]] };
+                if (CollisionUtils::testTetToSegment(tet, lineVerts[(*indicesPtr)[i][0]], lineVerts[(*indicesPtr)[i][1]]))
+                {
+                    expectedPairs.insert({ j, i });
+                }
+            }
+        }
+        EXPECT_GT(expectedPairs.size(), 0);
+        EXPECT_EQ(expectedPairs, pairs);
+
+        lineMesh->translate(Vec3d(0.05, 0.1, -0.1));
+        lineMesh->updatePostTransformData();
+    }
+}
@@ -22,7 +22,9 @@
 #include "imstkPBDCollisionHandling.h"
 #include "imstkCollisionData.h"
 #include "imstkGeometryMap.h"
+#include "imstkLogger.h"
 #include "imstkOneToOneMap.h"
+#include "imstkParallelFor.h"
 #include "imstkPbdEdgeEdgeConstraint.h"
 #include "imstkPbdModel.h"
 #include "imstkPbdObject.h"
@@ -35,21 +37,41 @@
 namespace imstk
 {
 ///
-/// \brief Packs the info needed to add a constraint to a side
+/// \brief Packs the info needed to add a constraint to a side. The map and the indices
+/// are cast once per frame instead of once per element
 ///
 struct MeshSide
 {
     MeshSide(VecDataArray<double, 3>& vertices, VecDataArray<double, 3>& velocities, DataArray<double>& invMasses,
              GeometryMap* mapPtr, AbstractDataArray* indicesPtr) : m_vertices(vertices), m_velocities(velocities),
-        m_invMasses(invMasses), m_mapPtr(mapPtr), m_indicesPtr(indicesPtr)
+        m_invMasses(invMasses), m_mapPtr(dynamic_cast<OneToOneMap*>(mapPtr)),
+        m_edgesPtr(dynamic_cast<VecDataArray<int, 2>*>(indicesPtr)),
+        m_trianglesPtr(dynamic_cast<VecDataArray<int, 3>*>(indicesPtr))
     {
     }
 
+    ///
+    /// \brief Vertex, mass and velocity of a vertex of the colliding geometry, mapped
+    /// to the physics geometry when the map is one to one
+    ///
+    VertexMassPair getVertexMassPair(size_t ptId) const
+    {
+        if (m_mapPtr != nullptr)
+        {
+            const std::map<size_t, size_t>& map  = m_mapPtr->getMap();
+            const auto                      iter = map.find(ptId);
+            CHECK(iter != map.end()) << "Invalid source index";
+            ptId = iter->second;
+        }
+        return { &m_vertices[ptId], m_invMasses[ptId], &m_velocities[ptId] };
+    }
+
     VecDataArray<double, 3>& m_vertices;
     VecDataArray<double, 3>& m_velocities;
     DataArray<double>& m_invMasses;
-    GeometryMap* m_mapPtr = nullptr;
-    AbstractDataArray* m_indicesPtr = nullptr;
+    const OneToOneMap* m_mapPtr = nullptr;
+    const VecDataArray<int, 2>* m_edgesPtr     = nullptr;
+    const VecDataArray<int, 3>* m_trianglesPtr = nullptr;
 };
 
 static std::array<VertexMassPair, 1>
@@ -67,11 +89,7 @@ getVertex(const CollisionElement& elem, const MeshSide& side)
     std::array<VertexMassPair, 1> results;
     if (ptId != -1)
     {
-        if (side.m_mapPtr && dynamic_cast<OneToOneMap*>(side.m_mapPtr) != nullptr)
-        {
-            ptId = static_cast<int>(side.m_mapPtr->getMapIdx(static_cast<size_t>(ptId)));
-        }
-        results[0] = { &side.m_vertices[ptId], side.m_invMasses[ptId], &side.m_velocities[ptId] };
+        results[0] = side.getVertexMassPair(static_cast<size_t>(ptId));
     }
     return results;
 }
@@ -79,13 +97,13 @@ getVertex(const CollisionElement& elem, const MeshSide& side)
 static std::array<VertexMassPair, 2>
 getEdge(const CollisionElement& elem, const MeshSide& side)
 {
-    size_t v1, v2;
+    int v1, v2;
     v1 = v2 = -1;
     if (elem.m_type == CollisionElementType::CellIndex && elem.m_element.m_CellIndexElement.cellType == IMSTK_EDGE)
     {
         if (elem.m_element.m_CellIndexElement.idCount == 1)
         {
-            const Vec2i& cell = (*dynamic_cast<VecDataArray<int, 2>*>(side.m_indicesPtr))[elem.m_element.m_CellIndexElement.ids[0]];
+            const Vec2i& cell = (*side.m_edgesPtr)[elem.m_element.m_CellIndexElement.ids[0]];
             v1 = cell[0];
             v2 = cell[1];
         }
@@ -98,13 +116,8 @@ getEdge(const CollisionElement& elem, const MeshSide& side)
     std::array<VertexMassPair, 2> results;
     if (v1 != -1)
     {
-        if (side.m_mapPtr && dynamic_cast<OneToOneMap*>(side.m_mapPtr) != nullptr)
-        {
-            v1 = side.m_mapPtr->getMapIdx(v1);
-            v2 = side.m_mapPtr->getMapIdx(v2);
-        }
-        results[0] = { &side.m_vertices[v1], side.m_invMasses[v1], &side.m_velocities[v1] };
-        results[1] = { &side.m_vertices[v2], side.m_invMasses[v2], &side.m_velocities[v2] };
+        results[0] = side.getVertexMassPair(static_cast<size_t>(v1));
+        results[1] = side.getVertexMassPair(static_cast<size_t>(v2));
     }
     return results;
 }
@@ -118,7 +131,7 @@ getTriangle(const CollisionElement& elem, const MeshSide& side)
     {
         if (elem.m_element.m_CellIndexElement.idCount == 1)
         {
-            const Vec3i& cell = (*dynamic_cast<VecDataArray<int, 3>*>(side.m_indicesPtr))[elem.m_element.m_CellIndexElement.ids[0]];
+            const Vec3i& cell = (*side.m_trianglesPtr)[elem.m_element.m_CellIndexElement.ids[0]];
             v1 = cell[0];
             v2 = cell[1];
             v3 = cell[2];
@@ -133,42 +146,131 @@ getTriangle(const CollisionElement& elem, const MeshSide& side)
     std::array<VertexMassPair, 3> results;
     if (v1 != -1)
     {
-        if (side.m_mapPtr && dynamic_cast<OneToOneMap*>(side.m_mapPtr) != nullptr)
-        {
-            v1 = static_cast<int>(side.m_mapPtr->getMapIdx(v1));
-            v2 = static_cast<int>(side.m_mapPtr->getMapIdx(v2));
-            v3 = static_cast<int>(side.m_mapPtr->getMapIdx(v3));
-        }
-        results[0] = { &side.m_vertices[v1], side.m_invMasses[v1], &side.m_velocities[v1] };
-        results[1] = { &side.m_vertices[v2], side.m_invMasses[v2], &side.m_velocities[v2] };
-        results[2] = { &side.m_vertices[v3], side.m_invMasses[v3], &side.m_velocities[v3] };
+        results[0] = side.getVertexMassPair(static_cast<size_t>(v1));
+        results[1] = side.getVertexMassPair(static_cast<size_t>(v2));
+        results[2] = side.getVertexMassPair(static_cast<size_t>(v3));
     }
     return results;
 }
 
-PBDCollisionHandling::PBDCollisionHandling() :
-    m_pbdCollisionSolver(std::make_shared<PbdCollisionSolver>())
+///
+/// \brief Constraint of a vertex of side A against a point of B, only solving side A
+///
+static PBDCollisionHandling::Contact
+getMeshNonMeshContact(const CollisionElement& colElemA, const CollisionElement& colElemB,
+                      const MeshSide& sideA, const double stiffnessA)
 {
+    using Contact = PBDCollisionHandling::Contact;
+    Contact contact;
+    if (colElemA.m_type != CollisionElementType::CellIndex)
+    {
+        return contact;
+    }
+
+    // Triangle or edge vs vertex, or PointDirection vertex
+    if (colElemB.m_type == CollisionElementType::CellVertex && colElemB.m_element.m_CellVertexElement.size == 1)
+    {
+        contact.m_fixedPoint = colElemB.m_element.m_CellVertexElement.pts[0];
+    }
+    else if (colElemB.m_type == CollisionElementType::PointDirection)
+    {
+        contact.m_fixedPoint = colElemB.m_element.m_PointDirectionElement.pt;
+    }
+    else
+    {
+        return contact;
+    }
+
+    const CellTypeId cellTypeA = colElemA.m_element.m_CellIndexElement.cellType;
+    if (cellTypeA == IMSTK_TRIANGLE)
+    {
+        const std::array<VertexMassPair, 3> vertexMassA = getTriangle(colElemA, sideA);
+        contact = Contact(Contact::Type::PointTriangle, { VertexMassPair(), vertexMassA[0], vertexMassA[1], vertexMassA[2] },
+            0.0, stiffnessA, contact.m_fixedPoint);
+    }
+    else if (cellTypeA == IMSTK_EDGE)
+    {
+        const std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
+        contact = Contact(Contact::Type::PointEdge, { VertexMassPair(), vertexMassA[0], vertexMassA[1], VertexMassPair() },
+            0.0, stiffnessA, contact.m_fixedPoint);
+    }
+    return contact;
 }
 
-PBDCollisionHandling::~PBDCollisionHandling()
+///
+/// \brief Constraint between the cells of two meshes, solving both sides
+///
+static PBDCollisionHandling::Contact
+getMeshMeshContact(const CollisionElement& colElemA, const CollisionElement& colElemB,
+                   const MeshSide& sideA, const MeshSide& sideB, const double stiffnessA, const double stiffnessB)
 {
-    for (const auto ptr: m_EEConstraintPool)
+    using Contact = PBDCollisionHandling::Contact;
+    if (colElemA.m_type != CollisionElementType::CellIndex || colElemB.m_type != CollisionElementType::CellIndex)
+    {
+        return Contact();
+    }
+
+    const CellTypeId cellTypeA = colElemA.m_element.m_CellIndexElement.cellType;
+    const CellTypeId cellTypeB = colElemB.m_element.m_CellIndexElement.cellType;
+
+    // Vertex vs Triangle
+    if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_TRIANGLE)
+    {
+        const std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
+        const std::array<VertexMassPair, 3> vertexMassB = getTriangle(colElemB, sideB);
+        return Contact(Contact::Type::PointTriangle, { vertexMassA[0], vertexMassB[0], vertexMassB[1], vertexMassB[2] },
+            stiffnessA, stiffnessB);
+    }
+    // Triangle vs Vertex
+    else if (cellTypeA == IMSTK_TRIANGLE && cellTypeB == IMSTK_VERTEX)
+    {
+        const std::array<VertexMassPair, 3> vertexMassA = getTriangle(colElemA, sideA);
+        const std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
+        return Contact(Contact::Type::PointTriangle, { vertexMassB[0], vertexMassA[0], vertexMassA[1], vertexMassA[2] },
+            stiffnessB, stiffnessA);
+    }
+    // Edge vs Edge
+    else if (cellTypeA == IMSTK_EDGE && cellTypeB == IMSTK_EDGE)
     {
-        delete ptr;
+        const std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
+        const std::array<VertexMassPair, 2> vertexMassB = getEdge(colElemB, sideB);
+        return Contact(Contact::Type::EdgeEdge, { vertexMassA[0], vertexMassA[1], vertexMassB[0], vertexMassB[1] },
+            stiffnessA, stiffnessB);
     }
-    for (const auto ptr: m_VTConstraintPool)
+    // Edge vs Vertex
+    else if (cellTypeA == IMSTK_EDGE && cellTypeB == IMSTK_VERTEX)
     {
-        delete ptr;
+        const std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
+        const std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
+        return Contact(Contact::Type::PointEdge, { vertexMassB[0], vertexMassA[0], vertexMassA[1], VertexMassPair() },
+            stiffnessB, stiffnessA);
     }
-    for (const auto ptr : m_PEConstraintPool)
+    // Vertex vs Edge
+    else if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_EDGE)
     {
-        delete ptr;
+        const std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
+        const std::array<VertexMassPair, 2> vertexMassB = getEdge(colElemB, sideB);
+        return Contact(Contact::Type::PointEdge, { vertexMassA[0], vertexMassB[0], vertexMassB[1], VertexMassPair() },
+            stiffnessA, stiffnessB);
     }
-    for (const auto ptr : m_PPConstraintPool)
+    // Vertex vs Vertex
+    else if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_VERTEX)
     {
-        delete ptr;
+        const std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
+        const std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
+        return Contact(Contact::Type::PointPoint, { vertexMassA[0], vertexMassB[0], VertexMassPair(), VertexMassPair() },
+            stiffnessA, stiffnessB);
     }
+    return Contact();
+}
+
+PBDCollisionHandling::PBDCollisionHandling() :
+    m_pbdCollisionSolver(std::make_shared<PbdCollisionSolver>())
+{
+}
+
+PBDCollisionHandling::~PBDCollisionHandling()
+{
 }
 
 void
@@ -176,25 +278,19 @@ PBDCollisionHandling::handle(
     const std::vector<CollisionElement>& elementsA,
     const std::vector<CollisionElement>& elementsB)
 {
-    // Remove constraints without deallocating the memory
-    // \todo: Consider using stack
-    // \todo: Test counting them first
-    m_VTConstraintPool.resize(0);
-    m_EEConstraintPool.resize(0);
-    m_PEConstraintPool.resize(0);
-    m_PPConstraintPool.resize(0);
+    // Release the constraints of the last frame without deallocating the memory
+    m_VTConstraintPool.reset();
+    m_EEConstraintPool.reset();
+    m_PEConstraintPool.reset();
+    m_PPConstraintPool.reset();
 
-    m_fixedPoints.resize(0);
-    m_fixedPointVelocities.resize(0);
+    m_fixedPoints.reset();
+    m_fixedPointVelocities.reset();
 
     generateMeshMeshConstraints(elementsA, elementsB);
     generateMeshNonMeshConstraints(elementsA, elementsB);
 
     // Copy constraints
-    for (int i = 0; i < m_PBDConstraints.size(); i++)
-    {
-        delete m_PBDConstraints[i];
-    }
     m_PBDConstraints.resize(0);
     m_PBDConstraints.reserve(
         m_EEConstraintPool.size() + m_VTConstraintPool.size() +
@@ -202,19 +298,19 @@ PBDCollisionHandling::handle(
 
     for (size_t i = 0; i < m_EEConstraintPool.size(); i++)
     {
-        m_PBDConstraints.push_back(static_cast<PbdCollisionConstraint*>(m_EEConstraintPool[i]));
+        m_PBDConstraints.push_back(&m_EEConstraintPool[i]);
     }
     for (size_t i = 0; i < m_VTConstraintPool.size(); i++)
     {
-        m_PBDConstraints.push_back(static_cast<PbdCollisionConstraint*>(m_VTConstraintPool[i]));
+        m_PBDConstraints.push_back(&m_VTConstraintPool[i]);
     }
     for (size_t i = 0; i < m_PEConstraintPool.size(); i++)
     {
-        m_PBDConstraints.push_back(static_cast<PbdCollisionConstraint*>(m_PEConstraintPool[i]));
+        m_PBDConstraints.push_back(&m_PEConstraintPool[i]);
     }
     for (size_t i = 0; i < m_PPConstraintPool.size(); i++)
     {
-        m_PBDConstraints.push_back(static_cast<PbdCollisionConstraint*>(m_PPConstraintPool[i]));
+        m_PBDConstraints.push_back(&m_PPConstraintPool[i]);
     }
 
     if (m_PBDConstraints.size() == 0)
@@ -249,105 +345,37 @@ PBDCollisionHandling::generateMeshNonMeshConstraints(
         pbdObjectA->getPhysicsToCollidingMap().get(),
         nullptr);
 
-    // \todo: Test if splitting constraints by type is more efficient
-    for (int i = 0; i < elementsA.size(); i++)
-    {
-        const CollisionElement& colElemA = elementsA[i];
-
-        // Point direction constraints are handled via pointpoint constraints
-        if (colElemA.m_type == CollisionElementType::PointIndexDirection)
+    // Point direction constraints are handled via pointpoint constraints
+    m_contacts.resize(elementsA.size());
+    ParallelUtils::parallelFor(elementsA.size(),
+        [&](const size_t i)
         {
-            std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
+            const CollisionElement& colElemA = elementsA[i];
+            if (colElemA.m_type != CollisionElementType::PointIndexDirection)
+            {
+                m_contacts[i] = Contact();
+                return;
+            }
+            const std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
 
             const Vec3d& dir   = colElemA.m_element.m_PointIndexDirectionElement.dir;                      // Direction to resolve point out of shape
             const Vec3d& pt    = (*verticesAPtr)[colElemA.m_element.m_PointIndexDirectionElement.ptIndex]; // Point inside the shape
             const double depth = colElemA.m_element.m_PointIndexDirectionElement.penetrationDepth;
 
             // Point to resolve to
-            m_fixedPoints.push_back(pt + dir * depth);
-            m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
-
-            addPPConstraint(
-                { &m_fixedPoints.back(), 0.0, &m_fixedPointVelocities.back() },
-                vertexMassA[0],
-                0.0, stiffnessA);
-        }
-    }
+            m_contacts[i] = Contact(Contact::Type::PointPoint, { VertexMassPair(), vertexMassA[0], VertexMassPair(), VertexMassPair() },
+                0.0, stiffnessA, pt + dir * depth);
+        });
+    addContacts();
 
     if (elementsA.size() == elementsB.size())
     {
-        for (int i = 0; i < elementsA.size(); i++)
-        {
-            const CollisionElement& colElemA = elementsA[i];
-            const CollisionElement& colElemB = elementsB[i];
-
-            if (colElemA.m_type != CollisionElementType::CellIndex)
-            {
-                continue;
-            }
-
-            const CellTypeId cellTypeA = colElemA.m_element.m_CellIndexElement.cellType;
-
-            // Triangle vs ...
-            if (cellTypeA == IMSTK_TRIANGLE)
-            {
-                std::array<VertexMassPair, 3> vertexMassA = getTriangle(colElemA, sideA);
-
-                bool shouldAddConstraint = false;
-                // Triangle vs Vertex
-                if (colElemB.m_type == CollisionElementType::CellVertex && colElemB.m_element.m_CellVertexElement.size == 1)
-                {
-                    m_fixedPoints.push_back(colElemB.m_element.m_CellVertexElement.pts[0]);
-                    m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
-                    shouldAddConstraint = true;
-                }
-                // Triangle vs PointDirection Vertex
-                else if (colElemB.m_type == CollisionElementType::PointDirection)
-                {
-                    m_fixedPoints.push_back(colElemB.m_element.m_PointDirectionElement.pt);
-                    m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
-                    shouldAddConstraint = true;
-                }
-                if (shouldAddConstraint)
-                {
-                    // Only solve one side
-                    addVTConstraint(
-                        { &m_fixedPoints.back(), 0.0, &m_fixedPointVelocities.back() },
-                        vertexMassA[0], vertexMassA[1], vertexMassA[2],
-                        0.0, stiffnessA);
-                }
-            }
-            // Edge vs ...
-            else if (cellTypeA == IMSTK_EDGE)
+        ParallelUtils::parallelFor(elementsA.size(),
+            [&](const size_t i)
             {
-                std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
-
-                bool shouldAddConstraint = false;
-                // Edge vs vertex
-                if (colElemB.m_type == CollisionElementType::CellVertex && colElemB.m_element.m_CellVertexElement.size == 1)
-                {
-                    m_fixedPoints.push_back(colElemB.m_element.m_PointDirectionElement.pt);
-                    m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
-                    shouldAddConstraint = true;
-                }
-                // Edge vs PointDirection vertex
-                else if (colElemB.m_type == CollisionElementType::PointDirection)
-                {
-                    m_fixedPoints.push_back(colElemB.m_element.m_PointDirectionElement.pt);
-                    m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
-                    shouldAddConstraint = true;
-                }
-
-                if (shouldAddConstraint)
-                {
-                    // Only solve one side
-                    addPEConstraint(
-                        { &m_fixedPoints.back(), 0.0, &m_fixedPointVelocities.back() },
-                        vertexMassA[0], vertexMassA[1],
-                        0.0, stiffnessA);
-                }
-            }
-        }
+                m_contacts[i] = getMeshNonMeshContact(elementsA[i], elementsB[i], sideA, stiffnessA);
+            });
+        addContacts();
     }
 }
 
@@ -419,89 +447,50 @@ PBDCollisionHandling::generateMeshMeshConstraints(
         (pbdObjectB == nullptr) ? nullptr : pbdObjectB->getPhysicsToCollidingMap().get(),
         nullptr);
 
-    // \todo: Test if splitting constraints by type is more efficient
-    for (int i = 0; i < elementsA.size(); i++)
-    {
-        const CollisionElement& colElemA = elementsA[i];
-        const CollisionElement& colElemB = elementsB[i];
+    m_contacts.resize(elementsA.size());
+    ParallelUtils::parallelFor(elementsA.size(),
+        [&](const size_t i)
+        {
+            m_contacts[i] = getMeshMeshContact(elementsA[i], elementsB[i], sideA, sideB, stiffnessA, stiffnessB);
+        });
+    addContacts();
+}
 
-        if (colElemA.m_type != CollisionElementType::CellIndex || colElemB.m_type != CollisionElementType::CellIndex)
+void
+PBDCollisionHandling::addContacts()
+{
+    for (const Contact& contact : m_contacts)
+    {
+        if (contact.m_type == Contact::Type::None)
         {
             continue;
         }
 
-        const CellTypeId cellTypeA = colElemA.m_element.m_CellIndexElement.cellType;
-        const CellTypeId cellTypeB = colElemB.m_element.m_CellIndexElement.cellType;
-
-        // Vertex vs Triangle
-        if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_TRIANGLE)
-        {
-            std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
-            std::array<VertexMassPair, 3> vertexMassB = getTriangle(colElemB, sideB);
-
-            // Setup a constraint to solve both sides (move both the triangle vertices and point vertex)
-            addVTConstraint(
-                vertexMassA[0],
-                vertexMassB[0], vertexMassB[1], vertexMassB[2],
-                stiffnessA, stiffnessB);
-        }
-        // Triangle vs Vertex
-        else if (cellTypeA == IMSTK_TRIANGLE && cellTypeB == IMSTK_VERTEX)
+        VertexMassPair pt0 = contact.m_pts[0];
+        if (contact.m_hasFixedPoint)
         {
-            std::array<VertexMassPair, 3> vertexMassA = getTriangle(colElemA, sideA);
-            std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
-
-            // Setup a constraint to solve both sides (move both the triangle vertices and point vertex)
-            addVTConstraint(
-                vertexMassB[0],
-                vertexMassA[0], vertexMassA[1], vertexMassA[2],
-                stiffnessB, stiffnessA);
+            m_fixedPoints.push_back(contact.m_fixedPoint);
+            m_fixedPointVelocities.push_back(Vec3d(0.0, 0.0, 0.0));
+            pt0 = { &m_fixedPoints.back(), 0.0, &m_fixedPointVelocities.back() };
         }
-        // Edge vs Edge
-        else if (cellTypeA == IMSTK_EDGE && cellTypeB == IMSTK_EDGE)
-        {
-            std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
-            std::array<VertexMassPair, 2> vertexMassB = getEdge(colElemB, sideB);
 
-            addEEConstraint(
-                vertexMassA[0], vertexMassA[1],
-                vertexMassB[0], vertexMassB[1],
-                stiffnessA, stiffnessB);
-        }
-        // Edge vs Vertex
-        else if (cellTypeA == IMSTK_EDGE && cellTypeB == IMSTK_VERTEX)
+        const std::array<VertexMassPair, 4>& pts = contact.m_pts;
+        switch (contact.m_type)
         {
-            std::array<VertexMassPair, 2> vertexMassA = getEdge(colElemA, sideA);
-            std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
-
-            // Setup a constraint to solve both sides (move both the triangle vertices and point vertex)
-            addPEConstraint(
-                vertexMassB[0],
-                vertexMassA[0], vertexMassA[1],
-                stiffnessB, stiffnessA);
-        }
-        // Vertex vs Edge
-        else if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_EDGE)
-        {
-            std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
-            std::array<VertexMassPair, 2> vertexMassB = getEdge(colElemB, sideB);
-
-            // Setup a constraint to solve both sides (move both the triangle vertices and point vertex)
-            addPEConstraint(
-                vertexMassA[0],
-                vertexMassB[0], vertexMassB[1],
-                stiffnessA, stiffnessB);
-        }
-        // Vertex vs Vertex
-        else if (cellTypeA == IMSTK_VERTEX && cellTypeB == IMSTK_VERTEX)
-        {
-            std::array<VertexMassPair, 1> vertexMassA = getVertex(colElemA, sideA);
-            std::array<VertexMassPair, 1> vertexMassB = getVertex(colElemB, sideB);
-
-            addPPConstraint(
-                vertexMassA[0],
-                vertexMassB[0],
-                stiffnessA, stiffnessB);
+        case Contact::Type::PointTriangle:
+            addVTConstraint(pt0, pts[1], pts[2], pts[3], contact.m_stiffnessA, contact.m_stiffnessB);
+            break;
+        case Contact::Type::EdgeEdge:
+            addEEConstraint(pt0, pts[1], pts[2], pts[3], contact.m_stiffnessA, contact.m_stiffnessB);
+            break;
+        case Contact::Type::PointEdge:
+            addPEConstraint(pt0, pts[1], pts[2], contact.m_stiffnessA, contact.m_stiffnessB);
+            break;
+        case Contact::Type::PointPoint:
+            addPPConstraint(pt0, pts[1], contact.m_stiffnessA, contact.m_stiffnessB);
+            break;
+        default:
+            break;
         }
     }
 }
@@ -521,9 +510,8 @@ PBDCollisionHandling::addVTConstraint(
     VertexMassPair ptB1, VertexMassPair ptB2, VertexMassPair ptB3,
     double stiffnessA, double stiffnessB)
 {
-    PbdPointTriangleConstraint* constraint = new PbdPointTriangleConstraint();
+    PbdPointTriangleConstraint* constraint = m_VTConstraintPool.acquire();
     constraint->initConstraint(ptA, ptB1, ptB2, ptB3, stiffnessA, stiffnessB);
-    m_VTConstraintPool.push_back(constraint);
 }
 
 void
@@ -532,9 +520,8 @@ PBDCollisionHandling::addEEConstraint(
     VertexMassPair ptB1, VertexMassPair ptB2,
     double stiffnessA, double stiffnessB)
 {
-    PbdEdgeEdgeConstraint* constraint = new PbdEdgeEdgeConstraint();
+    PbdEdgeEdgeConstraint* constraint = m_EEConstraintPool.acquire();
     constraint->initConstraint(ptA1, ptA2, ptB1, ptB2, stiffnessA, stiffnessB);
-    m_EEConstraintPool.push_back(constraint);
 }
 
 void
@@ -543,9 +530,8 @@ PBDCollisionHandling::addPEConstraint(
     VertexMassPair ptB1, VertexMassPair ptB2,
     double stiffnessA, double stiffnessB)
 {
-    PbdPointEdgeConstraint* constraint = new PbdPointEdgeConstraint();
+    PbdPointEdgeConstraint* constraint = m_PEConstraintPool.acquire();
     constraint->initConstraint(ptA1, ptB1, ptB2, stiffnessA, stiffnessB);
-    m_PEConstraintPool.push_back(constraint);
 }
 
 void
@@ -553,8 +539,7 @@ PBDCollisionHandling::addPPConstraint(
     VertexMassPair ptA, VertexMassPair ptB,
     double stiffnessA, double stiffnessB)
 {
-    PbdPointPointConstraint* constraint = new PbdPointPointConstraint();
+    PbdPointPointConstraint* constraint = m_PPConstraintPool.acquire();
     constraint->initConstraint(ptA, ptB, stiffnessA, stiffnessB);
-    m_PPConstraintPool.push_back(constraint);
 }
 }
\ No newline at end of file
@@ -22,8 +22,11 @@
 #pragma once
 
 #include "imstkCollisionHandling.h"
+#include "imstkObjectPool.h"
 #include "imstkPbdCollisionConstraint.h"
 
+#include <array>
+
 namespace imstk
 {
 class PbdCollisionSolver;
@@ -64,6 +67,46 @@ public:
     void setFriction(const double friction) { m_friction = friction; }
     const double getFriction() const { return m_friction; }
 
+    ///
+    /// \struct Contact
+    ///
+    /// \brief Constraint to add for a pair of collision elements. Contacts are generated
+    /// in parallel, one per pair, then added in order. A fixed first point only gets its
+    /// storage once the contact is added
+    ///
+    struct Contact
+    {
+        enum class Type
+        {
+            None,
+            PointTriangle,
+            EdgeEdge,
+            PointEdge,
+            PointPoint
+        };
+
+        Contact() = default;
+        Contact(const Type type, const std::array<VertexMassPair, 4>& pts,
+                const double stiffnessA, const double stiffnessB) :
+            m_type(type), m_pts(pts), m_stiffnessA(stiffnessA), m_stiffnessB(stiffnessB)
+        {
+        }
+
+        Contact(const Type type, const std::array<VertexMassPair, 4>& pts,
+                const double stiffnessA, const double stiffnessB, const Vec3d& fixedPoint) :
+            m_type(type), m_pts(pts), m_stiffnessA(stiffnessA), m_stiffnessB(stiffnessB),
+            m_hasFixedPoint(true), m_fixedPoint(fixedPoint)
+        {
+        }
+
+        Type m_type = Type::None;
+        std::array<VertexMassPair, 4> m_pts;    ///> Points in the order of the add*Constraint arguments
+        double m_stiffnessA    = 0.0;
+        double m_stiffnessB    = 0.0;
+        bool   m_hasFixedPoint = false;         ///> The first point is m_fixedPoint, not solved
+        Vec3d  m_fixedPoint    = Vec3d::Zero();
+    };
+
 protected:
     ///
     /// \brief Add collision constraints based off contact data
@@ -87,6 +130,11 @@ protected:
         const std::vector<CollisionElement>& elementsB);
 
 protected:
+    ///
+    /// \brief Add the constraints of the generated contacts, in order
+    ///
+    void addContacts();
+
     ///
     /// \brief Add a vertex-triangle constraint
     ///
@@ -122,16 +170,17 @@ private:
     std::shared_ptr<PbdCollisionSolver> m_pbdCollisionSolver = nullptr;
 
     std::vector<PbdCollisionConstraint*> m_PBDConstraints; ///> List of PBD constraints
+    std::vector<Contact> m_contacts;                       ///> Contact per pair of collision elements
 
-    // Lists important here as the memory locations should not change upon push_back
-    // and the amount is not known a priori
-    std::list<Vec3d> m_fixedPoints;
-    std::list<Vec3d> m_fixedPointVelocities;
+    // Pools as the memory locations should not change upon push_back and the amount
+    // is not known a priori. They are reset every frame, their memory is reused
+    ObjectPool<Vec3d> m_fixedPoints;
+    ObjectPool<Vec3d> m_fixedPointVelocities;
 
-    std::vector<PbdEdgeEdgeConstraint*>      m_EEConstraintPool;
-    std::vector<PbdPointTriangleConstraint*> m_VTConstraintPool;
-    std::vector<PbdPointEdgeConstraint*>     m_PEConstraintPool;
-    std::vector<PbdPointPointConstraint*>    m_PPConstraintPool;
+    ObjectPool<PbdEdgeEdgeConstraint>      m_EEConstraintPool;
+    ObjectPool<PbdPointTriangleConstraint> m_VTConstraintPool;
+    ObjectPool<PbdPointEdgeConstraint>     m_PEConstraintPool;
+    ObjectPool<PbdPointPointConstraint>    m_PPConstraintPool;
 
     double m_restitution = 0.0; ///> Coefficient of restitution (1.0 = perfect elastic, 0.0 = inelastic)
     double m_friction    = 0.1; ///> Coefficient of friction (1.0 = full frictional force, 0.0 = none)
@@ -72,6 +72,31 @@ parallelFor(const IndexType endIdx, Function&& function, const bool doParallel =
     parallelFor(IndexType(0), endIdx, std::forward<Function>(function), doParallel);
 }
 
+///
+/// \brief Execute a function in parallel over sub ranges of [beginIdx, endIdx),
+/// the function takes the begin and end index of a chunk. Useful when the
+/// per index work is small and the function can process a contiguous range at once
+/// \param start index
+/// \param end index
+/// \param function to execute that takes a begin and end index
+///
+template<class IndexType, class Function>
+void
+parallelForRange(const IndexType beginIdx, const IndexType endIdx, Function&& function, const bool doParallel = true)
+{
+    if (doParallel)
+    {
+        tbb::parallel_for(tbb::blocked_range<IndexType>(beginIdx, endIdx),
+            [&](const tbb::blocked_range<IndexType>& r) {
+                function(r.begin(), r.end());
+            });
+    }
+    else if (beginIdx < endIdx)
+    {
+        function(beginIdx, endIdx);
+    }
+}
+
 ///
 /// \brief Execute a 2D function in parallel over a range of indices in the x dimension,
 /// indices in the y dimension are scanned sequentially
@@ -0,0 +1,118 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkSVD3x3.h"
+
+#include <Eigen/SVD>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Random matrices, including singular, near identity and reflecting ones
+///
+std::vector<Mat3d>
+makeMatrices()
+{
+    srand(1);
+    std::vector<Mat3d> matrices;
+    for (int i = 0; i < 1000; i++)
+    {
+        Mat3d m = Mat3d::Random();
+        switch (i % 5)
+        {
+        case 1:
+            m.col(2) = 0.5 * m.col(0);
+            break;
+        case 2:
+            m = Mat3d::Identity() + 1.0e-3 * m;
+            break;
+        case 3:
+            m.col(1) = m.col(0);
+            m.col(2) = 2.0 * m.col(0);
+            break;
+        default:
+            break;
+        }
+        matrices.push_back(m);
+    }
+    matrices.push_back(Mat3d::Zero());
+    matrices.push_back(Mat3d::Identity());
+    matrices.push_back(-Mat3d::Identity());
+    return matrices;
+}
+}
+
+///
+/// \brief Test that the closed form SVD reconstructs the matrix with rotations and the
+/// singular values of Eigen, signed by the determinant
+///
+TEST(imstkSVD3x3Test, TestDecomposition)
+{
+    for (const Mat3d& A : makeMatrices())
+    {
+        Mat3d U;
+        Vec3d sigma;
+        Mat3d V;
+        computeSVD3x3(A, U, sigma, V);
+
+        EXPECT_NEAR((U * sigma.asDiagonal() * V.transpose() - A).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR((U * U.transpose() - Mat3d::Identity()).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR((V * V.transpose() - Mat3d::Identity()).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR(U.determinant(), 1.0, 1.0e-12);
+        EXPECT_NEAR(V.determinant(), 1.0, 1.0e-12);
+
+        Eigen::JacobiSVD<Mat3d> svd(A);
+        EXPECT_NEAR((sigma.cwiseAbs() - svd.singularValues()).norm(), 0.0, 1.0e-12);
+        EXPECT_GE(sigma[0], 0.0);
+        EXPECT_GE(sigma[1], 0.0);
+        if (std::abs(A.determinant()) > 1.0e-6)
+        {
+            EXPECT_EQ(sigma[2] < 0.0, A.determinant() < 0.0);
+        }
+    }
+}
+
+///
+/// \brief Test that the polar decomposition gives a rotation, the one of Eigen's SVD
+/// for matrices with a positive determinant
+///
+TEST(imstkSVD3x3Test, TestPolarDecomposition)
+{
+    for (const Mat3d& A : makeMatrices())
+    {
+        Mat3d R;
+        Mat3d S;
+        computePolarDecomposition3x3(A, R, S);
+        EXPECT_NEAR((R * S - A).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR((S - S.transpose()).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR(R.determinant(), 1.0, 1.0e-12);
+
+        if (A.determinant() > 1.0e-6)
+        {
+            Eigen::JacobiSVD<Mat3d> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+            EXPECT_NEAR((R - svd.matrixU() * svd.matrixV().transpose()).norm(), 0.0, 1.0e-10);
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+
+#include <cmath>
+#include <limits>
+
+namespace imstk
+{
+namespace svd3x3
+{
+///
+/// \brief Rotates the columns p and q of M by the rotation (c, s)
+///
+template<typename T>
+static inline void
+rotateColumns(Eigen::Matrix<T, 3, 3>& M, const int p, const int q, const T c, const T s)
+{
+    const Eigen::Matrix<T, 3, 1> mp = M.col(p);
+    M.col(p) = c * mp - s * M.col(q);
+    M.col(q) = s * mp + c * M.col(q);
+}
+
+///
+/// \brief One Jacobi rotation zeroing the (p, q) entry of the symmetric S, accumulated in V
+///
+template<typename T>
+static inline void
+jacobiRotate(Eigen::Matrix<T, 3, 3>& S, Eigen::Matrix<T, 3, 3>& V, const int p, const int q)
+{
+    // tan(theta) = sign(d) * 2 * spq / (|d| + sqrt(d^2 + 4 * spq^2)), the smaller root so |theta| <= pi/4,
+    // a null off diagonal entry gives the identity
+    const T d     = S(q, q) - S(p, p);
+    const T spq2  = T(2) * S(p, q);
+    const T denom = std::abs(d) + std::sqrt(d * d + spq2 * spq2);
+    const T t     = (denom > std::numeric_limits<T>::min()) ? ((d < T(0)) ? -spq2 : spq2) / denom : T(0);
+    const T c     = T(1) / std::sqrt(T(1) + t * t);
+    const T s     = t * c;
+
+    // S = J^T * S * J, only the entries that change, r being the third index
+    const int r   = 3 - p - q;
+    const T   srp = S(r, p);
+    const T   srq = S(r, q);
+    S(p, p) -= t * S(p, q);
+    S(q, q) += t * S(p, q);
+    S(p, q)  = S(q, p) = T(0);
+    S(r, p)  = S(p, r) = c * srp - s * srq;
+    S(r, q)  = S(q, r) = s * srp + c * srq;
+    rotateColumns(V, p, q, c, s);
+}
+
+///
+/// \brief Swaps the columns i and j of B and V when column j of B is longer, one column is
+/// negated so V stays a rotation
+///
+template<typename T>
+static inline void
+sortColumns(Eigen::Matrix<T, 3, 3>& B, Eigen::Matrix<T, 3, 3>& V, Eigen::Matrix<T, 3, 1>& norms2, const int i, const int j)
+{
+    if (norms2[j] > norms2[i])
+    {
+        B.col(i).swap(B.col(j));
+        V.col(i).swap(V.col(j));
+        B.col(j) *= T(-1);
+        V.col(j) *= T(-1);
+        std::swap(norms2[i], norms2[j]);
+    }
+}
+
+///
+/// \brief Givens rotation zeroing B(q, col) against B(p, col), applied to the rows of B
+/// and accumulated in the columns of U
+///
+template<typename T>
+static inline void
+givensQR(Eigen::Matrix<T, 3, 3>& B, Eigen::Matrix<T, 3, 3>& U, const int p, const int q, const int col)
+{
+    const T a1  = B(p, col);
+    const T a2  = B(q, col);
+    const T rho = std::sqrt(a1 * a1 + a2 * a2);
+    const T c   = (rho > std::numeric_limits<T>::min()) ? a1 / rho : T(1);
+    const T s   = (rho > std::numeric_limits<T>::min()) ? a2 / rho : T(0);
+
+    const Eigen::Matrix<T, 1, 3> bp = B.row(p);
+    B.row(p) = c * bp + s * B.row(q);
+    B.row(q) = -s * bp + c * B.row(q);
+    rotateColumns(U, p, q, c, -s);
+}
+}
+
+///
+/// \brief Closed form SVD of a 3x3 matrix, A = U * diag(sigma) * V^T, after McAdams et al.
+/// "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching and
+/// elementary floating point operations". V diagonalizes A^T*A in a fixed number of Jacobi
+/// sweeps, U comes from the Givens QR of A*V. The amount of work does not depend on the
+/// input, 4 sweeps give double precision.
+/// U and V are rotations, sigma is sorted by decreasing magnitude and only its last value
+/// is negative, when det(A) < 0 (the rotation variant SVD used by invertible FEM)
+///
+template<typename T>
+void
+computeSVD3x3(const Eigen::Matrix<T, 3, 3>& A,
+              Eigen::Matrix<T, 3, 3>& U, Eigen::Matrix<T, 3, 1>& sigma, Eigen::Matrix<T, 3, 3>& V,
+              const int numSweeps = 4)
+{
+    // Eigenvectors of the symmetric A^T*A
+    Eigen::Matrix<T, 3, 3> S = A.transpose() * A;
+    V.setIdentity();
+    for (int i = 0; i < numSweeps; i++)
+    {
+        svd3x3::jacobiRotate(S, V, 0, 1);
+        svd3x3::jacobiRotate(S, V, 0, 2);
+        svd3x3::jacobiRotate(S, V, 1, 2);
+    }
+
+    // Columns of A*V are orthogonal, sort them by decreasing norm
+    Eigen::Matrix<T, 3, 3> B = A * V;
+    Eigen::Matrix<T, 3, 1> norms2 = B.colwise().squaredNorm().transpose();
+    svd3x3::sortColumns(B, V, norms2, 0, 1);
+    svd3x3::sortColumns(B, V, norms2, 0, 2);
+    svd3x3::sortColumns(B, V, norms2, 1, 2);
+
+    // A*V = U*R with R diagonal up to round off, the sign of det(A) ends up on R(2, 2)
+    U.setIdentity();
+    svd3x3::givensQR(B, U, 0, 1, 0);
+    svd3x3::givensQR(B, U, 0, 2, 0);
+    svd3x3::givensQR(B, U, 1, 2, 1);
+    sigma = B.diagonal();
+}
+
+///
+/// \brief Polar decomposition A = R * S of a 3x3 matrix with R a rotation, from the closed
+/// form SVD. When det(A) < 0, R is the closest rotation and S is not positive definite
+///
+template<typename T>
+void
+computePolarDecomposition3x3(const Eigen::Matrix<T, 3, 3>& A, Eigen::Matrix<T, 3, 3>& R, Eigen::Matrix<T, 3, 3>& S)
+{
+    Eigen::Matrix<T, 3, 3> U;
+    Eigen::Matrix<T, 3, 1> sigma;
+    Eigen::Matrix<T, 3, 3> V;
+    computeSVD3x3(A, U, sigma, V);
+    R = U * V.transpose();
+    S = V * sigma.asDiagonal() * V.transpose();
+}
+} // imstk
@@ -44,20 +44,13 @@ PbdAreaConstraint::initConstraint(const VecDataArray<double, 3>& initVertexPosit
     m_restArea = 0.5 * (p1 - p0).cross(p2 - p0).norm();
 }
 
-bool
-PbdAreaConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& c,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of an area constraint, shared by the single and batched constraint
+///
+static inline bool
+computeArea(const Vec3d& p0, const Vec3d& p1, const Vec3d& p2,
+            const double restArea, const double epsilon, double& c, Vec3d* dcdx)
 {
-    const auto i1 = m_vertexIds[0];
-    const auto i2 = m_vertexIds[1];
-    const auto i3 = m_vertexIds[2];
-
-    const Vec3d& p0 = currVertexPositions[i1];
-    const Vec3d& p1 = currVertexPositions[i2];
-    const Vec3d& p2 = currVertexPositions[i3];
-
     const Vec3d e0 = p0 - p1;
     const Vec3d e1 = p1 - p2;
     const Vec3d e2 = p2 - p0;
@@ -65,13 +58,13 @@ PbdAreaConstraint::computeValueAndGradient(
     Vec3d n = e0.cross(e1);
     c = 0.5 * n.norm();
 
-    if (c < m_epsilon)
+    if (c < epsilon)
     {
         return false;
     }
 
     n /= 2 * c;
-    c -= m_restArea;
+    c -= restArea;
 
     dcdx[0] = e1.cross(n);
     dcdx[1] = e2.cross(n);
@@ -79,4 +72,41 @@ PbdAreaConstraint::computeValueAndGradient(
 
     return true;
 }
+
+bool
+PbdAreaConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& c,
+    Vec3d* dcdx) const
+{
+    return computeArea(
+        currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]], currVertexPositions[m_vertexIds[2]],
+        m_restArea, m_epsilon, c, dcdx);
+}
+
+bool
+PbdAreaConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdAreaConstraint) || !acceptTolerance(constraint))
+    {
+        return false;
+    }
+    push_back(getIds(constraint), static_cast<const PbdAreaConstraint&>(constraint).m_restArea,
+        constraint.getStiffness(), constraint.getCompliance());
+    return true;
+}
+
+template<typename T>
+bool
+PbdAreaConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 3>& ids = m_vertexIds[i];
+    return computeArea(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        pos[ids[2]].template cast<double>(), m_restData[i], m_epsilon, c, dcdx);
+}
+
+template bool PbdAreaConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdAreaConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdAreaConstraintBatch, 3, double>;
 }
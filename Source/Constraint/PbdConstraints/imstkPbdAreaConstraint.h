@@ -21,7 +21,7 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
 namespace imstk
 {
@@ -30,17 +30,13 @@ namespace imstk
 ///
 /// \brief Area constraint for triangular face
 ///
-class PbdAreaConstraint : public PbdConstraint
+class PbdAreaConstraint : public PbdConstraintN<3>
 {
 public:
     ///
     /// \brief Constructor
     ///
-    PbdAreaConstraint() : PbdConstraint()
-    {
-        m_vertexIds.resize(3);
-        m_dcdx.resize(3);
-    }
+    PbdAreaConstraint() : PbdConstraintN<3>() { }
 
     ///
     /// \brief Returns PBD constraint of type Area
@@ -58,9 +54,34 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPositions,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
 
 public:
     double m_restArea = 0.;  ///> Area at the rest position
 };
+
+///
+/// \class PbdAreaConstraintBatch
+///
+/// \brief Structure of arrays storage of area constraints
+///
+class PbdAreaConstraintBatch : public PbdConstraintBatchBase<PbdAreaConstraintBatch, 3, double>
+{
+public:
+    std::string getType() const override { return "Area"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdAreaConstraintBatch, 3, double>;
 } // imstk
@@ -47,31 +47,24 @@ PbdBendConstraint::initConstraint(const VecDataArray<double, 3>& initVertexPosit
     m_restLength = (p1 - center).norm();
 }
 
-bool
-PbdBendConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& c,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of a bend constraint, shared by the single and batched constraint
+///
+static inline bool
+computeBend(const Vec3d& p0, const Vec3d& p1, const Vec3d& p2,
+            const double restLength, const double epsilon, double& c, Vec3d* dcdx)
 {
-    const size_t i0 = m_vertexIds[0];
-    const size_t i1 = m_vertexIds[1];
-    const size_t i2 = m_vertexIds[2];
-
-    const Vec3d& p0 = currVertexPositions[i0];
-    const Vec3d& p1 = currVertexPositions[i1];
-    const Vec3d& p2 = currVertexPositions[i2];
-
     // Move towards triangle center
-    const Vec3d& center = (p0 + p1 + p2) / 3.0;
-    const Vec3d& diff   = p1 - center;
+    const Vec3d  center = (p0 + p1 + p2) / 3.0;
+    const Vec3d  diff   = p1 - center;
     const double dist   = diff.norm();
 
-    if (dist < m_epsilon)
+    if (dist < epsilon)
     {
         return false;
     }
 
-    c = dist - m_restLength;
+    c = dist - restLength;
 
     dcdx[0] = (-2.0 / dist) * diff;
     dcdx[1] = -2.0 * dcdx[0];
@@ -79,4 +72,41 @@ PbdBendConstraint::computeValueAndGradient(
 
     return true;
 }
+
+bool
+PbdBendConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& c,
+    Vec3d* dcdx) const
+{
+    return computeBend(
+        currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]], currVertexPositions[m_vertexIds[2]],
+        m_restLength, m_epsilon, c, dcdx);
+}
+
+bool
+PbdBendConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdBendConstraint) || !acceptTolerance(constraint))
+    {
+        return false;
+    }
+    push_back(getIds(constraint), static_cast<const PbdBendConstraint&>(constraint).m_restLength,
+        constraint.getStiffness(), constraint.getCompliance());
+    return true;
+}
+
+template<typename T>
+bool
+PbdBendConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 3>& ids = m_vertexIds[i];
+    return computeBend(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        pos[ids[2]].template cast<double>(), m_restData[i], m_epsilon, c, dcdx);
+}
+
+template bool PbdBendConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdBendConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdBendConstraintBatch, 3, double>;
 } // imstk
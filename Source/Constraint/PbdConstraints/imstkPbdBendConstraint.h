@@ -21,7 +21,7 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
 namespace imstk
 {
@@ -30,17 +30,13 @@ namespace imstk
 ///
 /// \brief Bend constraint between two segments
 ///
-class PbdBendConstraint : public PbdConstraint
+class PbdBendConstraint : public PbdConstraintN<3>
 {
 public:
     ///
     /// \brief Constructor
     ///
-    PbdBendConstraint() : PbdConstraint()
-    {
-        m_vertexIds.resize(3);
-        m_dcdx.resize(3);
-    }
+    PbdBendConstraint() : PbdConstraintN<3>() { }
 
     ///
     /// \brief Returns PBD constraint of type Type::Bend
@@ -73,8 +69,33 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPosition,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
 public:
     double m_restLength = 0.; ///> Rest length
 };
+
+///
+/// \class PbdBendConstraintBatch
+///
+/// \brief Structure of arrays storage of bend constraints
+///
+class PbdBendConstraintBatch : public PbdConstraintBatchBase<PbdBendConstraintBatch, 3, double>
+{
+public:
+    std::string getType() const override { return "Bend"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdBendConstraintBatch, 3, double>;
 } //imstk
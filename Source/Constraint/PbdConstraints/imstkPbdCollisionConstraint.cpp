@@ -32,17 +32,17 @@ PbdCollisionConstraint::PbdCollisionConstraint(const unsigned int n1, const unsi
     m_dcdxB.resize(n2);
 }
 
-void
-PbdCollisionConstraint::solvePosition()
+bool
+PbdCollisionConstraint::computeLambda(double& lambda)
 {
     double     c;
     const bool update = this->computeValueAndGradient(c, m_dcdxA, m_dcdxB);
     if (!update)
     {
-        return;
+        return false;
     }
 
-    double lambda = 0.0;
+    lambda = 0.0;
 
     // Sum the mass (so we can weight displacements)
     for (size_t i = 0; i < m_bodiesFirst.size(); i++)
@@ -57,10 +57,21 @@ PbdCollisionConstraint::solvePosition()
 
     if (lambda == 0.0)
     {
-        return;
+        return false;
     }
 
     lambda = c / lambda;
+    return true;
+}
+
+void
+PbdCollisionConstraint::solvePosition()
+{
+    double lambda;
+    if (!computeLambda(lambda))
+    {
+        return;
+    }
 
     for (size_t i = 0; i < m_bodiesFirst.size(); i++)
     {
@@ -81,6 +92,28 @@ PbdCollisionConstraint::solvePosition()
     }
 }
 
+bool
+PbdCollisionConstraint::computePositionCorrections(Vec3d* dx)
+{
+    double lambda;
+    if (!computeLambda(lambda))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_bodiesFirst.size(); i++)
+    {
+        dx[i] = m_bodiesFirst[i].invMass * lambda * m_dcdxA[i] * m_stiffnessA;
+    }
+
+    const size_t numVertsA = m_bodiesFirst.size();
+    for (size_t i = 0; i < m_bodiesSecond.size(); i++)
+    {
+        dx[numVertsA + i] = m_bodiesSecond[i].invMass * lambda * m_dcdxB[i] * m_stiffnessB;
+    }
+    return true;
+}
+
 void
 PbdCollisionConstraint::correctVelocity(const double friction, const double restitution)
 {
@@ -75,12 +75,27 @@ public:
     ///
     virtual void solvePosition();
 
+    ///
+    /// \brief Compute the position corrections of the vertices of A followed by those of B
+    /// without applying them. Used to solve many constraints simultaneously
+    /// \param[out] dx corrections, numVertsA + numVertsB of them
+    /// \return false if there is nothing to correct, dx is left untouched then
+    ///
+    bool computePositionCorrections(Vec3d* dx);
+
     ///
     /// \brief Solve the velocities given to the constraint
     ///
     virtual void correctVelocity(const double friction, const double restitution);
 
 protected:
+    ///
+    /// \brief Compute the gradients and the scale of the position corrections, the
+    /// correction of the i-th vertex of A is invMass * lambda * dcdxA[i] * stiffnessA
+    /// \return false if there is nothing to correct
+    ///
+    bool computeLambda(double& lambda);
+
     std::vector<VertexMassPair> m_bodiesFirst;                         ///> index of points for the first object
     std::vector<VertexMassPair> m_bodiesSecond;                        ///> index of points for the second object
 
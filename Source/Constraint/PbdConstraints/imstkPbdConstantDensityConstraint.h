@@ -65,7 +65,7 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& imstkNotUsed(currVertexPositions),
         double& imstkNotUsed(c),
-        std::vector<Vec3d>& imstkNotUsed(dcdx)) const override
+        Vec3d* imstkNotUsed(dcdx)) const override
     {
         return true;
     }
@@ -21,31 +21,40 @@
 
 #include "imstkPbdConstraint.h"
 
+#include <algorithm>
+
 namespace imstk
 {
-void
-PbdConstraint::projectConstraint(const DataArray<double>& invMasses, const double dt, const SolverType& solverType, VecDataArray<double, 3>& pos)
+bool
+PbdConstraint::computeLambda(const DataArray<double>& invMasses, const double dt, const SolverType& solverType,
+                             const VecDataArray<double, 3>& pos, double& lambda)
 {
+    // Nothing moves when every vertex is fixed (or sleeping), skip the evaluation
+    if (m_numVertices > 0 && std::all_of(m_vertexIds, m_vertexIds + m_numVertices,
+        [&](const size_t vid) { return invMasses[vid] == 0.0; }))
+    {
+        return false;
+    }
+
     double c;
 
     bool update = this->computeValueAndGradient(pos, c, m_dcdx);
     if (!update)
     {
-        return;
+        return false;
     }
 
     double dcMidc = 0.0;
-    double lambda = 0.0;
     double alpha;
 
-    for (size_t i = 0; i < m_vertexIds.size(); ++i)
+    for (size_t i = 0; i < m_numVertices; ++i)
     {
         dcMidc += invMasses[m_vertexIds[i]] * m_dcdx[i].squaredNorm();
     }
 
     if (dcMidc < IMSTK_DOUBLE_EPS)
     {
-        return;
+        return false;
     }
 
     switch (solverType)
@@ -63,8 +72,19 @@ PbdConstraint::projectConstraint(const DataArray<double>& invMasses, const doubl
         lambda    = -(c + alpha * m_lambda) / (dcMidc + alpha);
         m_lambda += lambda;
     }
+    return true;
+}
 
-    for (size_t i = 0, vid = 0; i < m_vertexIds.size(); ++i)
+void
+PbdConstraint::projectConstraint(const DataArray<double>& invMasses, const double dt, const SolverType& solverType, VecDataArray<double, 3>& pos)
+{
+    double lambda;
+    if (!computeLambda(invMasses, dt, solverType, pos, lambda))
+    {
+        return;
+    }
+
+    for (size_t i = 0, vid = 0; i < m_numVertices; ++i)
     {
         vid = m_vertexIds[i];
         if (invMasses[vid] > 0.0)
@@ -73,4 +93,56 @@ PbdConstraint::projectConstraint(const DataArray<double>& invMasses, const doubl
         }
     }
 }
+
+void
+PbdConstraint::applyLambda(const DataArray<double>& invMasses, VecDataArray<double, 3>& pos)
+{
+    double c;
+    if (m_lambda == 0.0 || !this->computeValueAndGradient(pos, c, m_dcdx))
+    {
+        return;
+    }
+
+    for (size_t i = 0, vid = 0; i < m_numVertices; ++i)
+    {
+        vid = m_vertexIds[i];
+        if (invMasses[vid] > 0.0)
+        {
+            pos[vid] += invMasses[vid] * m_lambda * m_dcdx[i];
+        }
+    }
+}
+
+bool
+PbdConstraint::computePositionCorrections(const DataArray<double>& invMasses, const double dt, const SolverType& solverType,
+                                          const VecDataArray<double, 3>& pos, Vec3d* dx)
+{
+    double lambda;
+    if (!computeLambda(invMasses, dt, solverType, pos, lambda))
+    {
+        std::fill_n(dx, m_numVertices, Vec3d::Zero());
+        return false;
+    }
+
+    for (size_t i = 0; i < m_numVertices; ++i)
+    {
+        dx[i] = invMasses[m_vertexIds[i]] * lambda * m_dcdx[i];
+    }
+    return true;
+}
+
+double
+PbdConstraint::computeResidual(const VecDataArray<double, 3>& pos, const double dt, const SolverType& solverType)
+{
+    double c = 0.0;
+    if (!this->computeValueAndGradient(pos, c, m_dcdx))
+    {
+        return 0.0;
+    }
+    if (solverType == SolverType::PBD)
+    {
+        return std::abs(c);
+    }
+    return std::abs(c + m_compliance / (dt * dt) * m_lambda);
+}
 }
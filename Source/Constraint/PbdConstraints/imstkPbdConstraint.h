@@ -24,8 +24,35 @@
 #include "imstkMath.h"
 #include "imstkVecDataArray.h"
 
+#include <array>
+
 namespace imstk
 {
+///
+/// \class PbdArrayView
+///
+/// \brief Non owning view of the fixed size arrays stored in a constraint
+///
+template<typename T>
+class PbdArrayView
+{
+public:
+    PbdArrayView(T* data, const size_t size) : m_data(data), m_size(size) { }
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+
+    T& operator[](const size_t i) const { return m_data[i]; }
+
+protected:
+    T*     m_data;
+    size_t m_size;
+};
+
 ///
 /// \class PbdConstraint
 ///
@@ -63,16 +90,18 @@ public:
     ///
     /// \param[in] currVertexPositions vector of current positions
     /// \param[inout] c constraint value
+    /// \param[out] dcdx gradient per vertex of the constraint, getVertexIds().size() of them
     ///
     virtual bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPositions,
         double& c,
-        std::vector<Vec3d>& dcdx) const = 0;
+        Vec3d* dcdx) const = 0;
 
     ///
     /// \brief Get the vertex indices of the constraint
     ///
-    std::vector<size_t>& getVertexIds() { return m_vertexIds; }
+    PbdArrayView<size_t> getVertexIds() { return PbdArrayView<size_t>(m_vertexIds, m_numVertices); }
+    PbdArrayView<const size_t> getVertexIds() const { return PbdArrayView<const size_t>(m_vertexIds, m_numVertices); }
 
     ///
     /// \brief Set the tolerance used for pbd constraints
@@ -98,23 +127,108 @@ public:
     ///
     double getStiffness() const { return m_stiffness; }
 
+    ///
+    /// \brief Get the compliance, used in xPBD
+    ///
+    double getCompliance() const { return m_compliance; }
+
     ///
     /// \brief Use PBD
     ///
     void zeroOutLambda() { m_lambda = 0.0; }
 
+    ///
+    /// \brief Scale the Lagrange multiplier, ie: to warm start it from the previous solve
+    ///
+    void scaleLambda(const double scale) { m_lambda *= scale; }
+
+    ///
+    /// \brief Move the vertices by the correction of the accumulated Lagrange multiplier,
+    /// invMass * lambda * dC/dx, such that warm started positions and multiplier agree
+    ///
+    void applyLambda(const DataArray<double>& invMasses, VecDataArray<double, 3>& pos);
+
     ///
     /// \brief Update positions by projecting constraints.
     ///
     virtual void projectConstraint(const DataArray<double>& currInvMasses, const double dt, const SolverType& type, VecDataArray<double, 3>& pos);
 
+    ///
+    /// \brief Compute the position corrections of the constraint vertices without applying
+    /// them, used to project all constraints against the same positions (Jacobi)
+    /// \param[out] dx correction per vertex of the constraint, zero if there is nothing to correct
+    /// \return false if there is nothing to correct
+    ///
+    bool computePositionCorrections(const DataArray<double>& currInvMasses, const double dt, const SolverType& type,
+                                    const VecDataArray<double, 3>& pos, Vec3d* dx);
+
+    ///
+    /// \brief Compute how far the constraint is from being satisfied, |C + alpha * lambda|
+    /// in xPBD (alpha = compliance / dt^2) and |C| in PBD. Zero if the constraint cannot be evaluated
+    ///
+    double computeResidual(const VecDataArray<double, 3>& pos, const double dt, const SolverType& type);
+
 protected:
-    std::vector<size_t> m_vertexIds;   ///> index of points for the constraint
-    double m_epsilon        = 1.0e-16; ///> Tolerance used for the costraints
-    double m_stiffness      = 1.0;     ///> used in PBD, [0, 1]
-    double m_compliance     = 1e-7;    ///> used in xPBD, inverse of Young's Modulus
+    ///
+    /// \brief Compute the gradients and the multiplier increment of the projection,
+    /// the correction of the i-th vertex is invMass * lambda * m_dcdx[i]
+    /// \return false if there is nothing to correct
+    ///
+    bool computeLambda(const DataArray<double>& invMasses, const double dt, const SolverType& type,
+                       const VecDataArray<double, 3>& pos, double& lambda);
+
+    ///
+    /// \brief Point the constraint to the storage of its vertex ids and gradients,
+    /// owned by the derived class, see PbdConstraintN
+    ///
+    void setVertexStorage(size_t* vertexIds, Vec3d* dcdx, const size_t numVertices)
+    {
+        m_vertexIds   = vertexIds;
+        m_dcdx        = dcdx;
+        m_numVertices = numVertices;
+    }
+
+    size_t* m_vertexIds     = nullptr; ///> index of points for the constraint
+    Vec3d*  m_dcdx          = nullptr; ///> gradient of the constraint per point
+    size_t  m_numVertices   = 0;       ///> number of points of the constraint
+    double  m_epsilon       = 1.0e-16; ///> Tolerance used for the costraints
+    double  m_stiffness     = 1.0;     ///> used in PBD, [0, 1]
+    double  m_compliance    = 1e-7;    ///> used in xPBD, inverse of Young's Modulus
     mutable double m_lambda = 0.0;     ///> Lagrange multiplier
+};
+
+///
+/// \class PbdConstraintN
+///
+/// \brief Constraint over a fixed number N of vertices. The vertex ids and the gradients
+/// are stored inline so that a constraint is a single allocation, contiguous in memory
+///
+template<int N, typename Base = PbdConstraint>
+class PbdConstraintN : public Base
+{
+public:
+    PbdConstraintN() : Base() { bindStorage(); }
+
+    PbdConstraintN(const PbdConstraintN& other) : Base(other), m_ids(other.m_ids), m_gradients(other.m_gradients)
+    {
+        bindStorage();
+    }
+
+    PbdConstraintN& operator=(const PbdConstraintN& other)
+    {
+        Base::operator=(other);
+        m_ids       = other.m_ids;
+        m_gradients = other.m_gradients;
+        bindStorage();
+        return *this;
+    }
+
+    ~PbdConstraintN() override = default;
+
+private:
+    void bindStorage() { this->setVertexStorage(m_ids.data(), m_gradients.data(), N); }
 
-    std::vector<Vec3d> m_dcdx;
+    std::array<size_t, N> m_ids       = { };
+    std::array<Vec3d, N>  m_gradients = { };
 };
 }
\ No newline at end of file
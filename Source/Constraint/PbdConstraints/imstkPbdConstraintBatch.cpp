@@ -0,0 +1,187 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdConstraintBatch.h"
+
+namespace imstk
+{
+void
+PbdConstraintBatch::removeConstraints(const std::unordered_set<size_t>& vertices)
+{
+    for (const size_t vid : vertices)
+    {
+        const std::vector<size_t>& constraints = getVertexConstraints(vid);
+        while (!constraints.empty())
+        {
+            removeConstraint(constraints.back());
+        }
+    }
+}
+
+void
+PbdConstraintBatch::removeConstraint(const size_t i)
+{
+    // Walk the constraint up to the end by swapping it with the last constraint of
+    // its range, then shrinking the range and growing the following one
+    const int partition = getPartition(i);
+    size_t    idx       = i;
+    for (size_t r = (partition == -1) ? getNumPartitions() : static_cast<size_t>(partition);
+         r < m_partitionOffsets.size(); r++)
+    {
+        const bool   isLastRange = (r + 1 == m_partitionOffsets.size());
+        const size_t last = (isLastRange ? size() : m_partitionOffsets[r + 1]) - 1;
+        if (idx != last)
+        {
+            swapIndexedConstraints(idx, last);
+        }
+        idx = last;
+        if (!isLastRange)
+        {
+            m_partitionOffsets[r + 1]--;
+        }
+    }
+    unindexConstraint(idx);
+    popBack();
+}
+
+const std::vector<size_t>&
+PbdConstraintBatch::getVertexConstraints(const size_t vertexId) const
+{
+    static const std::vector<size_t> empty;
+    return (vertexId < m_vertexConstraints.size()) ? m_vertexConstraints[vertexId] : empty;
+}
+
+void
+PbdConstraintBatch::swapIndexedConstraints(const size_t i, const size_t j)
+{
+    unindexConstraint(i);
+    unindexConstraint(j);
+    swapConstraints(i, j);
+    indexConstraint(i);
+    indexConstraint(j);
+}
+
+void
+PbdConstraintBatch::indexConstraint(const size_t i)
+{
+    const size_t* ids = getVertexIds(i);
+    for (size_t j = 0; j < getNumVertices(); j++)
+    {
+        if (ids[j] >= m_vertexConstraints.size())
+        {
+            m_vertexConstraints.resize(ids[j] + 1);
+        }
+        m_vertexConstraints[ids[j]].push_back(i);
+    }
+}
+
+void
+PbdConstraintBatch::unindexConstraint(const size_t i)
+{
+    const size_t* ids = getVertexIds(i);
+    for (size_t j = 0; j < getNumVertices(); j++)
+    {
+        std::vector<size_t>& constraints = m_vertexConstraints[ids[j]];
+        auto                 iter = std::find(constraints.begin(), constraints.end(), i);
+        if (iter != constraints.end())
+        {
+            *iter = constraints.back();
+            constraints.pop_back();
+        }
+    }
+}
+
+void
+PbdConstraintBatch::rebuildIndex()
+{
+    for (auto& constraints : m_vertexConstraints)
+    {
+        constraints.clear();
+    }
+    for (size_t i = 0; i < size(); i++)
+    {
+        indexConstraint(i);
+    }
+}
+
+void
+PbdConstraintBatch::setPartitions(const std::vector<int>& partitionIds, const size_t numPartitions)
+{
+    // Counting sort by partition, unpartitioned (-1) constraints go last
+    std::vector<size_t> counts(numPartitions + 1, 0);
+    for (size_t i = 0; i < partitionIds.size(); i++)
+    {
+        const int id = partitionIds[i];
+        counts[(id == -1) ? numPartitions : static_cast<size_t>(id)]++;
+    }
+
+    m_partitionOffsets.resize(numPartitions + 1);
+    std::vector<size_t> writeIdx(numPartitions + 1);
+    size_t              offset = 0;
+    for (size_t i = 0; i < numPartitions + 1; i++)
+    {
+        m_partitionOffsets[i] = writeIdx[i] = offset;
+        offset += counts[i];
+    }
+
+    std::vector<size_t> order(partitionIds.size());
+    for (size_t i = 0; i < partitionIds.size(); i++)
+    {
+        const int id = partitionIds[i];
+        order[writeIdx[(id == -1) ? numPartitions : static_cast<size_t>(id)]++] = i;
+    }
+    reorder(order);
+    rebuildIndex();
+}
+
+void
+PbdConstraintBatch::moveToPartition(const size_t i, const size_t partition)
+{
+    // Add empty partitions before the unpartitioned range if needed
+    while (getNumPartitions() <= partition)
+    {
+        m_partitionOffsets.push_back(m_partitionOffsets.back());
+    }
+
+    // Walk the constraint down by swapping it with the first constraint of every
+    // range after the partition, then growing the range before it
+    size_t idx = i;
+    for (size_t r = m_partitionOffsets.size() - 1; r > partition; r--)
+    {
+        if (idx != m_partitionOffsets[r])
+        {
+            swapIndexedConstraints(idx, m_partitionOffsets[r]);
+        }
+        idx = m_partitionOffsets[r]++;
+    }
+}
+
+int
+PbdConstraintBatch::getPartition(const size_t i) const
+{
+    if (i >= m_partitionOffsets.back())
+    {
+        return -1;
+    }
+    const auto iter = std::upper_bound(m_partitionOffsets.begin(), m_partitionOffsets.end(), i);
+    return static_cast<int>(std::distance(m_partitionOffsets.begin(), iter)) - 1;
+}
+}
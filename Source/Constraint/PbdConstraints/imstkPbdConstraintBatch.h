@@ -0,0 +1,646 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintSimd.h"
+
+#include <algorithm>
+#include <array>
+#include <typeinfo>
+#include <unordered_set>
+
+namespace imstk
+{
+///
+/// \class PbdConstraintBatch
+///
+/// \brief Base class for type-bucketed pbd constraints. A batch stores many constraints
+/// of one type as flat contiguous arrays (vertex ids, rest values, stiffness, lambdas)
+/// instead of individually allocated PbdConstraint objects. A whole range of constraints
+/// is projected with a single virtual call, the per constraint kernel is not virtual.
+///
+/// Constraints in a batch are ordered by partition (color). Partition p occupies
+/// [offsets[p], offsets[p+1]), constraints after the last offset are not partitioned
+/// and must be solved sequentially.
+///
+class PbdConstraintBatch
+{
+public:
+    PbdConstraintBatch() = default;
+    virtual ~PbdConstraintBatch() = default;
+
+public:
+    ///
+    /// \brief Returns the type of the constraints stored, same as PbdConstraint::getType
+    ///
+    virtual std::string getType() const = 0;
+
+    ///
+    /// \brief Copies the constraint into the batch as an unpartitioned constraint
+    /// \return false if the constraint cannot be stored in this batch
+    ///
+    virtual bool addConstraint(const PbdConstraint& constraint) = 0;
+
+    ///
+    /// \brief Copies the constraints of another batch of the same type with their vertex
+    /// ids shifted by vertexOffset, as unpartitioned constraints
+    /// \return false if they cannot be stored in this batch
+    ///
+    virtual bool append(const PbdConstraintBatch& other, const size_t vertexOffset) = 0;
+
+    ///
+    /// \brief Returns the number of constraints in the batch
+    ///
+    virtual size_t size() const = 0;
+
+    ///
+    /// \brief Returns the number of vertices per constraint
+    ///
+    virtual size_t getNumVertices() const = 0;
+
+    ///
+    /// \brief Returns the vertex ids of the i'th constraint, getNumVertices() long
+    ///
+    virtual const size_t* getVertexIds(const size_t i) const = 0;
+
+    ///
+    /// \brief Project the constraints in range [begin, end)
+    ///
+    virtual void projectConstraints(const size_t begin, const size_t end,
+                                    const DataArray<double>& invMasses, const double dt,
+                                    const PbdConstraint::SolverType& type, VecDataArray<double, 3>& pos) = 0;
+
+    ///
+    /// \brief Project the constraints in range [begin, end) on single precision positions,
+    /// evaluated in single precision by the simd kernel of the batch if it has one, in
+    /// double precision otherwise
+    ///
+    virtual void projectConstraints(const size_t begin, const size_t end,
+                                    const DataArray<float>& invMasses, const double dt,
+                                    const PbdConstraint::SolverType& type, VecDataArray<float, 3>& pos) = 0;
+
+    ///
+    /// \brief Compute the position corrections of the constraints in range [begin, end)
+    /// without applying them, used to project all constraints against the same positions (Jacobi)
+    /// \param[out] dx getNumVertices() corrections per constraint, zero for constraints with nothing to correct
+    ///
+    virtual void computePositionCorrections(const size_t begin, const size_t end,
+                                            const DataArray<double>& invMasses, const double dt,
+                                            const PbdConstraint::SolverType& type, const VecDataArray<double, 3>& pos,
+                                            Vec3d* dx) = 0;
+
+    ///
+    /// \brief Compute how far the constraints in range [begin, end) are from being satisfied,
+    /// see PbdConstraint::computeResidual
+    ///
+    virtual void computeResiduals(const size_t begin, const size_t end,
+                                  const VecDataArray<double, 3>& pos, const double dt,
+                                  const PbdConstraint::SolverType& type, double* residuals) = 0;
+    virtual void computeResiduals(const size_t begin, const size_t end,
+                                  const VecDataArray<float, 3>& pos, const double dt,
+                                  const PbdConstraint::SolverType& type, double* residuals) = 0;
+
+    ///
+    /// \brief Zero out the Lagrange multipliers of every constraint
+    ///
+    virtual void zeroOutLambdas() = 0;
+
+    ///
+    /// \brief Scale the Lagrange multipliers of every constraint, ie: to warm start them
+    ///
+    virtual void scaleLambdas(const double scale) = 0;
+
+    ///
+    /// \brief Move the vertices of the constraints in range [begin, end) by the correction
+    /// of their accumulated Lagrange multipliers, see PbdConstraint::applyLambda
+    ///
+    virtual void applyLambdas(const size_t begin, const size_t end,
+                              const DataArray<double>& invMasses, VecDataArray<double, 3>& pos) = 0;
+
+    ///
+    /// \brief Removes all constraints that reference any of the given vertices, in time
+    /// proportional to the number of constraints removed
+    ///
+    void removeConstraints(const std::unordered_set<size_t>& vertices);
+
+    ///
+    /// \brief Removes the i'th constraint in O(number of partitions). The last constraint
+    /// of its range takes its place, and so on for the following ranges
+    ///
+    void removeConstraint(const size_t i);
+
+    ///
+    /// \brief Returns the indices of the constraints using the vertex, in no particular order
+    ///
+    const std::vector<size_t>& getVertexConstraints(const size_t vertexId) const;
+
+    ///
+    /// \brief Reorders the constraints by the given partition ids. A partition id
+    /// of -1 places the constraint in the unpartitioned range
+    ///
+    void setPartitions(const std::vector<int>& partitionIds, const size_t numPartitions);
+
+    ///
+    /// \brief Moves an unpartitioned constraint (ie: just added) to the given partition
+    /// in O(number of partitions), partitions are added if needed
+    ///
+    void moveToPartition(const size_t i, const size_t partition);
+
+    ///
+    /// \brief Returns the partition of the i'th constraint, -1 if not partitioned
+    ///
+    int getPartition(const size_t i) const;
+
+    ///
+    /// \brief Returns the number of partitions stored
+    ///
+    size_t getNumPartitions() const { return m_partitionOffsets.size() - 1; }
+
+    ///
+    /// \brief Returns the start offsets of every partition followed by the start of the
+    /// unpartitioned range
+    ///
+    const std::vector<size_t>& getPartitionOffsets() const { return m_partitionOffsets; }
+
+protected:
+    ///
+    /// \brief Returns if the parameters shared by all constraints of the other batch
+    /// (of the same type) match the ones of this batch, when empty this batch takes them
+    ///
+    virtual bool acceptParameters(const PbdConstraintBatch&) { return true; }
+
+    ///
+    /// \brief Permutes every per constraint array such that new[i] = old[order[i]],
+    /// order may be shorter than size() in which case the rest is dropped
+    ///
+    virtual void reorder(const std::vector<size_t>& order) = 0;
+
+    ///
+    /// \brief Swaps two constraints
+    ///
+    virtual void swapConstraints(const size_t i, const size_t j) = 0;
+
+    ///
+    /// \brief Drops the last constraint
+    ///
+    virtual void popBack() = 0;
+
+    ///
+    /// \brief Swaps two constraints and their entries in the vertex to constraint index
+    ///
+    void swapIndexedConstraints(const size_t i, const size_t j);
+
+    ///
+    /// \brief Add/remove the i'th constraint to/from the vertex to constraint index
+    ///
+    void indexConstraint(const size_t i);
+    void unindexConstraint(const size_t i);
+
+    ///
+    /// \brief Rebuilds the vertex to constraint index, ie: after a reorder
+    ///
+    void rebuildIndex();
+
+    std::vector<size_t> m_partitionOffsets = { 0 }; ///> Partition start offsets, last is start of unpartitioned range
+    std::vector<std::vector<size_t>> m_vertexConstraints; ///> Per vertex, indices of the constraints using it
+};
+
+///
+/// \class PbdConstraintBatchBase
+///
+/// \brief Storage for a batch of constraints with N vertices and per constraint
+/// rest data of type DataType. Implements the generic (xPBD/PBD) projection, correction,
+/// residual and lambda loops once. Derived (CRTP) only provides the constraint kernel
+///
+///     template<typename T>
+///     bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+///
+/// giving the value and gradient of the i'th constraint. The call is not virtual. Every
+/// batch explicitly instantiates its base in the translation unit defining the kernel (and
+/// declares it extern in its header), such that the kernel can be inlined in the loops.
+/// Derived may also hide getSimdKernel to project partitions with one of the
+/// PbdConstraintSimd::project* functions
+///
+template<typename Derived, int N, typename DataType>
+class PbdConstraintBatchBase : public PbdConstraintBatch
+{
+public:
+    PbdConstraintBatchBase() = default;
+    ~PbdConstraintBatchBase() override = default;
+
+public:
+    size_t size() const override { return m_vertexIds.size(); }
+
+    size_t getNumVertices() const override { return N; }
+
+    const size_t* getVertexIds(const size_t i) const override { return m_vertexIds[i].data(); }
+
+    void zeroOutLambdas() override { std::fill(m_lambdas.begin(), m_lambdas.end(), 0.0); }
+
+    void scaleLambdas(const double scale) override
+    {
+        for (double& lambda : m_lambdas)
+        {
+            lambda *= scale;
+        }
+    }
+
+    bool append(const PbdConstraintBatch& other, const size_t vertexOffset) override
+    {
+        if (typeid(other) != typeid(*this))
+        {
+            return false;
+        }
+        const auto& batch = static_cast<const PbdConstraintBatchBase&>(other);
+        if (batch.size() == 0)
+        {
+            return true;
+        }
+        if ((size() > 0 && m_epsilon != batch.m_epsilon) || !acceptParameters(other))
+        {
+            return false;
+        }
+
+        m_epsilon = batch.m_epsilon;
+        reserve(size() + batch.size());
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            std::array<size_t, N> ids = batch.m_vertexIds[i];
+            for (size_t& id : ids)
+            {
+                id += vertexOffset;
+            }
+            push_back(ids, batch.m_restData[i], batch.m_stiffness[i], batch.m_compliance[i]);
+        }
+        return true;
+    }
+
+    void projectConstraints(const size_t begin, const size_t end,
+                            const DataArray<double>& invMasses, const double dt,
+                            const PbdConstraint::SolverType& type, VecDataArray<double, 3>& pos) override
+    {
+        projectConstraintsSimdImpl(begin, end, invMasses, dt, type, pos);
+    }
+
+    void projectConstraints(const size_t begin, const size_t end,
+                            const DataArray<float>& invMasses, const double dt,
+                            const PbdConstraint::SolverType& type, VecDataArray<float, 3>& pos) override
+    {
+        projectConstraintsSimdImpl(begin, end, invMasses, dt, type, pos);
+    }
+
+    void computePositionCorrections(const size_t begin, const size_t end,
+                                    const DataArray<double>& invMasses, const double dt,
+                                    const PbdConstraint::SolverType& type, const VecDataArray<double, 3>& pos,
+                                    Vec3d* dx) override
+    {
+        const double invDt2 = (dt > 0.0) ? 1.0 / (dt * dt) : 0.0;
+        for (size_t i = begin; i < end; i++)
+        {
+            Vec3d* constraintDx = dx + (i - begin) * N;
+            if (!computeCorrection(i, invMasses, invDt2, type, pos, constraintDx))
+            {
+                std::fill_n(constraintDx, N, Vec3d::Zero());
+            }
+        }
+    }
+
+    void computeResiduals(const size_t begin, const size_t end,
+                          const VecDataArray<double, 3>& pos, const double dt,
+                          const PbdConstraint::SolverType& type, double* residuals) override
+    {
+        computeResidualsImpl(begin, end, pos, dt, type, residuals);
+    }
+
+    void computeResiduals(const size_t begin, const size_t end,
+                          const VecDataArray<float, 3>& pos, const double dt,
+                          const PbdConstraint::SolverType& type, double* residuals) override
+    {
+        computeResidualsImpl(begin, end, pos, dt, type, residuals);
+    }
+
+    void applyLambdas(const size_t begin, const size_t end,
+                      const DataArray<double>& invMasses, VecDataArray<double, 3>& pos) override
+    {
+        std::array<Vec3d, N> dcdx;
+        for (size_t i = begin; i < end; i++)
+        {
+            double c = 0.0;
+            if (m_lambdas[i] == 0.0 || !derived().computeValueAndGradient(i, pos, c, dcdx.data()))
+            {
+                continue;
+            }
+
+            const std::array<size_t, N>& ids = m_vertexIds[i];
+            for (int j = 0; j < N; j++)
+            {
+                if (invMasses[ids[j]] > 0.0)
+                {
+                    pos[ids[j]] += invMasses[ids[j]] * m_lambdas[i] * dcdx[j];
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief Reserve space for n constraints
+    ///
+    void reserve(const size_t n)
+    {
+        m_vertexIds.reserve(n);
+        m_restData.reserve(n);
+        m_stiffness.reserve(n);
+        m_compliance.reserve(n);
+        m_lambdas.reserve(n);
+    }
+
+protected:
+    ///
+    /// \brief Returns the simd kernel projecting several independent constraints at
+    /// once, nullptr when there is none. Hidden by Derived, it is only valid for batches
+    /// whose rest data is a single double
+    ///
+    template<typename T>
+    static PbdConstraintSimd::ProjectFunc<T> getSimdKernel() { return nullptr; }
+
+    ///
+    /// \brief Appends a constraint given its ids, rest data and stiffness
+    ///
+    void push_back(const std::array<size_t, N>& ids, const DataType& restData,
+                   const double stiffness, const double compliance)
+    {
+        m_vertexIds.push_back(ids);
+        m_restData.push_back(restData);
+        m_stiffness.push_back(stiffness);
+        m_compliance.push_back(compliance);
+        m_lambdas.push_back(0.0);
+        indexConstraint(size() - 1);
+    }
+
+    ///
+    /// \brief Returns if the constraint tolerance matches the one of the batch,
+    /// the first constraint added sets the tolerance of the batch
+    ///
+    bool acceptTolerance(const PbdConstraint& constraint)
+    {
+        if (size() == 0)
+        {
+            m_epsilon = constraint.getTolerance();
+            return true;
+        }
+        return m_epsilon == constraint.getTolerance();
+    }
+
+    ///
+    /// \brief Copies the vertex ids of a generic constraint
+    ///
+    static std::array<size_t, N> getIds(const PbdConstraint& constraint)
+    {
+        std::array<size_t, N> ids;
+        std::copy_n(constraint.getVertexIds().begin(), N, ids.begin());
+        return ids;
+    }
+
+    void reorder(const std::vector<size_t>& order) override
+    {
+        permute(m_vertexIds, order);
+        permute(m_restData, order);
+        permute(m_stiffness, order);
+        permute(m_compliance, order);
+        permute(m_lambdas, order);
+    }
+
+    void swapConstraints(const size_t i, const size_t j) override
+    {
+        std::swap(m_vertexIds[i], m_vertexIds[j]);
+        std::swap(m_restData[i], m_restData[j]);
+        std::swap(m_stiffness[i], m_stiffness[j]);
+        std::swap(m_compliance[i], m_compliance[j]);
+        std::swap(m_lambdas[i], m_lambdas[j]);
+    }
+
+    void popBack() override
+    {
+        m_vertexIds.pop_back();
+        m_restData.pop_back();
+        m_stiffness.pop_back();
+        m_compliance.pop_back();
+        m_lambdas.pop_back();
+    }
+
+private:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+    ///
+    /// \brief Rest values as seen by the simd kernels, only batches with a single double
+    /// of rest data per constraint have them
+    ///
+    static const double* getRestValues(const double* restData) { return restData; }
+    template<typename U>
+    static const double* getRestValues(const U*) { return nullptr; }
+
+    ///
+    /// \brief Computes the position correction of every vertex of the i'th constraint
+    /// and updates its Lagrange multiplier. Positions may be stored in single
+    /// precision (T = float), the correction is computed in double
+    /// \return false if there is nothing to correct
+    ///
+    template<typename T>
+    bool computeCorrection(const size_t i, const DataArray<T>& invMasses, const double invDt2,
+                           const PbdConstraint::SolverType& type, const VecDataArray<T, 3>& pos,
+                           Vec3d* dx)
+    {
+        // Nothing moves when every vertex is fixed (or sleeping), skip the kernel
+        const std::array<size_t, N>& ids = m_vertexIds[i];
+        std::array<double, N>        w;
+        bool                         isMovable = false;
+        for (int j = 0; j < N; j++)
+        {
+            w[j]       = invMasses[ids[j]];
+            isMovable |= (w[j] != 0.0);
+        }
+        if (!isMovable)
+        {
+            return false;
+        }
+
+        std::array<Vec3d, N> dcdx;
+        double               c = 0.0;
+        if (!derived().computeValueAndGradient(i, pos, c, dcdx.data()))
+        {
+            return false;
+        }
+
+        double dcMidc = 0.0;
+        for (int j = 0; j < N; j++)
+        {
+            dcMidc += w[j] * dcdx[j].squaredNorm();
+        }
+        if (dcMidc < IMSTK_DOUBLE_EPS)
+        {
+            return false;
+        }
+
+        double dLambda;
+        if (type == PbdConstraint::SolverType::PBD)
+        {
+            dLambda = -c * m_stiffness[i] / dcMidc;
+        }
+        else
+        {
+            const double alpha = m_compliance[i] * invDt2;
+            dLambda       = -(c + alpha * m_lambdas[i]) / (dcMidc + alpha);
+            m_lambdas[i] += dLambda;
+        }
+
+        for (int j = 0; j < N; j++)
+        {
+            dx[j] = w[j] * dLambda * dcdx[j];
+        }
+        return true;
+    }
+
+    ///
+    /// \brief Projects the constraints in [begin, end) sequentially
+    ///
+    template<typename T>
+    void projectConstraintsImpl(const size_t begin, const size_t end,
+                                const DataArray<T>& invMasses, const double dt,
+                                const PbdConstraint::SolverType& type, VecDataArray<T, 3>& pos)
+    {
+        const double         invDt2 = (dt > 0.0) ? 1.0 / (dt * dt) : 0.0;
+        std::array<Vec3d, N> dx;
+        for (size_t i = begin; i < end; i++)
+        {
+            if (!computeCorrection(i, invMasses, invDt2, type, pos, dx.data()))
+            {
+                continue;
+            }
+
+            const std::array<size_t, N>& ids = m_vertexIds[i];
+            for (int j = 0; j < N; j++)
+            {
+                if (invMasses[ids[j]] > 0.0)
+                {
+                    pos[ids[j]] += dx[j].template cast<T>();
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief Same as projectConstraintsImpl but, when Derived has a simd kernel, constraints
+    /// within a partition, being independent, are first handed to it to project several at once
+    ///
+    template<typename T>
+    void projectConstraintsSimdImpl(const size_t begin, const size_t end,
+                                    const DataArray<T>& invMasses, const double dt,
+                                    const PbdConstraint::SolverType& type, VecDataArray<T, 3>& pos)
+    {
+        const PbdConstraintSimd::ProjectFunc<T> simdKernel = Derived::template getSimdKernel<T>();
+        if (simdKernel == nullptr || begin >= end)
+        {
+            projectConstraintsImpl(begin, end, invMasses, dt, type, pos);
+            return;
+        }
+
+        PbdConstraintSimd::BatchView batchView;
+        batchView.vertexIds  = m_vertexIds.data()->data();
+        batchView.restValues = getRestValues(m_restData.data());
+        batchView.stiffness  = m_stiffness.data();
+        batchView.compliance = m_compliance.data();
+        batchView.lambdas    = m_lambdas.data();
+        batchView.epsilon    = m_epsilon;
+
+        PbdConstraintSimd::SolveView<T> solveView;
+        solveView.invMasses = &invMasses[0];
+        solveView.positions = pos.getPointer()->data();
+        solveView.dt  = dt;
+        solveView.pbd = (type == PbdConstraint::SolverType::PBD);
+
+        // Partitions are processed one after the other, lanes never cross them
+        size_t i = begin;
+        for (size_t p = 0; p < getNumPartitions() && i < end; p++)
+        {
+            const size_t partitionEnd = std::min(end, m_partitionOffsets[p + 1]);
+            if (i < partitionEnd)
+            {
+                const size_t simdEnd = simdKernel(batchView, solveView, i, partitionEnd);
+                projectConstraintsImpl(simdEnd, partitionEnd, invMasses, dt, type, pos);
+                i = partitionEnd;
+            }
+        }
+
+        // Unpartitioned constraints are sequential
+        projectConstraintsImpl(i, end, invMasses, dt, type, pos);
+    }
+
+    ///
+    /// \brief Computes the residuals of the constraints in range [begin, end), see computeResiduals
+    ///
+    template<typename T>
+    void computeResidualsImpl(const size_t begin, const size_t end,
+                              const VecDataArray<T, 3>& pos, const double dt,
+                              const PbdConstraint::SolverType& type, double* residuals) const
+    {
+        const double         invDt2 = (dt > 0.0) ? 1.0 / (dt * dt) : 0.0;
+        std::array<Vec3d, N> dcdx;
+        for (size_t i = begin; i < end; i++)
+        {
+            double c = 0.0;
+            if (!derived().computeValueAndGradient(i, pos, c, dcdx.data()))
+            {
+                residuals[i - begin] = 0.0;
+            }
+            else if (type == PbdConstraint::SolverType::PBD)
+            {
+                residuals[i - begin] = std::abs(c);
+            }
+            else
+            {
+                residuals[i - begin] = std::abs(c + m_compliance[i] * invDt2 * m_lambdas[i]);
+            }
+        }
+    }
+
+    template<typename T, typename Alloc>
+    static void permute(std::vector<T, Alloc>& values, const std::vector<size_t>& order)
+    {
+        std::vector<T, Alloc> results;
+        results.reserve(order.size());
+        for (const size_t i : order)
+        {
+            results.push_back(values[i]);
+        }
+        values = std::move(results);
+    }
+
+protected:
+    std::vector<std::array<size_t, N>> m_vertexIds;                               ///> Vertex ids per constraint
+    std::vector<DataType, Eigen::aligned_allocator<DataType>> m_restData;         ///> Rest value(s) per constraint
+    std::vector<double> m_stiffness;                                              ///> Used in PBD
+    std::vector<double> m_compliance;                                             ///> Used in xPBD
+    std::vector<double> m_lambdas;                                                ///> Lagrange multipliers
+    double m_epsilon = 1.0e-16;                                                   ///> Tolerance shared by all constraints in the batch
+};
+}
@@ -21,57 +21,451 @@
 
 #include "imstkPbdConstraintContainer.h"
 #include "imstkGraph.h"
-
-#include <unordered_map>
+#include "imstkLogger.h"
+#include "imstkPbdAreaConstraint.h"
+#include "imstkPbdBendConstraint.h"
+#include "imstkPbdDihedralConstraint.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdFEMTetConstraint.h"
+#include "imstkPbdVolumeConstraint.h"
 
 namespace imstk
 {
+///
+/// \brief Creates an empty batch for the given constraint type, nullptr if not supported
+///
+static std::shared_ptr<PbdConstraintBatch>
+makeConstraintBatch(const std::string& type)
+{
+    if (type == "Distance")
+    {
+        return std::make_shared<PbdDistanceConstraintBatch>();
+    }
+    else if (type == "Dihedral")
+    {
+        return std::make_shared<PbdDihedralConstraintBatch>();
+    }
+    else if (type == "Volume")
+    {
+        return std::make_shared<PbdVolumeConstraintBatch>();
+    }
+    else if (type == "Area")
+    {
+        return std::make_shared<PbdAreaConstraintBatch>();
+    }
+    else if (type == "Bend")
+    {
+        return std::make_shared<PbdBendConstraintBatch>();
+    }
+    else if (type == "FEMTet")
+    {
+        return std::make_shared<PbdFEMTetConstraintBatch>();
+    }
+    return nullptr;
+}
+
 void
 PbdConstraintContainer::addConstraint(std::shared_ptr<PbdConstraint> constraint)
 {
     m_constraintLock.lock();
-    m_constraints.push_back(constraint);
+
+    // Once partitioned, new constraints are greedily colored against the
+    // constraints already using their vertices instead of being solved sequentially,
+    // a new partition is opened when all of them are taken
+    const auto vertexIds = constraint->getVertexIds();
+    int        partition = -1;
+    if (m_partitioned)
+    {
+        partition = findFreePartition(vertexIds.data(), vertexIds.size());
+        if (partition == -1)
+        {
+            partition = m_numPartitions++;
+        }
+    }
+
+    if (m_storageMode != StorageMode::Batched || !addToBatch(*constraint, partition))
+    {
+        if (partition == -1)
+        {
+            m_constraints.push_back(constraint);
+            indexConstraint(constraint.get(), partition, m_constraints.size() - 1);
+        }
+        else
+        {
+            if (static_cast<size_t>(partition) >= m_partitionedConstraints.size())
+            {
+                m_partitionedConstraints.resize(static_cast<size_t>(partition) + 1);
+            }
+            m_partitionedConstraints[partition].push_back(constraint);
+            indexConstraint(constraint.get(), partition, m_partitionedConstraints[partition].size() - 1);
+        }
+    }
+    if (partition != -1)
+    {
+        markPartition(vertexIds.data(), vertexIds.size(), partition);
+    }
+    m_modifiedCount++;
     m_constraintLock.unlock();
 }
 
+bool
+PbdConstraintContainer::addToBatch(const PbdConstraint& constraint, const int partition)
+{
+    std::shared_ptr<PbdConstraintBatch> batch = nullptr;
+    for (auto& b : m_batches)
+    {
+        if (b->addConstraint(constraint))
+        {
+            batch = b;
+            break;
+        }
+    }
+
+    // No batch accepts it, try a new one
+    if (batch == nullptr)
+    {
+        batch = makeConstraintBatch(constraint.getType());
+        if (batch == nullptr || !batch->addConstraint(constraint))
+        {
+            return false;
+        }
+        m_batches.push_back(batch);
+    }
+
+    if (partition != -1)
+    {
+        batch->moveToPartition(batch->size() - 1, static_cast<size_t>(partition));
+    }
+    return true;
+}
+
+int
+PbdConstraintContainer::findFreePartition(const size_t* vertexIds, const size_t numVertices) const
+{
+    for (int p = 0; p < m_numPartitions; p++)
+    {
+        bool isFree = true;
+        for (size_t i = 0; i < numVertices && isFree; i++)
+        {
+            if (vertexIds[i] < m_vertexPartitions.size())
+            {
+                const std::vector<int>& partitions = m_vertexPartitions[vertexIds[i]];
+                isFree = std::find(partitions.begin(), partitions.end(), p) == partitions.end();
+            }
+        }
+        if (isFree)
+        {
+            return p;
+        }
+    }
+    return -1;
+}
+
 void
-PbdConstraintContainer::removeConstraint(std::shared_ptr<PbdConstraint> constraint)
+PbdConstraintContainer::partitionBatchConstraints(PbdConstraintBatch& batch, const size_t first)
 {
+    // Moving a constraint to a partition only swaps constraints before it, the ones
+    // after it are still to be partitioned
+    const size_t numVertices = batch.getNumVertices();
+    for (size_t i = first; i < batch.size(); i++)
+    {
+        int partition = findFreePartition(batch.getVertexIds(i), numVertices);
+        if (partition == -1)
+        {
+            partition = m_numPartitions++;
+        }
+        markPartition(batch.getVertexIds(i), numVertices, partition);
+        batch.moveToPartition(i, static_cast<size_t>(partition));
+    }
+}
+
+void
+PbdConstraintContainer::markPartition(const size_t* vertexIds, const size_t numVertices, const int partition)
+{
+    for (size_t i = 0; i < numVertices; i++)
+    {
+        if (vertexIds[i] >= m_vertexPartitions.size())
+        {
+            m_vertexPartitions.resize(vertexIds[i] + 1);
+        }
+        m_vertexPartitions[vertexIds[i]].push_back(partition);
+    }
+}
+
+void
+PbdConstraintContainer::unmarkPartition(const size_t* vertexIds, const size_t numVertices, const int partition)
+{
+    for (size_t i = 0; i < numVertices; i++)
+    {
+        std::vector<int>& partitions = m_vertexPartitions[vertexIds[i]];
+        auto              iter       = std::find(partitions.begin(), partitions.end(), partition);
+        if (iter != partitions.end())
+        {
+            *iter = partitions.back();
+            partitions.pop_back();
+        }
+    }
+}
+
+void
+PbdConstraintContainer::indexConstraint(const PbdConstraint* constraint, const int partition, const size_t i)
+{
+    m_constraintLocations[constraint] = std::make_pair(partition, i);
+    for (const size_t vid : constraint->getVertexIds())
+    {
+        if (vid >= m_vertexConstraints.size())
+        {
+            m_vertexConstraints.resize(vid + 1);
+        }
+        m_vertexConstraints[vid].push_back(constraint);
+    }
+}
+
+void
+PbdConstraintContainer::unindexConstraint(const PbdConstraint* constraint)
+{
+    m_constraintLocations.erase(constraint);
+    for (const size_t vid : constraint->getVertexIds())
+    {
+        std::vector<const PbdConstraint*>& constraints = m_vertexConstraints[vid];
+        auto                               iter = std::find(constraints.begin(), constraints.end(), constraint);
+        if (iter != constraints.end())
+        {
+            *iter = constraints.back();
+            constraints.pop_back();
+        }
+    }
+}
+
+const std::vector<const PbdConstraint*>&
+PbdConstraintContainer::getVertexConstraints(const size_t vertexId) const
+{
+    static const std::vector<const PbdConstraint*> empty;
+    return (vertexId < m_vertexConstraints.size()) ? m_vertexConstraints[vertexId] : empty;
+}
+
+void
+PbdConstraintContainer::rebuildIndex()
+{
+    m_constraintLocations.clear();
+    m_vertexConstraints.clear();
+    for (size_t i = 0; i < m_constraints.size(); i++)
+    {
+        indexConstraint(m_constraints[i].get(), -1, i);
+    }
+    for (size_t p = 0; p < m_partitionedConstraints.size(); p++)
+    {
+        for (size_t i = 0; i < m_partitionedConstraints[p].size(); i++)
+        {
+            indexConstraint(m_partitionedConstraints[p][i].get(), static_cast<int>(p), i);
+        }
+    }
+}
+
+void
+PbdConstraintContainer::removeConstraintAt(const int partition, const size_t i)
+{
+    std::vector<std::shared_ptr<PbdConstraint>>& constraints =
+        (partition == -1) ? m_constraints : m_partitionedConstraints[partition];
+    const auto vertexIds = constraints[i]->getVertexIds();
+    if (partition != -1)
+    {
+        unmarkPartition(vertexIds.data(), vertexIds.size(), partition);
+    }
+    unindexConstraint(constraints[i].get());
+
+    if (i + 1 != constraints.size())
+    {
+        constraints[i] = std::move(constraints.back());
+        m_constraintLocations[constraints[i].get()].second = i;
+    }
+    constraints.pop_back();
+    m_modifiedCount++;
+}
+
+void
+PbdConstraintContainer::appendBatches(const PbdConstraintContainer& other, const size_t vertexOffset)
+{
+    setStorageMode(StorageMode::Batched);
+
     m_constraintLock.lock();
-    iterator i = std::find(m_constraints.begin(), m_constraints.end(), constraint);
-    if (i != m_constraints.end())
+    for (const auto& otherBatch : other.getBatches())
     {
-        m_constraints.erase(i);
+        std::shared_ptr<PbdConstraintBatch> appendedBatch = nullptr;
+        size_t                              first = 0;
+        for (auto& batch : m_batches)
+        {
+            first = batch->size();
+            if (batch->append(*otherBatch, vertexOffset))
+            {
+                appendedBatch = batch;
+                break;
+            }
+        }
+
+        // No batch accepts them, copy into a new one
+        if (appendedBatch == nullptr)
+        {
+            std::shared_ptr<PbdConstraintBatch> batch = makeConstraintBatch(otherBatch->getType());
+            first = 0;
+            if (batch != nullptr && batch->append(*otherBatch, vertexOffset))
+            {
+                m_batches.push_back(batch);
+                appendedBatch = batch;
+            }
+        }
+
+        if (m_partitioned && appendedBatch != nullptr)
+        {
+            partitionBatchConstraints(*appendedBatch, first);
+        }
     }
+    m_modifiedCount++;
     m_constraintLock.unlock();
 }
 
 void
-PbdConstraintContainer::removeConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
+PbdConstraintContainer::setStorageMode(const StorageMode mode)
+{
+    if (mode == m_storageMode)
+    {
+        return;
+    }
+    if (mode == StorageMode::Polymorphic)
+    {
+        LOG_IF(WARNING, !m_batches.empty()) << "Batched constraints cannot be converted back to polymorphic constraints";
+        if (m_batches.empty())
+        {
+            m_storageMode = mode;
+        }
+        return;
+    }
+
+    m_constraintLock.lock();
+    m_storageMode = mode;
+
+    // Move every supported constraint into batches, partitions are invalidated
+    clearPartitions();
+    std::vector<std::shared_ptr<PbdConstraint>> constraints = std::move(m_constraints);
+    m_constraints.clear();
+    for (auto& constraint : constraints)
+    {
+        if (!addToBatch(*constraint, -1))
+        {
+            m_constraints.push_back(constraint);
+        }
+    }
+    rebuildIndex();
+    m_modifiedCount++;
+    m_constraintLock.unlock();
+}
+
+const bool
+PbdConstraintContainer::empty() const
 {
-    // Remove constraints that contain the given vertices
-    auto removeConstraintFunc = [&](std::shared_ptr<PbdConstraint> constraint)
-                                {
-                                    for (auto i : constraint->getVertexIds())
-                                    {
-                                        if (vertices->find(i) != vertices->end())
-                                        {
-                                            return true;
-                                        }
-                                    }
-                                    return false;
-                                };
+    if (!m_constraints.empty())
+    {
+        return false;
+    }
+    for (const auto& partition : m_partitionedConstraints)
+    {
+        if (!partition.empty())
+        {
+            return false;
+        }
+    }
+    for (const auto& batch : m_batches)
+    {
+        if (batch->size() != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+PbdConstraintContainer::clearPartitions()
+{
+    // Partitioned constraints go back to be solved sequentially
+    for (auto& partition : m_partitionedConstraints)
+    {
+        m_constraints.insert(m_constraints.end(), partition.begin(), partition.end());
+    }
+    m_partitionedConstraints.clear();
+    for (auto& batch : m_batches)
+    {
+        batch->setPartitions(std::vector<int>(batch->size(), -1), 0);
+    }
+
+    m_vertexPartitions.clear();
+    m_numPartitions = 0;
+    m_partitioned   = false;
+    rebuildIndex();
+    m_modifiedCount++;
+}
 
+void
+PbdConstraintContainer::removeConstraint(std::shared_ptr<PbdConstraint> constraint)
+{
     m_constraintLock.lock();
-    m_constraints.erase(std::remove_if(m_constraints.begin(), m_constraints.end(), removeConstraintFunc),
-        m_constraints.end());
+    auto iter = m_constraintLocations.find(constraint.get());
+    if (iter != m_constraintLocations.end())
+    {
+        removeConstraintAt(iter->second.first, iter->second.second);
+    }
+    m_constraintLock.unlock();
+}
 
-    // Also remove partitioned constraints
-    for (auto& pc : m_partitionedConstraints)
+void
+PbdConstraintContainer::removeVertexConstraints(const size_t vid)
+{
+    // Polymorphic constraints are found from the vertex to constraint index, removing
+    // them frees their partition for the vertices they used
+    while (vid < m_vertexConstraints.size() && !m_vertexConstraints[vid].empty())
     {
-        pc.erase(std::remove_if(pc.begin(), pc.end(), removeConstraintFunc), pc.end());
+        const std::pair<int, size_t>& location = m_constraintLocations.at(m_vertexConstraints[vid].back());
+        removeConstraintAt(location.first, location.second);
     }
 
+    // And the batched constraints
+    for (auto& batch : m_batches)
+    {
+        const size_t               numVertices = batch->getNumVertices();
+        const std::vector<size_t>& constraints = batch->getVertexConstraints(vid);
+        while (!constraints.empty())
+        {
+            const size_t i         = constraints.back();
+            const int    partition = batch->getPartition(i);
+            if (m_partitioned && partition != -1)
+            {
+                unmarkPartition(batch->getVertexIds(i), numVertices, partition);
+            }
+            batch->removeConstraint(i);
+            m_modifiedCount++;
+        }
+    }
+}
+
+void
+PbdConstraintContainer::removeConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
+{
+    m_constraintLock.lock();
+    for (const size_t vid : *vertices)
+    {
+        removeVertexConstraints(vid);
+    }
+    m_constraintLock.unlock();
+}
+
+void
+PbdConstraintContainer::removeConstraints(const size_t firstVertex, const size_t lastVertex)
+{
+    m_constraintLock.lock();
+    for (size_t vid = firstVertex; vid < lastVertex; vid++)
+    {
+        removeVertexConstraints(vid);
+    }
     m_constraintLock.unlock();
 }
 
@@ -79,115 +473,143 @@ PbdConstraintContainer::iterator
 PbdConstraintContainer::eraseConstraint(iterator iter)
 {
     m_constraintLock.lock();
-    iterator newIter = m_constraints.erase(iter);
+    const size_t i = static_cast<size_t>(std::distance(m_constraints.begin(), iter));
+    removeConstraintAt(-1, i);
     m_constraintLock.unlock();
-    return newIter;
+    return m_constraints.begin() + i;
 }
 
 PbdConstraintContainer::const_iterator
 PbdConstraintContainer::eraseConstraint(const_iterator iter)
 {
     m_constraintLock.lock();
-    const_iterator newIter = m_constraints.erase(iter);
+    const size_t i = static_cast<size_t>(std::distance(m_constraints.cbegin(), iter));
+    removeConstraintAt(-1, i);
     m_constraintLock.unlock();
-    return newIter;
+    return m_constraints.cbegin() + i;
 }
 
 void
 PbdConstraintContainer::partitionConstraints(const int partitionedThreshold)
 {
-    // Form the map { vertex : list_of_constraints_involve_vertex }
-    std::vector<std::shared_ptr<PbdConstraint>>& allConstraints = m_constraints;
+    // Gather every polymorphic constraint, previously partitioned ones included
+    std::vector<std::shared_ptr<PbdConstraint>> allConstraints = std::move(m_constraints);
+    m_constraints.clear();
+    for (auto& partition : m_partitionedConstraints)
+    {
+        allConstraints.insert(allConstraints.end(), partition.begin(), partition.end());
+    }
+    m_partitionedConstraints.clear();
 
-    //std::cout << "---------partitionConstraints: " << allConstraints.size() << std::endl;
+    // Batched constraints are numbered after the polymorphic ones
+    std::vector<size_t> batchStarts(m_batches.size());
+    size_t              numNodes = allConstraints.size();
+    for (size_t i = 0; i < m_batches.size(); i++)
+    {
+        batchStarts[i] = numNodes;
+        numNodes      += m_batches[i]->size();
+    }
 
-    std::unordered_map<size_t, std::vector<size_t>> vertexConstraints;
+    // List the vertices of every constraint, constraints sharing a vertex are connected
+    // in the constraint graph
+    std::vector<size_t> constraintVertexOffsets(numNodes + 1, 0);
+    std::vector<size_t> constraintVertices;
     for (size_t constrIdx = 0; constrIdx < allConstraints.size(); ++constrIdx)
     {
-        const auto& constr = allConstraints[constrIdx];
-        for (const auto& vIds : constr->getVertexIds())
-        {
-            vertexConstraints[vIds].push_back(constrIdx);
-        }
+        const auto vIds = allConstraints[constrIdx]->getVertexIds();
+        constraintVertices.insert(constraintVertices.end(), vIds.begin(), vIds.end());
+        constraintVertexOffsets[constrIdx + 1] = constraintVertices.size();
     }
-
-    // Add edges to the constraint graph
-    // Each edge represent a shared vertex between two constraints
-    Graph constraintGraph(allConstraints.size());
-    for (const auto& kv : vertexConstraints)
+    for (size_t i = 0; i < m_batches.size(); i++)
     {
-        const auto& constraints = kv.second;     // the list of constraints for a vertex
-        for (size_t i = 0; i < constraints.size(); ++i)
+        const PbdConstraintBatch& batch    = *m_batches[i];
+        const size_t              numVerts = batch.getNumVertices();
+        for (size_t j = 0; j < batch.size(); j++)
         {
-            for (size_t j = i + 1; j < constraints.size(); ++j)
-            {
-                constraintGraph.addEdge(constraints[i], constraints[j]);
-            }
+            const size_t* vIds = batch.getVertexIds(j);
+            constraintVertices.insert(constraintVertices.end(), vIds, vIds + numVerts);
+            constraintVertexOffsets[batchStarts[i] + j + 1] = constraintVertices.size();
         }
     }
-    vertexConstraints.clear();
+
+    Graph constraintGraph(numNodes);
+    constraintGraph.setEdgesFromSharedKeys(constraintVertexOffsets, constraintVertices);
+    constraintVertices.clear();
 
     // do graph coloring for the constraint graph
-    const auto coloring = constraintGraph.doColoring(Graph::ColoringMethod::WelshPowell);
-    // const auto  coloring = constraintGraph.doColoring(Graph::ColoringMethod::Greedy);
+    const auto coloring = constraintGraph.doColoring(Graph::ColoringMethod::JonesPlassmann);
     const auto& partitionIndices = coloring.first;
-    const auto  numPartitions    = coloring.second;
-    assert(partitionIndices.size() == allConstraints.size());
-
-    std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_partitionedConstraints;
-    partitionedConstraints.resize(0);
-    partitionedConstraints.resize(static_cast<size_t>(numPartitions));
+    const auto  numColors = coloring.second;
+    assert(partitionIndices.size() == numNodes);
 
-    for (size_t constrIdx = 0; constrIdx < partitionIndices.size(); ++constrIdx)
+    // If a partition has size smaller than the partition threshold, then its constraints
+    // are processed sequentially because small size partitions yield bad performance upon
+    // running in parallel. Map colors to partitions, -1 for sequential
+    std::vector<size_t> colorSizes(static_cast<size_t>(numColors), 0);
+    for (const auto color : partitionIndices)
     {
-        const auto partitionIdx = partitionIndices[constrIdx];
-        partitionedConstraints[partitionIdx].push_back(allConstraints[constrIdx]);
+        colorSizes[color]++;
+    }
+    std::vector<int> colorToPartition(static_cast<size_t>(numColors), -1);
+    int              numPartitions = 0;
+    for (size_t color = 0; color < colorSizes.size(); ++color)
+    {
+        if (colorSizes[color] >= static_cast<size_t>(partitionedThreshold))
+        {
+            colorToPartition[color] = numPartitions++;
+        }
     }
 
-    // If a partition has size smaller than the partition threshold, then move its constraints back
-    // These constraints will be processed sequentially
-    // Because small size partitions yield bad performance upon running in parallel
-    allConstraints.resize(0);
-    for (const auto& constraints : partitionedConstraints)
+    m_partitionedConstraints.resize(static_cast<size_t>(numPartitions));
+    for (size_t constrIdx = 0; constrIdx < allConstraints.size(); ++constrIdx)
     {
-        if (constraints.size() < partitionedThreshold)
+        const int partitionIdx = colorToPartition[partitionIndices[constrIdx]];
+        if (partitionIdx == -1)
         {
-            for (size_t constrIdx = 0; constrIdx < constraints.size(); ++constrIdx)
-            {
-                allConstraints.push_back(std::move(constraints[constrIdx]));
-            }
+            m_constraints.push_back(std::move(allConstraints[constrIdx]));
+        }
+        else
+        {
+            m_partitionedConstraints[partitionIdx].push_back(std::move(allConstraints[constrIdx]));
         }
     }
 
-    // Remove all empty partitions
-    size_t writeIdx = 0;
-    for (size_t readIdx = 0; readIdx < partitionedConstraints.size(); ++readIdx)
+    // Batches share the partition numbering, partition p of any batch has no vertex in
+    // common with partition p of another batch nor with the polymorphic partition p
+    for (size_t i = 0; i < m_batches.size(); i++)
     {
-        if (partitionedConstraints[readIdx].size() >= partitionedThreshold)
+        std::vector<int> batchPartitions(m_batches[i]->size());
+        for (size_t j = 0; j < batchPartitions.size(); j++)
         {
-            if (readIdx != writeIdx)
-            {
-                partitionedConstraints[writeIdx] = std::move(partitionedConstraints[readIdx]);
-            }
-            ++writeIdx;
+            batchPartitions[j] = colorToPartition[partitionIndices[batchStarts[i] + j]];
         }
+        m_batches[i]->setPartitions(batchPartitions, static_cast<size_t>(numPartitions));
     }
-    partitionedConstraints.resize(writeIdx);
 
-    // Print
-    /*if (print)
+    // Keep the partitions used per vertex to color constraints added later
+    m_vertexPartitions.clear();
+    for (size_t p = 0; p < m_partitionedConstraints.size(); p++)
+    {
+        for (const auto& constraint : m_partitionedConstraints[p])
+        {
+            const auto vertexIds = constraint->getVertexIds();
+            markPartition(vertexIds.data(), vertexIds.size(), static_cast<int>(p));
+        }
+    }
+    for (const auto& batch : m_batches)
     {
-        size_t numConstraints = 0;
-        int    idx = 0;
-        for (const auto& constraints : partitionedConstraints)
+        const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+        for (size_t p = 0; p < batch->getNumPartitions(); p++)
         {
-            std::cout << "Partition # " << idx++ << " | # nodes: " << constraints.size() << std::endl;
-            numConstraints += constraints.size();
+            for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+            {
+                markPartition(batch->getVertexIds(i), batch->getNumVertices(), static_cast<int>(p));
+            }
         }
-        std::cout << "Sequential processing # nodes: " << allConstraints.size() << std::endl;
-        numConstraints += allConstraints.size();
-        std::cout << "Total constraints: " << numConstraints << " | Graph size: "
-            << constraintGraph.size() << std::endl;
-    }*/
+    }
+    m_numPartitions = numPartitions;
+    m_partitioned   = true;
+    rebuildIndex();
+    m_modifiedCount++;
+}
 }
-}
\ No newline at end of file
@@ -21,8 +21,9 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 namespace imstk
@@ -30,10 +31,22 @@ namespace imstk
 ///
 /// \class PbdConstraintContainer
 ///
-/// \brief Container for pbd constraints
+/// \brief Container for pbd constraints. Constraints are either stored individually
+/// (polymorphic) or, in batched mode, copied into type-bucketed batches where the
+/// type is supported. Constraints of unsupported types are always stored individually
 ///
 class PbdConstraintContainer
 {
+public:
+    ///
+    /// \brief How constraints added to the container are stored
+    ///
+    enum class StorageMode
+    {
+        Polymorphic, ///> Every constraint is stored as its own object
+        Batched      ///> Supported constraints are copied into PbdConstraintBatch's
+    };
+
 public:
     PbdConstraintContainer() = default;
     virtual ~PbdConstraintContainer() = default;
@@ -44,26 +57,46 @@ public:
 
 public:
     ///
-    /// \brief Adds a constraint to the system, thread safe
+    /// \brief Adds a constraint to the system, thread safe. Once partitioned, the
+    /// constraint is put in the first partition none of its vertices are used in,
+    /// if there is none a new partition is opened for it
     ///
     virtual void addConstraint(std::shared_ptr<PbdConstraint> constraint);
 
     ///
-    /// \brief Linear searches for and removes a constraint from the system, thread safe
+    /// \brief Removes a polymorphic constraint from the system in O(1), the last constraint
+    /// of its partition takes its place, thread safe
     ///
     virtual void removeConstraint(std::shared_ptr<PbdConstraint> constraint);
 
     ///
-    /// \brief Removes all constraints associated with vertex ids
+    /// \brief Removes all constraints associated with vertex ids, partitions stay valid.
+    /// Takes time proportional to the number of constraints removed
     ///
     virtual void removeConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices);
 
     ///
-    /// \brief Removes a constraint from the system by iterator, thread safe
+    /// \brief Removes all constraints associated with vertex ids in range [firstVertex, lastVertex),
+    /// partitions stay valid. Takes time proportional to the range and the number of constraints removed
+    ///
+    void removeConstraints(const size_t firstVertex, const size_t lastVertex);
+
+    ///
+    /// \brief Removes a constraint from the system by iterator, the last constraint takes
+    /// its place so the returned iterator points to the same position, thread safe
     ///
     virtual iterator eraseConstraint(iterator iter);
     virtual const_iterator eraseConstraint(const_iterator iter);
 
+    ///
+    /// \brief Copies the batches of another container with their vertex ids shifted by
+    /// vertexOffset, ie: to solve the constraints of several bodies whose vertices are
+    /// concatenated. Once partitioned, the copies are partitioned like added constraints,
+    /// its polymorphic constraints are not copied. Switches this container to batched
+    /// storage, thread safe
+    ///
+    void appendBatches(const PbdConstraintContainer& other, const size_t vertexOffset);
+
     ///
     /// \brief Reserve an amount of constraints in the pool, if you know
     /// ahead of time the number of constraints, or even an estimate, it
@@ -74,10 +107,11 @@ public:
     ///
     /// \brief Returns if there are no constraints
     ///
-    const bool empty() const { return m_constraints.empty() && m_partitionedConstraints.empty(); }
+    const bool empty() const;
 
     ///
-    /// \brief Get the underlying container
+    /// \brief Get the underlying container. Constraints must be added and removed through
+    /// the container to keep its vertex to constraint index valid
     ///
     const std::vector<std::shared_ptr<PbdConstraint>>& getConstraints() const { return m_constraints; }
     std::vector<std::shared_ptr<PbdConstraint>>& getConstraints() { return m_constraints; }
@@ -85,22 +119,109 @@ public:
     ///
     /// \brief Get the partitioned constraints
     ///
-    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>> getPartitionedConstraints() const { return m_partitionedConstraints; }
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& getPartitionedConstraints() const { return m_partitionedConstraints; }
+
+    ///
+    /// \brief Get the constraint batches, only used in batched mode
+    ///
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>& getBatches() const { return m_batches; }
+
+    ///
+    /// \brief Get the polymorphic constraints using the vertex, partitioned ones included,
+    /// the batched ones are indexed by their batch
+    ///
+    const std::vector<const PbdConstraint*>& getVertexConstraints(const size_t vertexId) const;
+
+    ///
+    /// \brief Set the storage mode. Switching to batched moves all supported
+    /// constraints into batches and clears the partitions. Batches cannot be
+    /// converted back to polymorphic constraints
+    ///
+    void setStorageMode(const StorageMode mode);
+
+    ///
+    /// \brief Get the storage mode
+    ///
+    StorageMode getStorageMode() const { return m_storageMode; }
+
+    ///
+    /// \brief Returns a count incremented every time constraints are added, removed or
+    /// reordered, ie: to find out whether copies of the constraints are out of date
+    ///
+    size_t getModifiedCount() const { return m_modifiedCount; }
 
     ///
-    /// \brief Partitions pbd constraints into separate vectors via graph coloring
+    /// \brief Partitions pbd constraints into separate vectors via graph coloring. After
+    /// this constraints added/removed update the partitions incrementally
     /// \param Minimum number of constraints in groups, any under will be dumped back into m_constraints
     ///
     void partitionConstraints(const int partitionThreshold);
 
     ///
-    /// \brief Clear the parition vectors
+    /// \brief Clear the parition vectors, all constraints become sequential
+    ///
+    void clearPartitions();
+
+protected:
+    ///
+    /// \brief Copies the constraint into a batch of its type and partition (-1 for
+    /// none), not thread safe
+    /// \return false if its type is not supported
+    ///
+    bool addToBatch(const PbdConstraint& constraint, const int partition);
+
+    ///
+    /// \brief Returns the first partition none of the vertices are used in, -1 if none
+    ///
+    int findFreePartition(const size_t* vertexIds, const size_t numVertices) const;
+
+    ///
+    /// \brief Puts the unpartitioned constraints of the batch from first on in the first
+    /// partition none of their vertices are used in, a new one if there is none
+    ///
+    void partitionBatchConstraints(PbdConstraintBatch& batch, const size_t first);
+
+    ///
+    /// \brief Mark/unmark the vertices as used in the partition
+    ///
+    void markPartition(const size_t* vertexIds, const size_t numVertices, const int partition);
+    void unmarkPartition(const size_t* vertexIds, const size_t numVertices, const int partition);
+
+    ///
+    /// \brief Add/remove a polymorphic constraint to/from the vertex to constraint index,
+    /// given its partition (-1 for none) and its index in it
+    ///
+    void indexConstraint(const PbdConstraint* constraint, const int partition, const size_t i);
+    void unindexConstraint(const PbdConstraint* constraint);
+
+    ///
+    /// \brief Removes all constraints using the vertex, not thread safe
+    ///
+    void removeVertexConstraints(const size_t vid);
+
+    ///
+    /// \brief Rebuilds the vertex to constraint index of the polymorphic constraints
+    ///
+    void rebuildIndex();
+
+    ///
+    /// \brief Removes the i'th polymorphic constraint of the partition (-1 for none) by
+    /// swapping it with the last one, not thread safe
     ///
-    void clearPartitions() { m_partitionedConstraints.clear(); }
+    void removeConstraintAt(const int partition, const size_t i);
 
 protected:
     std::vector<std::shared_ptr<PbdConstraint>> m_constraints;                         ///> Not partitioned constraints
     std::vector<std::vector<std::shared_ptr<PbdConstraint>>> m_partitionedConstraints; ///> Partitioned pbd constraints
+    std::vector<std::shared_ptr<PbdConstraintBatch>> m_batches;                        ///> Type-bucketed constraints, used in batched mode
+    StorageMode m_storageMode = StorageMode::Polymorphic;
+    size_t      m_modifiedCount = 0;                                                   ///> Incremented when constraints are added or removed
+
+    bool m_partitioned   = false;                                                      ///> Whether constraints were partitioned
+    int  m_numPartitions = 0;                                                          ///> Number of partitions shared by all constraints
+    std::vector<std::vector<int>> m_vertexPartitions;                                  ///> Partitions each vertex is used in
+    std::vector<std::vector<const PbdConstraint*>> m_vertexConstraints;                ///> Polymorphic constraints using each vertex
+    std::unordered_map<const PbdConstraint*, std::pair<int, size_t>> m_constraintLocations; ///> Partition (-1 for none) and index of the polymorphic constraints
     ParallelUtils::SpinLock m_constraintLock;                                          ///> Used to deal with concurrent addition/removal of constraints
 };
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdConstraintSimd.h"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define IMSTK_PBD_SIMD_CPUID_MSVC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define IMSTK_PBD_SIMD_CPUID_GNU
+#endif
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+///
+/// \brief Queries the cpu (and os) for AVX2/AVX-512F support
+///
+static InstructionSet
+detectInstructionSet()
+{
+    bool hasAVX2   = false;
+    bool hasAVX512 = false;
+#if defined(IMSTK_PBD_SIMD_CPUID_GNU)
+    __builtin_cpu_init();
+    hasAVX2   = __builtin_cpu_supports("avx2");
+    hasAVX512 = __builtin_cpu_supports("avx512f");
+#elif defined(IMSTK_PBD_SIMD_CPUID_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7)
+    {
+        __cpuid(info, 1);
+        // The os has to save the wider registers too
+        if ((info[2] & (1 << 27)) != 0)
+        {
+            const unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            hasAVX2   = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+            hasAVX512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+        }
+    }
+#endif
+
+    if (hasAVX512 && getAVX512Kernels() != nullptr)
+    {
+        return InstructionSet::AVX512;
+    }
+    if (hasAVX2 && getAVX2Kernels() != nullptr)
+    {
+        return InstructionSet::AVX2;
+    }
+    return InstructionSet::Scalar;
+}
+
+static std::atomic<InstructionSet>&
+selectedInstructionSet()
+{
+    static std::atomic<InstructionSet> selected(getSupportedInstructionSet());
+    return selected;
+}
+
+static const Kernels*
+getKernels()
+{
+    switch (selectedInstructionSet().load(std::memory_order_relaxed))
+    {
+    case InstructionSet::AVX512:
+        return getAVX512Kernels();
+    case InstructionSet::AVX2:
+        return getAVX2Kernels();
+    default:
+        return nullptr;
+    }
+}
+
+InstructionSet
+getSupportedInstructionSet()
+{
+    static const InstructionSet supported = detectInstructionSet();
+    return supported;
+}
+
+InstructionSet
+getInstructionSet()
+{
+    return selectedInstructionSet().load();
+}
+
+void
+setInstructionSet(const InstructionSet set)
+{
+    const InstructionSet supported = getSupportedInstructionSet();
+    selectedInstructionSet().store(static_cast<int>(set) > static_cast<int>(supported) ? supported : set);
+}
+
+size_t
+projectDistanceConstraints(const BatchView& batch, const SolveView<double>& solve, const size_t begin, const size_t end)
+{
+    const Kernels* kernels = getKernels();
+    return (kernels == nullptr) ? begin : kernels->projectDistance(batch, solve, begin, end);
+}
+
+size_t
+projectDihedralConstraints(const BatchView& batch, const SolveView<double>& solve, const size_t begin, const size_t end)
+{
+    const Kernels* kernels = getKernels();
+    return (kernels == nullptr) ? begin : kernels->projectDihedral(batch, solve, begin, end);
+}
+
+size_t
+projectDistanceConstraints(const BatchView& batch, const SolveView<float>& solve, const size_t begin, const size_t end)
+{
+    const Kernels* kernels = getKernels();
+    return (kernels == nullptr) ? begin : kernels->projectDistanceSingle(batch, solve, begin, end);
+}
+
+size_t
+projectDihedralConstraints(const BatchView& batch, const SolveView<float>& solve, const size_t begin, const size_t end)
+{
+    const Kernels* kernels = getKernels();
+    return (kernels == nullptr) ? begin : kernels->projectDihedralSingle(batch, solve, begin, end);
+}
+
+double
+atan2(const double y, const double x)
+{
+    return std::atan2(y, x);
+}
+
+float
+atan2(const float y, const float x)
+{
+    return std::atan2(y, x);
+}
+} // namespace PbdConstraintSimd
+} // namespace imstk
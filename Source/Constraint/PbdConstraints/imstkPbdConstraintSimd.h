@@ -0,0 +1,131 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+///
+/// \brief Instruction sets the batched constraint kernels may be run with
+///
+enum class InstructionSet
+{
+    Scalar = 0,
+    AVX2,  ///> 4 constraints per lane group
+    AVX512 ///> 8 constraints per lane group
+};
+
+///
+/// \struct BatchView
+///
+/// \brief Raw view of a constraint batch, arrays are indexed by constraint
+///
+struct BatchView
+{
+    const size_t* vertexIds  = nullptr; ///> N vertex ids per constraint
+    const double* restValues = nullptr;
+    const double* stiffness  = nullptr; ///> Used in PBD
+    const double* compliance = nullptr; ///> Used in xPBD
+    double* lambdas = nullptr;
+    double epsilon  = 1.0e-16;
+};
+
+///
+/// \struct SolveView
+///
+/// \brief Raw view of the state being solved, in double or single precision.
+/// Single precision lanes are twice as many per register
+///
+template<typename T>
+struct SolveView
+{
+    const T* invMasses = nullptr;
+    T* positions       = nullptr; ///> Interleaved xyz
+    double dt  = 0.0;
+    bool   pbd = false;           ///> Use the PBD update instead of xPBD
+};
+
+///
+/// \brief Projects constraints of a range in which no two constraints share a vertex
+/// (ie: a range within a partition), several constraints at once
+/// \return index of the first constraint not projected, those left do not fill all lanes
+///
+template<typename T>
+using ProjectFunc = size_t (*)(const BatchView& batch, const SolveView<T>& solve, const size_t begin, const size_t end);
+
+///
+/// \struct Kernels
+///
+/// \brief Kernels compiled for one instruction set
+///
+struct Kernels
+{
+    ProjectFunc<double> projectDistance = nullptr;
+    ProjectFunc<double> projectDihedral = nullptr;
+    ProjectFunc<float>  projectDistanceSingle = nullptr;
+    ProjectFunc<float>  projectDihedralSingle = nullptr;
+};
+
+///
+/// \brief Returns the kernels compiled for AVX2/AVX512, nullptr if the build
+/// does not target them. Each is in its own translation unit compiled for its instruction set
+///
+const Kernels* getAVX2Kernels();
+const Kernels* getAVX512Kernels();
+
+///
+/// \brief Returns the widest instruction set supported by both the build and the cpu
+///
+InstructionSet getSupportedInstructionSet();
+
+///
+/// \brief Returns the instruction set in use, defaults to the supported one
+///
+InstructionSet getInstructionSet();
+
+///
+/// \brief Set the instruction set to use, clamped to the supported one.
+/// Mostly useful to compare against the scalar path
+///
+void setInstructionSet(const InstructionSet set);
+
+///
+/// \brief Project a range of independent distance/dihedral constraints with
+/// the instruction set in use. Returns begin when scalar
+///
+size_t projectDistanceConstraints(const BatchView& batch, const SolveView<double>& solve, const size_t begin, const size_t end);
+size_t projectDihedralConstraints(const BatchView& batch, const SolveView<double>& solve, const size_t begin, const size_t end);
+size_t projectDistanceConstraints(const BatchView& batch, const SolveView<float>& solve, const size_t begin, const size_t end);
+size_t projectDihedralConstraints(const BatchView& batch, const SolveView<float>& solve, const size_t begin, const size_t end);
+
+///
+/// \brief atan2 for the kernels. Defined in a translation unit compiled without
+/// instruction set flags, the inline std::atan2 overloads instantiated in a kernel
+/// translation unit could otherwise be the copy the linker keeps for every caller
+///
+double atan2(const double y, const double x);
+float atan2(const float y, const float x);
+} // namespace PbdConstraintSimd
+} // namespace imstk
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdConstraintSimd.h"
+
+// This file is compiled with AVX2 enabled when targeting x86-64, it is only
+// called when the cpu supports it (see imstkPbdConstraintSimd.cpp)
+#if defined(__AVX2__)
+
+#include "imstkPbdConstraintSimdKernels.h"
+
+#include <immintrin.h>
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+namespace
+{
+///
+/// \brief 4 double lanes, masks are stored as all bits set lanes
+///
+struct AVX2Ops
+{
+    using Scalar = double;
+    using Index  = long long;
+    using Reg    = __m256d;
+    using Mask   = __m256d;
+    static constexpr int Width = 4;
+
+    static Reg zero() { return _mm256_setzero_pd(); }
+    static Reg set1(const double v) { return _mm256_set1_pd(v); }
+    static Reg load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+    static void store(double* ptr, const Reg v) { _mm256_storeu_pd(ptr, v); }
+    static Reg loadDouble(const double* ptr) { return load(ptr); }
+    static void addToDouble(double* ptr, const Reg v) { store(ptr, add(load(ptr), v)); }
+
+    static Reg add(const Reg a, const Reg b) { return _mm256_add_pd(a, b); }
+    static Reg sub(const Reg a, const Reg b) { return _mm256_sub_pd(a, b); }
+    static Reg mul(const Reg a, const Reg b) { return _mm256_mul_pd(a, b); }
+    static Reg div(const Reg a, const Reg b) { return _mm256_div_pd(a, b); }
+    static Reg sqrt(const Reg a) { return _mm256_sqrt_pd(a); }
+
+    static Mask allTrue() { return _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); }
+    static Mask cmpGe(const Reg a, const Reg b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static Mask cmpGt(const Reg a, const Reg b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static Mask andMask(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+    static Reg select(const Mask m, const Reg a) { return _mm256_and_pd(m, a); }
+
+    static Reg gather(const double* base, const long long* ids)
+    {
+        return _mm256_i64gather_pd(base, _mm256_load_si256(reinterpret_cast<const __m256i*>(ids)), 8);
+    }
+
+    static void scatterAdd(double* base, const long long* ids, const Reg v)
+    {
+        alignas(32) double values[Width];
+        _mm256_store_pd(values, v);
+        for (int k = 0; k < Width; k++)
+        {
+            base[ids[k]] += values[k];
+        }
+    }
+};
+
+///
+/// \brief 8 float lanes, masks are stored as all bits set lanes
+///
+struct AVX2SingleOps
+{
+    using Scalar = float;
+    using Index  = int;
+    using Reg    = __m256;
+    using Mask   = __m256;
+    static constexpr int Width = 8;
+
+    static Reg zero() { return _mm256_setzero_ps(); }
+    static Reg set1(const double v) { return _mm256_set1_ps(static_cast<float>(v)); }
+    static Reg load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+    static void store(float* ptr, const Reg v) { _mm256_storeu_ps(ptr, v); }
+
+    static Reg loadDouble(const double* ptr)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(ptr))),
+            _mm256_cvtpd_ps(_mm256_loadu_pd(ptr + 4)), 1);
+    }
+
+    static void addToDouble(double* ptr, const Reg v)
+    {
+        _mm256_storeu_pd(ptr, _mm256_add_pd(_mm256_loadu_pd(ptr), _mm256_cvtps_pd(_mm256_castps256_ps128(v))));
+        _mm256_storeu_pd(ptr + 4, _mm256_add_pd(_mm256_loadu_pd(ptr + 4), _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1))));
+    }
+
+    static Reg add(const Reg a, const Reg b) { return _mm256_add_ps(a, b); }
+    static Reg sub(const Reg a, const Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg mul(const Reg a, const Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg div(const Reg a, const Reg b) { return _mm256_div_ps(a, b); }
+    static Reg sqrt(const Reg a) { return _mm256_sqrt_ps(a); }
+
+    static Mask allTrue() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    static Mask cmpGe(const Reg a, const Reg b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Mask cmpGt(const Reg a, const Reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask andMask(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+    static Reg select(const Mask m, const Reg a) { return _mm256_and_ps(m, a); }
+
+    static Reg gather(const float* base, const int* ids)
+    {
+        return _mm256_i32gather_ps(base, _mm256_load_si256(reinterpret_cast<const __m256i*>(ids)), 4);
+    }
+
+    static void scatterAdd(float* base, const int* ids, const Reg v)
+    {
+        alignas(32) float values[Width];
+        _mm256_store_ps(values, v);
+        for (int k = 0; k < Width; k++)
+        {
+            base[ids[k]] += values[k];
+        }
+    }
+};
+
+const Kernels avx2Kernels = {
+    &projectLanes<AVX2Ops, DistanceLanes>,
+    &projectLanes<AVX2Ops, DihedralLanes>,
+    &projectLanes<AVX2SingleOps, DistanceLanes>,
+    &projectLanes<AVX2SingleOps, DihedralLanes>
+};
+} // namespace
+
+const Kernels*
+getAVX2Kernels()
+{
+    return &avx2Kernels;
+}
+} // namespace PbdConstraintSimd
+} // namespace imstk
+
+#else
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+const Kernels*
+getAVX2Kernels()
+{
+    return nullptr;
+}
+} // namespace PbdConstraintSimd
+} // namespace imstk
+
+#endif
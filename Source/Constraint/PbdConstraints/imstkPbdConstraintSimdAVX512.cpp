@@ -0,0 +1,165 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdConstraintSimd.h"
+
+// This file is compiled with AVX-512F enabled when targeting x86-64, it is only
+// called when the cpu supports it (see imstkPbdConstraintSimd.cpp)
+#if defined(__AVX512F__)
+
+#include "imstkPbdConstraintSimdKernels.h"
+
+#include <immintrin.h>
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+namespace
+{
+///
+/// \brief 8 double lanes, masks are mask registers (only AVX-512F used)
+///
+struct AVX512Ops
+{
+    using Scalar = double;
+    using Index  = long long;
+    using Reg    = __m512d;
+    using Mask   = __mmask8;
+    static constexpr int Width = 8;
+
+    static Reg zero() { return _mm512_setzero_pd(); }
+    static Reg set1(const double v) { return _mm512_set1_pd(v); }
+    static Reg load(const double* ptr) { return _mm512_loadu_pd(ptr); }
+    static void store(double* ptr, const Reg v) { _mm512_storeu_pd(ptr, v); }
+    static Reg loadDouble(const double* ptr) { return load(ptr); }
+    static void addToDouble(double* ptr, const Reg v) { store(ptr, add(load(ptr), v)); }
+
+    static Reg add(const Reg a, const Reg b) { return _mm512_add_pd(a, b); }
+    static Reg sub(const Reg a, const Reg b) { return _mm512_sub_pd(a, b); }
+    static Reg mul(const Reg a, const Reg b) { return _mm512_mul_pd(a, b); }
+    static Reg div(const Reg a, const Reg b) { return _mm512_div_pd(a, b); }
+    static Reg sqrt(const Reg a) { return _mm512_sqrt_pd(a); }
+
+    static Mask allTrue() { return static_cast<Mask>(0xFF); }
+    static Mask cmpGe(const Reg a, const Reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static Mask cmpGt(const Reg a, const Reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static Mask andMask(const Mask a, const Mask b) { return static_cast<Mask>(a & b); }
+    static Reg select(const Mask m, const Reg a) { return _mm512_maskz_mov_pd(m, a); }
+
+    static Reg gather(const double* base, const long long* ids)
+    {
+        return _mm512_i64gather_pd(_mm512_load_si512(ids), base, 8);
+    }
+
+    static void scatterAdd(double* base, const long long* ids, const Reg v)
+    {
+        const __m512i vIds = _mm512_load_si512(ids);
+        _mm512_i64scatter_pd(base, vIds, _mm512_add_pd(_mm512_i64gather_pd(vIds, base, 8), v), 8);
+    }
+};
+
+///
+/// \brief 16 float lanes, the double halves are combined through 256 bit
+/// double lanes as only AVX-512F is used
+///
+struct AVX512SingleOps
+{
+    using Scalar = float;
+    using Index  = int;
+    using Reg    = __m512;
+    using Mask   = __mmask16;
+    static constexpr int Width = 16;
+
+    static Reg zero() { return _mm512_setzero_ps(); }
+    static Reg set1(const double v) { return _mm512_set1_ps(static_cast<float>(v)); }
+    static Reg load(const float* ptr) { return _mm512_loadu_ps(ptr); }
+    static void store(float* ptr, const Reg v) { _mm512_storeu_ps(ptr, v); }
+
+    static Reg loadDouble(const double* ptr)
+    {
+        const __m256 lo = _mm512_cvtpd_ps(_mm512_loadu_pd(ptr));
+        const __m256 hi = _mm512_cvtpd_ps(_mm512_loadu_pd(ptr + 8));
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(lo)), _mm256_castps_pd(hi), 1));
+    }
+
+    static void addToDouble(double* ptr, const Reg v)
+    {
+        _mm512_storeu_pd(ptr, _mm512_add_pd(_mm512_loadu_pd(ptr), _mm512_cvtps_pd(_mm512_castps512_ps256(v))));
+        _mm512_storeu_pd(ptr + 8, _mm512_add_pd(_mm512_loadu_pd(ptr + 8),
+            _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)))));
+    }
+
+    static Reg add(const Reg a, const Reg b) { return _mm512_add_ps(a, b); }
+    static Reg sub(const Reg a, const Reg b) { return _mm512_sub_ps(a, b); }
+    static Reg mul(const Reg a, const Reg b) { return _mm512_mul_ps(a, b); }
+    static Reg div(const Reg a, const Reg b) { return _mm512_div_ps(a, b); }
+    static Reg sqrt(const Reg a) { return _mm512_sqrt_ps(a); }
+
+    static Mask allTrue() { return static_cast<Mask>(0xFFFF); }
+    static Mask cmpGe(const Reg a, const Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static Mask cmpGt(const Reg a, const Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Mask andMask(const Mask a, const Mask b) { return static_cast<Mask>(a & b); }
+    static Reg select(const Mask m, const Reg a) { return _mm512_maskz_mov_ps(m, a); }
+
+    static Reg gather(const float* base, const int* ids)
+    {
+        return _mm512_i32gather_ps(_mm512_load_si512(ids), base, 4);
+    }
+
+    static void scatterAdd(float* base, const int* ids, const Reg v)
+    {
+        const __m512i vIds = _mm512_load_si512(ids);
+        _mm512_i32scatter_ps(base, vIds, _mm512_add_ps(_mm512_i32gather_ps(vIds, base, 4), v), 4);
+    }
+};
+
+const Kernels avx512Kernels = {
+    &projectLanes<AVX512Ops, DistanceLanes>,
+    &projectLanes<AVX512Ops, DihedralLanes>,
+    &projectLanes<AVX512SingleOps, DistanceLanes>,
+    &projectLanes<AVX512SingleOps, DihedralLanes>
+};
+} // namespace
+
+const Kernels*
+getAVX512Kernels()
+{
+    return &avx512Kernels;
+}
+} // namespace PbdConstraintSimd
+} // namespace imstk
+
+#else
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+const Kernels*
+getAVX512Kernels()
+{
+    return nullptr;
+}
+} // namespace PbdConstraintSimd
+} // namespace imstk
+
+#endif
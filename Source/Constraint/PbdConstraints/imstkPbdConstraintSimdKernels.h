@@ -0,0 +1,248 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+// Only to be included by the translation units compiled for a given
+// instruction set. Everything has internal linkage so that no function
+// compiled with wider instructions leaks into code run on other cpus.
+// Only intrinsics and raw pointers are used here for the same reason, math
+// functions go through the out of line ones of imstkPbdConstraintSimd.h.
+
+#include "imstkPbdConstraintSimd.h"
+
+#include <limits>
+
+namespace imstk
+{
+namespace PbdConstraintSimd
+{
+namespace
+{
+///
+/// \brief Vector of 3 simd registers, one lane per constraint
+///
+template<typename Ops>
+struct Vec3Lanes
+{
+    using Reg = typename Ops::Reg;
+    Reg x, y, z;
+};
+
+template<typename Ops>
+inline Vec3Lanes<Ops>
+sub(const Vec3Lanes<Ops>& a, const Vec3Lanes<Ops>& b)
+{
+    return { Ops::sub(a.x, b.x), Ops::sub(a.y, b.y), Ops::sub(a.z, b.z) };
+}
+
+template<typename Ops>
+inline Vec3Lanes<Ops>
+add(const Vec3Lanes<Ops>& a, const Vec3Lanes<Ops>& b)
+{
+    return { Ops::add(a.x, b.x), Ops::add(a.y, b.y), Ops::add(a.z, b.z) };
+}
+
+template<typename Ops>
+inline Vec3Lanes<Ops>
+scale(const Vec3Lanes<Ops>& a, const typename Ops::Reg s)
+{
+    return { Ops::mul(a.x, s), Ops::mul(a.y, s), Ops::mul(a.z, s) };
+}
+
+template<typename Ops>
+inline typename Ops::Reg
+dot(const Vec3Lanes<Ops>& a, const Vec3Lanes<Ops>& b)
+{
+    return Ops::add(Ops::add(Ops::mul(a.x, b.x), Ops::mul(a.y, b.y)), Ops::mul(a.z, b.z));
+}
+
+template<typename Ops>
+inline Vec3Lanes<Ops>
+cross(const Vec3Lanes<Ops>& a, const Vec3Lanes<Ops>& b)
+{
+    return {
+        Ops::sub(Ops::mul(a.y, b.z), Ops::mul(a.z, b.y)),
+        Ops::sub(Ops::mul(a.z, b.x), Ops::mul(a.x, b.z)),
+        Ops::sub(Ops::mul(a.x, b.y), Ops::mul(a.y, b.x))
+    };
+}
+
+///
+/// \brief Distance constraint, mirrors PbdDistanceConstraint::computeValueAndGradient
+///
+struct DistanceLanes
+{
+    static constexpr int NumVertices = 2;
+
+    template<typename Ops>
+    static typename Ops::Mask compute(const Vec3Lanes<Ops>* p, const typename Ops::Reg restLength, const double,
+                                      typename Ops::Reg& c, Vec3Lanes<Ops>* dcdx)
+    {
+        const Vec3Lanes<Ops>    diff = sub(p[0], p[1]);
+        const typename Ops::Reg len  = Ops::sqrt(dot(diff, diff));
+        const typename Ops::Reg invLen = Ops::div(Ops::set1(1.0), len);
+        dcdx[0] = scale(diff, invLen);
+        dcdx[1] = scale(dcdx[0], Ops::set1(-1.0));
+        c       = Ops::sub(len, restLength);
+        return Ops::allTrue();
+    }
+};
+
+///
+/// \brief Dihedral constraint, mirrors PbdDihedralConstraint::computeValueAndGradient
+///
+struct DihedralLanes
+{
+    static constexpr int NumVertices = 4;
+
+    template<typename Ops>
+    static typename Ops::Mask compute(const Vec3Lanes<Ops>* p, const typename Ops::Reg restAngle, const double epsilon,
+                                      typename Ops::Reg& c, Vec3Lanes<Ops>* dcdx)
+    {
+        using Reg = typename Ops::Reg;
+        const Vec3Lanes<Ops> e  = sub(p[3], p[2]);
+        const Vec3Lanes<Ops> e1 = sub(p[3], p[0]);
+        const Vec3Lanes<Ops> e2 = sub(p[0], p[2]);
+        const Vec3Lanes<Ops> e3 = sub(p[3], p[1]);
+        const Vec3Lanes<Ops> e4 = sub(p[1], p[2]);
+
+        Vec3Lanes<Ops> n1 = cross(e1, e);
+        Vec3Lanes<Ops> n2 = cross(e, e3);
+        const Reg      A1 = Ops::sqrt(dot(n1, n1));
+        const Reg      A2 = Ops::sqrt(dot(n2, n2));
+        n1 = scale(n1, Ops::div(Ops::set1(1.0), A1));
+        n2 = scale(n2, Ops::div(Ops::set1(1.0), A2));
+
+        const Reg l = Ops::sqrt(dot(e, e));
+        const Reg A1l = Ops::mul(A1, l);
+        const Reg A2l = Ops::mul(A2, l);
+
+        dcdx[0] = scale(n1, Ops::sub(Ops::zero(), Ops::div(l, A1)));
+        dcdx[1] = scale(n2, Ops::sub(Ops::zero(), Ops::div(l, A2)));
+        dcdx[2] = add(scale(n1, Ops::div(dot(e, e1), A1l)), scale(n2, Ops::div(dot(e, e3), A2l)));
+        dcdx[3] = add(scale(n1, Ops::div(dot(e, e2), A1l)), scale(n2, Ops::div(dot(e, e4), A2l)));
+
+        // No simd atan2 among the intrinsics, evaluate it per lane with the
+        // out of line one
+        alignas(64) typename Ops::Scalar y[Ops::Width];
+        alignas(64) typename Ops::Scalar x[Ops::Width];
+        Ops::store(y, dot(cross(n1, n2), e));
+        Ops::store(x, Ops::mul(l, dot(n1, n2)));
+        for (int k = 0; k < Ops::Width; k++)
+        {
+            y[k] = PbdConstraintSimd::atan2(y[k], x[k]);
+        }
+        c = Ops::sub(Ops::load(y), restAngle);
+
+        return Ops::cmpGe(l, Ops::set1(epsilon));
+    }
+};
+
+///
+/// \brief Projects groups of Ops::Width independent constraints at once, same
+/// update as PbdConstraintBatchBase::projectConstraintsImpl. The state is in
+/// Ops::Scalar precision, the constraint data is always double. The multipliers are
+/// read in Ops::Scalar precision but accumulated in double
+///
+template<typename Ops, typename Constraint>
+size_t
+projectLanes(const BatchView& batch, const SolveView<typename Ops::Scalar>& solve, const size_t begin, const size_t end)
+{
+    using Scalar = typename Ops::Scalar;
+    using Index  = typename Ops::Index;
+    using Reg    = typename Ops::Reg;
+    using Mask   = typename Ops::Mask;
+    constexpr int W = Ops::Width;
+    constexpr int N = Constraint::NumVertices;
+
+    // constexpr so no (non inline) limits function gets compiled here
+    constexpr double eps    = std::numeric_limits<double>::epsilon();
+    const double     invDt2 = (solve.dt > 0.0) ? 1.0 / (solve.dt * solve.dt) : 0.0;
+    Scalar*          pos    = solve.positions;
+
+    size_t i = begin;
+    for (; i + W <= end; i += W)
+    {
+        // Gather the positions and inverse masses of every vertex
+        alignas(64) Index vIds[N][W];
+        alignas(64) Index posIds[N][W];
+        for (int j = 0; j < N; j++)
+        {
+            for (int k = 0; k < W; k++)
+            {
+                vIds[j][k]   = static_cast<Index>(batch.vertexIds[(i + k) * N + j]);
+                posIds[j][k] = vIds[j][k] * 3;
+            }
+        }
+
+        Vec3Lanes<Ops> p[N];
+        Reg            w[N];
+        for (int j = 0; j < N; j++)
+        {
+            p[j].x = Ops::gather(pos, posIds[j]);
+            p[j].y = Ops::gather(pos + 1, posIds[j]);
+            p[j].z = Ops::gather(pos + 2, posIds[j]);
+            w[j]   = Ops::gather(solve.invMasses, vIds[j]);
+        }
+
+        Reg            c;
+        Vec3Lanes<Ops> dcdx[N];
+        Mask           valid = Constraint::template compute<Ops>(p, Ops::loadDouble(batch.restValues + i), batch.epsilon, c, dcdx);
+
+        Reg dcMidc = Ops::zero();
+        for (int j = 0; j < N; j++)
+        {
+            dcMidc = Ops::add(dcMidc, Ops::mul(w[j], dot(dcdx[j], dcdx[j])));
+        }
+        valid = Ops::andMask(valid, Ops::cmpGe(dcMidc, Ops::set1(eps)));
+
+        Reg dLambda;
+        if (solve.pbd)
+        {
+            dLambda = Ops::div(Ops::mul(Ops::sub(Ops::zero(), c), Ops::loadDouble(batch.stiffness + i)), dcMidc);
+            dLambda = Ops::select(valid, dLambda);
+        }
+        else
+        {
+            const Reg alpha  = Ops::mul(Ops::loadDouble(batch.compliance + i), Ops::set1(invDt2));
+            const Reg lambda = Ops::loadDouble(batch.lambdas + i);
+            dLambda = Ops::div(Ops::sub(Ops::zero(), Ops::add(c, Ops::mul(alpha, lambda))), Ops::add(dcMidc, alpha));
+            dLambda = Ops::select(valid, dLambda);
+            // Accumulate in double, only the increment is in Ops::Scalar precision
+            Ops::addToDouble(batch.lambdas + i, dLambda);
+        }
+
+        // Scatter the corrections, vertices are unique within the range
+        for (int j = 0; j < N; j++)
+        {
+            const Mask move = Ops::andMask(valid, Ops::cmpGt(w[j], Ops::zero()));
+            const Reg  s    = Ops::mul(w[j], dLambda);
+            Ops::scatterAdd(pos, posIds[j], Ops::select(move, Ops::mul(s, dcdx[j].x)));
+            Ops::scatterAdd(pos + 1, posIds[j], Ops::select(move, Ops::mul(s, dcdx[j].y)));
+            Ops::scatterAdd(pos + 2, posIds[j], Ops::select(move, Ops::mul(s, dcdx[j].z)));
+        }
+    }
+    return i;
+}
+} // namespace
+} // namespace PbdConstraintSimd
+} // namespace imstk
@@ -50,37 +50,28 @@ PbdDihedralConstraint::initConstraint(const VecDataArray<double, 3>& initVertexP
     m_restAngle = atan2(n1.cross(n2).dot(p3 - p2), (p3 - p2).norm() * n1.dot(n2));
 }
 
-bool
-PbdDihedralConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& c,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of a dihedral constraint, shared by the single and batched constraint
+///
+static inline bool
+computeDihedral(const Vec3d& p0, const Vec3d& p1, const Vec3d& p2, const Vec3d& p3,
+                const double restAngle, const double epsilon, double& c, Vec3d* dcdx)
 {
-    const auto i0 = m_vertexIds[0];
-    const auto i1 = m_vertexIds[1];
-    const auto i2 = m_vertexIds[2];
-    const auto i3 = m_vertexIds[3];
-
-    const Vec3d& p0 = currVertexPositions[i0];
-    const Vec3d& p1 = currVertexPositions[i1];
-    const Vec3d& p2 = currVertexPositions[i2];
-    const Vec3d& p3 = currVertexPositions[i3];
-
     const auto e  = p3 - p2;
     const auto e1 = p3 - p0;
     const auto e2 = p0 - p2;
     const auto e3 = p3 - p1;
     const auto e4 = p1 - p2;
     // To accelerate, all normal (area) vectors and edge length should be precomputed in parallel
-    auto       n1 = e1.cross(e);
-    auto       n2 = e.cross(e3);
-    const auto A1 = n1.norm();
-    const auto A2 = n2.norm();
+    Vec3d        n1 = e1.cross(e);
+    Vec3d        n2 = e.cross(e3);
+    const double A1 = n1.norm();
+    const double A2 = n2.norm();
     n1 /= A1;
     n2 /= A2;
 
     const double l = e.norm();
-    if (l < m_epsilon)
+    if (l < epsilon)
     {
         return false;
     }
@@ -90,8 +81,47 @@ PbdDihedralConstraint::computeValueAndGradient(
     dcdx[2] = (e.dot(e1) / (A1 * l)) * n1 + (e.dot(e3) / (A2 * l)) * n2;
     dcdx[3] = (e.dot(e2) / (A1 * l)) * n1 + (e.dot(e4) / (A2 * l)) * n2;
 
-    c = atan2(n1.cross(n2).dot(e), l * n1.dot(n2)) - m_restAngle;
+    c = atan2(n1.cross(n2).dot(e), l * n1.dot(n2)) - restAngle;
 
     return true;
 }
+
+bool
+PbdDihedralConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& c,
+    Vec3d* dcdx) const
+{
+    return computeDihedral(
+        currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]],
+        currVertexPositions[m_vertexIds[2]], currVertexPositions[m_vertexIds[3]],
+        m_restAngle, m_epsilon, c, dcdx);
+}
+
+bool
+PbdDihedralConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdDihedralConstraint) || !acceptTolerance(constraint))
+    {
+        return false;
+    }
+    push_back(getIds(constraint), static_cast<const PbdDihedralConstraint&>(constraint).m_restAngle,
+        constraint.getStiffness(), constraint.getCompliance());
+    return true;
+}
+
+template<typename T>
+bool
+PbdDihedralConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 4>& ids = m_vertexIds[i];
+    return computeDihedral(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        pos[ids[2]].template cast<double>(), pos[ids[3]].template cast<double>(),
+        m_restData[i], m_epsilon, c, dcdx);
+}
+
+template bool PbdDihedralConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdDihedralConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdDihedralConstraintBatch, 4, double>;
 } // imstk
@@ -21,7 +21,7 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
 namespace imstk
 {
@@ -30,17 +30,13 @@ namespace imstk
 ///
 /// \brief Angular constraint between two triangular faces
 ///
-class PbdDihedralConstraint : public PbdConstraint
+class PbdDihedralConstraint : public PbdConstraintN<4>
 {
 public:
     ///
     /// \brief Constructor
     ///
-    PbdDihedralConstraint() : PbdConstraint()
-    {
-        m_vertexIds.resize(4);
-        m_dcdx.resize(4);
-    }
+    PbdDihedralConstraint() : PbdConstraintN<4>() { }
 
     ///
     /// \brief Returns PBD constraint of type Type::Dihedral
@@ -78,9 +74,37 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPositions,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
 
 public:
     double m_restAngle = 0.0; ///> Rest angle
 };
+
+///
+/// \class PbdDihedralConstraintBatch
+///
+/// \brief Structure of arrays storage of dihedral constraints
+///
+class PbdDihedralConstraintBatch : public PbdConstraintBatchBase<PbdDihedralConstraintBatch, 4, double>
+{
+public:
+    std::string getType() const override { return "Dihedral"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    template<typename T>
+    static PbdConstraintSimd::ProjectFunc<T> getSimdKernel() { return &PbdConstraintSimd::projectDihedralConstraints; }
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdDihedralConstraintBatch, 4, double>;
 } //imstk
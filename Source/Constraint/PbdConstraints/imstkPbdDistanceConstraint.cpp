@@ -40,21 +40,55 @@ PbdDistanceConstraint::initConstraint(const VecDataArray<double, 3>& initVertexP
     m_restLength = (p0 - p1).norm();
 }
 
-bool
-PbdDistanceConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& c,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of a distance constraint, shared by the single and batched constraint
+///
+static inline bool
+computeDistance(const Vec3d& p0, const Vec3d& p1, const double restLength, double& c, Vec3d* dcdx)
 {
-    const Vec3d& p0 = currVertexPositions[m_vertexIds[0]];
-    const Vec3d& p1 = currVertexPositions[m_vertexIds[1]];
-
     dcdx[0] = p0 - p1;
     const double len = dcdx[0].norm();
     dcdx[0] /= len;
     dcdx[1]  = -dcdx[0];
-    c        = len - m_restLength;
+    c        = len - restLength;
 
     return true;
 }
+
+bool
+PbdDistanceConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& c,
+    Vec3d* dcdx) const
+{
+    return computeDistance(currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]],
+        m_restLength, c, dcdx);
+}
+
+bool
+PbdDistanceConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdDistanceConstraint) || !acceptTolerance(constraint))
+    {
+        return false;
+    }
+    const auto& distConstraint = static_cast<const PbdDistanceConstraint&>(constraint);
+    push_back(getIds(constraint), distConstraint.m_restLength,
+        constraint.getStiffness(), constraint.getCompliance());
+    return true;
+}
+
+template<typename T>
+bool
+PbdDistanceConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 2>& ids = m_vertexIds[i];
+    return computeDistance(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        m_restData[i], c, dcdx);
+}
+
+template bool PbdDistanceConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdDistanceConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdDistanceConstraintBatch, 2, double>;
 }
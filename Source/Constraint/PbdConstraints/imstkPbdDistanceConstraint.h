@@ -21,7 +21,7 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
 namespace imstk
 {
@@ -30,17 +30,13 @@ namespace imstk
 ///
 /// \brief Distance constraints between two nodal points
 ///
-class PbdDistanceConstraint : public PbdConstraint
+class PbdDistanceConstraint : public PbdConstraintN<2>
 {
 public:
     ///
     /// \brief Constructor
     ///
-    PbdDistanceConstraint() : PbdConstraint()
-    {
-        m_vertexIds.resize(2);
-        m_dcdx.resize(2);
-    }
+    PbdDistanceConstraint() : PbdConstraintN<2>() { }
 
     ///
     /// \brief Returns PBD constraint of type Type::Distance
@@ -58,9 +54,37 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPositions,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
 
 public:
     double m_restLength = 0.0; ///> Rest length between the nodes
 };
+
+///
+/// \class PbdDistanceConstraintBatch
+///
+/// \brief Structure of arrays storage of distance constraints
+///
+class PbdDistanceConstraintBatch : public PbdConstraintBatchBase<PbdDistanceConstraintBatch, 2, double>
+{
+public:
+    std::string getType() const override { return "Distance"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    template<typename T>
+    static PbdConstraintSimd::ProjectFunc<T> getSimdKernel() { return &PbdConstraintSimd::projectDistanceConstraints; }
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdDistanceConstraintBatch, 2, double>;
 } // imstk
@@ -23,14 +23,11 @@
 
 namespace imstk
 {
-PbdFEMConstraint::PbdFEMConstraint(const unsigned int cardinality,
-                                   MaterialType       mtype /*= MaterialType::StVK*/) :
+PbdFEMConstraint::PbdFEMConstraint(MaterialType mtype /*= MaterialType::StVK*/) :
     PbdConstraint(),
     m_elementVolume(0),
     m_material(mtype),
     m_invRestMat(Mat3d::Identity())
 {
-    m_vertexIds.resize(cardinality);
-    m_dcdx.resize(cardinality);
 }
 } // imstk
@@ -42,6 +42,8 @@ struct PbdFEMConstraintConfig
 
     double m_YoungModulus = 1000; ///> FEM parameter, if constraint type is FEM
     double m_PoissonRatio = 0.2;  ///> FEM parameter, if constraint type is FEM
+
+    bool m_useEigenSVD = false;   ///> Corotation uses Eigen::JacobiSVD instead of the closed form SVD, ie: for validation
 };
 
 ///
@@ -67,7 +69,7 @@ public:
     ///
     /// \brief Constructor
     ///
-    PbdFEMConstraint(const unsigned int cardinality, MaterialType mtype = MaterialType::StVK);
+    PbdFEMConstraint(MaterialType mtype = MaterialType::StVK);
 
 public:
     double       m_elementVolume = 0.0; ///> Volume of the element
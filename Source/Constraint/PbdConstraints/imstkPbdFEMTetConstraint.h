@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkPbdConstraintBatch.h"
 #include "imstkPbdFEMConstraint.h"
 
 namespace imstk
@@ -31,14 +32,13 @@ namespace imstk
 /// \brief The FEMTetConstraint class class for constraint as the elastic energy
 /// computed by linear shape functions with tetrahedral mesh.
 ///
-class PbdFEMTetConstraint : public PbdFEMConstraint
+class PbdFEMTetConstraint : public PbdConstraintN<4, PbdFEMConstraint>
 {
 public:
     ///
     /// \brief Constructor
     ///
-    PbdFEMTetConstraint(MaterialType mtype = MaterialType::StVK) :
-        PbdFEMConstraint(4, mtype) {}
+    PbdFEMTetConstraint(MaterialType mtype = MaterialType::StVK) { m_material = mtype; }
 
     ///
     /// \brief Get the type of FEM constraint
@@ -59,6 +59,49 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPosition,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
 };
+
+///
+/// \struct PbdFEMTetElementData
+///
+/// \brief Per element rest data of a tetrahedral FEM constraint
+///
+struct PbdFEMTetElementData
+{
+    Mat3d m_invRestMat;
+    double m_elementVolume;
+};
+
+///
+/// \class PbdFEMTetConstraintBatch
+///
+/// \brief Structure of arrays storage of tetrahedral FEM constraints. The material
+/// and its config are shared by the batch, they are taken from the first constraint added
+///
+class PbdFEMTetConstraintBatch : public PbdConstraintBatchBase<PbdFEMTetConstraintBatch, 4, PbdFEMTetElementData>
+{
+public:
+    std::string getType() const override { return "FEMTet"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+
+protected:
+    bool acceptParameters(const PbdConstraintBatch& other) override;
+
+    PbdFEMConstraint::MaterialType m_material = PbdFEMConstraint::MaterialType::StVK;
+    std::shared_ptr<PbdFEMConstraintConfig> m_config = nullptr;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdFEMTetConstraintBatch, 4, PbdFEMTetElementData>;
 } // imstk
@@ -20,6 +20,7 @@
 =========================================================================*/
 
 #include "imstkPbdFEMTetConstraint.h"
+#include "imstkSVD3x3.h"
 
 namespace  imstk
 {
@@ -58,42 +59,35 @@ PbdFEMTetConstraint::initConstraint(const VecDataArray<double, 3>& initVertexPos
     return false;
 }
 
-bool
-PbdFEMTetConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& cval,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of a tetrahedral FEM constraint, shared by the single and batched constraint
+///
+static inline bool
+computeFEMTet(const Vec3d& p0, const Vec3d& p1, const Vec3d& p2, const Vec3d& p3,
+              const Mat3d& invRestMat, const double elementVolume,
+              const PbdFEMConstraint::MaterialType material, const PbdFEMConstraintConfig& config,
+              double& cval, Vec3d* dcdx)
 {
-    const auto i0 = m_vertexIds[0];
-    const auto i1 = m_vertexIds[1];
-    const auto i2 = m_vertexIds[2];
-    const auto i3 = m_vertexIds[3];
-
-    const Vec3d& p0 = currVertexPositions[i0];
-    const Vec3d& p1 = currVertexPositions[i1];
-    const Vec3d& p2 = currVertexPositions[i2];
-    const Vec3d& p3 = currVertexPositions[i3];
-
     Mat3d m;
     m.col(0) = p0 - p3;
     m.col(1) = p1 - p3;
     m.col(2) = p2 - p3;
 
     // deformation gradient
-    const Mat3d F = m * m_invRestMat;
+    const Mat3d F = m * invRestMat;
     // First Piola-Kirchhoff tensor
-    Mat3d P;
+    Mat3d P = Mat3d::Zero();
     // energy constraint
     double C = 0;
 
-    const auto mu     = m_config->m_mu;
-    const auto lambda = m_config->m_lambda;
+    const double mu     = config.m_mu;
+    const double lambda = config.m_lambda;
 
-    switch (m_material)
+    switch (material)
     {
     // P(F) = F*(2*mu*E + lambda*tr(E)*I)
     // E = (F^T*F - I)/2
-    case MaterialType::StVK:
+    case PbdFEMConstraint::MaterialType::StVK:
     {
         Mat3d E;
         E(0, 0) = 0.5 * (F(0, 0) * F(0, 0) + F(1, 0) * F(1, 0) + F(2, 0) * F(2, 0) - 1.0);                  // xx
@@ -123,16 +117,30 @@ PbdFEMTetConstraint::computeValueAndGradient(
     }
 
     // P(F) = (2*mu*(F-R) + lambda*(J-1)*J*F^-T
-    case MaterialType::Corotation:
+    case PbdFEMConstraint::MaterialType::Corotation:
     {
-        Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
-        Mat3d                   R = svd.matrixU() * svd.matrixV().adjoint();
-        Vec3d                   Sigma(svd.singularValues());
-        Mat3d                   invFT = svd.matrixU();
+        // The closed form SVD is rotation variant, R stays a rotation and J is negative
+        // for inverted elements. Eigen's singular values are positive
+        Mat3d U;
+        Vec3d Sigma;
+        Mat3d V;
+        if (config.m_useEigenSVD)
+        {
+            Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+            U     = svd.matrixU();
+            Sigma = svd.singularValues();
+            V     = svd.matrixV();
+        }
+        else
+        {
+            computeSVD3x3(F, U, Sigma, V);
+        }
+        Mat3d R     = U * V.adjoint();
+        Mat3d invFT = U;
         invFT.col(0) /= Sigma(0);
         invFT.col(1) /= Sigma(1);
         invFT.col(2) /= Sigma(2);
-        invFT *= svd.matrixV().adjoint();
+        invFT *= V.adjoint();
         double J  = Sigma(0) * Sigma(1) * Sigma(2);
         Mat3d  FR = F - R;
 
@@ -146,7 +154,7 @@ PbdFEMTetConstraint::computeValueAndGradient(
         break;
     }
     // P(F) = mu*(F - mu*F^-T) + lambda*log(J)F^-T;
-    case MaterialType::NeoHookean:
+    case PbdFEMConstraint::MaterialType::NeoHookean:
     {
         Mat3d  invFT = F.inverse().transpose();
         double logJ  = log(F.determinant());
@@ -161,7 +169,7 @@ PbdFEMTetConstraint::computeValueAndGradient(
         break;
     }
 
-    case MaterialType::Linear:
+    case PbdFEMConstraint::MaterialType::Linear:
     {
         break;
     }
@@ -169,9 +177,9 @@ PbdFEMTetConstraint::computeValueAndGradient(
         break;
     }
 
-    Mat3d gradC = m_elementVolume * P * m_invRestMat.transpose();
+    Mat3d gradC = elementVolume * P * invRestMat.transpose();
     cval    = C;
-    cval   *=  m_elementVolume;
+    cval   *=  elementVolume;
     dcdx[0] = gradC.col(0);
     dcdx[1] = gradC.col(1);
     dcdx[2] = gradC.col(2);
@@ -179,4 +187,76 @@ PbdFEMTetConstraint::computeValueAndGradient(
 
     return true;
 }
+
+bool
+PbdFEMTetConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& cval,
+    Vec3d* dcdx) const
+{
+    return computeFEMTet(
+        currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]],
+        currVertexPositions[m_vertexIds[2]], currVertexPositions[m_vertexIds[3]],
+        m_invRestMat, m_elementVolume, m_material, *m_config, cval, dcdx);
+}
+
+bool
+PbdFEMTetConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdFEMTetConstraint))
+    {
+        return false;
+    }
+    const auto& femConstraint = static_cast<const PbdFEMTetConstraint&>(constraint);
+    if (femConstraint.m_config == nullptr)
+    {
+        return false;
+    }
+    if (size() == 0)
+    {
+        m_material = femConstraint.m_material;
+        m_config   = femConstraint.m_config;
+    }
+    else if (m_material != femConstraint.m_material || m_config != femConstraint.m_config)
+    {
+        return false;
+    }
+    if (!acceptTolerance(constraint))
+    {
+        return false;
+    }
+
+    push_back(getIds(constraint), { femConstraint.m_invRestMat, femConstraint.m_elementVolume },
+        constraint.getStiffness(), constraint.getCompliance());
+    return true;
+}
+
+bool
+PbdFEMTetConstraintBatch::acceptParameters(const PbdConstraintBatch& other)
+{
+    const auto& batch = static_cast<const PbdFEMTetConstraintBatch&>(other);
+    if (size() == 0)
+    {
+        m_material = batch.m_material;
+        m_config   = batch.m_config;
+        return true;
+    }
+    return m_material == batch.m_material && m_config == batch.m_config;
+}
+
+template<typename T>
+bool
+PbdFEMTetConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 4>& ids  = m_vertexIds[i];
+    const PbdFEMTetElementData&  data = m_restData[i];
+    return computeFEMTet(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        pos[ids[2]].template cast<double>(), pos[ids[3]].template cast<double>(),
+        data.m_invRestMat, data.m_elementVolume, m_material, *m_config, c, dcdx);
+}
+
+template bool PbdFEMTetConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdFEMTetConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdFEMTetConstraintBatch, 4, PbdFEMTetElementData>;
 } // imstk
@@ -45,22 +45,13 @@ PbdVolumeConstraint::initConstraint(const VecDataArray<double, 3>& initVertexPos
     m_restVolume = (1.0 / 6.0) * ((p1 - p0).cross(p2 - p0)).dot(p3 - p0);
 }
 
-bool
-PbdVolumeConstraint::computeValueAndGradient(
-    const VecDataArray<double, 3>& currVertexPositions,
-    double& c,
-    std::vector<Vec3d>& dcdx) const
+///
+/// \brief Value and gradient of a volume constraint, shared by the single and batched constraint
+///
+static inline bool
+computeVolume(const Vec3d& x0, const Vec3d& x1, const Vec3d& x2, const Vec3d& x3,
+              const double restVolume, double& c, Vec3d* dcdx)
 {
-    const auto i0 = m_vertexIds[0];
-    const auto i1 = m_vertexIds[1];
-    const auto i2 = m_vertexIds[2];
-    const auto i3 = m_vertexIds[3];
-
-    const Vec3d& x0 = currVertexPositions[i0];
-    const Vec3d& x1 = currVertexPositions[i1];
-    const Vec3d& x2 = currVertexPositions[i2];
-    const Vec3d& x3 = currVertexPositions[i3];
-
     const double onesixth = 1.0 / 6.0;
 
     dcdx[0] = onesixth * (x1 - x2).cross(x3 - x1);
@@ -69,7 +60,45 @@ PbdVolumeConstraint::computeValueAndGradient(
     dcdx[3] = onesixth * (x1 - x0).cross(x2 - x0);
 
     const double volume = dcdx[3].dot(x3 - x0);
-    c = (volume - m_restVolume);
+    c = (volume - restVolume);
+    return true;
+}
+
+bool
+PbdVolumeConstraint::computeValueAndGradient(
+    const VecDataArray<double, 3>& currVertexPositions,
+    double& c,
+    Vec3d* dcdx) const
+{
+    return computeVolume(
+        currVertexPositions[m_vertexIds[0]], currVertexPositions[m_vertexIds[1]],
+        currVertexPositions[m_vertexIds[2]], currVertexPositions[m_vertexIds[3]],
+        m_restVolume, c, dcdx);
+}
+
+bool
+PbdVolumeConstraintBatch::addConstraint(const PbdConstraint& constraint)
+{
+    if (typeid(constraint) != typeid(PbdVolumeConstraint) || !acceptTolerance(constraint))
+    {
+        return false;
+    }
+    push_back(getIds(constraint), static_cast<const PbdVolumeConstraint&>(constraint).getRestVolume(),
+        constraint.getStiffness(), constraint.getCompliance());
     return true;
 }
+
+template<typename T>
+bool
+PbdVolumeConstraintBatch::computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const
+{
+    const std::array<size_t, 4>& ids = m_vertexIds[i];
+    return computeVolume(pos[ids[0]].template cast<double>(), pos[ids[1]].template cast<double>(),
+        pos[ids[2]].template cast<double>(), pos[ids[3]].template cast<double>(), m_restData[i], c, dcdx);
+}
+
+template bool PbdVolumeConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<double, 3>&, double&, Vec3d*) const;
+template bool PbdVolumeConstraintBatch::computeValueAndGradient(const size_t, const VecDataArray<float, 3>&, double&, Vec3d*) const;
+
+template class PbdConstraintBatchBase<PbdVolumeConstraintBatch, 4, double>;
 } // imstk
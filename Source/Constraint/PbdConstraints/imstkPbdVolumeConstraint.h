@@ -21,7 +21,7 @@
 
 #pragma once
 
-#include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBatch.h"
 
 namespace imstk
 {
@@ -30,17 +30,13 @@ namespace imstk
 ///
 /// \brief Volume constraint for tetrahedral element
 ///
-class PbdVolumeConstraint : public PbdConstraint
+class PbdVolumeConstraint : public PbdConstraintN<4>
 {
 public:
     ///
     /// \brief constructor
     ///
-    PbdVolumeConstraint()
-    {
-        m_vertexIds.resize(4);
-        m_dcdx.resize(4);
-    }
+    PbdVolumeConstraint() : PbdConstraintN<4>() { }
 
     ///
     /// \brief Returns PBD constraint of type Type::Volume
@@ -61,9 +57,39 @@ public:
     bool computeValueAndGradient(
         const VecDataArray<double, 3>& currVertexPosition,
         double& c,
-        std::vector<Vec3d>& dcdx) const override;
+        Vec3d* dcdx) const override;
+
+    ///
+    /// \brief Get the rest volume
+    ///
+    double getRestVolume() const { return m_restVolume; }
 
 protected:
     double m_restVolume = 0.0; ///> Rest volume
 };
+
+///
+/// \class PbdVolumeConstraintBatch
+///
+/// \brief Structure of arrays storage of volume constraints
+///
+class PbdVolumeConstraintBatch : public PbdConstraintBatchBase<PbdVolumeConstraintBatch, 4, double>
+{
+public:
+    std::string getType() const override { return "Volume"; }
+
+    bool addConstraint(const PbdConstraint& constraint) override;
+
+private:
+    friend PbdConstraintBatchBase;
+
+    ///
+    /// \brief Value and gradient of the i'th constraint, positions may be single precision
+    ///
+    template<typename T>
+    bool computeValueAndGradient(const size_t i, const VecDataArray<T, 3>& pos, double& c, Vec3d* dcdx) const;
+};
+
+// Loops are instantiated next to the kernel, in the translation unit of the constraint
+extern template class PbdConstraintBatchBase<PbdVolumeConstraintBatch, 4, double>;
 } // imstk
@@ -55,4 +55,31 @@ TEST(imstkPbdBendConstraintTest, TestConvergence1)
     // Should resolve back to a flat line
     EXPECT_NEAR(vertices[0][1], 0.0, IMSTK_DOUBLE_EPS);
     EXPECT_NEAR(vertices[2][1], 0.0, IMSTK_DOUBLE_EPS);
-}
\ No newline at end of file
+}
+
+///
+/// \brief Test that a copied constraint keeps its own vertex ids and gradients, stored
+/// inline in the constraint
+///
+TEST(imstkPbdBendConstraintTest, TestCopy)
+{
+    VecDataArray<double, 3> vertices(4);
+    vertices[0] = Vec3d(0.0, 0.0, 0.0);
+    vertices[1] = Vec3d(0.5, 0.0, 0.0);
+    vertices[2] = Vec3d(1.0, 0.1, 0.0);
+    vertices[3] = Vec3d(1.5, 0.0, 0.0);
+
+    PbdBendConstraint constraint;
+    constraint.initConstraint(vertices, 0, 1, 2, 1.0);
+    const PbdBendConstraint copy(constraint);
+    constraint.initConstraint(vertices, 1, 2, 3, 1.0);
+
+    const auto ids = copy.getVertexIds();
+    ASSERT_EQ(ids.size(), 3);
+    EXPECT_EQ(ids[0], 0);
+    EXPECT_EQ(ids[1], 1);
+    EXPECT_EQ(ids[2], 2);
+    EXPECT_GE(reinterpret_cast<const char*>(ids.data()), reinterpret_cast<const char*>(&copy));
+    EXPECT_LT(reinterpret_cast<const char*>(ids.data()), reinterpret_cast<const char*>(&copy + 1));
+    EXPECT_EQ(constraint.getVertexIds()[0], 1);
+}
@@ -0,0 +1,445 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdFEMTetConstraint.h"
+#include "imstkPbdConstraintTestingUtils.h"
+
+#include <unordered_set>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief A custom constraint derived from a batchable type
+///
+class CustomDistanceConstraint : public PbdDistanceConstraint
+{
+};
+
+///
+/// \brief Returns the number of partitions of the polymorphic constraints and of the
+/// batches, partition p of each is solved together
+///
+size_t
+getNumPartitions(const PbdConstraintContainer& container)
+{
+    size_t numPartitions = container.getPartitionedConstraints().size();
+    for (const auto& batch : container.getBatches())
+    {
+        numPartitions = std::max(numPartitions, batch->getNumPartitions());
+    }
+    return numPartitions;
+}
+
+///
+/// \brief Returns if no two constraints of a partition share a vertex, partition p
+/// of the polymorphic constraints and of every batch are solved together
+///
+bool
+arePartitionsIndependent(const PbdConstraintContainer& container)
+{
+    const size_t numPartitions = getNumPartitions(container);
+
+    for (size_t p = 0; p < numPartitions; p++)
+    {
+        std::unordered_set<size_t> usedVerts;
+        if (p < container.getPartitionedConstraints().size())
+        {
+            for (const auto& constraint : container.getPartitionedConstraints()[p])
+            {
+                for (const size_t vid : static_cast<const PbdConstraint&>(*constraint).getVertexIds())
+                {
+                    if (!usedVerts.insert(vid).second)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        for (const auto& batch : container.getBatches())
+        {
+            if (p < batch->getNumPartitions())
+            {
+                const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+                for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+                {
+                    for (size_t j = 0; j < batch->getNumVertices(); j++)
+                    {
+                        if (!usedVerts.insert(batch->getVertexIds(i)[j]).second)
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+}
+
+///
+/// \brief Test that batched distance constraints project identical to the polymorphic ones
+///
+TEST(imstkPbdConstraintContainerTest, TestBatchedDistanceProjection)
+{
+    VecDataArray<double, 3> vertices    = *makeChainVertices(10, Vec3d(1.0, 0.0, 0.0));
+    auto                    constraints = makeChainConstraints(vertices, 1e5);
+    DataArray<double>       invMasses(10);
+    for (int i = 0; i < 10; i++)
+    {
+        invMasses[i] = 1.0;
+        vertices[i] += Vec3d(0.0, 0.1 * (i % 3), 0.05 * (i % 2));
+    }
+    invMasses[0] = 0.0;
+    VecDataArray<double, 3> batchedVertices = vertices;
+
+    PbdConstraintContainer container;
+    container.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+    for (const auto& c : constraints)
+    {
+        container.addConstraint(c);
+    }
+    ASSERT_TRUE(container.getConstraints().empty());
+    ASSERT_EQ(container.getBatches().size(), 1);
+    PbdConstraintBatch& batch = *container.getBatches()[0];
+    ASSERT_EQ(batch.size(), constraints.size());
+    EXPECT_EQ(batch.getType(), "Distance");
+
+    for (int iter = 0; iter < 5; iter++)
+    {
+        for (const auto& c : constraints)
+        {
+            c->projectConstraint(invMasses, 0.01, PbdConstraint::SolverType::xPBD, vertices);
+        }
+        batch.projectConstraints(0, batch.size(), invMasses, 0.01, PbdConstraint::SolverType::xPBD, batchedVertices);
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_NEAR((vertices[i] - batchedVertices[i]).norm(), 0.0, 1e-12);
+    }
+}
+
+///
+/// \brief Test that batched FEM constraints project identical to the polymorphic ones
+///
+TEST(imstkPbdConstraintContainerTest, TestBatchedFEMTetProjection)
+{
+    VecDataArray<double, 3> vertices(5);
+    vertices[0] = Vec3d(0.0, 0.0, 0.0);
+    vertices[1] = Vec3d(1.0, 0.0, 0.0);
+    vertices[2] = Vec3d(0.0, 1.0, 0.0);
+    vertices[3] = Vec3d(0.0, 0.0, 1.0);
+    vertices[4] = Vec3d(1.0, 1.0, 1.0);
+    DataArray<double> invMasses(5);
+    invMasses.fill(1.0);
+
+    auto config = std::make_shared<PbdFEMConstraintConfig>(1000.0, 1000.0, 1000.0, 0.2);
+    std::vector<std::shared_ptr<PbdConstraint>> constraints;
+    for (auto material : { PbdFEMConstraint::MaterialType::StVK, PbdFEMConstraint::MaterialType::NeoHookean })
+    {
+        auto c0 = std::make_shared<PbdFEMTetConstraint>(material);
+        c0->initConstraint(vertices, 0, 1, 2, 3, config);
+        auto c1 = std::make_shared<PbdFEMTetConstraint>(material);
+        c1->initConstraint(vertices, 1, 2, 3, 4, config);
+        constraints.push_back(c0);
+        constraints.push_back(c1);
+    }
+
+    // Deform
+    vertices[3]     = Vec3d(0.1, 0.2, 1.3);
+    vertices[4]     = Vec3d(1.2, 0.9, 1.1);
+    VecDataArray<double, 3> batchedVertices = vertices;
+
+    PbdConstraintContainer container;
+    container.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+    for (const auto& c : constraints)
+    {
+        container.addConstraint(c);
+    }
+    // One batch per material
+    ASSERT_EQ(container.getBatches().size(), 2);
+
+    for (int iter = 0; iter < 5; iter++)
+    {
+        for (const auto& c : constraints)
+        {
+            c->projectConstraint(invMasses, 0.01, PbdConstraint::SolverType::xPBD, vertices);
+        }
+        for (const auto& batch : container.getBatches())
+        {
+            batch->projectConstraints(0, batch->size(), invMasses, 0.01, PbdConstraint::SolverType::xPBD, batchedVertices);
+        }
+    }
+
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_NEAR((vertices[i] - batchedVertices[i]).norm(), 0.0, 1e-10);
+    }
+}
+
+///
+/// \brief Test that constraints of custom types are not batched
+///
+TEST(imstkPbdConstraintContainerTest, TestCustomConstraintNotBatched)
+{
+    VecDataArray<double, 3> vertices    = *makeChainVertices(3, Vec3d(1.0, 0.0, 0.0));
+    auto                    constraints = makeChainConstraints(vertices, 1e5);
+
+    auto custom = std::make_shared<CustomDistanceConstraint>();
+    custom->initConstraint(vertices, 0, 2, 1e5);
+
+    PbdConstraintContainer container;
+    container.addConstraint(constraints[0]);
+    container.addConstraint(custom);
+    container.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+    container.addConstraint(constraints[1]);
+
+    ASSERT_EQ(container.getConstraints().size(), 1);
+    EXPECT_EQ(container.getConstraints()[0], custom);
+    ASSERT_EQ(container.getBatches().size(), 1);
+    EXPECT_EQ(container.getBatches()[0]->size(), 2);
+}
+
+///
+/// \brief Test that partitions of batched constraints share no vertices and that
+/// removal keeps them consistent
+///
+TEST(imstkPbdConstraintContainerTest, TestBatchedPartitioning)
+{
+    VecDataArray<double, 3> vertices    = *makeChainVertices(101, Vec3d(1.0, 0.0, 0.0));
+    auto                    constraints = makeChainConstraints(vertices, 1e5);
+
+    PbdConstraintContainer container;
+    container.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+    for (const auto& c : constraints)
+    {
+        container.addConstraint(c);
+    }
+    container.partitionConstraints(1);
+
+    const PbdConstraintBatch& batch = *container.getBatches()[0];
+    ASSERT_EQ(batch.size(), 100);
+    // A chain needs at least two colors
+    ASSERT_GE(batch.getNumPartitions(), 2);
+
+    auto checkPartitions = [&]()
+                           {
+                               const std::vector<size_t>& offsets = batch.getPartitionOffsets();
+                               for (size_t p = 0; p < batch.getNumPartitions(); p++)
+                               {
+                                   std::unordered_set<size_t> usedVerts;
+                                   for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+                                   {
+                                       const size_t* ids = batch.getVertexIds(i);
+                                       EXPECT_TRUE(usedVerts.insert(ids[0]).second);
+                                       EXPECT_TRUE(usedVerts.insert(ids[1]).second);
+                                   }
+                               }
+                           };
+    checkPartitions();
+    EXPECT_EQ(batch.getPartitionOffsets().back(), batch.size());
+
+    // Remove vertex 50, the two constraints using it should go
+    auto removeVerts = std::make_shared<std::unordered_set<size_t>>();
+    removeVerts->insert(50);
+    container.removeConstraints(removeVerts);
+    ASSERT_EQ(batch.size(), 98);
+    checkPartitions();
+    EXPECT_EQ(batch.getPartitionOffsets().back(), batch.size());
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        EXPECT_NE(batch.getVertexIds(i)[0], 50);
+        EXPECT_NE(batch.getVertexIds(i)[1], 50);
+    }
+}
+
+///
+/// \brief Test that constraints added after removal are put in the partitions
+/// freed by the removed ones
+///
+TEST(imstkPbdConstraintContainerTest, TestIncrementalPartitioning)
+{
+    for (auto mode : { PbdConstraintContainer::StorageMode::Polymorphic, PbdConstraintContainer::StorageMode::Batched })
+    {
+        VecDataArray<double, 3> vertices    = *makeChainVertices(101, Vec3d(1.0, 0.0, 0.0));
+        auto                    constraints = makeChainConstraints(vertices, 1e5);
+
+        PbdConstraintContainer container;
+        container.setStorageMode(mode);
+        for (const auto& c : constraints)
+        {
+            container.addConstraint(c);
+        }
+        container.partitionConstraints(1);
+        ASSERT_TRUE(arePartitionsIndependent(container));
+        const size_t numSequential = container.getConstraints().size();
+
+        // Cut at vertex 50 and reconnect it
+        auto removeVerts = std::make_shared<std::unordered_set<size_t>>();
+        removeVerts->insert(50);
+        container.removeConstraints(removeVerts);
+        auto c0 = std::make_shared<PbdDistanceConstraint>();
+        c0->initConstraint(vertices, 49, 50, 1e5);
+        auto c1 = std::make_shared<PbdDistanceConstraint>();
+        c1->initConstraint(vertices, 50, 51, 1e5);
+        container.addConstraint(c0);
+        container.addConstraint(c1);
+
+        // Neither should end up solved sequentially
+        EXPECT_EQ(container.getConstraints().size(), numSequential);
+        EXPECT_TRUE(arePartitionsIndependent(container));
+
+        // Constraints at a vertex used in every partition open new partitions instead
+        // of being solved sequentially. Vertex 10 is then used by 12 constraints, each
+        // in its own partition
+        for (int i = 0; i < 10; i++)
+        {
+            auto c = std::make_shared<PbdDistanceConstraint>();
+            c->initConstraint(vertices, 10, 20 + i, 1e5);
+            container.addConstraint(c);
+        }
+        EXPECT_EQ(container.getConstraints().size(), numSequential);
+        EXPECT_GE(getNumPartitions(container), 12);
+        EXPECT_TRUE(arePartitionsIndependent(container));
+    }
+}
+
+///
+/// \brief Test that removing constraints through the vertex to constraint index removes
+/// exactly those using the vertices, by vertices, by vertex range, by pointer and by iterator
+///
+TEST(imstkPbdConstraintContainerTest, TestIndexedRemoval)
+{
+    for (auto mode : { PbdConstraintContainer::StorageMode::Polymorphic, PbdConstraintContainer::StorageMode::Batched })
+    {
+        VecDataArray<double, 3> vertices    = *makeChainVertices(1001, Vec3d(1.0, 0.0, 0.0));
+        auto                    constraints = makeChainConstraints(vertices, 1e5);
+
+        PbdConstraintContainer container;
+        container.setStorageMode(mode);
+        for (const auto& c : constraints)
+        {
+            container.addConstraint(c);
+        }
+        container.partitionConstraints(1);
+
+        auto countConstraints = [&]()
+                                {
+                                    size_t count = container.getConstraints().size();
+                                    for (const auto& partition : container.getPartitionedConstraints())
+                                    {
+                                        count += partition.size();
+                                    }
+                                    for (const auto& batch : container.getBatches())
+                                    {
+                                        count += batch->size();
+                                    }
+                                    return count;
+                                };
+        auto usesVertex = [&](const size_t vid)
+                          {
+                              for (const auto& batch : container.getBatches())
+                              {
+                                  for (size_t i = 0; i < batch->size(); i++)
+                                  {
+                                      if (batch->getVertexIds(i)[0] == vid || batch->getVertexIds(i)[1] == vid)
+                                      {
+                                          return true;
+                                      }
+                                  }
+                              }
+                              auto uses = [&](const std::vector<std::shared_ptr<PbdConstraint>>& cs)
+                                          {
+                                              for (const auto& c : cs)
+                                              {
+                                                  const auto ids = static_cast<const PbdConstraint&>(*c).getVertexIds();
+                                                  if (std::find(ids.begin(), ids.end(), vid) != ids.end())
+                                                  {
+                                                      return true;
+                                                  }
+                                              }
+                                              return false;
+                                          };
+                              bool isUsed = uses(container.getConstraints());
+                              for (const auto& partition : container.getPartitionedConstraints())
+                              {
+                                  isUsed |= uses(partition);
+                              }
+                              return isUsed;
+                          };
+
+        // Vertices 10 and 11 share a constraint, 5 constraints use the three vertices
+        auto removeVerts = std::make_shared<std::unordered_set<size_t>>();
+        *removeVerts = { 10, 11, 500 };
+        container.removeConstraints(removeVerts);
+        EXPECT_EQ(countConstraints(), 1000 - 5);
+        EXPECT_FALSE(usesVertex(10));
+        EXPECT_FALSE(usesVertex(11));
+        EXPECT_FALSE(usesVertex(500));
+        EXPECT_TRUE(usesVertex(9));
+        EXPECT_TRUE(usesVertex(501));
+        EXPECT_TRUE(arePartitionsIndependent(container));
+
+        if (mode == PbdConstraintContainer::StorageMode::Polymorphic)
+        {
+            // Constraint 700 joins vertices 700 and 701
+            container.removeConstraint(constraints[700]);
+            EXPECT_EQ(countConstraints(), 1000 - 6);
+            EXPECT_TRUE(usesVertex(700));
+            removeVerts->clear();
+            removeVerts->insert(701);
+            container.removeConstraints(removeVerts);
+            EXPECT_EQ(countConstraints(), 1000 - 7);
+            EXPECT_FALSE(usesVertex(701));
+
+            container.clearPartitions();
+            auto iter = container.eraseConstraint(container.getConstraints().begin());
+            EXPECT_EQ(iter, container.getConstraints().begin());
+            EXPECT_EQ(countConstraints(), 1000 - 8);
+        }
+
+        // Vertices 900 to 949 are used by constraints 899 to 949
+        const size_t numConstraints = countConstraints();
+        container.removeConstraints(900, 950);
+        EXPECT_EQ(countConstraints(), numConstraints - 51);
+        EXPECT_FALSE(usesVertex(900));
+        EXPECT_FALSE(usesVertex(949));
+        EXPECT_TRUE(usesVertex(899));
+        EXPECT_TRUE(usesVertex(950));
+        EXPECT_TRUE(arePartitionsIndependent(container));
+
+        // Removing every vertex empties the container
+        removeVerts->clear();
+        for (size_t i = 0; i < 1001; i++)
+        {
+            removeVerts->insert(i);
+        }
+        container.removeConstraints(removeVerts);
+        EXPECT_TRUE(container.empty());
+    }
+}
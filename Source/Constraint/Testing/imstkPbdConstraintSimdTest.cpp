@@ -0,0 +1,192 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdConstraintSimd.h"
+#include "imstkPbdDihedralConstraint.h"
+#include "imstkPbdDistanceConstraint.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Builds a cloth grid with distance and dihedral constraints in batches,
+/// perturbs it and projects every constraint a few times with the given instruction set
+///
+VecDataArray<double, 3>
+solveCloth(const PbdConstraintSimd::InstructionSet set, const PbdConstraint::SolverType solverType)
+{
+    // PBD stiffness is in [0, 1]
+    const bool   isPBD = (solverType == PbdConstraint::SolverType::PBD);
+    const double distStiffness     = isPBD ? 0.9 : 1e3;
+    const double dihedralStiffness = isPBD ? 0.5 : 1e2;
+
+    const int               dim = 23;
+    VecDataArray<double, 3> vertices(dim * dim);
+    DataArray<double>       invMasses(dim * dim);
+    for (int y = 0; y < dim; y++)
+    {
+        for (int x = 0; x < dim; x++)
+        {
+            vertices[y * dim + x]  = Vec3d(x * 0.1, 0.0, y * 0.1);
+            invMasses[y * dim + x] = (y == 0) ? 0.0 : 1.0;
+        }
+    }
+
+    PbdConstraintContainer container;
+    container.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+    for (int y = 0; y < dim - 1; y++)
+    {
+        for (int x = 0; x < dim - 1; x++)
+        {
+            const size_t a = y * dim + x;
+            const size_t b = a + 1;
+            const size_t c = a + dim;
+            const size_t d = c + 1;
+
+            auto dist0 = std::make_shared<PbdDistanceConstraint>();
+            dist0->initConstraint(vertices, a, b, distStiffness);
+            auto dist1 = std::make_shared<PbdDistanceConstraint>();
+            dist1->initConstraint(vertices, a, c, distStiffness);
+            auto dist2 = std::make_shared<PbdDistanceConstraint>();
+            dist2->initConstraint(vertices, b, c, distStiffness);
+            container.addConstraint(dist0);
+            container.addConstraint(dist1);
+            container.addConstraint(dist2);
+
+            // Triangles (a, b, c) and (b, d, c) share edge b-c
+            auto dihedral = std::make_shared<PbdDihedralConstraint>();
+            dihedral->initConstraint(vertices, a, d, b, c, dihedralStiffness);
+            container.addConstraint(dihedral);
+        }
+    }
+    container.partitionConstraints(8);
+    EXPECT_EQ(container.getBatches().size(), 2);
+
+    // Perturb
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        if (invMasses[i] > 0.0)
+        {
+            vertices[i] += Vec3d(0.01 * ((i * 7) % 5), -0.02 * ((i * 3) % 4), 0.015 * ((i * 11) % 3));
+        }
+    }
+
+    const PbdConstraintSimd::InstructionSet prevSet = PbdConstraintSimd::getInstructionSet();
+    PbdConstraintSimd::setInstructionSet(set);
+    for (int iter = 0; iter < 10; iter++)
+    {
+        for (const auto& batch : container.getBatches())
+        {
+            const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+            for (size_t p = 0; p < batch->getNumPartitions(); p++)
+            {
+                batch->projectConstraints(offsets[p], offsets[p + 1], invMasses, 0.01, solverType, vertices);
+            }
+            batch->projectConstraints(offsets.back(), batch->size(), invMasses, 0.01, solverType, vertices);
+        }
+    }
+    PbdConstraintSimd::setInstructionSet(prevSet);
+
+    return vertices;
+}
+}
+
+///
+/// \brief Test that the simd kernels (when supported by the cpu) give the scalar results
+///
+TEST(imstkPbdConstraintSimdTest, TestMatchesScalarXPBD)
+{
+    const VecDataArray<double, 3> scalarResults = solveCloth(PbdConstraintSimd::InstructionSet::Scalar, PbdConstraint::SolverType::xPBD);
+    const VecDataArray<double, 3> simdResults   = solveCloth(PbdConstraintSimd::getSupportedInstructionSet(), PbdConstraint::SolverType::xPBD);
+    for (int i = 0; i < scalarResults.size(); i++)
+    {
+        EXPECT_NEAR((scalarResults[i] - simdResults[i]).norm(), 0.0, 1e-10);
+    }
+}
+
+///
+/// \brief Test that the simd kernels (when supported by the cpu) give the scalar results
+///
+TEST(imstkPbdConstraintSimdTest, TestMatchesScalarPBD)
+{
+    const VecDataArray<double, 3> scalarResults = solveCloth(PbdConstraintSimd::InstructionSet::Scalar, PbdConstraint::SolverType::PBD);
+    const VecDataArray<double, 3> simdResults   = solveCloth(PbdConstraintSimd::getSupportedInstructionSet(), PbdConstraint::SolverType::PBD);
+    for (int i = 0; i < scalarResults.size(); i++)
+    {
+        EXPECT_NEAR((scalarResults[i] - simdResults[i]).norm(), 0.0, 1e-10);
+    }
+}
+
+///
+/// \brief Test that the single precision kernels accumulate the multipliers in double,
+/// constraints with nothing to correct leave multipliers not representable in float as is
+///
+TEST(imstkPbdConstraintSimdTest, TestSingleKeepsDoubleLambdas)
+{
+    const int           numConstraints = 32;
+    std::vector<size_t> vertexIds(2 * numConstraints);
+    std::vector<double> restValues(numConstraints, 1.0);
+    std::vector<double> compliance(numConstraints, 1.0e-3);
+    std::vector<double> lambdas(numConstraints);
+    std::vector<float>  positions(3 * 2 * numConstraints);
+    std::vector<float>  invMasses(2 * numConstraints, 0.0f);
+    for (int i = 0; i < numConstraints; i++)
+    {
+        vertexIds[2 * i]     = 2 * i;
+        vertexIds[2 * i + 1] = 2 * i + 1;
+        lambdas[i] = 0.1 + 1.0e-12 * i;
+        positions[6 * i + 3] = 2.0f;
+    }
+    const std::vector<double> initLambdas = lambdas;
+
+    PbdConstraintSimd::BatchView batch;
+    batch.vertexIds  = vertexIds.data();
+    batch.restValues = restValues.data();
+    batch.compliance = compliance.data();
+    batch.lambdas    = lambdas.data();
+    PbdConstraintSimd::SolveView<float> solve;
+    solve.invMasses = invMasses.data();
+    solve.positions = positions.data();
+    solve.dt = 0.01;
+
+    PbdConstraintSimd::projectDistanceConstraints(batch, solve, 0, numConstraints);
+    for (int i = 0; i < numConstraints; i++)
+    {
+        EXPECT_EQ(lambdas[i], initLambdas[i]);
+    }
+}
+
+///
+/// \brief Test the instruction set is clamped to the supported one
+///
+TEST(imstkPbdConstraintSimdTest, TestSetInstructionSet)
+{
+    const PbdConstraintSimd::InstructionSet prevSet = PbdConstraintSimd::getInstructionSet();
+    PbdConstraintSimd::setInstructionSet(PbdConstraintSimd::InstructionSet::AVX512);
+    EXPECT_EQ(PbdConstraintSimd::getInstructionSet(), PbdConstraintSimd::getSupportedInstructionSet());
+    PbdConstraintSimd::setInstructionSet(PbdConstraintSimd::InstructionSet::Scalar);
+    EXPECT_EQ(PbdConstraintSimd::getInstructionSet(), PbdConstraintSimd::InstructionSet::Scalar);
+    PbdConstraintSimd::setInstructionSet(prevSet);
+}
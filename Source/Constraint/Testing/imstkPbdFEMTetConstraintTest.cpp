@@ -0,0 +1,65 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkPbdFEMTetConstraint.h"
+
+using namespace imstk;
+
+///
+/// \brief Test that the corotational constraint gives the same projection with the
+/// closed form SVD and with Eigen's
+///
+TEST(imstkPbdFEMTetConstraintTest, TestCorotationSVD)
+{
+    VecDataArray<double, 3> restVertices(4);
+    restVertices[0] = Vec3d(0.0, 0.0, 0.0);
+    restVertices[1] = Vec3d(1.0, 0.0, 0.0);
+    restVertices[2] = Vec3d(0.0, 1.0, 0.0);
+    restVertices[3] = Vec3d(0.0, 0.0, 1.0);
+    DataArray<double> invMasses(4);
+    invMasses.fill(1.0);
+
+    std::vector<VecDataArray<double, 3>> results;
+    for (const bool useEigenSVD : { false, true })
+    {
+        auto config = std::make_shared<PbdFEMConstraintConfig>(1000.0, 1000.0, 1000.0, 0.2);
+        config->m_useEigenSVD = useEigenSVD;
+        PbdFEMTetConstraint constraint(PbdFEMConstraint::MaterialType::Corotation);
+        constraint.initConstraint(restVertices, 0, 1, 2, 3, config);
+
+        // Stretch and rotate
+        VecDataArray<double, 3> vertices = restVertices;
+        vertices[1] = Vec3d(0.9, 0.5, 0.1);
+        vertices[3] = Vec3d(-0.2, 0.1, 1.4);
+        for (int i = 0; i < 5; i++)
+        {
+            constraint.projectConstraint(invMasses, 0.01, PbdConstraint::SolverType::xPBD, vertices);
+        }
+        results.push_back(vertices);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR((results[0][i] - results[1][i]).norm(), 0.0, 1.0e-10);
+    }
+}
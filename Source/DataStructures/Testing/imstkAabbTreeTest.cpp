@@ -0,0 +1,113 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkAabbTree.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Small random boxes in the unit cube
+///
+std::vector<Eigen::AlignedBox3d>
+makeBoxes(const int numBoxes, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<Eigen::AlignedBox3d>       boxes;
+    for (int i = 0; i < numBoxes; i++)
+    {
+        const Vec3d min(dist(rng), dist(rng), dist(rng));
+        boxes.emplace_back(min, min + 0.05 * Vec3d(dist(rng), dist(rng), dist(rng)));
+    }
+    return boxes;
+}
+
+std::vector<std::pair<int, int>>
+bruteForceOverlaps(const std::vector<Eigen::AlignedBox3d>& boxesA, const std::vector<Eigen::AlignedBox3d>& boxesB)
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < static_cast<int>(boxesA.size()); i++)
+    {
+        for (int j = 0; j < static_cast<int>(boxesB.size()); j++)
+        {
+            if (boxesA[i].intersects(boxesB[j]))
+            {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+}
+
+///
+/// \brief Test that the overlapping pairs of two trees are the brute force ones,
+/// after a build and after a refit to moved boxes
+///
+TEST(imstkAabbTreeTest, TestOverlaps)
+{
+    std::mt19937                     rng(7);
+    std::vector<Eigen::AlignedBox3d> boxesA = makeBoxes(2000, rng);
+    std::vector<Eigen::AlignedBox3d> boxesB = makeBoxes(1500, rng);
+
+    AabbTree treeA;
+    AabbTree treeB;
+    treeA.build(boxesA);
+    treeB.build(boxesB, 1);
+    EXPECT_EQ(treeA.getNumPrimitives(), 2000);
+
+    std::vector<std::pair<int, int>> pairs;
+    treeA.computeOverlaps(treeB, pairs);
+    std::sort(pairs.begin(), pairs.end());
+    const std::vector<std::pair<int, int>> expectedPairs = bruteForceOverlaps(boxesA, boxesB);
+    EXPECT_FALSE(expectedPairs.empty());
+    EXPECT_EQ(pairs, expectedPairs);
+
+    // Move the boxes, the refit tree finds the new pairs
+    for (auto& box : boxesB)
+    {
+        box.translate(Vec3d(0.1, 0.0, -0.05));
+    }
+    treeB.refit(boxesB);
+    treeA.computeOverlaps(treeB, pairs);
+    std::sort(pairs.begin(), pairs.end());
+    EXPECT_EQ(pairs, bruteForceOverlaps(boxesA, boxesB));
+
+    // Disjoint trees
+    for (auto& box : boxesB)
+    {
+        box.translate(Vec3d(2.0, 0.0, 0.0));
+    }
+    treeB.update(boxesB);
+    treeA.computeOverlaps(treeB, pairs);
+    EXPECT_TRUE(pairs.empty());
+
+    // Box queries
+    EXPECT_TRUE(treeA.intersects(boxesA[0]));
+    EXPECT_FALSE(treeA.intersects(Eigen::AlignedBox3d(Vec3d(1.5, 0.0, 0.0), Vec3d(1.6, 1.0, 1.0))));
+    EXPECT_FALSE(AabbTree().intersects(boxesA[0]));
+}
@@ -93,4 +93,75 @@ TEST(imstkGraphTest, WelshPowellColoring)
     // g2.print();
     auto colorsG2 = g2.doColoring(Graph::ColoringMethod::WelshPowell, false);
     EXPECT_EQ(true, verifyColoring(g2, colorsG2.first));
-}
\ No newline at end of file
+}
+
+TEST(imstkGraphTest, JonesPlassmannColoring)
+{
+    Graph g1(5);
+    g1.addEdge(0, 1);
+    g1.addEdge(0, 2);
+    g1.addEdge(1, 2);
+    g1.addEdge(1, 3);
+    g1.addEdge(2, 3);
+    g1.addEdge(3, 4);
+    auto colorsG1 = g1.doColoring(Graph::ColoringMethod::JonesPlassmann, false);
+    EXPECT_EQ(true, verifyColoring(g1, colorsG1.first));
+    EXPECT_EQ(3, colorsG1.second);
+
+    // Grid of 4-connected nodes, large enough to take several rounds
+    const size_t dim = 64;
+    Graph        g2(dim * dim);
+    for (size_t i = 0; i < dim; ++i)
+    {
+        for (size_t j = 0; j < dim; ++j)
+        {
+            if (i + 1 < dim)
+            {
+                g2.addEdge(i * dim + j, (i + 1) * dim + j);
+            }
+            if (j + 1 < dim)
+            {
+                g2.addEdge(i * dim + j, i * dim + j + 1);
+            }
+        }
+    }
+    auto colorsG2 = g2.doColoring(Graph::ColoringMethod::JonesPlassmann, false);
+    EXPECT_EQ(true, verifyColoring(g2, colorsG2.first));
+    EXPECT_LE(colorsG2.second, 5);
+}
+
+TEST(imstkGraphTest, EdgesFromSharedKeys)
+{
+    // Nodes are segments of a closed polyline, keys are its vertices
+    const size_t        numNodes = 50;
+    std::vector<size_t> offsets(numNodes + 1);
+    std::vector<size_t> keys;
+    Graph               g1(numNodes);
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        keys.push_back(i);
+        keys.push_back((i + 1) % numNodes);
+        offsets[i + 1] = keys.size();
+        g1.addEdge(i, (i + 1) % numNodes);
+    }
+    Graph g2(numNodes);
+    g2.setEdgesFromSharedKeys(offsets, keys);
+
+    std::unordered_set<size_t> edges1, edges2;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        g1.getEdges(i, edges1);
+        g2.getEdges(i, edges2);
+        EXPECT_EQ(edges1, edges2);
+    }
+    for (auto method : { Graph::ColoringMethod::Greedy, Graph::ColoringMethod::WelshPowell, Graph::ColoringMethod::JonesPlassmann })
+    {
+        EXPECT_EQ(true, verifyColoring(g2, g2.doColoring(method, false).first));
+    }
+
+    // Adding an edge after keeps the shared key edges
+    g2.addEdge(0, numNodes / 2);
+    g2.getEdges(0, edges2);
+    EXPECT_EQ(3, edges2.size());
+    EXPECT_EQ(true, verifyColoring(g2, g2.doColoring(Graph::ColoringMethod::JonesPlassmann, false).first));
+}
@@ -137,6 +137,23 @@ randomizePositions(const std::shared_ptr<SurfaceMesh>& mesh)
     mesh->postModified();
 }
 
+///
+/// \brief Move all the vertices by a small random offset
+///
+void
+jitterPositions(const std::shared_ptr<PointSet>& pointset, const double amplitude)
+{
+    for (int i = 0; i < pointset->getNumVertices(); ++i)
+    {
+        pointset->setVertexPosition(i, pointset->getVertexPosition(i) + Vec3d(
+            (static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0) * amplitude,
+            (static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0) * amplitude,
+            (static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0) * amplitude
+            ));
+    }
+    pointset->postModified();
+}
+
 namespace imstk
 {
 class LooseOctreeTest : public ::testing::Test
@@ -205,7 +222,7 @@ public:
             unsigned int primitiveCounts[OctreePrimitiveType::NumPrimitiveTypes];
             for (int i = 0; i < OctreePrimitiveType::NumPrimitiveTypes; ++i)
             {
-                primitiveCounts[i] = 0;
+                primitiveCounts[i] = m_Octree->getRootNode()->getPrimitiveCount(static_cast<OctreePrimitiveType>(i));
             }
 
             for (const auto& it:  m_Octree->m_sActiveTreeNodeBlocks)
@@ -364,3 +381,19 @@ TEST_F(LooseOctreeTest, TestTeleportingPrimitives)
         randomizePositions(m_Mesh);
     }
 }
+
+///
+/// \brief Test incremental octree update while primitives move by small steps, only some
+/// of them leaving their nodes at every update
+///
+TEST_F(LooseOctreeTest, TestMovingPrimitives)
+{
+    buildExample();
+    m_Octree->setAlwaysRebuild(false);
+    for (int iter = 0; iter < 5 * ITERATIONS; ++iter)
+    {
+        testOctree();
+        jitterPositions(m_PointSet, 0.5);
+        jitterPositions(m_Mesh, 0.5);
+    }
+}
@@ -0,0 +1,58 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkObjectPool.h"
+
+using namespace imstk;
+
+///
+/// \brief Test that objects keep their address across blocks and that a reset
+/// reuses the memory instead of allocating more
+///
+TEST(imstkObjectPoolTest, TestReuse)
+{
+    ObjectPool<int>   pool(4);
+    std::vector<int*> ptrs;
+    for (int i = 0; i < 10; i++)
+    {
+        ptrs.push_back(pool.acquire());
+        *ptrs.back() = i;
+    }
+    EXPECT_EQ(pool.size(), 10);
+    EXPECT_EQ(pool.capacity(), 12);
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(&pool[i], ptrs[i]);
+        EXPECT_EQ(pool[i], i);
+    }
+
+    pool.reset();
+    EXPECT_EQ(pool.size(), 0);
+    for (int i = 0; i < 10; i++)
+    {
+        pool.push_back(-i);
+        EXPECT_EQ(&pool.back(), ptrs[i]);
+        EXPECT_EQ(pool.back(), -i);
+    }
+    EXPECT_EQ(pool.capacity(), 12);
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkSweepAndPrune.h"
+
+#include <random>
+
+using namespace imstk;
+
+///
+/// \brief Test that the overlapping pairs match a test of all pairs as random boxes
+/// are added and moved around
+///
+TEST(imstkSweepAndPruneTest, TestOverlappingPairs)
+{
+    std::mt19937                           rng(7);
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    std::uniform_real_distribution<double> size(0.0, 0.2);
+    std::uniform_real_distribution<double> displacement(-0.05, 0.05);
+
+    const int                        numBoxes = 50;
+    std::vector<Eigen::AlignedBox3d> boxes;
+    SweepAndPrune                    sweepAndPrune;
+    for (int i = 0; i < numBoxes; i++)
+    {
+        const Vec3d min(position(rng), position(rng), position(rng));
+        boxes.push_back(Eigen::AlignedBox3d(min, min + Vec3d(size(rng), size(rng), size(rng))));
+        EXPECT_EQ(sweepAndPrune.addProxy(boxes.back()), i);
+    }
+    // Touching boxes overlap
+    boxes[1] = Eigen::AlignedBox3d(boxes[0].max(), boxes[0].max() + Vec3d(0.1, 0.1, 0.1));
+    sweepAndPrune.updateProxy(1, boxes[1]);
+
+    for (int step = 0; step < 20; step++)
+    {
+        std::vector<std::pair<int, int>> expectedPairs;
+        for (int i = 0; i < numBoxes; i++)
+        {
+            for (int j = i + 1; j < numBoxes; j++)
+            {
+                if (boxes[i].intersects(boxes[j]))
+                {
+                    expectedPairs.push_back({ i, j });
+                }
+                EXPECT_EQ(sweepAndPrune.isOverlapping(i, j), boxes[i].intersects(boxes[j]));
+            }
+        }
+        std::vector<std::pair<int, int>> pairs;
+        sweepAndPrune.getOverlappingPairs(pairs);
+        EXPECT_EQ(pairs, expectedPairs);
+
+        // Move and resize every box
+        for (int i = 0; i < numBoxes; i++)
+        {
+            const Vec3d min = boxes[i].min() + Vec3d(displacement(rng), displacement(rng), displacement(rng));
+            const Vec3d max = (boxes[i].max() + Vec3d(displacement(rng), displacement(rng), displacement(rng))).cwiseMax(min);
+            boxes[i] = Eigen::AlignedBox3d(min, max);
+            sweepAndPrune.updateProxy(i, boxes[i]);
+        }
+    }
+    sweepAndPrune.beginFrame();
+    EXPECT_TRUE(sweepAndPrune.updateAndTestPair(0, [&]() { return boxes[0]; }, 1, [&]() { return boxes[0]; }));
+
+    sweepAndPrune.clear();
+    EXPECT_EQ(sweepAndPrune.getNumProxies(), 0);
+}
+
+///
+/// \brief Test that the margin grows the boxes
+///
+TEST(imstkSweepAndPruneTest, TestMargin)
+{
+    SweepAndPrune sweepAndPrune;
+    sweepAndPrune.setMargin(0.1);
+    const int a = sweepAndPrune.addProxy(Eigen::AlignedBox3d(Vec3d::Zero(), Vec3d::Ones()));
+    const int b = sweepAndPrune.addProxy(Eigen::AlignedBox3d(Vec3d(1.15, 0.0, 0.0), Vec3d(2.0, 1.0, 1.0)));
+    EXPECT_TRUE(sweepAndPrune.isOverlapping(a, b));
+    sweepAndPrune.updateProxy(b, Eigen::AlignedBox3d(Vec3d(1.25, 0.0, 0.0), Vec3d(2.0, 1.0, 1.0)));
+    EXPECT_FALSE(sweepAndPrune.isOverlapping(a, b));
+}
+
+///
+/// \brief Test that the box of a proxy shared by several pairs is computed once per frame
+///
+TEST(imstkSweepAndPruneTest, TestBoxOncePerFrame)
+{
+    SweepAndPrune sweepAndPrune;
+    const int     a = sweepAndPrune.addProxy(Eigen::AlignedBox3d(Vec3d::Zero(), Vec3d::Ones()));
+    const int     b = sweepAndPrune.addProxy(Eigen::AlignedBox3d(Vec3d(2.0, 0.0, 0.0), Vec3d(3.0, 1.0, 1.0)));
+    const int     c = sweepAndPrune.addProxy(Eigen::AlignedBox3d(Vec3d(0.0, 2.0, 0.0), Vec3d(1.0, 3.0, 1.0)));
+
+    // a moves over to b
+    int  numComputes = 0;
+    auto computeBoxA = [&]()
+                       {
+                           numComputes++;
+                           return Eigen::AlignedBox3d(Vec3d(1.5, 0.0, 0.0), Vec3d(2.5, 1.0, 1.0));
+                       };
+    auto computeBoxB = [&]() { return Eigen::AlignedBox3d(Vec3d(2.0, 0.0, 0.0), Vec3d(3.0, 1.0, 1.0)); };
+    auto computeBoxC = [&]() { return Eigen::AlignedBox3d(Vec3d(0.0, 2.0, 0.0), Vec3d(1.0, 3.0, 1.0)); };
+
+    // Boxes given on addition hold for the frame they were added in
+    EXPECT_FALSE(sweepAndPrune.updateAndTestPair(a, computeBoxA, b, computeBoxB));
+    EXPECT_EQ(numComputes, 0);
+
+    sweepAndPrune.beginFrame();
+    EXPECT_TRUE(sweepAndPrune.updateAndTestPair(a, computeBoxA, b, computeBoxB));
+    EXPECT_FALSE(sweepAndPrune.updateAndTestPair(a, computeBoxA, c, computeBoxC));
+    EXPECT_EQ(numComputes, 1);
+
+    sweepAndPrune.beginFrame();
+    EXPECT_FALSE(sweepAndPrune.updateAndTestPair(c, computeBoxC, a, computeBoxA));
+    EXPECT_EQ(numComputes, 2);
+}
@@ -0,0 +1,295 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkAabbTree.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace imstk
+{
+namespace
+{
+///
+/// \brief Node pairs are expanded breadth first until there are this many to share among threads
+///
+const size_t s_minParallelNodePairs = 256;
+
+///
+/// \brief Whether the traversal of two overlapping nodes descends into the first one,
+/// the larger one or the only internal one
+///
+bool
+descendFirst(const AabbTree::Node& a, const AabbTree::Node& b)
+{
+    return b.isLeaf() || (!a.isLeaf() && a.box.diagonal().squaredNorm() > b.box.diagonal().squaredNorm());
+}
+}
+
+void
+AabbTree::build(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes, const int maxLeafSize)
+{
+    const int numPrimitives = static_cast<int>(primitiveBoxes.size());
+    m_primitiveIds.resize(numPrimitives);
+    std::iota(m_primitiveIds.begin(), m_primitiveIds.end(), 0);
+    m_nodes.clear();
+    m_leaves.clear();
+    if (numPrimitives == 0)
+    {
+        m_boxes.clear();
+        return;
+    }
+
+    std::vector<Vec3d> centers(numPrimitives);
+    for (int i = 0; i < numPrimitives; i++)
+    {
+        centers[i] = primitiveBoxes[i].center();
+    }
+
+    // Top down, every node splits its primitives at the median center along the
+    // longest axis of the centers
+    m_nodes.reserve(2 * numPrimitives / std::max(maxLeafSize, 1) + 1);
+    m_nodes.push_back(Node());
+    m_nodes[0].end = numPrimitives;
+    std::vector<int> stack = { 0 };
+    while (!stack.empty())
+    {
+        const int nodeId = stack.back();
+        stack.pop_back();
+        const int begin = m_nodes[nodeId].begin;
+        const int end   = m_nodes[nodeId].end;
+        if (end - begin <= maxLeafSize)
+        {
+            m_leaves.push_back(nodeId);
+            continue;
+        }
+
+        Eigen::AlignedBox3d centerBox;
+        for (int i = begin; i < end; i++)
+        {
+            centerBox.extend(centers[m_primitiveIds[i]]);
+        }
+        int axis;
+        centerBox.sizes().maxCoeff(&axis);
+
+        const int mid = (begin + end) / 2;
+        std::nth_element(m_primitiveIds.begin() + begin, m_primitiveIds.begin() + mid, m_primitiveIds.begin() + end,
+            [&](const int a, const int b) { return centers[a][axis] < centers[b][axis]; });
+
+        const int child = static_cast<int>(m_nodes.size());
+        m_nodes[nodeId].child = child;
+        m_nodes.resize(m_nodes.size() + 2);
+        m_nodes[child].begin     = begin;
+        m_nodes[child].end       = mid;
+        m_nodes[child + 1].begin = mid;
+        m_nodes[child + 1].end   = end;
+        stack.push_back(child + 1);
+        stack.push_back(child);
+    }
+
+    refit(primitiveBoxes);
+}
+
+void
+AabbTree::refit(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes)
+{
+    CHECK(static_cast<int>(primitiveBoxes.size()) == getNumPrimitives()) << "Refit with a different number of primitives";
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    m_boxes.resize(m_primitiveIds.size());
+    ParallelUtils::parallelFor(m_leaves.size(),
+        [&](const size_t i)
+        {
+            Node& leaf = m_nodes[m_leaves[i]];
+            leaf.box.setEmpty();
+            for (int j = leaf.begin; j < leaf.end; j++)
+            {
+                m_boxes[j] = primitiveBoxes[m_primitiveIds[j]];
+                leaf.box.extend(m_boxes[j]);
+            }
+        });
+
+    // Children come after their parent, bottom up is in reverse
+    for (int i = static_cast<int>(m_nodes.size()) - 1; i >= 0; i--)
+    {
+        Node& node = m_nodes[i];
+        if (!node.isLeaf())
+        {
+            node.box = m_nodes[node.child].box.merged(m_nodes[node.child + 1].box);
+        }
+    }
+}
+
+void
+AabbTree::update(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes, const int maxLeafSize)
+{
+    if (static_cast<int>(primitiveBoxes.size()) != getNumPrimitives() || m_nodes.empty())
+    {
+        build(primitiveBoxes, maxLeafSize);
+    }
+    else
+    {
+        refit(primitiveBoxes);
+    }
+}
+
+void
+AabbTree::computeOverlaps(const AabbTree& other, std::vector<std::pair<int, int>>& pairs) const
+{
+    pairs.clear();
+    if (m_nodes.empty() || other.m_nodes.empty() || !m_nodes[0].box.intersects(other.m_nodes[0].box))
+    {
+        return;
+    }
+
+    // Breadth first until there are enough node pairs to traverse in parallel
+    std::vector<std::pair<int, int>> front = { { 0, 0 } };
+    std::vector<std::pair<int, int>> nextFront;
+    while (!front.empty() && front.size() < s_minParallelNodePairs)
+    {
+        nextFront.clear();
+        for (const auto& nodePair : front)
+        {
+            const Node& nodeA = m_nodes[nodePair.first];
+            const Node& nodeB = other.m_nodes[nodePair.second];
+            if (nodeA.isLeaf() && nodeB.isLeaf())
+            {
+                overlapLeaves(other, nodeA, nodeB, pairs);
+                continue;
+            }
+
+            const bool descendA = descendFirst(nodeA, nodeB);
+            for (int k = 0; k < 2; k++)
+            {
+                const std::pair<int, int> childPair = descendA ?
+                                                      std::make_pair(nodeA.child + k, nodePair.second) :
+                                                      std::make_pair(nodePair.first, nodeB.child + k);
+                if (m_nodes[childPair.first].box.intersects(other.m_nodes[childPair.second].box))
+                {
+                    nextFront.push_back(childPair);
+                }
+            }
+        }
+        std::swap(front, nextFront);
+    }
+
+    // Every node pair of the front appends to its own list, concatenated in order
+    std::vector<std::vector<std::pair<int, int>>> frontPairs(front.size());
+    ParallelUtils::parallelFor(front.size(),
+        [&](const size_t i)
+        {
+            std::vector<std::pair<int, int>> stack;
+            traverse(other, front[i].first, front[i].second, stack, frontPairs[i]);
+        });
+    for (const auto& nodePairs : frontPairs)
+    {
+        pairs.insert(pairs.end(), nodePairs.begin(), nodePairs.end());
+    }
+}
+
+bool
+AabbTree::intersects(const Eigen::AlignedBox3d& queryBox) const
+{
+    if (m_nodes.empty())
+    {
+        return false;
+    }
+
+    std::vector<int> stack = { 0 };
+    while (!stack.empty())
+    {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.intersects(queryBox))
+        {
+            continue;
+        }
+
+        if (node.isLeaf())
+        {
+            for (int i = node.begin; i < node.end; i++)
+            {
+                if (m_boxes[i].intersects(queryBox))
+                {
+                    return true;
+                }
+            }
+            continue;
+        }
+        stack.push_back(node.child);
+        stack.push_back(node.child + 1);
+    }
+    return false;
+}
+
+void
+AabbTree::traverse(const AabbTree& other, const int nodeA, const int nodeB,
+                   std::vector<std::pair<int, int>>& stack, std::vector<std::pair<int, int>>& pairs) const
+{
+    stack.clear();
+    stack.emplace_back(nodeA, nodeB);
+    while (!stack.empty())
+    {
+        const std::pair<int, int> nodePair = stack.back();
+        stack.pop_back();
+        const Node& a = m_nodes[nodePair.first];
+        const Node& b = other.m_nodes[nodePair.second];
+        if (a.isLeaf() && b.isLeaf())
+        {
+            overlapLeaves(other, a, b, pairs);
+            continue;
+        }
+
+        const bool descendA = descendFirst(a, b);
+        for (int k = 1; k >= 0; k--)
+        {
+            const std::pair<int, int> childPair = descendA ?
+                                                  std::make_pair(a.child + k, nodePair.second) :
+                                                  std::make_pair(nodePair.first, b.child + k);
+            if (m_nodes[childPair.first].box.intersects(other.m_nodes[childPair.second].box))
+            {
+                stack.push_back(childPair);
+            }
+        }
+    }
+}
+
+void
+AabbTree::overlapLeaves(const AabbTree& other, const Node& leafA, const Node& leafB,
+                        std::vector<std::pair<int, int>>& pairs) const
+{
+    for (int i = leafA.begin; i < leafA.end; i++)
+    {
+        for (int j = leafB.begin; j < leafB.end; j++)
+        {
+            if (m_boxes[i].intersects(other.m_boxes[j]))
+            {
+                pairs.emplace_back(m_primitiveIds[i], other.m_primitiveIds[j]);
+            }
+        }
+    }
+}
+} // imstk
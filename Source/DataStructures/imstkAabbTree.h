@@ -0,0 +1,196 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkParallelUtils.h"
+#include "imstkVecDataArray.h"
+
+#include <limits>
+
+namespace imstk
+{
+///
+/// \class AabbTree
+///
+/// \brief Bounding volume hierarchy of axis aligned boxes over a set of primitives
+/// (ie: the triangles of a mesh) given by their boxes. Built top down by median splits,
+/// it can be refit to new boxes of the same primitives (ie: a deforming mesh) in linear
+/// time, the tree then stays valid but gets looser as the primitives move away from
+/// where it was built
+///
+class AabbTree
+{
+public:
+    ///
+    /// \brief A node covers the primitives [begin, end) of the tree order, an internal
+    /// node has its two children at child and child + 1
+    ///
+    struct Node
+    {
+        Eigen::AlignedBox3d box;
+        int child = -1; ///> -1 for leaves
+        int begin = 0;
+        int end   = 0;
+
+        bool isLeaf() const { return child == -1; }
+    };
+
+public:
+    AabbTree() = default;
+    ~AabbTree() = default;
+
+public:
+    ///
+    /// \brief Build the tree over the given primitive boxes
+    /// \param maxLeafSize max number of primitives per leaf
+    ///
+    void build(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes, const int maxLeafSize = 4);
+
+    ///
+    /// \brief Recompute the boxes of every node from new boxes of the same primitives,
+    /// keeping the structure of the tree
+    ///
+    void refit(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes);
+
+    ///
+    /// \brief Build the tree when the number of primitives differs from the one it was
+    /// built with, refit it otherwise
+    ///
+    void update(const std::vector<Eigen::AlignedBox3d>& primitiveBoxes, const int maxLeafSize = 4);
+
+    ///
+    /// \brief Find the pairs of primitives of this and the other tree whose boxes overlap,
+    /// by a simultaneous traversal of both trees. The traversal is parallel, the pairs
+    /// are (this primitive, other primitive) in an order independent of the number of threads
+    ///
+    void computeOverlaps(const AabbTree& other, std::vector<std::pair<int, int>>& pairs) const;
+
+    ///
+    /// \brief Returns whether the box of any primitive overlaps queryBox
+    ///
+    bool intersects(const Eigen::AlignedBox3d& queryBox) const;
+
+    ///
+    /// \brief Branch and bound search of the primitive nearest to a query (ie: a point or
+    /// a segment) bounded by queryBox. visit(primitiveId, bestSqrDist) is called on the
+    /// primitives whose box is not farther from queryBox than the best squared distance
+    /// found so far, nearest boxes first, and returns the updated best squared distance.
+    /// Primitives exactly as far as the best are visited too, such that ties can be broken
+    ///
+    template<typename Visit>
+    void visitNearest(const Eigen::AlignedBox3d& queryBox, Visit&& visit) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        double bestSqrDist = std::numeric_limits<double>::max();
+        std::vector<std::pair<int, double>> stack = { { 0, m_nodes[0].box.squaredExteriorDistance(queryBox) } };
+        while (!stack.empty())
+        {
+            const std::pair<int, double> entry = stack.back();
+            stack.pop_back();
+            if (entry.second > bestSqrDist)
+            {
+                continue;
+            }
+
+            const Node& node = m_nodes[entry.first];
+            if (node.isLeaf())
+            {
+                for (int i = node.begin; i < node.end; i++)
+                {
+                    if (m_boxes[i].squaredExteriorDistance(queryBox) <= bestSqrDist)
+                    {
+                        bestSqrDist = visit(m_primitiveIds[i], bestSqrDist);
+                    }
+                }
+                continue;
+            }
+
+            // Nearest child on top of the stack
+            const double sqrDist0 = m_nodes[node.child].box.squaredExteriorDistance(queryBox);
+            const double sqrDist1 = m_nodes[node.child + 1].box.squaredExteriorDistance(queryBox);
+            if (sqrDist0 <= sqrDist1)
+            {
+                stack.emplace_back(node.child + 1, sqrDist1);
+                stack.emplace_back(node.child, sqrDist0);
+            }
+            else
+            {
+                stack.emplace_back(node.child, sqrDist0);
+                stack.emplace_back(node.child + 1, sqrDist1);
+            }
+        }
+    }
+
+    ///
+    /// \brief Computes the bounding box of every cell (ie: line, triangle, tetrahedron) of a mesh
+    ///
+    template<int N>
+    static void computeCellBoxes(const VecDataArray<int, N>& indices, const VecDataArray<double, 3>& vertices,
+                                 std::vector<Eigen::AlignedBox3d>& boxes)
+    {
+        boxes.resize(indices.size());
+        ParallelUtils::parallelFor(indices.size(),
+            [&](const int i)
+            {
+                const Eigen::Matrix<int, N, 1>& cell = indices[i];
+                boxes[i] = Eigen::AlignedBox3d(vertices[cell[0]]);
+                for (int j = 1; j < N; j++)
+                {
+                    boxes[i].extend(vertices[cell[j]]);
+                }
+            });
+    }
+
+    ///
+    /// \brief Returns the number of primitives the tree was built over
+    ///
+    int getNumPrimitives() const { return static_cast<int>(m_primitiveIds.size()); }
+
+    ///
+    /// \brief Returns the nodes, the first is the root
+    ///
+    const std::vector<Node>& getNodes() const { return m_nodes; }
+
+protected:
+    ///
+    /// \brief Depth first traversal of the node pair, appending the overlapping primitive pairs
+    ///
+    void traverse(const AabbTree& other, const int nodeA, const int nodeB,
+                  std::vector<std::pair<int, int>>& stack, std::vector<std::pair<int, int>>& pairs) const;
+
+    ///
+    /// \brief Appends the overlapping primitive pairs of two leaves
+    ///
+    void overlapLeaves(const AabbTree& other, const Node& leafA, const Node& leafB,
+                       std::vector<std::pair<int, int>>& pairs) const;
+
+    std::vector<Node> m_nodes;                   ///> Children always come after their parent
+    std::vector<int>  m_primitiveIds;            ///> Primitive ids in tree order
+    std::vector<Eigen::AlignedBox3d> m_boxes;    ///> Primitive boxes in tree order
+    std::vector<int> m_leaves;                   ///> Indices of the leaf nodes
+};
+} // imstk
@@ -23,6 +23,9 @@
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <numeric>
 
 namespace imstk
@@ -30,10 +33,12 @@ namespace imstk
 void
 Graph::addEdge(const size_t v, const size_t w)
 {
-    if (v < m_adjList.size() && w < m_adjList.size())
+    if (v < m_numNodes && w < m_numNodes)
     {
+        updateAdjList();
         m_adjList[v].insert(w);
         m_adjList[w].insert(v);
+        m_csrValid = false;
     }
     else
     {
@@ -41,41 +46,164 @@ Graph::addEdge(const size_t v, const size_t w)
     }
 }
 
+void
+Graph::setEdgesFromSharedKeys(const std::vector<size_t>& nodeKeyOffsets, const std::vector<size_t>& nodeKeys)
+{
+    CHECK(nodeKeyOffsets.size() == m_numNodes + 1) << "Key offsets should be given for every node plus one";
+
+    // Invert to the nodes of every key, also compressed
+    size_t numKeys = 0;
+    for (const size_t key : nodeKeys)
+    {
+        numKeys = std::max(numKeys, key + 1);
+    }
+    std::vector<size_t> keyNodeOffsets(numKeys + 1, 0);
+    for (const size_t key : nodeKeys)
+    {
+        keyNodeOffsets[key + 1]++;
+    }
+    std::partial_sum(keyNodeOffsets.begin(), keyNodeOffsets.end(), keyNodeOffsets.begin());
+
+    std::vector<size_t> keyNodes(nodeKeys.size());
+    std::vector<size_t> writeIdx(keyNodeOffsets.begin(), keyNodeOffsets.end() - 1);
+    for (size_t node = 0; node < m_numNodes; node++)
+    {
+        for (size_t i = nodeKeyOffsets[node]; i < nodeKeyOffsets[node + 1]; i++)
+        {
+            keyNodes[writeIdx[nodeKeys[i]]++] = node;
+        }
+    }
+
+    // The neighbors of a node are the other nodes of its keys
+    std::vector<std::vector<size_t>> neighbors(m_numNodes);
+    ParallelUtils::parallelFor(m_numNodes,
+        [&](const size_t node)
+        {
+            std::vector<size_t>& nodeNeighbors = neighbors[node];
+            for (size_t i = nodeKeyOffsets[node]; i < nodeKeyOffsets[node + 1]; i++)
+            {
+                const size_t key = nodeKeys[i];
+                for (size_t j = keyNodeOffsets[key]; j < keyNodeOffsets[key + 1]; j++)
+                {
+                    if (keyNodes[j] != node)
+                    {
+                        nodeNeighbors.push_back(keyNodes[j]);
+                    }
+                }
+            }
+            std::sort(nodeNeighbors.begin(), nodeNeighbors.end());
+            nodeNeighbors.erase(std::unique(nodeNeighbors.begin(), nodeNeighbors.end()), nodeNeighbors.end());
+        });
+
+    m_csrOffsets.resize(m_numNodes + 1);
+    m_csrOffsets[0] = 0;
+    for (size_t node = 0; node < m_numNodes; node++)
+    {
+        m_csrOffsets[node + 1] = m_csrOffsets[node] + neighbors[node].size();
+    }
+    m_csrAdjacency.resize(m_csrOffsets.back());
+    ParallelUtils::parallelFor(m_numNodes,
+        [&](const size_t node)
+        {
+            std::copy(neighbors[node].begin(), neighbors[node].end(), m_csrAdjacency.begin() + m_csrOffsets[node]);
+        });
+    m_csrValid = true;
+
+    // The adjacency list is only rebuilt if edges are added later
+    m_adjList.clear();
+    m_adjListValid = false;
+}
+
 void
 Graph::getEdges(const size_t v, edgeType& edges) const
 {
-    edges = m_adjList[v];
+    if (m_adjListValid)
+    {
+        edges = m_adjList[v];
+    }
+    else
+    {
+        edges.clear();
+        edges.insert(m_csrAdjacency.begin() + m_csrOffsets[v], m_csrAdjacency.begin() + m_csrOffsets[v + 1]);
+    }
 }
 
 void
 Graph::print() const
 {
-    std::cout << "Graph: " << "\nTotal nodes: " << m_adjList.size() << "\nAdjacency:" << std::endl;
+    updateCSR();
+    std::cout << "Graph: " << "\nTotal nodes: " << m_numNodes << "\nAdjacency:" << std::endl;
 
-    for (size_t i = 0; i < m_adjList.size(); i++)
+    for (size_t i = 0; i < m_numNodes; i++)
     {
         std::cout << "\t[" << i << "] : ";
 
-        for (auto v : m_adjList[i])
+        for (size_t j = m_csrOffsets[i]; j < m_csrOffsets[i + 1]; j++)
         {
-            std::cout << v << " ";
+            std::cout << m_csrAdjacency[j] << " ";
         }
         std::cout << std::endl;
     }
 }
 
+void
+Graph::updateCSR() const
+{
+    if (m_csrValid)
+    {
+        return;
+    }
+
+    m_csrOffsets.resize(m_numNodes + 1);
+    m_csrOffsets[0] = 0;
+    for (size_t i = 0; i < m_numNodes; i++)
+    {
+        m_csrOffsets[i + 1] = m_csrOffsets[i] + m_adjList[i].size();
+    }
+    m_csrAdjacency.resize(m_csrOffsets.back());
+    ParallelUtils::parallelFor(m_numNodes,
+        [&](const size_t i)
+        {
+            std::copy(m_adjList[i].begin(), m_adjList[i].end(), m_csrAdjacency.begin() + m_csrOffsets[i]);
+        });
+    m_csrValid = true;
+}
+
+void
+Graph::updateAdjList()
+{
+    if (m_adjListValid)
+    {
+        return;
+    }
+
+    m_adjList.resize(m_numNodes);
+    for (size_t i = 0; i < m_numNodes; i++)
+    {
+        m_adjList[i].insert(m_csrAdjacency.begin() + m_csrOffsets[i], m_csrAdjacency.begin() + m_csrOffsets[i + 1]);
+    }
+    m_adjListValid = true;
+}
+
 Graph::graphColorsType
 Graph::doColoring(ColoringMethod method /*=ColoringMethod::WelshPowell*/, bool print /*= false*/) const
 {
-    return method == ColoringMethod::WelshPowell ?
-           doColoringWelshPowell(print) :
-           doColoringGreedy(print);
+    updateCSR();
+    switch (method)
+    {
+    case ColoringMethod::WelshPowell:
+        return doColoringWelshPowell(print);
+    case ColoringMethod::JonesPlassmann:
+        return doColoringJonesPlassmann(print);
+    default:
+        return doColoringGreedy(print);
+    }
 }
 
 Graph::graphColorsType
 Graph::doColoringWelshPowell(bool print /*= false*/) const
 {
-    const auto numNodes = m_adjList.size();
+    const auto numNodes = m_numNodes;
 
     using ColorType = unsigned short;
     const ColorType INVALID = std::numeric_limits<unsigned short>::max();
@@ -87,7 +215,7 @@ Graph::doColoringWelshPowell(bool print /*= false*/) const
     ParallelUtils::parallelFor(numNodes,
         [&](const size_t idx)
         {
-            neighborCounts[idx] = m_adjList[idx].size();
+            neighborCounts[idx] = m_csrOffsets[idx + 1] - m_csrOffsets[idx];
         });
 
     std::vector<size_t> coloringOrder(numNodes);
@@ -109,8 +237,9 @@ Graph::doColoringWelshPowell(bool print /*= false*/) const
         {
             const auto u   = coloringOrder[i];
             bool       bOK = true;
-            for (const auto v : m_adjList[u])
+            for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
             {
+                const size_t v = m_csrAdjacency[j];
                 // Check if any neighbor node has the same color as the first processing node
                 if (colors[v] == color)
                 {
@@ -165,7 +294,7 @@ Graph::doColoringWelshPowell(bool print /*= false*/) const
 std::pair<std::vector<unsigned short>, unsigned short>
 Graph::doColoringGreedy(bool print /*= false*/) const
 {
-    const auto                  numNodes = m_adjList.size();
+    const auto                  numNodes = m_numNodes;
     std::vector<unsigned short> colors(numNodes, std::numeric_limits<unsigned short>::max());
     std::vector<bool>           available(numNodes, false);
 
@@ -177,8 +306,9 @@ Graph::doColoringGreedy(bool print /*= false*/) const
     {
         // Process all adjacent vertices and flag their colors
         // as unavailable
-        for (const auto& i : m_adjList[u])
+        for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
         {
+            const size_t i = m_csrAdjacency[j];
             if (colors[i] != std::numeric_limits<unsigned short>::max())
             {
                 available[colors[i]] = true;
@@ -201,8 +331,9 @@ Graph::doColoringGreedy(bool print /*= false*/) const
         }
 
         // Reset the values back to false for the next iteration
-        for (const auto& i : m_adjList[u])
+        for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
         {
+            const size_t i = m_csrAdjacency[j];
             if (colors[i] != std::numeric_limits<unsigned short>::max())
             {
                 available[colors[i]] = false;
@@ -231,4 +362,145 @@ Graph::doColoringGreedy(bool print /*= false*/) const
 
     return std::make_pair(colors, numColors);
 }
+
+///
+/// \brief Hash used to order nodes of equal degree (splitmix64 finalizer)
+///
+static inline uint64_t
+hashNode(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x  = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x  = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+Graph::graphColorsType
+Graph::doColoringJonesPlassmann(bool print /*= false*/) const
+{
+    const size_t numNodes = m_numNodes;
+
+    using ColorType = unsigned short;
+    std::vector<ColorType> colors(numNodes, std::numeric_limits<ColorType>::max());
+
+    // Largest degree first gives fewer colors, ties are broken randomly but deterministically.
+    // This orients every edge, from the node with higher priority to the one with lower priority
+    std::vector<uint64_t> priorities(numNodes);
+    ParallelUtils::parallelFor(numNodes,
+        [&](const size_t u)
+        {
+            const uint64_t degree = std::min<uint64_t>(m_csrOffsets[u + 1] - m_csrOffsets[u], 0xFFFF);
+            priorities[u] = (degree << 48) | (hashNode(u) >> 16);
+        });
+    auto isHigher = [&](const size_t v, const size_t u)
+                    {
+                        return (priorities[v] != priorities[u]) ? priorities[v] > priorities[u] : v > u;
+                    };
+
+    // Count the neighbors with higher priority, the nodes without any are colored first
+    std::vector<std::atomic<size_t>> numWaiting(numNodes);
+    std::vector<size_t>              frontier(numNodes);
+    std::atomic<size_t>              frontierSize(0);
+    ParallelUtils::parallelFor(numNodes,
+        [&](const size_t u)
+        {
+            size_t count = 0;
+            for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
+            {
+                count += isHigher(m_csrAdjacency[j], u) ? 1 : 0;
+            }
+            numWaiting[u] = count;
+            if (count == 0)
+            {
+                frontier[frontierSize++] = u;
+            }
+        });
+
+    std::vector<size_t> nextFrontier(numNodes);
+    while (frontierSize > 0)
+    {
+        // No two nodes of the frontier are neighbors and all their higher priority
+        // neighbors are colored, give them the smallest color not used by those
+        ParallelUtils::parallelFor(frontierSize.load(),
+            [&](const size_t i)
+            {
+                const size_t u      = frontier[i];
+                const size_t degree = m_csrOffsets[u + 1] - m_csrOffsets[u];
+
+                // At most degree + 1 colors are needed
+                char              localUsed[256];
+                std::vector<char> heapUsed;
+                char*             used = localUsed;
+                if (degree >= 256)
+                {
+                    heapUsed.resize(degree + 1);
+                    used = heapUsed.data();
+                }
+                std::fill_n(used, degree + 1, 0);
+                for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
+                {
+                    const ColorType c = colors[m_csrAdjacency[j]];
+                    if (c <= degree)
+                    {
+                        used[c] = 1;
+                    }
+                }
+                ColorType color = 0;
+                while (used[color])
+                {
+                    ++color;
+                }
+                colors[u] = color;
+            });
+
+        // Release the lower priority neighbors that no longer wait on any node. The
+        // order of the next frontier varies but the colors do not depend on it
+        std::atomic<size_t> nextFrontierSize(0);
+        ParallelUtils::parallelFor(frontierSize.load(),
+            [&](const size_t i)
+            {
+                const size_t u = frontier[i];
+                for (size_t j = m_csrOffsets[u]; j < m_csrOffsets[u + 1]; j++)
+                {
+                    const size_t v = m_csrAdjacency[j];
+                    if (isHigher(u, v) && --numWaiting[v] == 0)
+                    {
+                        nextFrontier[nextFrontierSize++] = v;
+                    }
+                }
+            });
+        std::swap(frontier, nextFrontier);
+        frontierSize = nextFrontierSize.load();
+    }
+
+    ColorType numColors = 0;
+    for (const ColorType c : colors)
+    {
+        numColors = std::max(numColors, static_cast<ColorType>(c + 1));
+    }
+
+    graphColorsType coloring = std::make_pair(colors, numColors);
+    if (print)
+    {
+        printColoring(coloring);
+    }
+    return coloring;
+}
+
+void
+Graph::printColoring(const graphColorsType& coloring)
+{
+    std::map<size_t, size_t> verticesPerColor;
+    std::cout << "Num. of nodes: " << coloring.first.size() << " | Num. of colors: " << coloring.second << std::endl;
+    for (const auto color : coloring.first)
+    {
+        verticesPerColor[color]++;
+    }
+    std::cout << "Vertices per color: " << std::endl;
+    for (const auto& kv : verticesPerColor)
+    {
+        std::cout << "C: " << kv.first << " - " << kv.second << std::endl;
+    }
+    std::cout << std::endl;
+}
 }
@@ -21,13 +21,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <unordered_set>
 #include <vector>
 
 namespace imstk
 {
 ///
-/// \brief class to represent a graph object
+/// \brief class to represent a graph object. Edges are either added one by one
+/// (adjacency list) or all at once in compressed sparse row (CSR) form. Coloring
+/// always runs on the CSR form
 ///
 class Graph
 {
@@ -37,13 +40,14 @@ public:
     enum class ColoringMethod
     {
         Greedy,
-        WelshPowell
+        WelshPowell,
+        JonesPlassmann ///> Parallel, colors every node that is a local maximum at once
     };
 
     ///
     /// \brief Constructor/destructor
     ///
-    Graph(const size_t size) { m_adjList.resize(size); }
+    Graph(const size_t size) : m_numNodes(size) { m_adjList.resize(size); }
     ~Graph() = default;
 
     ///
@@ -51,6 +55,14 @@ public:
     ///
     void addEdge(const size_t v, const size_t w);
 
+    ///
+    /// \brief Sets all edges at once by connecting every pair of nodes that share a key
+    /// (ie: constraints sharing a vertex). The keys of node i are
+    /// nodeKeys[nodeKeyOffsets[i], nodeKeyOffsets[i + 1]). Much faster than adding
+    /// every pair with addEdge, the CSR adjacency is built in parallel. Replaces all edges
+    ///
+    void setEdgesFromSharedKeys(const std::vector<size_t>& nodeKeyOffsets, const std::vector<size_t>& nodeKeys);
+
     ///
     /// \brief Get edges surrounding a node
     ///
@@ -59,7 +71,7 @@ public:
     ///
     /// \brief Get size of the graph
     ///
-    size_t size() const { return m_adjList.size(); }
+    size_t size() const { return m_numNodes; }
 
     ///
     /// \brief print adjacency list representation of graph
@@ -91,7 +103,37 @@ protected:
     ///
     graphColorsType doColoringWelshPowell(bool print = false) const;
 
-    std::vector<edgeType> m_adjList;    ///< A array of std::vectors to represent adjacency list
+    ///
+    /// \brief Colorize in parallel using Jones-Plassmann. Nodes are colored, with the
+    /// smallest color free among their neighbors, in rounds of the nodes whose neighbors
+    /// of higher priority (degree, then a hash of the id) are all colored. Total work is
+    /// linear in the number of edges and the result does not depend on the number of threads
+    /// \return Vertex colors and number of colors
+    ///
+    graphColorsType doColoringJonesPlassmann(bool print = false) const;
+
+    ///
+    /// \brief Print the number of nodes per color
+    ///
+    static void printColoring(const graphColorsType& coloring);
+
+    ///
+    /// \brief Builds the CSR adjacency from the adjacency list if out of date
+    ///
+    void updateCSR() const;
+
+    ///
+    /// \brief Builds the adjacency list from the CSR adjacency if out of date
+    ///
+    void updateAdjList();
+
+    size_t                m_numNodes = 0;
+    std::vector<edgeType> m_adjList;             ///< A array of std::vectors to represent adjacency list
+    bool                  m_adjListValid = true; ///< False when the edges were given in CSR form
+
+    mutable std::vector<size_t> m_csrOffsets;        ///< Neighbors of node i are m_csrAdjacency[m_csrOffsets[i], m_csrOffsets[i + 1])
+    mutable std::vector<size_t> m_csrAdjacency;
+    mutable bool                m_csrValid = false;
     ColoringMethod m_ColoringMethod = ColoringMethod::WelshPowell;
 };
 }
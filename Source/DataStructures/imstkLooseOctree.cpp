@@ -22,6 +22,7 @@
 #include "imstkLooseOctree.h"
 #include "imstkLogger.h"
 #include "imstkSurfaceMesh.h"
+#include "imstkVecDataArray.h"
 
 namespace imstk
 {
@@ -189,13 +190,21 @@ OctreeNode::keepPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimiti
 void
 OctreeNode::insertPoint(OctreePrimitive* const pPrimitive)
 {
-    // Type alias, to reduce copy/past errors
-    static const auto type = OctreePrimitiveType::Point;
+    findNodeForPoint(pPrimitive)->keepPrimitive(pPrimitive, OctreePrimitiveType::Point);
+}
 
+void
+OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type)
+{
+    findNodeForNonPointPrimitive(pPrimitive)->keepPrimitive(pPrimitive, type);
+}
+
+OctreeNode*
+OctreeNode::findNodeForPoint(const OctreePrimitive* const pPrimitive)
+{
     if (m_Depth == m_MaxDepth)
     {
-        keepPrimitive(pPrimitive, type);
-        return;
+        return this;
     }
 
     // Split node if this is a leaf node
@@ -211,11 +220,11 @@ OctreeNode::insertPoint(OctreePrimitive* const pPrimitive)
         }
     }
 
-    m_pChildren->m_Nodes[childIdx].insertPoint(pPrimitive);
+    return m_pChildren->m_Nodes[childIdx].findNodeForPoint(pPrimitive);
 }
 
-void
-OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type)
+OctreeNode*
+OctreeNode::findNodeForNonPointPrimitive(const OctreePrimitive* const pPrimitive)
 {
     const auto  lowerCorner = pPrimitive->m_LowerCorner;
     const auto  upperCorner = pPrimitive->m_UpperCorner;
@@ -231,8 +240,7 @@ OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const Oct
 
     if (m_Depth == m_MaxDepth)
     {
-        keepPrimitive(pPrimitive, type);
-        return;
+        return this;
     }
 
     uint32_t childIdx  = 0;
@@ -267,15 +275,14 @@ OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const Oct
     // If the primive straddles over multiple children nodes, we must keep it at the current node
     if (bStraddle)
     {
-        keepPrimitive(pPrimitive, type);
-        return;
+        return this;
     }
 
     // Split node if this is a leaf node
     split();
 
-    // Insert the primitive to the child node that loosely contains it
-    m_pChildren->m_Nodes[childIdx].insertNonPointPrimitive(pPrimitive, type);
+    // Find the node in the child node that loosely contains the primitive
+    return m_pChildren->m_Nodes[childIdx].findNodeForNonPointPrimitive(pPrimitive);
 }
 
 LooseOctree::LooseOctree(const Vec3d& center, const double width, const double minWidth,
@@ -612,6 +619,11 @@ LooseOctree::incrementalUpdate()
 {
     // For all primitives, update their positions (if point) or bounding box (if non-point)
     // Then, check their validity (valid primitive = it is still loosely contained in the node's bounding box)
+    // The invalid primitives are collected, with the nodes they have to be removed from
+    for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
+    {
+        m_vInvalidPrimitives[type].resize(0);
+    }
     updatePositionAndCheckValidity();
     updateBoundingBoxAndCheckValidity(OctreePrimitiveType::Triangle);
     updateBoundingBoxAndCheckValidity(OctreePrimitiveType::Analytical);
@@ -636,33 +648,51 @@ LooseOctree::updatePositionAndCheckValidity()
     {
         return;
     }
-    ParallelUtils::parallelFor(vPrimitivePtrs.size(),
-        [&](const size_t idx) {
-            const auto pPrimitive = vPrimitivePtrs[idx];
-            const auto pointset   = static_cast<PointSet*>(pPrimitive->m_pGeometry);
-            const auto point      = pointset->getVertexPosition(pPrimitive->m_Idx);
+    ParallelUtils::parallelForRange(size_t(0), vPrimitivePtrs.size(),
+        [&](const size_t begin, const size_t end) {
+            // Primitives of a geometry are contiguous, fetch its vertices once instead of once per primitive
+            const PointSet*                pPointSet = nullptr;
+            const VecDataArray<double, 3>* pVertices = nullptr;
+            std::vector<std::pair<OctreeNode*, OctreePrimitive*>> invalidPrimitives;
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                const auto pPrimitive = vPrimitivePtrs[idx];
+                if (pPrimitive->m_pGeometry != pPointSet)
+                {
+                    pPointSet = static_cast<PointSet*>(pPrimitive->m_pGeometry);
+                    pVertices = pPointSet->getVertexPositions().get();
+                }
+                const Vec3d& point = (*pVertices)[pPrimitive->m_Idx];
 
-            // Cache the position
-            pPrimitive->m_Position = { point[0], point[1], point[2] };
+                // Cache the position
+                pPrimitive->m_Position = { point[0], point[1], point[2] };
 
-            auto pNode = pPrimitive->m_pNode;
-            if (!pNode->looselyContains(point) && pNode != m_pRootNode)
-            {
-                // Go up, find the node tightly containing it (or stop if reached root node)
-                while (pNode != m_pRootNode) {
-                    pNode = pNode->m_pParent; // Go up one level
-                    if (pNode->contains(point) || pNode == m_pRootNode)
+                auto pNode = pPrimitive->m_pNode;
+                if (!pNode->looselyContains(point) && pNode != m_pRootNode)
+                {
+                    invalidPrimitives.push_back({ pNode, pPrimitive });
+
+                    // Go up, find the node tightly containing it (or stop if reached root node)
+                    while (pNode != m_pRootNode) {
+                        pNode = pNode->m_pParent; // Go up one level
+                        if (pNode->contains(point) || pNode == m_pRootNode)
+                        {
+                            pPrimitive->m_bValid = false;
+                            pPrimitive->m_pNode  = pNode;
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    pPrimitive->m_bValid = (pNode != m_pRootNode) ? true : false;
+                    if (!pPrimitive->m_bValid)
                     {
-                        pPrimitive->m_bValid = false;
-                        pPrimitive->m_pNode  = pNode;
-                        break;
+                        invalidPrimitives.push_back({ pNode, pPrimitive });
                     }
                 }
             }
-            else
-            {
-                pPrimitive->m_bValid = (pNode != m_pRootNode) ? true : false;
-            }
+            addInvalidPrimitives(OctreePrimitiveType::Point, invalidPrimitives);
         });
 }
 
@@ -674,120 +704,162 @@ LooseOctree::updateBoundingBoxAndCheckValidity(const OctreePrimitiveType type)
     {
         return;
     }
-    ParallelUtils::parallelFor(vPrimitivePtrs.size(),
-        [&](const size_t idx) {
-            const auto pPrimitive = vPrimitivePtrs[idx];
-            computePrimitiveBoundingBox(pPrimitive, type);
-            const auto lowerCorner = pPrimitive->m_LowerCorner;
-            const auto upperCorner = pPrimitive->m_UpperCorner;
-            const Vec3d center(
-                (lowerCorner[0] + upperCorner[0]) * 0.5,
-                (lowerCorner[1] + upperCorner[1]) * 0.5,
-                (lowerCorner[2] + upperCorner[2]) * 0.5);
-
-            auto pNode = pPrimitive->m_pNode;
-            if (!pNode->looselyContains(lowerCorner, upperCorner) && pNode != m_pRootNode)
+    ParallelUtils::parallelForRange(size_t(0), vPrimitivePtrs.size(),
+        [&](const size_t begin, const size_t end) {
+            // Triangles of a mesh are contiguous, fetch its buffers once instead of once per primitive
+            const SurfaceMesh*             pSurfMesh = nullptr;
+            const VecDataArray<double, 3>* pVertices = nullptr;
+            const VecDataArray<int, 3>*    pIndices  = nullptr;
+            std::vector<std::pair<OctreeNode*, OctreePrimitive*>> invalidPrimitives;
+            for (size_t idx = begin; idx < end; ++idx)
             {
-                // Go up, find the node tightly containing it (or stop if reached root node)
-                while (pNode != m_pRootNode) {
-                    pNode = pNode->m_pParent; // Go up one level
-
-                    if (pNode->contains(lowerCorner, upperCorner) || pNode == m_pRootNode)
+                const auto pPrimitive = vPrimitivePtrs[idx];
+                if (type == OctreePrimitiveType::Triangle)
+                {
+                    if (pPrimitive->m_pGeometry != pSurfMesh)
                     {
-                        pPrimitive->m_bValid = false;
-                        pPrimitive->m_pNode  = pNode;
-                        break;
+                        pSurfMesh = static_cast<SurfaceMesh*>(pPrimitive->m_pGeometry);
+                        pVertices = pSurfMesh->getVertexPositions().get();
+                        pIndices  = pSurfMesh->getTriangleIndices().get();
                     }
+                    computeTriangleBoundingBox(pPrimitive, *pVertices, *pIndices);
                 }
-            }
-            // If node still contains primitive + node depth reaches maxDepth
-            else if (pNode->m_Depth == m_MaxDepth)
-            {
-                pPrimitive->m_bValid = true;
-            }
-            // If node still contains primitive but node depth does not reach maxDepth,
-            // then check if the primitive straddles over children nodes
-            else
-            {
-                bool bStraddle = false;
-
-                for (uint32_t dim = 0; dim < 3; ++dim)
+                else
                 {
-                    if (m_Center[dim] < center[dim])
-                    {
-                        if (pNode->m_Center[dim] - (pNode->m_HalfWidth * 0.5) > lowerCorner[dim]
-                            || pNode->m_Center[dim] + (pNode->m_HalfWidth * 1.5) < upperCorner[dim])
-                        {
-                            bStraddle = true;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        if (pNode->m_Center[dim] + (pNode->m_HalfWidth * 0.5) < upperCorner[dim]
-                            || pNode->m_Center[dim] - (pNode->m_HalfWidth * 1.5) > lowerCorner[dim])
+                    computePrimitiveBoundingBox(pPrimitive, type);
+                }
+                const auto  lowerCorner = pPrimitive->m_LowerCorner;
+                const auto  upperCorner = pPrimitive->m_UpperCorner;
+                const Vec3d center(
+                    (lowerCorner[0] + upperCorner[0]) * 0.5,
+                    (lowerCorner[1] + upperCorner[1]) * 0.5,
+                    (lowerCorner[2] + upperCorner[2]) * 0.5);
+
+                auto pNode = pPrimitive->m_pNode;
+                if (!pNode->looselyContains(lowerCorner, upperCorner) && pNode != m_pRootNode)
+                {
+                    invalidPrimitives.push_back({ pNode, pPrimitive });
+
+                    // Go up, find the node tightly containing it (or stop if reached root node)
+                    while (pNode != m_pRootNode) {
+                        pNode = pNode->m_pParent; // Go up one level
+
+                        if (pNode->contains(lowerCorner, upperCorner) || pNode == m_pRootNode)
                         {
-                            bStraddle = true;
+                            pPrimitive->m_bValid = false;
+                            pPrimitive->m_pNode  = pNode;
                             break;
                         }
                     }
                 }
-
-                // If the primitive straddles over children nodes, it cannot be moved down to any child node
-                if (bStraddle)
+                // If node still contains primitive + node depth reaches maxDepth
+                else if (pNode->m_Depth == m_MaxDepth)
                 {
                     pPrimitive->m_bValid = true;
                 }
+                // If node still contains primitive but node depth does not reach maxDepth,
+                // then check if the primitive straddles over children nodes
                 else
                 {
-                    // Move the primitive down to a child node
-                    pPrimitive->m_bValid = false;
-                    pPrimitive->m_pNode  = pNode;
+                    bool bStraddle = false;
+
+                    for (uint32_t dim = 0; dim < 3; ++dim)
+                    {
+                        if (pNode->m_Center[dim] < center[dim])
+                        {
+                            if (pNode->m_Center[dim] - (pNode->m_HalfWidth * 0.5) > lowerCorner[dim]
+                                || pNode->m_Center[dim] + (pNode->m_HalfWidth * 1.5) < upperCorner[dim])
+                            {
+                                bStraddle = true;
+                                break;
+                            }
+                        }
+                        else
+                        {
+                            if (pNode->m_Center[dim] + (pNode->m_HalfWidth * 0.5) < upperCorner[dim]
+                                || pNode->m_Center[dim] - (pNode->m_HalfWidth * 1.5) > lowerCorner[dim])
+                            {
+                                bStraddle = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    // If the primitive straddles over children nodes, it cannot be moved down to any child node
+                    if (bStraddle)
+                    {
+                        pPrimitive->m_bValid = true;
+                    }
+                    else
+                    {
+                        // Move the primitive down to a child node
+                        pPrimitive->m_bValid = false;
+                        pPrimitive->m_pNode  = pNode;
+                        invalidPrimitives.push_back({ pNode, pPrimitive });
+                    }
                 }
             }
+            addInvalidPrimitives(type, invalidPrimitives);
         });
 }
 
+void
+LooseOctree::addInvalidPrimitives(const OctreePrimitiveType type, const std::vector<std::pair<OctreeNode*, OctreePrimitive*>>& invalidPrimitives)
+{
+    if (invalidPrimitives.size() == 0)
+    {
+        return;
+    }
+    m_InvalidPrimitivesLock.lock();
+    m_vInvalidPrimitives[type].insert(m_vInvalidPrimitives[type].end(), invalidPrimitives.begin(), invalidPrimitives.end());
+    m_InvalidPrimitivesLock.unlock();
+}
+
 void
 LooseOctree::removeInvalidPrimitivesFromNodes()
 {
-    if (m_sActiveTreeNodeBlocks.size() == 0)
+    // Gather the nodes that lost a primitive, each of them once
+    std::vector<OctreeNode*> invalidNodes;
+    for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
+    {
+        for (const auto& invalidPrimitive : m_vInvalidPrimitives[type])
+        {
+            invalidNodes.push_back(invalidPrimitive.first);
+        }
+    }
+    if (invalidNodes.size() == 0)
     {
         return;
     }
-    tbb::parallel_for(m_sActiveTreeNodeBlocks.range(),
-        [&](decltype(m_sActiveTreeNodeBlocks)::const_range_type& r) {
-            for (auto it = r.begin(), iEnd = r.end(); it != iEnd; ++it)
+    tbb::parallel_sort(invalidNodes.begin(), invalidNodes.end());
+    invalidNodes.erase(std::unique(invalidNodes.begin(), invalidNodes.end()), invalidNodes.end());
+
+    ParallelUtils::parallelFor(invalidNodes.size(),
+        [&](const size_t idx) {
+            const auto pNode = invalidNodes[idx];
+            for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
             {
-                const auto pNodeBlock = *it;
-                for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+                const auto pOldHead = pNode->m_pPrimitiveListHeads[type];
+                if (!pOldHead)
                 {
-                    auto& pNode = pNodeBlock->m_Nodes[childIdx];
-                    for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
-                    {
-                        const auto pOldHead = pNode.m_pPrimitiveListHeads[type];
-                        if (!pOldHead)
-                        {
-                            continue;
-                        }
+                    continue;
+                }
 
-                        OctreePrimitive* pIter    = pOldHead;
-                        OctreePrimitive* pNewHead = nullptr;
-                        uint32_t count = 0;
-                        while (pIter) {
-                            const auto pNext = pIter->m_pNext;
-                            if (pIter->m_bValid)
-                            {
-                                pIter->m_pNext = pNewHead;
-                                pNewHead       = pIter;
-                                ++count;
-                            }
-                            pIter = pNext;
-                        }
-                        pNode.m_pPrimitiveListHeads[type] = pNewHead;
-                        pNode.m_PrimitiveCounts[type]     = count;
+                OctreePrimitive* pIter    = pOldHead;
+                OctreePrimitive* pNewHead = nullptr;
+                uint32_t count = 0;
+                while (pIter) {
+                    const auto pNext = pIter->m_pNext;
+                    if (pIter->m_bValid)
+                    {
+                        pIter->m_pNext = pNewHead;
+                        pNewHead       = pIter;
+                        ++count;
                     }
+                    pIter = pNext;
                 }
+                pNode->m_pPrimitiveListHeads[type] = pNewHead;
+                pNode->m_PrimitiveCounts[type]     = count;
             }
         });
 }
@@ -795,21 +867,44 @@ LooseOctree::removeInvalidPrimitivesFromNodes()
 void
 LooseOctree::reinsertInvalidPrimitives(const OctreePrimitiveType type)
 {
-    const auto& vPrimitivePtrs = m_vPrimitivePtrs[type];
-    if (vPrimitivePtrs.size() == 0)
+    auto& vInvalidPrimitives = m_vInvalidPrimitives[type];
+    if (vInvalidPrimitives.size() == 0)
     {
         return;
     }
-    ParallelUtils::parallelFor(vPrimitivePtrs.size(),
+
+    // Find the node each primitive is inserted to, starting from the node found during validity check
+    ParallelUtils::parallelFor(vInvalidPrimitives.size(),
         [&](const size_t idx) {
-            const auto pPrimitive = vPrimitivePtrs[idx];
-            if (pPrimitive->m_bValid)
+            auto&      invalidPrimitive = vInvalidPrimitives[idx];
+            const auto pPrimitive       = invalidPrimitive.second;
+            invalidPrimitive.first = (type == OctreePrimitiveType::Point) ?
+                                     pPrimitive->m_pNode->findNodeForPoint(pPrimitive) :
+                                     pPrimitive->m_pNode->findNodeForNonPointPrimitive(pPrimitive);
+        });
+
+    // Batch the primitives by target node, then link each batch to its node
+    // Every node is modified by a single thread, no lock is needed
+    tbb::parallel_sort(vInvalidPrimitives.begin(), vInvalidPrimitives.end());
+    ParallelUtils::parallelFor(vInvalidPrimitives.size(),
+        [&](const size_t idx) {
+            const auto pNode = vInvalidPrimitives[idx].first;
+            if (idx > 0 && vInvalidPrimitives[idx - 1].first == pNode)
             {
                 return;
             }
 
-            const auto pNode = pPrimitive->m_pNode;
-            (type == OctreePrimitiveType::Point) ? pNode->insertPoint(pPrimitive) : pNode->insertNonPointPrimitive(pPrimitive, type);
+            uint32_t count = 0;
+            for (size_t i = idx; i < vInvalidPrimitives.size() && vInvalidPrimitives[i].first == pNode; ++i)
+            {
+                const auto pPrimitive = vInvalidPrimitives[i].second;
+                pPrimitive->m_pNode  = pNode;
+                pPrimitive->m_bValid = true;
+                pPrimitive->m_pNext  = pNode->m_pPrimitiveListHeads[type];
+                pNode->m_pPrimitiveListHeads[type] = pPrimitive;
+                ++count;
+            }
+            pNode->m_PrimitiveCounts[type] += count;
         });
 }
 
@@ -821,38 +916,35 @@ LooseOctree::computePrimitiveBoundingBox(OctreePrimitive* const pPrimitive, cons
         << "Cannot compute bounding box for point primitive";
 #endif
 
-    Vec3d lowerCorner;
-    Vec3d upperCorner;
-
     if (type == OctreePrimitiveType::Triangle)
     {
         const auto surfMesh = static_cast<SurfaceMesh*>(pPrimitive->m_pGeometry);
-        const auto face     = (*surfMesh->getTriangleIndices())[pPrimitive->m_Idx];
+        computeTriangleBoundingBox(pPrimitive, *surfMesh->getVertexPositions(), *surfMesh->getTriangleIndices());
+        return;
+    }
 
-        lowerCorner = surfMesh->getVertexPosition(face[0]);
-        upperCorner = lowerCorner;
+    Vec3d lowerCorner;
+    Vec3d upperCorner;
+    pPrimitive->m_pGeometry->computeBoundingBox(lowerCorner, upperCorner);
 
-        const Vec3d verts12[2] = {
-            surfMesh->getVertexPosition(face[1]),
-            surfMesh->getVertexPosition(face[2])
-        };
+    pPrimitive->m_LowerCorner = { lowerCorner[0], lowerCorner[1], lowerCorner[2] };
+    pPrimitive->m_UpperCorner = { upperCorner[0], upperCorner[1], upperCorner[2] };
+}
 
-        for (uint32_t dim = 0; dim < 3; ++dim)
-        {
-            lowerCorner[dim] = lowerCorner[dim] < verts12[0][dim] ? lowerCorner[dim] : verts12[0][dim];
-            lowerCorner[dim] = lowerCorner[dim] < verts12[1][dim] ? lowerCorner[dim] : verts12[1][dim];
+void
+LooseOctree::computeTriangleBoundingBox(OctreePrimitive* const pPrimitive,
+                                        const VecDataArray<double, 3>& vertices, const VecDataArray<int, 3>& indices)
+{
+    const Vec3i& face = indices[pPrimitive->m_Idx];
+    const Vec3d& v0   = vertices[face[0]];
+    const Vec3d& v1   = vertices[face[1]];
+    const Vec3d& v2   = vertices[face[2]];
 
-            upperCorner[dim] = upperCorner[dim] > verts12[0][dim] ? upperCorner[dim] : verts12[0][dim];
-            upperCorner[dim] = upperCorner[dim] > verts12[1][dim] ? upperCorner[dim] : verts12[1][dim];
-        }
-    }
-    else
+    for (uint32_t dim = 0; dim < 3; ++dim)
     {
-        pPrimitive->m_pGeometry->computeBoundingBox(lowerCorner, upperCorner);
+        pPrimitive->m_LowerCorner[dim] = std::min(v0[dim], std::min(v1[dim], v2[dim]));
+        pPrimitive->m_UpperCorner[dim] = std::max(v0[dim], std::max(v1[dim], v2[dim]));
     }
-
-    pPrimitive->m_LowerCorner = { lowerCorner[0], lowerCorner[1], lowerCorner[2] };
-    pPrimitive->m_UpperCorner = { upperCorner[0], upperCorner[1], upperCorner[2] };
 }
 
 OctreeNodeBlock*
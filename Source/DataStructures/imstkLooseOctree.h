@@ -26,6 +26,7 @@
 
 #include <array>
 #include <unordered_set>
+#include <vector>
 
 #ifdef WIN32
 #pragma warning(disable : 4201)
@@ -37,6 +38,7 @@ class LooseOctree;
 class Geometry;
 class PointSet;
 class SurfaceMesh;
+template<typename T, int N> class VecDataArray;
 
 ///
 /// \brief The OctreePrimitiveType enum
@@ -201,6 +203,18 @@ public:
     ///
     void insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type);
 
+    ///
+    /// \brief Find the node of the subtree a point primitive is inserted to, splitting nodes on the way down
+    /// The primitive is not added to the node
+    ///
+    OctreeNode* findNodeForPoint(const OctreePrimitive* const pPrimitive);
+
+    ///
+    /// \brief Find the node of the subtree a non-point primitive is inserted to, splitting nodes on the way down
+    /// The primitive is not added to the node
+    ///
+    OctreeNode* findNodeForNonPointPrimitive(const OctreePrimitive* const pPrimitive);
+
     ///
     /// \brief Check if the given point is contained exactly in the node boundary (bounding box)
     ///
@@ -490,20 +504,34 @@ protected:
 
     ///
     /// \brief Remove all invalid primitives from the tree nodes previously contained them
+    /// Only the nodes that lost a primitive are visited
     ///
     void removeInvalidPrimitivesFromNodes();
 
     ///
     /// \brief For each invalid primitive, insert it back to the tree in a top-down manner
     /// starting from the lowest ancestor node that tightly contains it (that node was found during validity check)
+    /// The target nodes are found in parallel, then the primitives are batched by target node and each batch
+    /// is linked to its node by a single thread, without locking
     ///
     void reinsertInvalidPrimitives(const OctreePrimitiveType type);
 
+    ///
+    /// \brief Append the invalid primitives found by a thread, with the nodes they are to be removed from
+    ///
+    void addInvalidPrimitives(const OctreePrimitiveType type, const std::vector<std::pair<OctreeNode*, OctreePrimitive*>>& invalidPrimitives);
+
     ///
     /// \brief Compute the AABB bounding box of a non-point primitive
     ///
     void computePrimitiveBoundingBox(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type);
 
+    ///
+    /// \brief Compute the AABB bounding box of a triangle primitive, from the buffers of its mesh
+    ///
+    static void computeTriangleBoundingBox(OctreePrimitive* const pPrimitive,
+                                           const VecDataArray<double, 3>& vertices, const VecDataArray<int, 3>& indices);
+
     ///
     /// \brief Request a block of 8 tree nodes from memory pool (this is called only during splitting node)
     /// If the memory pool is exhausted, 64 more blocks will be allocated from the system memory
@@ -559,6 +587,11 @@ protected:
     /// List of all indices of the added geometries, to check for duplication such that one geometry cannot be mistakenly added multiple times
     std::unordered_set<uint32_t> m_sGeometryIndices;
 
+    /// Primitives invalidated during an incremental update, each paired with a node: first the node it is removed from,
+    /// then the node it is reinserted to
+    std::vector<std::pair<OctreeNode*, OctreePrimitive*>> m_vInvalidPrimitives[OctreePrimitiveType::NumPrimitiveTypes];
+    ParallelUtils::SpinLock m_InvalidPrimitivesLock;      ///> Atomic lock for multi-threading append to the invalid primitives
+
     bool m_bAlwaysRebuild = false;                        ///> If true, the octree is always be rebuit from scratch every time calling to update()
     bool m_bCompleteBuild = false;                        ///> This is set to true after tree has been built, otherwise false
 
@@ -0,0 +1,92 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace imstk
+{
+///
+/// \class ObjectPool
+///
+/// \brief Typed pool of objects allocated in fixed size blocks. Objects keep their address
+/// until the pool is destroyed. reset() releases every object at once in O(1) and the
+/// objects are then handed out again, already constructed, so callers must reinitialize
+/// what they get. Used for objects that are all recreated every frame (ie: collision constraints)
+///
+template<typename T>
+class ObjectPool
+{
+public:
+    ObjectPool(const size_t blockSize = 256) : m_blockSize(blockSize > 0 ? blockSize : 1) { }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ///
+    /// \brief Returns the next free object, allocating a new block only when all are in use
+    ///
+    T* acquire()
+    {
+        const size_t block = m_size / m_blockSize;
+        if (block == m_blocks.size())
+        {
+            m_blocks.emplace_back(new T[m_blockSize]);
+        }
+        return &m_blocks[block][m_size++ % m_blockSize];
+    }
+
+    ///
+    /// \brief Copies value into the next free object
+    ///
+    void push_back(const T& value) { *acquire() = value; }
+
+    ///
+    /// \brief Releases all objects, the memory is kept for reuse
+    ///
+    void reset() { m_size = 0; }
+
+    ///
+    /// \brief Last acquired object
+    ///
+    T& back() { return (*this)[m_size - 1]; }
+
+    T& operator[](const size_t i) { return m_blocks[i / m_blockSize][i % m_blockSize]; }
+    const T& operator[](const size_t i) const { return m_blocks[i / m_blockSize][i % m_blockSize]; }
+
+    ///
+    /// \brief Number of objects in use
+    ///
+    size_t size() const { return m_size; }
+
+    ///
+    /// \brief Number of objects allocated
+    ///
+    size_t capacity() const { return m_blocks.size() * m_blockSize; }
+
+protected:
+    std::vector<std::unique_ptr<T[]>> m_blocks;   ///> Blocks of m_blockSize objects
+    size_t m_blockSize;                           ///> Number of objects per block
+    size_t m_size = 0;                            ///> Number of objects in use
+};
+} // imstk
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkSweepAndPrune.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+int
+SweepAndPrune::addProxy(const Eigen::AlignedBox3d& box)
+{
+    const int proxyId = getNumProxies();
+
+    // Appended after all the others the proxy overlaps none, then sort its endpoints in
+    const Eigen::AlignedBox3d grownBox(box.min().array() - m_margin, box.max().array() + m_margin);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+        const int              i = static_cast<int>(endpoints.size());
+        endpoints.push_back({ grownBox.min()[axis], proxyId, false });
+        endpoints.push_back({ grownBox.max()[axis], proxyId, true });
+        m_endpointIds[axis].push_back(i);
+        m_endpointIds[axis].push_back(i + 1);
+        sortEndpoint(axis, i);
+        sortEndpoint(axis, i + 1);
+    }
+    m_proxyFrames.push_back(m_frame);
+    m_proxyLocks.push_back(ParallelUtils::SpinLock());
+    return proxyId;
+}
+
+void
+SweepAndPrune::updateProxy(const int proxyId, const Eigen::AlignedBox3d& box)
+{
+    const Eigen::AlignedBox3d grownBox(box.min().array() - m_margin, box.max().array() + m_margin);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const int minId = m_endpointIds[axis][2 * proxyId];
+        const int maxId = m_endpointIds[axis][2 * proxyId + 1];
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+
+        // Move the leading endpoint first so the min never passes the max of the same proxy
+        if (grownBox.max()[axis] > endpoints[maxId].value)
+        {
+            endpoints[maxId].value = grownBox.max()[axis];
+            sortEndpoint(axis, maxId);
+            endpoints[minId].value = grownBox.min()[axis];
+            sortEndpoint(axis, minId);
+        }
+        else
+        {
+            endpoints[minId].value = grownBox.min()[axis];
+            sortEndpoint(axis, minId);
+            const int movedMaxId = m_endpointIds[axis][2 * proxyId + 1];
+            endpoints[movedMaxId].value = grownBox.max()[axis];
+            sortEndpoint(axis, movedMaxId);
+        }
+    }
+}
+
+void
+SweepAndPrune::updateProxyOnce(const int proxyId, const std::function<Eigen::AlignedBox3d()>& computeBox)
+{
+    // Other pairs of the proxy wait for it to be set, pairs of other proxies go on
+    m_proxyLocks[proxyId].lock();
+    if (m_proxyFrames[proxyId] != m_frame)
+    {
+        const Eigen::AlignedBox3d box = computeBox();
+        m_lock.lock();
+        updateProxy(proxyId, box);
+        m_lock.unlock();
+        m_proxyFrames[proxyId] = m_frame;
+    }
+    m_proxyLocks[proxyId].unlock();
+}
+
+bool
+SweepAndPrune::updateAndTestPair(const int proxyIdA, const std::function<Eigen::AlignedBox3d()>& computeBoxA,
+                                 const int proxyIdB, const std::function<Eigen::AlignedBox3d()>& computeBoxB)
+{
+    updateProxyOnce(proxyIdA, computeBoxA);
+    updateProxyOnce(proxyIdB, computeBoxB);
+    m_lock.lock();
+    const bool overlapping = isOverlapping(proxyIdA, proxyIdB);
+    m_lock.unlock();
+    return overlapping;
+}
+
+bool
+SweepAndPrune::isOverlapping(const int proxyIdA, const int proxyIdB) const
+{
+    auto i = m_overlapCounts.find(getPairKey(proxyIdA, proxyIdB));
+    return i != m_overlapCounts.end() && i->second == 3;
+}
+
+void
+SweepAndPrune::getOverlappingPairs(std::vector<std::pair<int, int>>& pairs) const
+{
+    pairs.clear();
+    for (const auto& overlapCount : m_overlapCounts)
+    {
+        if (overlapCount.second == 3)
+        {
+            pairs.push_back({ static_cast<int>(overlapCount.first >> 32), static_cast<int>(overlapCount.first & 0xffffffff) });
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+}
+
+void
+SweepAndPrune::clear()
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        m_endpoints[axis].clear();
+        m_endpointIds[axis].clear();
+    }
+    m_overlapCounts.clear();
+    m_proxyFrames.clear();
+    m_proxyLocks.clear();
+}
+
+void
+SweepAndPrune::sortEndpoint(const int axis, int i)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    while (i > 0 && endpoints[i] < endpoints[i - 1])
+    {
+        swapEndpoints(axis, i - 1);
+        i--;
+    }
+    while (i < static_cast<int>(endpoints.size()) - 1 && endpoints[i + 1] < endpoints[i])
+    {
+        swapEndpoints(axis, i);
+        i++;
+    }
+}
+
+void
+SweepAndPrune::swapEndpoints(const int axis, const int i)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    const Endpoint&        left      = endpoints[i];
+    const Endpoint&        right     = endpoints[i + 1];
+
+    // A max going over a min starts an overlap along the axis, a min going over a max ends one
+    if (left.isMax != right.isMax && left.proxyId != right.proxyId)
+    {
+        const std::uint64_t key = getPairKey(left.proxyId, right.proxyId);
+        if (left.isMax)
+        {
+            m_overlapCounts[key]++;
+        }
+        else
+        {
+            auto overlapCount = m_overlapCounts.find(key);
+            if (--overlapCount->second == 0)
+            {
+                m_overlapCounts.erase(overlapCount);
+            }
+        }
+    }
+
+    std::swap(endpoints[i], endpoints[i + 1]);
+    m_endpointIds[axis][2 * endpoints[i].proxyId + endpoints[i].isMax]         = i;
+    m_endpointIds[axis][2 * endpoints[i + 1].proxyId + endpoints[i + 1].isMax] = i + 1;
+}
+} // imstk
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkSpinLock.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace imstk
+{
+///
+/// \class SweepAndPrune
+///
+/// \brief Incremental sweep and prune over a set of axis aligned boxes (proxies), ie: the
+/// bounds of the objects of a scene. The box endpoints are kept sorted along each axis,
+/// moving a box insertion sorts its endpoints from where they were, which is near linear
+/// when boxes move little between updates. Every swap of a min and a max endpoint updates
+/// the number of axes the two proxies overlap on, so the overlapping pairs are known at
+/// any time without testing all of them
+///
+class SweepAndPrune
+{
+protected:
+    struct Endpoint
+    {
+        double value;
+        int proxyId;
+        bool isMax;
+
+        ///
+        /// \brief Order by value, a min goes before a max of same value such that touching
+        /// boxes overlap
+        ///
+        bool operator<(const Endpoint& other) const
+        {
+            return value < other.value || (value == other.value && !isMax && other.isMax);
+        }
+    };
+
+public:
+    SweepAndPrune() = default;
+    ~SweepAndPrune() = default;
+
+public:
+    ///
+    /// \brief Add a proxy with its box, grown by the margin
+    /// \return id of the proxy, proxies are numbered from 0 in the order they are added
+    ///
+    int addProxy(const Eigen::AlignedBox3d& box);
+
+    ///
+    /// \brief Set the box of a proxy, grown by the margin
+    ///
+    void updateProxy(const int proxyId, const Eigen::AlignedBox3d& box);
+
+    ///
+    /// \brief Starts a new frame, the box of every proxy is set again on its first
+    /// update in the frame
+    ///
+    void beginFrame() { m_frame++; }
+
+    ///
+    /// \brief Set the boxes of two proxies and returns if they overlap, this is thread safe.
+    /// The box of a proxy is only computed, and its endpoints moved, by the first pair
+    /// using it in the frame. The lock of the endpoints is not held while computing boxes
+    ///
+    bool updateAndTestPair(const int proxyIdA, const std::function<Eigen::AlignedBox3d()>& computeBoxA,
+                           const int proxyIdB, const std::function<Eigen::AlignedBox3d()>& computeBoxB);
+
+    ///
+    /// \brief Returns if the boxes of two proxies overlap
+    ///
+    bool isOverlapping(const int proxyIdA, const int proxyIdB) const;
+
+    ///
+    /// \brief Returns the pairs of overlapping proxies, with the lower id first
+    ///
+    void getOverlappingPairs(std::vector<std::pair<int, int>>& pairs) const;
+
+    ///
+    /// \brief Removes all the proxies
+    ///
+    void clear();
+
+    ///
+    /// \brief Get the number of proxies
+    ///
+    int getNumProxies() const { return static_cast<int>(m_endpointIds[0].size() / 2); }
+
+    ///
+    /// \brief Set/Get the distance boxes are grown by, pairs are reported overlapping
+    /// below twice this distance. default 0.0
+    ///
+    void setMargin(const double margin) { m_margin = margin; }
+    double getMargin() const { return m_margin; }
+
+protected:
+    ///
+    /// \brief Insertion sort the endpoint at index i of the axis to its place, counting
+    /// the overlaps it starts and ends
+    ///
+    void sortEndpoint(const int axis, int i);
+
+    ///
+    /// \brief Swap the endpoints at i and i + 1 of the axis, the one at i is passing over
+    /// the one at i + 1
+    ///
+    void swapEndpoints(const int axis, const int i);
+
+    ///
+    /// \brief Set the box of the proxy if not done yet in the frame, thread safe
+    ///
+    void updateProxyOnce(const int proxyId, const std::function<Eigen::AlignedBox3d()>& computeBox);
+
+    ///
+    /// \brief Returns the key of a proxy pair in the overlap counts
+    ///
+    static std::uint64_t getPairKey(const int proxyIdA, const int proxyIdB)
+    {
+        const std::uint64_t a = static_cast<std::uint32_t>(std::min(proxyIdA, proxyIdB));
+        const std::uint64_t b = static_cast<std::uint32_t>(std::max(proxyIdA, proxyIdB));
+        return (a << 32) | b;
+    }
+
+    std::array<std::vector<Endpoint>, 3> m_endpoints;   ///> Sorted endpoints of each axis
+    std::array<std::vector<int>, 3>      m_endpointIds; ///> Index in m_endpoints of the min (2 * proxyId) and max (2 * proxyId + 1)
+    std::unordered_map<std::uint64_t, int> m_overlapCounts; ///> Number of axes a pair overlaps on, pairs with none are not stored
+
+    double m_margin = 0.0;
+    ParallelUtils::SpinLock m_lock;                          ///> Guards the endpoints and overlap counts
+
+    size_t m_frame = 0;
+    std::vector<size_t> m_proxyFrames;                       ///> Frame the box of every proxy was last set in
+    std::vector<ParallelUtils::SpinLock> m_proxyLocks;       ///> Held while the box of the proxy is computed and set
+};
+} // imstk
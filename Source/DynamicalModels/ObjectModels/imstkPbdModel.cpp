@@ -33,6 +33,36 @@
 
 namespace imstk
 {
+namespace
+{
+///
+/// \brief Calls func with the vertex ids and count of every constraint of the container
+///
+template<typename Func>
+void
+forEachConstraint(const PbdConstraintContainer& constraints, Func func)
+{
+    for (const auto& batch : constraints.getBatches())
+    {
+        for (size_t i = 0; i < batch->size(); i++)
+        {
+            func(batch->getVertexIds(i), batch->getNumVertices());
+        }
+    }
+    for (const auto& constraint : constraints.getConstraints())
+    {
+        func(constraint->getVertexIds().data(), constraint->getVertexIds().size());
+    }
+    for (const auto& partition : constraints.getPartitionedConstraints())
+    {
+        for (const auto& constraint : partition)
+        {
+            func(constraint->getVertexIds().data(), constraint->getVertexIds().size());
+        }
+    }
+}
+}
+
 void
 PbdModelConfig::computeElasticConstants()
 {
@@ -175,9 +205,21 @@ PbdModel::PbdModel() : DynamicalModel(DynamicalModelType::PositionBasedDynamics)
     };
 
     // Setup PBD compute nodes
-    m_integrationPositionNode = m_taskGraph->addFunction("PbdModel_IntegratePosition", std::bind(&PbdModel::integratePosition, this));
-    m_solveConstraintsNode    = m_taskGraph->addFunction("PbdModel_SolveConstraints", [&]() { m_pbdSolver->solve(); }); // Avoids rebinding on solver swap
-    m_updateVelocityNode      = m_taskGraph->addFunction("PbdModel_UpdateVelocity", std::bind(&PbdModel::updateVelocity, this));
+    m_integrationPositionNode = m_taskGraph->addFunction("PbdModel_IntegratePosition", [&]() { integratePosition(); });
+    m_solveConstraintsNode    = m_taskGraph->addFunction("PbdModel_SolveConstraints", [&]() { solveConstraints(); }); // Avoids rebinding on solver swap
+    m_updateVelocityNode      = m_taskGraph->addFunction("PbdModel_UpdateVelocity", [&]()
+        {
+            updateVelocity();
+            if (!m_substepsCoupled)
+            {
+                solveSubsteps();
+                updateSleeping();
+                for (const auto& model : m_coupledModels)
+                {
+                    model->updateSleeping();
+                }
+            }
+        });
 }
 
 void
@@ -196,6 +238,11 @@ PbdModel::initialize()
     // Initialize constraints
     {
         m_constraints = std::make_shared<PbdConstraintContainer>();
+        // Single precision is only implemented for the batches
+        if (m_config->m_batchConstraints || m_config->m_scalarType == IMSTK_FLOAT)
+        {
+            m_constraints->setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+        }
 
         m_config->computeElasticConstants();
 
@@ -210,8 +257,8 @@ PbdModel::initialize()
             }
         }
 
-        // Partition constraints for parallel computation
-        if (m_config->m_doPartitioning)
+        // Partition constraints for parallel computation, Jacobi does not need it
+        if (m_config->m_doPartitioning && m_config->m_executionMode != PbdSolver::ExecutionMode::Jacobi)
         {
             m_constraints->partitionConstraints(static_cast<int>(m_partitionThreshold));
         }
@@ -225,13 +272,22 @@ PbdModel::initialize()
     if (m_pbdSolver == nullptr)
     {
         m_pbdSolver = std::make_shared<PbdSolver>();
-        m_pbdSolver->setIterations(m_config->m_iterations);
+        m_pbdSolver->setIterations((m_config->m_numSubsteps > 1) ? 1 : m_config->m_iterations);
         m_pbdSolver->setSolverType(m_config->m_solverType);
+        m_pbdSolver->setExecutionMode(m_config->m_executionMode);
+        m_pbdSolver->setRelaxation(m_config->m_relaxation);
+        m_pbdSolver->setChebyshevAcceleration(m_config->m_chebyshevAcceleration);
+        m_pbdSolver->setChebyshevSpectralRadius(m_config->m_chebyshevSpectralRadius);
+        m_pbdSolver->setLambdaWarmStart(m_config->m_lambdaWarmStart);
+        m_pbdSolver->setResidualTolerance(m_config->m_residualTolerance);
+        m_pbdSolver->setMaxIterations(m_config->m_maxIterations);
+        m_pbdSolver->setResidualCheckInterval(m_config->m_residualCheckInterval);
+        m_pbdSolver->setScalarType(m_config->m_scalarType);
     }
     m_pbdSolver->setPositions(getCurrentState()->getPositions());
-    m_pbdSolver->setInvMasses(getInvMasses());
+    m_pbdSolver->setInvMasses(getActiveInvMasses());
     m_pbdSolver->setConstraints(getConstraints());
-    m_pbdSolver->setTimeStep(m_config->m_dt);
+    m_pbdSolver->setTimeStep(getSubstepTimeStep());
 
     this->setTimeStepSizeType(m_timeStepSizeType);
 
@@ -307,6 +363,22 @@ PbdModel::initState()
     {
         setFixedPoint(i);
     }
+
+    // All nodes start awake, the active inverse masses are only a copy when nodes may sleep
+    m_sleeping.assign(numParticles, 0);
+    m_slowSteps.assign(numParticles, 0);
+    if (m_config->m_sleepVelocityThreshold > 0.0)
+    {
+        if (m_activeInvMass == nullptr || m_activeInvMass == m_invMass)
+        {
+            m_activeInvMass = std::make_shared<DataArray<double>>();
+        }
+        *m_activeInvMass = *m_invMass;
+    }
+    else
+    {
+        m_activeInvMass = m_invMass;
+    }
 }
 
 void
@@ -319,6 +391,14 @@ PbdModel::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskN
     m_taskGraph->addEdge(m_updateVelocityNode, sink);
 }
 
+void
+PbdModel::setSolveNode(std::shared_ptr<TaskNode> node)
+{
+    m_taskGraph->removeNode(m_solveConstraintsNode);
+    m_solveConstraintsNode = node;
+    m_taskGraph->addNode(m_solveConstraintsNode);
+}
+
 void
 PbdModel::addConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
 {
@@ -331,6 +411,12 @@ PbdModel::addConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
     }
 }
 
+void
+PbdModel::removeConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
+{
+    m_constraints->removeConstraints(vertices);
+}
+
 void
 PbdModel::setParticleMass(const double val, const size_t idx)
 {
@@ -340,6 +426,7 @@ PbdModel::setParticleMass(const double val, const size_t idx)
     {
         masses[idx]    = val;
         invMasses[idx] = 1.0 / val;
+        updateActiveInvMass(idx);
     }
 }
 
@@ -352,6 +439,7 @@ PbdModel::setFixedPoint(const size_t idx)
     {
         fixedNodeInvMass[idx] = invMasses[idx];
         invMasses[idx] = 0.0;
+        updateActiveInvMass(idx);
     }
 }
 
@@ -364,11 +452,28 @@ PbdModel::setPointUnfixed(const size_t idx)
     {
         invMasses[idx] = fixedNodeInvMass[idx];
         fixedNodeInvMass.erase(idx);
+        updateActiveInvMass(idx);
+    }
+}
+
+void
+PbdModel::updateActiveInvMass(const size_t idx)
+{
+    if (m_activeInvMass != nullptr && m_activeInvMass != m_invMass
+        && idx < static_cast<size_t>(m_activeInvMass->size()) && !isSleeping(idx))
+    {
+        (*m_activeInvMass)[idx] = (*m_invMass)[idx];
     }
 }
 
 void
 PbdModel::integratePosition()
+{
+    integratePosition(getSubstepTimeStep(), m_config->m_numSubsteps <= 1);
+}
+
+void
+PbdModel::integratePosition(const double dt, const bool clearAccelerations)
 {
     std::shared_ptr<VecDataArray<double, 3>> prevPosPtr = m_previousState->getPositions();
     VecDataArray<double, 3>&                 prevPos    = *prevPosPtr;
@@ -378,23 +483,39 @@ PbdModel::integratePosition()
     VecDataArray<double, 3>&                 vel       = *velPtr;
     std::shared_ptr<VecDataArray<double, 3>> accnPtr   = m_currentState->getAccelerations();
     VecDataArray<double, 3>&                 accn      = *accnPtr;
-    const DataArray<double>&                 invMasses = *m_invMass;
+    const DataArray<double>&                 invMasses = *m_activeInvMass;
 
     ParallelUtils::parallelFor(m_mesh->getNumVertices(),
         [&](const size_t i)
         {
             if (std::abs(invMasses[i]) > 0.0)
             {
-                vel[i]    += (accn[i] + m_config->m_gravity) * m_config->m_dt;
-                accn[i]    = Vec3d::Zero();
+                vel[i] += (accn[i] + m_config->m_gravity) * dt;
+                if (clearAccelerations)
+                {
+                    accn[i] = Vec3d::Zero();
+                }
                 prevPos[i] = pos[i];
-                pos[i]    += (1.0 - m_config->m_viscousDampingCoeff) * vel[i] * m_config->m_dt;
+                pos[i]    += (1.0 - m_config->m_viscousDampingCoeff) * vel[i] * dt;
             }
         }, m_mesh->getNumVertices() > 50);
 }
 
+void
+PbdModel::solveConstraints()
+{
+    m_pbdSolver->setTimeStep(getSubstepTimeStep());
+    m_pbdSolver->solve();
+}
+
 void
 PbdModel::updateVelocity()
+{
+    updateVelocity(getSubstepTimeStep());
+}
+
+void
+PbdModel::updateVelocity(const double dt)
 {
     std::shared_ptr<VecDataArray<double, 3>> prevPosPtr = m_previousState->getPositions();
     const VecDataArray<double, 3>&           prevPos    = *prevPosPtr;
@@ -402,11 +523,11 @@ PbdModel::updateVelocity()
     const VecDataArray<double, 3>&           pos       = *posPtr;
     std::shared_ptr<VecDataArray<double, 3>> velPtr    = m_currentState->getVelocities();
     VecDataArray<double, 3>&                 vel       = *velPtr;
-    const DataArray<double>&                 invMasses = *m_invMass;
+    const DataArray<double>&                 invMasses = *m_activeInvMass;
 
-    if (m_config->m_dt > 0.0)
+    if (dt > 0.0)
     {
-        const double invDt = 1.0 / m_config->m_dt;
+        const double invDt = 1.0 / dt;
         ParallelUtils::parallelFor(m_mesh->getNumVertices(),
             [&](const size_t i)
             {
@@ -417,4 +538,197 @@ PbdModel::updateVelocity()
             }, m_mesh->getNumVertices() > 50);
     }
 }
-}
\ No newline at end of file
+
+void
+PbdModel::solveSubsteps()
+{
+    // The first substep is done by the nodes of the task graph, collision constraints
+    // found then are reused in the following ones. Coupled models move along such that
+    // the collision constraints see both sides at the same substep
+    const unsigned int numSubsteps = m_config->m_numSubsteps;
+    const double       dt = getSubstepTimeStep();
+    for (const auto& model : m_coupledModels)
+    {
+        CHECK(model->m_config->m_numSubsteps == numSubsteps) << "Models with coupled substeps must use the same number of substeps";
+    }
+    for (unsigned int i = 1; i < numSubsteps; i++)
+    {
+        const bool lastSubstep = (i + 1 == numSubsteps);
+        integratePosition(dt, lastSubstep);
+        m_pbdSolver->solve();
+        for (const auto& model : m_coupledModels)
+        {
+            model->integratePosition(model->getSubstepTimeStep(), lastSubstep);
+            model->m_pbdSolver->solve();
+        }
+        for (const auto& collisionSolver : m_collisionSolvers)
+        {
+            collisionSolver->solve();
+        }
+        updateVelocity(dt);
+        for (const auto& model : m_coupledModels)
+        {
+            model->updateVelocity(model->getSubstepTimeStep());
+        }
+    }
+
+    for (const auto& collisionSolver : m_collisionSolvers)
+    {
+        collisionSolver->clearCollisionConstraints();
+    }
+}
+
+void
+PbdModel::updateSleeping()
+{
+    const double threshold = m_config->m_sleepVelocityThreshold;
+    if (threshold <= 0.0 || m_activeInvMass == m_invMass)
+    {
+        return;
+    }
+
+    std::shared_ptr<VecDataArray<double, 3>> prevPosPtr = m_previousState->getPositions();
+    VecDataArray<double, 3>&                 prevPos    = *prevPosPtr;
+    std::shared_ptr<VecDataArray<double, 3>> posPtr     = m_currentState->getPositions();
+    const VecDataArray<double, 3>&           pos = *posPtr;
+    std::shared_ptr<VecDataArray<double, 3>> velPtr = m_currentState->getVelocities();
+    VecDataArray<double, 3>&                 vel    = *velPtr;
+    const DataArray<double>&                 invMasses       = *m_invMass;
+    DataArray<double>&                       activeInvMasses = *m_activeInvMass;
+    const double                             threshold2      = threshold * threshold;
+
+    // Sleeping nodes keep their previous position, when they moved it was from a collision,
+    // they wake up. Awake ones count their slow steps, 0 when moving
+    const size_t numVertices = m_sleeping.size();
+    m_moving.resize(numVertices);
+    ParallelUtils::parallelFor(numVertices,
+        [&](const size_t i)
+        {
+            if (m_sleeping[i])
+            {
+                if (pos[i] != prevPos[i])
+                {
+                    m_sleeping[i]  = 0;
+                    m_slowSteps[i] = 0;
+                }
+            }
+            else
+            {
+                m_slowSteps[i] = (vel[i].squaredNorm() < threshold2) ? m_slowSteps[i] + 1 : 0;
+            }
+            m_moving[i] = (m_sleeping[i] == 0 && m_slowSteps[i] == 0);
+        }, numVertices > 50);
+
+    // Whether a node shares a constraint with a moving node, found through the vertex to
+    // constraint indices
+    const PbdConstraintContainer& constraints = *m_constraints;
+    auto                          isNearMoving = [&](const size_t i)
+                                                 {
+                                                     for (const PbdConstraint* constraint : constraints.getVertexConstraints(i))
+                                                     {
+                                                         for (const size_t vid : constraint->getVertexIds())
+                                                         {
+                                                             if (m_moving[vid])
+                                                             {
+                                                                 return true;
+                                                             }
+                                                         }
+                                                     }
+                                                     for (const auto& batch : constraints.getBatches())
+                                                     {
+                                                         const size_t n = batch->getNumVertices();
+                                                         for (const size_t j : batch->getVertexConstraints(i))
+                                                         {
+                                                             const size_t* ids = batch->getVertexIds(j);
+                                                             for (size_t k = 0; k < n; k++)
+                                                             {
+                                                                 if (m_moving[ids[k]])
+                                                                 {
+                                                                     return true;
+                                                                 }
+                                                             }
+                                                         }
+                                                     }
+                                                     return false;
+                                                 };
+
+    // Nodes near moving ones wake up or restart their count, each node only writes its own
+    // state so nodes woken here don't wake their neighbors before they move. Then nodes slow
+    // for long enough fall asleep where they are
+    const unsigned int sleepSteps = std::max(m_config->m_sleepSteps, 1u);
+    ParallelUtils::parallelFor(numVertices,
+        [&](const size_t i)
+        {
+            if (isNearMoving(i))
+            {
+                if (m_sleeping[i])
+                {
+                    m_sleeping[i]  = 0;
+                    m_slowSteps[i] = 0;
+                }
+                m_slowSteps[i] = std::min(m_slowSteps[i], 1u);
+            }
+            if (m_sleeping[i] == 0 && m_slowSteps[i] >= sleepSteps)
+            {
+                m_sleeping[i] = 1;
+                vel[i]     = Vec3d::Zero();
+                prevPos[i] = pos[i];
+            }
+            activeInvMasses[i] = m_sleeping[i] ? 0.0 : invMasses[i];
+        }, numVertices > 50);
+}
+
+size_t
+PbdModel::getNumActiveParticles() const
+{
+    const DataArray<double>& activeInvMasses = *m_activeInvMass;
+    size_t                   numActive       = 0;
+    for (int i = 0; i < activeInvMasses.size(); i++)
+    {
+        numActive += (activeInvMasses[i] != 0.0) ? 1 : 0;
+    }
+    return numActive;
+}
+
+size_t
+PbdModel::getNumActiveConstraints() const
+{
+    const DataArray<double>& activeInvMasses = *m_activeInvMass;
+    size_t                   numActive       = 0;
+    forEachConstraint(*m_constraints,
+        [&](const size_t* ids, const size_t n)
+        {
+            bool isActive = (n == 0);
+            for (size_t j = 0; j < n && !isActive; j++)
+            {
+                isActive = (activeInvMasses[ids[j]] != 0.0);
+            }
+            numActive += isActive ? 1 : 0;
+        });
+    return numActive;
+}
+
+void
+PbdModel::addCollisionSolver(std::shared_ptr<PbdCollisionSolver> solver)
+{
+    solver->setRetainConstraints(true);
+    m_collisionSolvers.push_back(solver);
+}
+
+bool
+PbdModel::coupleSubsteps(std::shared_ptr<PbdModel> model)
+{
+    if (std::find(m_coupledModels.begin(), m_coupledModels.end(), model) != m_coupledModels.end())
+    {
+        return true;
+    }
+    if (model.get() == this || m_substepsCoupled || model->m_substepsCoupled || !model->m_coupledModels.empty()
+        || model->m_config->m_numSubsteps != m_config->m_numSubsteps)
+    {
+        return false;
+    }
+    model->m_substepsCoupled = true;
+    m_coupledModels.push_back(model);
+    return true;
+}
+}
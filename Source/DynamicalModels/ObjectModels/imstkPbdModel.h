@@ -24,6 +24,7 @@
 #include "imstkDynamicalModel.h"
 #include "imstkPbdCollisionConstraint.h"
 #include "imstkPbdFEMConstraint.h"
+#include "imstkPbdSolver.h"
 #include "imstkPbdState.h"
 
 #include <unordered_map>
@@ -34,7 +35,6 @@ namespace imstk
 struct PbdConstraintFunctor;
 class PointSet;
 class PbdConstraintContainer;
-class PbdSolver;
 
 ///
 /// \struct PBDModelConfig
@@ -96,8 +96,11 @@ struct PbdModelConfig
         double m_viscousDampingCoeff = 0.01;      ///> Viscous damping coefficient [0, 1]
         double m_contactStiffness    = 1.0;       ///> Stiffness for contact
         unsigned int m_iterations    = 10;        ///> Internal constraints pbd solver iterations
+        unsigned int m_numSubsteps   = 1;         ///> Substeps per step, above 1 each substep does a single solver iteration
         double m_dt = 0.0;                        ///> Time step size
         bool m_doPartitioning = true;             ///> Does graph coloring to solve in parallel
+        bool m_batchConstraints = false;          ///> Stores supported constraints in type-bucketed batches
+        ScalarTypeId m_scalarType = IMSTK_DOUBLE; ///> Precision of the solve, IMSTK_FLOAT solves batches on float copies of the state, not with substeps
 
         std::vector<std::size_t> m_fixedNodeIds;  ///> Nodal/vertex IDs of the nodes that are fixed
         Vec3d m_gravity = Vec3d(0.0, -9.81, 0.0); ///> Gravity acceleration
@@ -112,6 +115,18 @@ struct PbdModelConfig
             });
 
         PbdConstraint::SolverType m_solverType = PbdConstraint::SolverType::xPBD;
+        PbdSolver::ExecutionMode m_executionMode = PbdSolver::ExecutionMode::GaussSeidel; ///> Jacobi does not partition the constraints
+        double m_relaxation = 1.0;                                                         ///> Relaxation of the averaged corrections in Jacobi mode
+        bool   m_chebyshevAcceleration   = false;                                          ///> Accelerates the solver iterations, see PbdSolver::setChebyshevAcceleration
+        double m_chebyshevSpectralRadius = 0.0;                                            ///> Spectral radius of the Chebyshev acceleration, 0 estimates it
+        double m_lambdaWarmStart = 0.0;                                                    ///> Fraction of the xPBD multipliers kept between solves, see PbdSolver::setLambdaWarmStart
+
+        double m_residualTolerance     = 0.0; ///> Stop iterating once the max constraint residual is below, 0 disables
+        size_t m_maxIterations         = 0;   ///> Max iterations with a residual tolerance, 0 uses m_iterations
+        size_t m_residualCheckInterval = 0;   ///> Iterations between residual evaluations, 0 only when a tolerance is set
+
+        double m_sleepVelocityThreshold = 0.0; ///> Nodes slower than this for m_sleepSteps steps sleep until moved, 0 disables
+        unsigned int m_sleepSteps       = 10;  ///> Consecutive slow steps before a node sleeps
 
     protected:
         friend class PbdModel;
@@ -155,6 +170,12 @@ public:
     ///
     void addConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices);
 
+    ///
+    /// \brief Remove constraints related to a set of vertices. Like added ones, the
+    /// partitions are updated incrementally
+    ///
+    void removeConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices);
+
     virtual void setTimeStep(const double timeStep) override { m_config->m_dt = timeStep; }
     double getTimeStep() const override { return m_config->m_dt; }
 
@@ -189,15 +210,69 @@ public:
     std::shared_ptr<DataArray<double>> getInvMasses() { return m_invMass; }
 
     ///
-    /// \brief Time integrate the position
+    /// \brief Get the inverse masses solved and integrated, null for the sleeping nodes.
+    /// Those are the inverse masses when sleeping is disabled
+    ///
+    std::shared_ptr<DataArray<double>> getActiveInvMasses() { return m_activeInvMass; }
+
+    ///
+    /// \brief Returns whether the node sleeps, a sleeping node is neither integrated nor
+    /// solved until moved by a collision or a constraint shared with a moving node
+    ///
+    bool isSleeping(const size_t idx) const { return idx < m_sleeping.size() && m_sleeping[idx] != 0; }
+
+    ///
+    /// \brief Get the number of nodes integrated and solved, those awake and not fixed
+    ///
+    size_t getNumActiveParticles() const;
+
+    ///
+    /// \brief Get the number of internal constraints with at least one active node
+    ///
+    size_t getNumActiveConstraints() const;
+
+    ///
+    /// \brief Get the time step of a substep, the time step divided by the number of substeps
+    ///
+    double getSubstepTimeStep() const { return m_config->m_dt / static_cast<double>(std::max(m_config->m_numSubsteps, 1u)); }
+
+    ///
+    /// \brief Time integrate the position over the first substep
     ///
     void integratePosition();
 
     ///
-    /// \brief Time integrate the velocity
+    /// \brief Solve the internal constraints over the first substep
+    ///
+    void solveConstraints();
+
+    ///
+    /// \brief Time integrate the velocity over the first substep
     ///
     void updateVelocity();
 
+    ///
+    /// \brief Run the substeps after the first one. Each integrates the position, solves the
+    /// internal constraints and the constraints of the collision solvers, then updates the
+    /// velocity. The collision constraints are cleared afterwards
+    ///
+    void solveSubsteps();
+
+    ///
+    /// \brief Add a collision solver whose constraints are solved again in every substep,
+    /// they are kept until the end of the step
+    ///
+    void addCollisionSolver(std::shared_ptr<PbdCollisionSolver> solver);
+
+    ///
+    /// \brief Run the substeps of another model in lockstep with the ones of this model, such
+    /// that collision solvers coupling both are solved once both moved. The update velocity node
+    /// of the other model then no longer runs its substeps and has to execute before the one
+    /// of this model. Returns false, leaving the models untouched, if they use a different number
+    /// of substeps or a model would run the substeps of a model running its own
+    ///
+    bool coupleSubsteps(std::shared_ptr<PbdModel> model);
+
     ///
     /// \brief Initialize the PBD model
     ///
@@ -227,6 +302,12 @@ public:
 
     std::shared_ptr<TaskNode> getSolveNode() const { return m_solveConstraintsNode; }
 
+    ///
+    /// \brief Replace the node solving the internal constraints, ie: by the node of a
+    /// PbdSystem solving several models at once. Must be set before the graph edges are built
+    ///
+    void setSolveNode(std::shared_ptr<TaskNode> node);
+
     std::shared_ptr<TaskNode> getUpdateVelocityNode() const { return m_updateVelocityNode; }
 
 protected:
@@ -235,6 +316,28 @@ protected:
     ///
     void initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskNode> sink) override;
 
+    ///
+    /// \brief Time integrate the position over dt, the accelerations are kept for
+    /// the following substeps unless clearAccelerations
+    ///
+    void integratePosition(const double dt, const bool clearAccelerations);
+
+    ///
+    /// \brief Time integrate the velocity over dt
+    ///
+    void updateVelocity(const double dt);
+
+    ///
+    /// \brief Put to sleep the nodes slow for m_sleepSteps steps, wake the ones moved
+    /// by collisions and the ones sharing a constraint with a moving node
+    ///
+    void updateSleeping();
+
+    ///
+    /// \brief Copy the inverse mass of an awake node to the active inverse masses
+    ///
+    void updateActiveInvMass(const size_t idx);
+
 protected:
     size_t m_partitionThreshold = 16;                                                     ///> Threshold for constraint partitioning
 
@@ -243,11 +346,19 @@ protected:
     std::shared_ptr<DataArray<double>> m_mass    = nullptr;                               ///> Mass of nodes
     std::shared_ptr<DataArray<double>> m_invMass = nullptr;                               ///> Inverse of mass of nodes
     std::shared_ptr<std::unordered_map<size_t, double>> m_fixedNodeInvMass = nullptr;     ///> Map for archiving fixed nodes' mass.
+    std::shared_ptr<DataArray<double>> m_activeInvMass = nullptr;                         ///> Inverse of mass of nodes, 0 when sleeping
+
+    std::vector<unsigned char> m_sleeping;                                                ///> Per node, 1 when sleeping
+    std::vector<unsigned int>  m_slowSteps;                                               ///> Per node, consecutive steps below the sleep threshold
+    std::vector<unsigned char> m_moving;                                                  ///> Per node, 1 when awake and not slow, used to wake its neighbors
 
     std::shared_ptr<PbdModelConfig> m_config = nullptr;                                   ///> Model parameters, must be set before simulation
 
 protected:
     std::shared_ptr<PbdConstraintContainer> m_constraints;         ///> The set of constraints to update/use
+    std::vector<std::shared_ptr<PbdCollisionSolver>> m_collisionSolvers; ///> Collision solvers solved in every substep
+    std::vector<std::shared_ptr<PbdModel>> m_coupledModels;        ///> Models whose substeps are run along the ones of this model
+    bool m_substepsCoupled = false;                                ///> Whether the substeps of this model are run by another one
 
 protected:
     // Computational Nodes
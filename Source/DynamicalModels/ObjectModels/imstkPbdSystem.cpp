@@ -0,0 +1,234 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdSystem.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdSolver.h"
+#include "imstkTaskNode.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+PbdSystem::PbdSystem() :
+    m_positions(std::make_shared<VecDataArray<double, 3>>()),
+    m_invMasses(std::make_shared<DataArray<double>>()),
+    m_constraints(std::make_shared<PbdConstraintContainer>()),
+    m_solver(std::make_shared<PbdSolver>()),
+    m_solveNode(std::make_shared<TaskNode>([&]() { solve(); }, "PbdSystem_SolveConstraints"))
+{
+    m_solver->setPositions(m_positions);
+    m_solver->setInvMasses(m_invMasses);
+    m_solver->setConstraints(m_constraints);
+}
+
+void
+PbdSystem::addModel(std::shared_ptr<PbdModel> model)
+{
+    if (model->getConfig()->m_numSubsteps > 1)
+    {
+        LOG(WARNING) << "PbdSystem does not support models with substeps, the model is solved on its own";
+        return;
+    }
+    m_models.push_back(model);
+    model->setSolveNode(m_solveNode);
+    m_initialized = false;
+}
+
+void
+PbdSystem::initialize()
+{
+    CHECK(!m_models.empty()) << "PbdSystem has no model to solve";
+
+    // Vertices of the models are concatenated
+    m_vertexOffsets.resize(m_models.size() + 1);
+    m_vertexOffsets[0] = 0;
+    for (size_t i = 0; i < m_models.size(); i++)
+    {
+        m_vertexOffsets[i + 1] = m_vertexOffsets[i] + static_cast<size_t>(m_models[i]->getCurrentState()->getPositions()->size());
+    }
+    m_positions->resize(static_cast<int>(m_vertexOffsets.back()));
+    m_invMasses->resize(static_cast<int>(m_vertexOffsets.back()));
+
+    m_constraints = std::make_shared<PbdConstraintContainer>();
+    m_modelSolvers.assign(m_models.size(), nullptr);
+    m_modelConstraints.resize(m_models.size());
+    m_constraintsModifiedCounts.resize(m_models.size());
+    for (size_t i = 0; i < m_models.size(); i++)
+    {
+        CHECK(m_models[i]->getConfig()->m_numSubsteps <= 1) << "PbdSystem does not support models with substeps";
+        PbdConstraintContainer& modelConstraints = *m_models[i]->getConstraints();
+        modelConstraints.setStorageMode(PbdConstraintContainer::StorageMode::Batched);
+        m_constraints->appendBatches(modelConstraints, m_vertexOffsets[i]);
+        m_modelConstraints[i] = m_models[i]->getConstraints();
+        m_constraintsModifiedCounts[i] = modelConstraints.getModifiedCount();
+        initModelSolver(i);
+    }
+
+    std::shared_ptr<PbdModelConfig> config = m_models.front()->getConfig();
+    if (config->m_doPartitioning && config->m_executionMode != PbdSolver::ExecutionMode::Jacobi)
+    {
+        m_constraints->partitionConstraints(static_cast<int>(m_partitionThreshold));
+    }
+
+    m_solver->setIterations(config->m_iterations);
+    m_solver->setSolverType(config->m_solverType);
+    m_solver->setExecutionMode(config->m_executionMode);
+    m_solver->setRelaxation(config->m_relaxation);
+    m_solver->setChebyshevAcceleration(config->m_chebyshevAcceleration);
+    m_solver->setChebyshevSpectralRadius(config->m_chebyshevSpectralRadius);
+    m_solver->setLambdaWarmStart(config->m_lambdaWarmStart);
+    m_solver->setResidualTolerance(config->m_residualTolerance);
+    m_solver->setMaxIterations(config->m_maxIterations);
+    m_solver->setResidualCheckInterval(config->m_residualCheckInterval);
+    m_solver->setScalarType(config->m_scalarType);
+    m_solver->setConstraints(m_constraints);
+
+    m_initialized = true;
+}
+
+void
+PbdSystem::initModelSolver(const size_t i)
+{
+    // Constraints that are not batched are solved on the model
+    PbdModel&                     model = *m_models[i];
+    const PbdConstraintContainer& modelConstraints     = *model.getConstraints();
+    auto                          unbatchedConstraints = std::make_shared<PbdConstraintContainer>();
+    for (const auto& constraint : modelConstraints.getConstraints())
+    {
+        unbatchedConstraints->addConstraint(constraint);
+    }
+    for (const auto& constraintPartition : modelConstraints.getPartitionedConstraints())
+    {
+        for (const auto& constraint : constraintPartition)
+        {
+            unbatchedConstraints->addConstraint(constraint);
+        }
+    }
+
+    m_modelSolvers[i] = nullptr;
+    if (!unbatchedConstraints->empty())
+    {
+        std::shared_ptr<PbdModelConfig> config = model.getConfig();
+        auto                            solver = std::make_shared<PbdSolver>();
+        solver->setIterations(config->m_iterations);
+        solver->setSolverType(config->m_solverType);
+        solver->setPositions(model.getCurrentState()->getPositions());
+        solver->setInvMasses(model.getActiveInvMasses());
+        solver->setConstraints(unbatchedConstraints);
+        m_modelSolvers[i] = solver;
+    }
+}
+
+void
+PbdSystem::updateModelConstraints(const size_t i)
+{
+    // Replace the constraints of the model only, those of the other models keep their
+    // partitions and the new ones are partitioned incrementally
+    m_constraints->removeConstraints(m_vertexOffsets[i], m_vertexOffsets[i + 1]);
+    m_constraints->appendBatches(*m_modelConstraints[i], m_vertexOffsets[i]);
+    m_constraintsModifiedCounts[i] = m_modelConstraints[i]->getModifiedCount();
+    initModelSolver(i);
+}
+
+void
+PbdSystem::solve()
+{
+    if (!m_initialized || isModified())
+    {
+        initialize();
+    }
+    else
+    {
+        for (size_t i = 0; i < m_models.size(); i++)
+        {
+            if (m_modelConstraints[i]->getModifiedCount() != m_constraintsModifiedCounts[i])
+            {
+                updateModelConstraints(i);
+            }
+        }
+    }
+
+    gather();
+    m_solver->setTimeStep(m_models.front()->getSubstepTimeStep());
+    m_solver->solve();
+    scatter();
+
+    for (size_t i = 0; i < m_models.size(); i++)
+    {
+        if (m_modelSolvers[i] != nullptr)
+        {
+            m_modelSolvers[i]->setTimeStep(m_models[i]->getSubstepTimeStep());
+            m_modelSolvers[i]->solve();
+        }
+    }
+}
+
+bool
+PbdSystem::isModified() const
+{
+    for (size_t i = 0; i < m_models.size(); i++)
+    {
+        const size_t numVertices = static_cast<size_t>(m_models[i]->getCurrentState()->getPositions()->size());
+        if (numVertices != m_vertexOffsets[i + 1] - m_vertexOffsets[i]
+            || m_models[i]->getConstraints() != m_modelConstraints[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+PbdSystem::gather()
+{
+    Vec3d*  positions = m_positions->getPointer();
+    double* invMasses = m_invMasses->getPointer();
+    ParallelUtils::parallelFor(m_models.size(),
+        [&](const size_t i)
+        {
+            VecDataArray<double, 3>& modelPositions = *m_models[i]->getCurrentState()->getPositions();
+            DataArray<double>&       modelInvMasses = *m_models[i]->getActiveInvMasses();
+            const size_t             offset = m_vertexOffsets[i];
+            CHECK(static_cast<size_t>(modelPositions.size()) == m_vertexOffsets[i + 1] - offset
+                && modelInvMasses.size() == modelPositions.size()) << "PbdSystem vertices of model " << i << " changed";
+            std::copy_n(modelPositions.getPointer(), modelPositions.size(), positions + offset);
+            std::copy_n(modelInvMasses.getPointer(), modelInvMasses.size(), invMasses + offset);
+        });
+}
+
+void
+PbdSystem::scatter()
+{
+    const Vec3d* positions = m_positions->getPointer();
+    ParallelUtils::parallelFor(m_models.size(),
+        [&](const size_t i)
+        {
+            VecDataArray<double, 3>& modelPositions = *m_models[i]->getCurrentState()->getPositions();
+            CHECK(static_cast<size_t>(modelPositions.size()) == m_vertexOffsets[i + 1] - m_vertexOffsets[i])
+                << "PbdSystem vertices of model " << i << " changed";
+            std::copy_n(positions + m_vertexOffsets[i], modelPositions.size(), modelPositions.getPointer());
+        });
+}
+} // imstk
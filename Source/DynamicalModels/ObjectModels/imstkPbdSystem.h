@@ -0,0 +1,158 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+#include <vector>
+
+namespace imstk
+{
+class PbdConstraintContainer;
+class PbdModel;
+class PbdSolver;
+class TaskNode;
+
+///
+/// \class PbdSystem
+///
+/// \brief Experimental helper solving the internal constraints of several PbdModels as
+/// one system, in a single task node shared by all the models. Their positions and
+/// inverse masses are copied into one buffer and their batched constraints into one
+/// container with shifted vertex ids, such that the constraints of all bodies are
+/// partitioned (colored) together and projected in parallel by one PbdSolver.
+/// Constraints of a model that are not batched are then projected by a solver of that
+/// model. It is opt-in, nothing in the scene uses it.
+///
+/// It is not a global particle buffer: the models keep their own state, copied in and
+/// out on every solve in time linear in the total number of vertices. Collision
+/// constraints between the models are solved separately, they are not colored with the
+/// internal ones. Models that substep are not supported, their substeps after the first
+/// would still be solved per model.
+///
+/// The solver is configured from the first model added. When the constraints of a model
+/// change only those are replaced and partitioned incrementally, which may leave more
+/// partitions than a full coloring. When the vertices of a model change (ie: tearing), or
+/// the model is given another constraint container, everything is gathered and
+/// partitioned again
+///
+class PbdSystem
+{
+public:
+    PbdSystem();
+    virtual ~PbdSystem() = default;
+
+public:
+    ///
+    /// \brief Adds a model to the system, its solve node is replaced by the one of
+    /// the system. Must be done before the task graph of the scene is built. Models
+    /// with substeps are not added
+    ///
+    void addModel(std::shared_ptr<PbdModel> model);
+
+    ///
+    /// \brief Get the models of the system
+    ///
+    const std::vector<std::shared_ptr<PbdModel>>& getModels() const { return m_models; }
+
+    ///
+    /// \brief Get the index of the first vertex of the i'th model in the system buffer
+    ///
+    size_t getVertexOffset(const size_t i) const { return m_vertexOffsets[i]; }
+
+    ///
+    /// \brief Gathers the constraints of the models, which have to be initialized. The
+    /// constraints of the models are switched to batched storage. Done on the first
+    /// solve and again whenever the vertices of a model change
+    ///
+    void initialize();
+
+    ///
+    /// \brief Gather the state of the models, solve all their constraints and scatter it back
+    ///
+    void solve();
+
+    ///
+    /// \brief Set the threshold for constraint partitioning
+    ///
+    void setConstraintPartitionThreshold(const size_t threshold) { m_partitionThreshold = threshold; }
+
+    ///
+    /// \brief Returns the solver of the system
+    ///
+    std::shared_ptr<PbdSolver> getSolver() const { return m_solver; }
+
+    ///
+    /// \brief Returns the batched constraints of all the models
+    ///
+    std::shared_ptr<PbdConstraintContainer> getConstraints() const { return m_constraints; }
+
+    ///
+    /// \brief Returns the node solving the system, shared by all the models
+    ///
+    std::shared_ptr<TaskNode> getSolveNode() const { return m_solveNode; }
+
+protected:
+    ///
+    /// \brief Returns whether the number of vertices or the constraint container of a model
+    /// changed since initialize, the system buffers and constraints are then out of date
+    ///
+    bool isModified() const;
+
+    ///
+    /// \brief Replaces the constraints of the i'th model in the system constraints, after
+    /// they were added or removed (ie: cutting)
+    ///
+    void updateModelConstraints(const size_t i);
+
+    ///
+    /// \brief Creates the solver of the constraints of the i'th model that are not batched,
+    /// none if all are
+    ///
+    void initModelSolver(const size_t i);
+
+    ///
+    /// \brief Copy the positions and inverse masses of the models into the system buffers
+    ///
+    void gather();
+
+    ///
+    /// \brief Copy the solved positions back to the models
+    ///
+    void scatter();
+
+protected:
+    std::vector<std::shared_ptr<PbdModel>>               m_models;
+    std::vector<size_t>                                  m_vertexOffsets;             ///> First vertex of every model followed by the total
+    std::vector<std::shared_ptr<PbdConstraintContainer>> m_modelConstraints;          ///> Constraints of every model when gathered
+    std::vector<size_t>                                  m_constraintsModifiedCounts; ///> Modified count of the constraints of every model when gathered
+    std::vector<std::shared_ptr<PbdSolver>>              m_modelSolvers;              ///> Solvers of the unbatched constraints of every model, may be nullptr
+    std::shared_ptr<VecDataArray<double, 3>> m_positions;
+    std::shared_ptr<DataArray<double>>       m_invMasses;
+    std::shared_ptr<PbdConstraintContainer>  m_constraints;
+    std::shared_ptr<PbdSolver>               m_solver;
+    std::shared_ptr<TaskNode>                m_solveNode;
+    size_t m_partitionThreshold = 16;                                        ///> Threshold for constraint partitioning
+    bool   m_initialized        = false;
+};
+} // imstk
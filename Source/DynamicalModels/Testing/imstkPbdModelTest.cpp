@@ -0,0 +1,217 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkPbdModel.h"
+#include "imstkPbdPointPointConstraint.h"
+#include "imstkPbdSolver.h"
+#include "imstkPbdTestingUtils.h"
+#include "imstkTaskNode.h"
+
+using namespace imstk;
+
+///
+/// \brief Advance the model by one step, the way the task graph does
+///
+static void
+step(PbdModel& model)
+{
+    model.getIntegratePositionNode()->execute();
+    model.getSolveNode()->execute();
+    model.getUpdateVelocityNode()->execute();
+}
+
+///
+/// \brief Hanging chain of numVertices solved with the given iterations and substeps
+///
+static std::shared_ptr<PbdModel>
+makeChain(const int numVertices, const unsigned int numIterations, const unsigned int numSubsteps,
+          const Vec3d& spacing = Vec3d(0.1, 0.0, 0.0), const double sleepVelocityThreshold = 0.0)
+{
+    return makeChain(numVertices, 1.0e6, spacing, Vec3d::Zero(),
+        [&](PbdModelConfig& config)
+        {
+            config.m_iterations             = numIterations;
+            config.m_numSubsteps            = numSubsteps;
+            config.m_sleepVelocityThreshold = sleepVelocityThreshold;
+            config.m_sleepSteps             = 5;
+        });
+}
+
+///
+/// \brief Test that substeps integrate a free fall more accurately
+///
+TEST(imstkPbdModelTest, TestSubstepFreeFall)
+{
+    for (const unsigned int numSubsteps : { 1u, 10u })
+    {
+        auto pointSet = std::make_shared<PointSet>();
+        pointSet->initialize(std::make_shared<VecDataArray<double, 3>>(1));
+        (*pointSet->getVertexPositions())[0] = Vec3d::Zero();
+
+        auto config = std::make_shared<PbdModelConfig>();
+        config->m_numSubsteps         = numSubsteps;
+        config->m_dt                  = 0.1;
+        config->m_viscousDampingCoeff = 0.0;
+
+        PbdModel model;
+        model.setModelGeometry(pointSet);
+        model.configure(config);
+        model.initialize();
+        step(model);
+
+        // Symplectic Euler over n substeps of h falls g * h^2 * n(n + 1) / 2
+        const double g = -config->m_gravity[1];
+        const double n = static_cast<double>(numSubsteps);
+        const double h = config->m_dt / n;
+        EXPECT_NEAR((*pointSet->getVertexPositions())[0][1], -g * h * h * n * (n + 1.0) / 2.0, 1.0e-12);
+        EXPECT_NEAR((*model.getCurrentState()->getVelocities())[0][1], -g * config->m_dt, 1.0e-12);
+    }
+}
+
+///
+/// \brief Test that, for the same number of solver iterations per step, substeps
+/// leave a hanging chain less stretched than iterations
+///
+TEST(imstkPbdModelTest, TestSubstepStiffness)
+{
+    const int numVertices = 20;
+    auto      getStretch  = [&](PbdModel& model)
+                            {
+                                for (int i = 0; i < 200; i++)
+                                {
+                                    step(model);
+                                }
+                                const VecDataArray<double, 3>& positions = *model.getCurrentState()->getPositions();
+                                return (positions[numVertices - 1] - positions[0]).norm() / (0.1 * (numVertices - 1)) - 1.0;
+                            };
+
+    const double iterationStretch = getStretch(*makeChain(numVertices, 10, 1));
+    const double substepStretch   = getStretch(*makeChain(numVertices, 10, 10));
+    EXPECT_GT(iterationStretch, 0.0);
+    EXPECT_LT(substepStretch, iterationStretch);
+}
+
+///
+/// \brief Test that the nodes of a chain at rest fall asleep, with their constraints,
+/// and that a node moved by something else than the solver wakes up with its neighbors
+///
+TEST(imstkPbdModelTest, TestSleeping)
+{
+    const int numVertices = 10;
+    auto      model       = makeChain(numVertices, 10, 1, Vec3d(0.0, -0.1, 0.0), 0.5);
+    EXPECT_EQ(model->getNumActiveParticles(), numVertices - 1);
+    EXPECT_EQ(model->getNumActiveConstraints(), numVertices - 1);
+
+    for (int i = 0; i < 100; i++)
+    {
+        step(*model);
+    }
+    EXPECT_EQ(model->getNumActiveParticles(), 0);
+    EXPECT_EQ(model->getNumActiveConstraints(), 0);
+
+    // Sleeping nodes stay where they are
+    VecDataArray<double, 3>&      positions = *model->getCurrentState()->getPositions();
+    const VecDataArray<double, 3> restPositions(positions);
+    step(*model);
+    for (int i = 0; i < numVertices; i++)
+    {
+        EXPECT_EQ(positions[i], restPositions[i]);
+    }
+
+    // Displace the last node, ie: by a collision
+    positions[numVertices - 1] += Vec3d(0.05, 0.0, 0.0);
+    step(*model);
+    EXPECT_FALSE(model->isSleeping(numVertices - 1));
+    EXPECT_FALSE(model->isSleeping(numVertices - 2));
+    EXPECT_TRUE(model->isSleeping(1));
+    EXPECT_EQ(model->getNumActiveParticles(), 2);
+    EXPECT_EQ(model->getNumActiveConstraints(), 2);
+
+    // Slowed down by the constraints, they fall asleep again
+    for (int i = 0; i < 20; i++)
+    {
+        step(*model);
+    }
+    EXPECT_EQ(model->getNumActiveParticles(), 0);
+}
+
+///
+/// \brief Test that a model runs the substeps of the model it is coupled with, such that
+/// a contact between both is solved once both moved in every substep
+///
+TEST(imstkPbdModelTest, TestCoupledSubsteps)
+{
+    const unsigned int numSubsteps = 4;
+    auto               makePoint   = [&](const double x)
+                                     {
+                                         auto pointSet = std::make_shared<PointSet>();
+                                         pointSet->initialize(std::make_shared<VecDataArray<double, 3>>(1));
+                                         (*pointSet->getVertexPositions())[0] = Vec3d(x, 0.0, 0.0);
+
+                                         auto config = std::make_shared<PbdModelConfig>();
+                                         config->m_numSubsteps         = numSubsteps;
+                                         config->m_dt                  = 0.1;
+                                         config->m_viscousDampingCoeff = 0.0;
+
+                                         auto model = std::make_shared<PbdModel>();
+                                         model->setModelGeometry(pointSet);
+                                         model->configure(config);
+                                         model->initialize();
+                                         return model;
+                                     };
+    std::shared_ptr<PbdModel> modelA = makePoint(0.0);
+    std::shared_ptr<PbdModel> modelB = makePoint(1.0);
+    EXPECT_TRUE(modelA->coupleSubsteps(modelB));
+    EXPECT_TRUE(modelA->coupleSubsteps(modelB));
+    EXPECT_FALSE(modelB->coupleSubsteps(modelA));
+
+    // Contact pulling the points onto each other
+    Vec3d&                  posA = (*modelA->getCurrentState()->getPositions())[0];
+    Vec3d&                  posB = (*modelB->getCurrentState()->getPositions())[0];
+    PbdPointPointConstraint contact;
+    contact.initConstraint({ &posA, 1.0, &(*modelA->getCurrentState()->getVelocities())[0] },
+        { &posB, 1.0, &(*modelB->getCurrentState()->getVelocities())[0] }, 1.0, 1.0);
+    std::vector<PbdCollisionConstraint*> contacts = { &contact };
+    auto                                 collisionSolver = std::make_shared<PbdCollisionSolver>();
+    modelA->addCollisionSolver(collisionSolver);
+
+    // Same order as the task graph of a collision between two PbdObjects
+    modelA->getIntegratePositionNode()->execute();
+    modelB->getIntegratePositionNode()->execute();
+    modelA->getSolveNode()->execute();
+    modelB->getSolveNode()->execute();
+    collisionSolver->addCollisionConstraints(&contacts);
+    collisionSolver->solve();
+    modelB->getUpdateVelocityNode()->execute();
+    modelA->getUpdateVelocityNode()->execute();
+
+    // Both fell over all substeps once, and the contact held them together halfway in
+    // every substep. Had B run its substeps alone it would have moved past A
+    const double g = -modelA->getConfig()->m_gravity[1];
+    const double n = static_cast<double>(numSubsteps);
+    const double h = modelA->getConfig()->m_dt / n;
+    EXPECT_NEAR(posA[1], -g * h * h * n * (n + 1.0) / 2.0, 1.0e-12);
+    EXPECT_NEAR(posB[1], -g * h * h * n * (n + 1.0) / 2.0, 1.0e-12);
+    EXPECT_NEAR(posA[0], 0.5, 1.0e-9);
+    EXPECT_NEAR(posB[0], 0.5, 1.0e-9);
+}
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdSystem.h"
+#include "imstkPbdTestingUtils.h"
+#include "imstkTaskNode.h"
+
+using namespace imstk;
+
+///
+/// \brief Hanging chain of numVertices with batched constraints, offset along z
+///
+static std::shared_ptr<PbdModel>
+makeChain(const int numVertices, const double z, const PbdSolver::ExecutionMode mode,
+          const unsigned int numSubsteps = 1)
+{
+    return makeChain(numVertices, 1.0e4, Vec3d(0.1, 0.0, 0.0), Vec3d(0.0, 0.0, z),
+        [&](PbdModelConfig& config)
+        {
+            config.m_iterations       = 5;
+            config.m_numSubsteps      = numSubsteps;
+            config.m_executionMode    = mode;
+            config.m_batchConstraints = true;
+        });
+}
+
+///
+/// \brief Advance the models by one step, the way the task graph does
+///
+static void
+step(const std::vector<std::shared_ptr<PbdModel>>& models)
+{
+    for (const auto& model : models)
+    {
+        model->getIntegratePositionNode()->execute();
+    }
+    // The solve node is executed once when shared
+    std::shared_ptr<TaskNode> solveNode = nullptr;
+    for (const auto& model : models)
+    {
+        if (model->getSolveNode() != solveNode)
+        {
+            solveNode = model->getSolveNode();
+            solveNode->execute();
+        }
+    }
+    for (const auto& model : models)
+    {
+        model->getUpdateVelocityNode()->execute();
+    }
+}
+
+///
+/// \brief Test that the models of a system share its solve node and constraints
+///
+TEST(imstkPbdSystemTest, TestSharedSolve)
+{
+    auto modelA = makeChain(10, 0.0, PbdSolver::ExecutionMode::GaussSeidel);
+    auto modelB = makeChain(15, 1.0, PbdSolver::ExecutionMode::GaussSeidel);
+
+    PbdSystem system;
+    system.addModel(modelA);
+    system.addModel(modelB);
+    system.initialize();
+
+    EXPECT_EQ(modelA->getSolveNode(), system.getSolveNode());
+    EXPECT_EQ(modelB->getSolveNode(), system.getSolveNode());
+    EXPECT_EQ(system.getVertexOffset(1), 10);
+
+    // One batch of distance constraints for both chains, ids of B are shifted
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>& batches = system.getConstraints()->getBatches();
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches[0]->size(), 9 + 14);
+    size_t maxVertexId = 0;
+    for (size_t i = 0; i < batches[0]->size(); i++)
+    {
+        maxVertexId = std::max(maxVertexId, batches[0]->getVertexIds(i)[1]);
+    }
+    EXPECT_EQ(maxVertexId, 24);
+}
+
+///
+/// \brief Test that solving the models as one system gives the same result as solving
+/// them separately. Exact with Jacobi, which does not depend on the coloring
+///
+TEST(imstkPbdSystemTest, TestMatchesSeparateSolves)
+{
+    for (auto mode : { PbdSolver::ExecutionMode::Jacobi, PbdSolver::ExecutionMode::GaussSeidel })
+    {
+        std::vector<std::shared_ptr<PbdModel>> separateModels = {
+            makeChain(10, 0.0, mode), makeChain(15, 1.0, mode) };
+        std::vector<std::shared_ptr<PbdModel>> systemModels = {
+            makeChain(10, 0.0, mode), makeChain(15, 1.0, mode) };
+
+        auto system = std::make_shared<PbdSystem>();
+        for (const auto& model : systemModels)
+        {
+            system->addModel(model);
+        }
+
+        for (int i = 0; i < 50; i++)
+        {
+            for (const auto& model : separateModels)
+            {
+                step({ model });
+            }
+            step(systemModels);
+        }
+
+        const double tolerance = (mode == PbdSolver::ExecutionMode::Jacobi) ? 1.0e-12 : 1.0e-3;
+        for (size_t j = 0; j < systemModels.size(); j++)
+        {
+            const VecDataArray<double, 3>& expected = *separateModels[j]->getCurrentState()->getPositions();
+            const VecDataArray<double, 3>& actual   = *systemModels[j]->getCurrentState()->getPositions();
+            for (int i = 0; i < actual.size(); i++)
+            {
+                EXPECT_NEAR((expected[i] - actual[i]).norm(), 0.0, tolerance);
+            }
+        }
+    }
+}
+
+///
+/// \brief Test that the system replaces the constraints of a model when they are
+/// removed, ie: by cutting, and partitions them again
+///
+TEST(imstkPbdSystemTest, TestModelConstraintsChange)
+{
+    std::vector<std::shared_ptr<PbdModel>> models = {
+        makeChain(10, 0.0, PbdSolver::ExecutionMode::GaussSeidel),
+        makeChain(15, 1.0, PbdSolver::ExecutionMode::GaussSeidel) };
+
+    PbdSystem system;
+    system.setConstraintPartitionThreshold(1);
+    for (const auto& model : models)
+    {
+        system.addModel(model);
+    }
+    step(models);
+    ASSERT_EQ(system.getConstraints()->getBatches().size(), 1);
+    EXPECT_EQ(system.getConstraints()->getBatches()[0]->size(), 9 + 14);
+
+    // Detach the last vertex of the second chain
+    auto vertices = std::make_shared<std::unordered_set<size_t>>();
+    vertices->insert(14);
+    models[1]->getConstraints()->removeConstraints(vertices);
+    step(models);
+    ASSERT_EQ(system.getConstraints()->getBatches().size(), 1);
+    const PbdConstraintBatch& batch = *system.getConstraints()->getBatches()[0];
+    EXPECT_EQ(batch.size(), 9 + 13);
+
+    // All are partitioned, no two constraints of a partition share a vertex
+    const std::vector<size_t>& offsets = batch.getPartitionOffsets();
+    EXPECT_EQ(offsets.back(), batch.size());
+    for (size_t p = 0; p < batch.getNumPartitions(); p++)
+    {
+        std::unordered_set<size_t> usedVerts;
+        for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+        {
+            EXPECT_TRUE(usedVerts.insert(batch.getVertexIds(i)[0]).second);
+            EXPECT_TRUE(usedVerts.insert(batch.getVertexIds(i)[1]).second);
+        }
+    }
+}
+
+///
+/// \brief Test that models with substeps are not added to the system, they keep their
+/// own solve node
+///
+TEST(imstkPbdSystemTest, TestSubstepsNotSupported)
+{
+    auto model = makeChain(10, 0.0, PbdSolver::ExecutionMode::GaussSeidel, 4);
+    std::shared_ptr<TaskNode> solveNode = model->getSolveNode();
+
+    PbdSystem system;
+    system.addModel(model);
+    EXPECT_TRUE(system.getModels().empty());
+    EXPECT_EQ(model->getSolveNode(), solveNode);
+}
@@ -116,16 +116,24 @@ Capsule::updatePostTransformData() const
 }
 
 void
-Capsule::computeBoundingBox(Vec3d& min, Vec3d& max, const double imstkNotUsed(paddingPercent))
+Capsule::computeBoundingBox(Vec3d& min, Vec3d& max, const double paddingPercent)
 {
     updatePostTransformData();
 
-    const Vec3d orientationAxes = getRotation().col(1);
-    const Vec3d l  = (m_lengthPostTransform * 0.5 + m_radiusPostTransform) * orientationAxes;
+    // Box of the axis segment grown by the radius of the caps on every axis
+    const Vec3d orientationAxes = m_orientationPostTransform.toRotationMatrix().col(1);
+    const Vec3d l  = (m_lengthPostTransform * 0.5) * orientationAxes;
     const Vec3d p1 = m_positionPostTransform - l;
     const Vec3d p2 = m_positionPostTransform + l;
+    const Vec3d r  = Vec3d(1, 1, 1) * m_radiusPostTransform;
 
-    min = p1.cwiseMin(p2);
-    max = p1.cwiseMax(p2);
+    min = p1.cwiseMin(p2) - r;
+    max = p1.cwiseMax(p2) + r;
+    if (paddingPercent > 0.0)
+    {
+        const Vec3d range = max - min;
+        min = min - range * (paddingPercent / 100.0);
+        max = max + range * (paddingPercent / 100.0);
+    }
 }
 } // imstk
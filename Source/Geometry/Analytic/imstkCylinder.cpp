@@ -114,11 +114,12 @@ Cylinder::updatePostTransformData() const
 }
 
 void
-Cylinder::computeBoundingBox(Vec3d& min, Vec3d& max, const double imstkNotUsed(paddingPercent))
+Cylinder::computeBoundingBox(Vec3d& min, Vec3d& max, const double paddingPercent)
 {
     updatePostTransformData();
 
-    const Vec3d orientationAxes = getRotation().transpose().col(1);
+    // Box of the two caps, disks around the axis
+    const Vec3d orientationAxes = m_orientationPostTransform.toRotationMatrix().col(1);
     const Vec3d d  = orientationAxes * m_lengthPostTransform * 0.5;
     const Vec3d p1 = m_positionPostTransform - d;
     const Vec3d p2 = m_positionPostTransform + d;
@@ -128,5 +129,11 @@ Cylinder::computeBoundingBox(Vec3d& min, Vec3d& max, const double imstkNotUsed(p
     const Vec3d  e = m_radiusPostTransform * (Vec3d(1.0, 1.0, 1.0) - a.cwiseProduct(a).cwiseQuotient(Vec3d(qSqrLength, qSqrLength, qSqrLength))).cwiseSqrt();
     min = (p1 - e).cwiseMin(p2 - e);
     max = (p1 + e).cwiseMax(p2 + e);
+    if (paddingPercent > 0.0)
+    {
+        const Vec3d range = max - min;
+        min = min - range * (paddingPercent / 100.0);
+        max = max + range * (paddingPercent / 100.0);
+    }
 }
 } // imstk
@@ -61,6 +61,12 @@ public:
     ///
     void setMap(const std::map<size_t, size_t>& sourceMap);
 
+    ///
+    /// \brief Get the one-to-one correspondence, child index to parent index. Unlike
+    /// getMapIdx it may be read from several threads
+    ///
+    const std::map<size_t, size_t>& getMap() const { return m_oneToOneMap; }
+
     ///
     /// \brief Apply (if active) the tetra-triangle mesh map
     ///
@@ -23,13 +23,78 @@
 
 #include "imstkScene.h"
 #include "imstkCamera.h"
+#include "imstkCapsule.h"
+#include "imstkCollidingObject.h"
+#include "imstkCollisionData.h"
+#include "imstkCollisionInteraction.h"
+#include "imstkCylinder.h"
 #include "imstkDirectionalLight.h"
+#include "imstkLineMesh.h"
+#include "imstkPBDCollisionHandling.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdObject.h"
+#include "imstkPbdObjectCollision.h"
+#include "imstkPbdTestingUtils.h"
+#include "imstkPointSet.h"
+#include "imstkPointSetToCapsuleCD.h"
+#include "imstkSphere.h"
+#include "imstkSphereToCylinderCD.h"
 #include "imstkSpotLight.h"
+#include "imstkSweepAndPrune.h"
 #include "imstkSceneObject.h"
 #include "imstkTaskGraph.h"
+#include "imstkTaskNode.h"
+#include "imstkVecDataArray.h"
 
 using namespace imstk;
 
+namespace
+{
+///
+/// \brief Collision detection counting how many times it ran
+///
+template<typename CDType>
+class CountingCD : public CDType
+{
+public:
+    int m_numUpdates = 0;
+
+protected:
+    void requestUpdate() override
+    {
+        m_numUpdates++;
+        CDType::requestUpdate();
+    }
+};
+
+///
+/// \brief PbdObject simulating a hanging chain
+///
+std::shared_ptr<PbdObject>
+makeChainObject(const std::string& name, const unsigned int numSubsteps)
+{
+    std::shared_ptr<PbdModel> model = makeChain(5, 1.0e4, Vec3d(0.1, 0.0, 0.0), Vec3d::Zero(),
+        [&](PbdModelConfig& config) { config.m_numSubsteps = numSubsteps; });
+    auto obj = std::make_shared<PbdObject>(name);
+    obj->setDynamicalModel(model);
+    obj->setPhysicsGeometry(model->getModelGeometry());
+    obj->setCollidingGeometry(model->getModelGeometry());
+    return obj;
+}
+
+///
+/// \brief Interaction with collision detection only
+///
+class DetectionOnlyInteraction : public CollisionInteraction
+{
+public:
+    DetectionOnlyInteraction(std::shared_ptr<CollidingObject> objA, std::shared_ptr<CollidingObject> objB) :
+        CollisionInteraction("DetectionOnlyInteraction", objA, objB) { }
+
+    const std::string getTypeName() const override { return "DetectionOnlyInteraction"; }
+};
+}
+
 TEST(imstkSceneTest, empty_scene_emptiness_checks)
 {
     Scene scene("test scene");
@@ -174,4 +239,119 @@ TEST(imstkSceneTest, add_remove_scene_objects)
     m_scene.removeSceneObject(so);
     EXPECT_EQ(m_scene.getSceneObject("sceneObject0"), nullptr);
     EXPECT_EQ(m_scene.getSceneObjects().size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(imstkSceneTest, collision_broad_phase)
+{
+    auto sceneConfig = std::make_shared<SceneConfig>();
+    sceneConfig->collisionBroadPhaseEnabled = true;
+    Scene scene("test scene", sceneConfig);
+
+    // Capsule of radius 0.5 along y and a point far from it
+    auto capsule    = std::make_shared<Capsule>(Vec3d(0.0, 0.0, 0.0), 0.5, 2.0);
+    auto capsuleObj = std::make_shared<CollidingObject>("capsule");
+    capsuleObj->setCollidingGeometry(capsule);
+
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(1);
+    (*vertices)[0] = Vec3d(5.0, 0.0, 0.0);
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(vertices);
+    auto pointObj = std::make_shared<CollidingObject>("point");
+    pointObj->setCollidingGeometry(pointSet);
+
+    auto colDetect = std::make_shared<CountingCD<PointSetToCapsuleCD>>();
+    colDetect->setInputGeometryA(pointSet);
+    colDetect->setInputGeometryB(capsule);
+    auto interaction = std::make_shared<DetectionOnlyInteraction>(pointObj, capsuleObj);
+    interaction->setCollisionDetection(colDetect);
+
+    scene.addSceneObject(capsuleObj);
+    scene.addSceneObject(pointObj);
+    scene.addInteraction(interaction);
+    ASSERT_TRUE(scene.initialize());
+
+    // Apart, collision detection is skipped
+    scene.getCollisionBroadPhase()->beginFrame();
+    interaction->getCollisionDetectionNode()->execute();
+    EXPECT_EQ(colDetect->m_numUpdates, 0);
+    EXPECT_EQ(colDetect->getCollisionData()->elementsA.size(), 0);
+
+    // Inside the side of the capsule, away from its axis, collision detection runs
+    pointSet->setVertexPosition(0, Vec3d(0.45, 0.0, 0.0));
+    scene.getCollisionBroadPhase()->beginFrame();
+    interaction->getCollisionDetectionNode()->execute();
+    EXPECT_EQ(colDetect->m_numUpdates, 1);
+    EXPECT_EQ(colDetect->getCollisionData()->elementsA.size(), 1);
+}
+
+TEST(imstkSceneTest, collision_broad_phase_rotated_cylinder)
+{
+    auto sceneConfig = std::make_shared<SceneConfig>();
+    sceneConfig->collisionBroadPhaseEnabled = true;
+    Scene scene("test scene", sceneConfig);
+
+    // Long thin cylinder whose axis is turned from y to z, and a small sphere far from it
+    const Quatd orientation(Eigen::AngleAxisd(2.0 * PI / 3.0, Vec3d(1.0, 1.0, 1.0).normalized()));
+    auto        cylinder    = std::make_shared<Cylinder>(Vec3d(0.0, 0.0, 0.0), 0.2, 4.0, orientation);
+    auto        cylinderObj = std::make_shared<CollidingObject>("cylinder");
+    cylinderObj->setCollidingGeometry(cylinder);
+
+    auto sphere    = std::make_shared<Sphere>(Vec3d(0.0, 0.0, 5.0), 0.1);
+    auto sphereObj = std::make_shared<CollidingObject>("sphere");
+    sphereObj->setCollidingGeometry(sphere);
+
+    auto colDetect = std::make_shared<CountingCD<SphereToCylinderCD>>();
+    colDetect->setInputGeometryA(sphere);
+    colDetect->setInputGeometryB(cylinder);
+    auto interaction = std::make_shared<DetectionOnlyInteraction>(sphereObj, cylinderObj);
+    interaction->setCollisionDetection(colDetect);
+
+    scene.addSceneObject(cylinderObj);
+    scene.addSceneObject(sphereObj);
+    scene.addInteraction(interaction);
+    ASSERT_TRUE(scene.initialize());
+
+    // Apart, collision detection is skipped
+    scene.getCollisionBroadPhase()->beginFrame();
+    interaction->getCollisionDetectionNode()->execute();
+    EXPECT_EQ(colDetect->m_numUpdates, 0);
+
+    // Along the rotated axis, away from the center, collision detection runs
+    sphere->setPosition(Vec3d(0.0, 0.0, 1.5));
+    scene.getCollisionBroadPhase()->beginFrame();
+    interaction->getCollisionDetectionNode()->execute();
+    EXPECT_EQ(colDetect->m_numUpdates, 1);
+}
+
+TEST(imstkSceneTest, pbd_collision_substeps)
+{
+    // Without substeps the contacts are not retained for them
+    for (const unsigned int numSubsteps : { 1u, 4u })
+    {
+        auto objA = makeChainObject("chainA", numSubsteps);
+        auto objB = makeChainObject("chainB", numSubsteps);
+        auto objC = makeChainObject("chainC", numSubsteps);
+
+        auto interactionAB = std::make_shared<PbdObjectCollision>(objA, objB, "MeshToMeshBruteForceCD");
+        auto interactionAC = std::make_shared<PbdObjectCollision>(objA, objC, "MeshToMeshBruteForceCD");
+        for (const auto& interaction : { interactionAB, interactionAC })
+        {
+            auto ch = std::dynamic_pointer_cast<PBDCollisionHandling>(interaction->getCollisionHandlingA());
+            EXPECT_EQ(ch->getCollisionSolver()->getRetainConstraints(), numSubsteps > 1);
+        }
+    }
+}
+
+TEST(imstkSceneTest, pbd_collision_unequal_substeps)
+{
+    // Models with different numbers of substeps are not coupled, the contacts are only
+    // solved in the first substep
+    auto objA = makeChainObject("chainA", 1);
+    auto objB = makeChainObject("chainB", 4);
+
+    auto interaction = std::make_shared<PbdObjectCollision>(objA, objB, "MeshToMeshBruteForceCD");
+    auto ch = std::dynamic_pointer_cast<PBDCollisionHandling>(interaction->getCollisionHandlingA());
+    EXPECT_FALSE(ch->getCollisionSolver()->getRetainConstraints());
+    EXPECT_FALSE(objA->getPbdModel()->coupleSubsteps(objB->getPbdModel()));
+    EXPECT_FALSE(objB->getPbdModel()->coupleSubsteps(objA->getPbdModel()));
+}
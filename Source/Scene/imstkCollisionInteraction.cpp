@@ -21,9 +21,12 @@ limitations under the License.
 
 #include "imstkCollisionInteraction.h"
 #include "imstkCollidingObject.h"
+#include "imstkCollisionData.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 #include "imstkCollisionHandling.h"
 #include "imstkDynamicObject.h"
+#include "imstkGeometry.h"
+#include "imstkSweepAndPrune.h"
 #include "imstkTaskGraph.h"
 
 namespace imstk
@@ -76,13 +79,46 @@ CollisionInteraction::setCollisionHandlingAB(std::shared_ptr<CollisionHandling>
     m_colHandlingA = m_colHandlingB = colHandlingAB;
 }
 
+void
+CollisionInteraction::setBroadPhase(std::shared_ptr<SweepAndPrune> broadPhase, const int proxyIdA, const int proxyIdB)
+{
+    m_broadPhase = broadPhase;
+    m_proxyIdA   = proxyIdA;
+    m_proxyIdB   = proxyIdB;
+}
+
 void
 CollisionInteraction::updateCD()
 {
-    if (m_colDetect != nullptr)
+    if (m_colDetect == nullptr)
     {
-        m_colDetect->update();
+        return;
     }
+
+    // Skip the narrow phase if the bounds of the objects are apart, the bounds of an
+    // object are computed by the first of its interactions in the frame
+    if (m_broadPhase != nullptr)
+    {
+        auto computeBox = [](const std::shared_ptr<CollidingObject>& obj)
+                          {
+                              Vec3d min, max;
+                              obj->getCollidingGeometry()->computeBoundingBox(min, max);
+                              return Eigen::AlignedBox3d(min, max);
+                          };
+        if (!m_broadPhase->updateAndTestPair(
+            m_proxyIdA, [&]() { return computeBox(m_objA); },
+            m_proxyIdB, [&]() { return computeBox(m_objB); }))
+        {
+            std::shared_ptr<CollisionData> colData = m_colDetect->getCollisionData();
+            colData->geomA = m_colDetect->getInput(0);
+            colData->geomB = m_colDetect->getInput(1);
+            colData->elementsA.resize(0);
+            colData->elementsB.resize(0);
+            return;
+        }
+    }
+
+    m_colDetect->update();
 }
 
 void
@@ -29,6 +29,7 @@ class CollisionData;
 class CollisionDetectionAlgorithm;
 class CollisionHandling;
 class CollidingObject;
+class SweepAndPrune;
 
 ///
 /// \class CollisionInteraction
@@ -67,6 +68,16 @@ public:
     std::shared_ptr<CollisionHandling> getCollisionHandlingB() const { return m_colHandlingB; }
     std::shared_ptr<CollisionHandling> getCollisionHandlingAB() const { return m_colHandlingA; }
 
+    std::shared_ptr<CollidingObject> getObjectA() const { return m_objA; }
+    std::shared_ptr<CollidingObject> getObjectB() const { return m_objB; }
+
+    ///
+    /// \brief Set the scene broad phase with the proxies of the two objects, collision
+    /// detection is skipped, with no contacts, when their bounds do not overlap.
+    /// nullptr to always run collision detection
+    ///
+    void setBroadPhase(std::shared_ptr<SweepAndPrune> broadPhase, const int proxyIdA, const int proxyIdB);
+
     std::shared_ptr<TaskNode> getCollisionDetectionNode() const { return m_collisionDetectionNode; }
     std::shared_ptr<TaskNode> getCollisionHandlingANode() const { return m_collisionHandleANode; }
     std::shared_ptr<TaskNode> getCollisionHandlingBNode() const { return m_collisionHandleBNode; }
@@ -97,6 +108,10 @@ protected:
     std::shared_ptr<CollisionHandling> m_colHandlingA = nullptr;
     std::shared_ptr<CollisionHandling> m_colHandlingB = nullptr;
 
+    std::shared_ptr<SweepAndPrune> m_broadPhase = nullptr; ///< Scene broad phase, if any
+    int m_proxyIdA = -1;
+    int m_proxyIdB = -1;
+
     std::shared_ptr<TaskNode> m_collisionDetectionNode      = nullptr;
     std::shared_ptr<TaskNode> m_collisionHandleANode        = nullptr;
     std::shared_ptr<TaskNode> m_collisionHandleBNode        = nullptr;
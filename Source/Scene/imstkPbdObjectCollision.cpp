@@ -23,6 +23,7 @@ limitations under the License.
 #include "imstkCDObjectFactory.h"
 #include "imstkCollisionData.h"
 #include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkLogger.h"
 #include "imstkPBDCollisionHandling.h"
 #include "imstkPbdModel.h"
 #include "imstkPbdObject.h"
@@ -66,11 +67,39 @@ PbdObjectCollision::PbdObjectCollision(std::shared_ptr<PbdObject> obj1, std::sha
         m_taskGraph->addNode(pbdModel2->getIntegratePositionNode());
         m_taskGraph->addNode(pbdModel2->getUpdateVelocityNode());
         m_taskGraph->addNode(pbdModel2->getSolveNode());
+
+        // Reuse the contacts in the substeps, one model runs the substeps of both such
+        // that the contacts are solved once both moved
+        if (pbdModel1->getConfig()->m_numSubsteps > 1 || pbdModel2->getConfig()->m_numSubsteps > 1)
+        {
+            if (pbdModel1->coupleSubsteps(pbdModel2))
+            {
+                m_substepModel = pbdModel1;
+            }
+            else if (pbdModel2->coupleSubsteps(pbdModel1))
+            {
+                m_substepModel = pbdModel2;
+            }
+            else
+            {
+                LOG(WARNING) << getName() << ": substeps of the models cannot be coupled, contacts are only solved in the first substep";
+            }
+        }
     }
     else
     {
         m_taskGraph->addNode(obj2->getUpdateGeometryNode());
         m_taskGraph->addNode(obj2->getTaskGraph()->getSink());
+
+        // Reuse the contacts in the substeps of the model
+        if (pbdModel1->getConfig()->m_numSubsteps > 1)
+        {
+            m_substepModel = pbdModel1;
+        }
+    }
+    if (m_substepModel != nullptr)
+    {
+        m_substepModel->addCollisionSolver(ch->getCollisionSolver());
     }
 
     m_taskGraph->addNode(pbdModel1->getIntegratePositionNode());
@@ -103,6 +132,18 @@ PbdObjectCollision::getFriction() const
     return std::dynamic_pointer_cast<PBDCollisionHandling>(getCollisionHandlingA())->getFriction();
 }
 
+void
+PbdObjectCollision::setCollisionExecutionMode(const PbdCollisionSolver::ExecutionMode mode)
+{
+    std::dynamic_pointer_cast<PBDCollisionHandling>(getCollisionHandlingA())->getCollisionSolver()->setExecutionMode(mode);
+}
+
+PbdCollisionSolver::ExecutionMode
+PbdObjectCollision::getCollisionExecutionMode() const
+{
+    return std::dynamic_pointer_cast<PBDCollisionHandling>(getCollisionHandlingA())->getCollisionSolver()->getExecutionMode();
+}
+
 void
 PbdObjectCollision::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskNode> sink)
 {
@@ -132,6 +173,17 @@ PbdObjectCollision::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared
         m_taskGraph->addEdge(m_collisionSolveNode, pbdObj2->getPbdModel()->getUpdateVelocityNode());
         m_taskGraph->addEdge(pbdObj2->getPbdModel()->getUpdateVelocityNode(), m_correctVelocitiesNode);
         m_taskGraph->addEdge(m_correctVelocitiesNode, pbdObj2->getPbdModel()->getTaskGraph()->getSink());
+
+        // The model running the substeps of both goes once the other one updated its velocity
+        if (m_substepModel != nullptr)
+        {
+            std::shared_ptr<PbdModel> coupledModel = pbdObj2->getPbdModel();
+            if (m_substepModel == coupledModel)
+            {
+                coupledModel = pbdObj1->getPbdModel();
+            }
+            m_taskGraph->addEdge(coupledModel->getUpdateVelocityNode(), m_substepModel->getUpdateVelocityNode());
+        }
     }
     else
     {
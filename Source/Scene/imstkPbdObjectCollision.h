@@ -22,9 +22,11 @@ limitations under the License.
 #pragma once
 
 #include "imstkCollisionInteraction.h"
+#include "imstkPbdSolver.h"
 
 namespace imstk
 {
+class PbdModel;
 class PbdObject;
 
 ///
@@ -33,6 +35,12 @@ class PbdObject;
 /// \brief This class defines a collision interaction between two PbdObjects
 /// or PbdObject & CollidingObject
 ///
+/// When the models substep, the contacts are solved again in every substep. Between
+/// two PbdObjects one model runs the substeps of both (see PbdModel::coupleSubsteps),
+/// which is not possible once each already runs the substeps of another model, the
+/// contacts are then only solved in the first substep. The number of substeps has to
+/// be configured before the interaction is created
+///
 class PbdObjectCollision : public CollisionInteraction
 {
 public:
@@ -53,6 +61,12 @@ public:
     void setFriction(const double friction);
     const double getFriction() const;
 
+    ///
+    /// \brief Set/Get how the collision constraints are solved, sequential by default
+    ///
+    void setCollisionExecutionMode(const PbdCollisionSolver::ExecutionMode mode);
+    PbdCollisionSolver::ExecutionMode getCollisionExecutionMode() const;
+
 public:
     ///
     /// \brief Setup connectivity of task graph
@@ -63,5 +77,7 @@ protected:
     // Steps introduced in interaction
     std::shared_ptr<TaskNode> m_collisionSolveNode    = nullptr;
     std::shared_ptr<TaskNode> m_correctVelocitiesNode = nullptr;
+
+    std::shared_ptr<PbdModel> m_substepModel = nullptr; ///> Model solving the contacts in its substeps, nullptr if none
 };
 }
\ No newline at end of file
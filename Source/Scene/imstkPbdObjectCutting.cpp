@@ -81,10 +81,10 @@ PbdObjectCutting::apply()
 
     // update pbd states, constraints and solver
     pbdModel->initState();
-    pbdModel->getConstraints()->removeConstraints(m_removeConstraintVertices);
+    pbdModel->removeConstraints(m_removeConstraintVertices);
     // pbdModel->getConstraints()->addConstraintVertices(m_addConstraintVertices);
     pbdModel->addConstraints(m_addConstraintVertices);
-    pbdModel->getSolver()->setInvMasses(pbdModel->getInvMasses());
+    pbdModel->getSolver()->setInvMasses(pbdModel->getActiveInvMasses());
     pbdModel->getSolver()->setPositions(pbdModel->getCurrentState()->getPositions());
 }
 
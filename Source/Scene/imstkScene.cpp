@@ -22,14 +22,22 @@
 #include "imstkScene.h"
 #include "imstkCamera.h"
 #include "imstkCameraController.h"
+#include "imstkCapsule.h"
+#include "imstkCollidingObject.h"
 #include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkCollisionInteraction.h"
+#include "imstkCylinder.h"
 #include "imstkFeDeformableObject.h"
 #include "imstkFEMDeformableBodyModel.h"
 #include "imstkLight.h"
 #include "imstkLogger.h"
+#include "imstkOrientedBox.h"
 #include "imstkParallelUtils.h"
+#include "imstkPointSet.h"
 
 #include "imstkSequentialTaskGraphController.h"
+#include "imstkSphere.h"
+#include "imstkSweepAndPrune.h"
 #include "imstkTaskGraph.h"
 #include "imstkTaskGraphVizWriter.h"
 #include "imstkTbbTaskGraphController.h"
@@ -49,6 +57,7 @@ Scene::Scene(const std::string& name, std::shared_ptr<SceneConfig> config) :
     m_name(name),
     m_activeCamera(nullptr),
     m_taskGraph(std::make_shared<TaskGraph>("Scene_" + name + "_Source", "Scene_" + name + "_Sink")),
+    m_collisionBroadPhase(std::make_shared<SweepAndPrune>()),
     m_computeTimesLock(std::make_shared<ParallelUtils::SpinLock>())
 {
     auto defaultCam = std::make_shared<Camera>();
@@ -73,6 +82,8 @@ Scene::initialize()
         CHECK(obj->initialize()) << "Error initializing scene object: " << obj->getName();
     }
 
+    initCollisionBroadPhase();
+
     // Build the compute graph
     buildTaskGraph();
 
@@ -127,6 +138,56 @@ Scene::computeBoundingBox(Vec3d& lowerCorner, Vec3d& upperCorner, const double p
     upperCorner = upperCorner + range * (paddingPercent / 100.0);
 }
 
+void
+Scene::initCollisionBroadPhase()
+{
+    m_collisionBroadPhase->clear();
+
+    // Planes, implicit geometries, ... give no useful bounds, their interactions always run
+    auto hasFiniteBounds = [](const std::shared_ptr<Geometry>& geom)
+                           {
+                               return std::dynamic_pointer_cast<PointSet>(geom) != nullptr
+                                      || std::dynamic_pointer_cast<Sphere>(geom) != nullptr
+                                      || std::dynamic_pointer_cast<OrientedBox>(geom) != nullptr
+                                      || std::dynamic_pointer_cast<Capsule>(geom) != nullptr
+                                      || std::dynamic_pointer_cast<Cylinder>(geom) != nullptr;
+                           };
+
+    // One proxy per colliding object, shared among its interactions
+    std::unordered_map<std::shared_ptr<CollidingObject>, int> proxyIds;
+    auto getProxyId = [&](const std::shared_ptr<CollidingObject>& obj)
+                      {
+                          auto i = proxyIds.find(obj);
+                          if (i != proxyIds.end())
+                          {
+                              return i->second;
+                          }
+                          Vec3d min, max;
+                          obj->getCollidingGeometry()->computeBoundingBox(min, max);
+                          const int proxyId = m_collisionBroadPhase->addProxy(Eigen::AlignedBox3d(min, max));
+                          proxyIds[obj] = proxyId;
+                          return proxyId;
+                      };
+
+    for (const auto& obj : m_sceneObjects)
+    {
+        if (auto interaction = std::dynamic_pointer_cast<CollisionInteraction>(obj))
+        {
+            std::shared_ptr<CollidingObject> objA = interaction->getObjectA();
+            std::shared_ptr<CollidingObject> objB = interaction->getObjectB();
+            if (m_config->collisionBroadPhaseEnabled
+                && hasFiniteBounds(objA->getCollidingGeometry()) && hasFiniteBounds(objB->getCollidingGeometry()))
+            {
+                interaction->setBroadPhase(m_collisionBroadPhase, getProxyId(objA), getProxyId(objB));
+            }
+            else
+            {
+                interaction->setBroadPhase(nullptr, -1, -1);
+            }
+        }
+    }
+}
+
 void
 Scene::buildTaskGraph()
 {
@@ -488,6 +549,9 @@ Scene::advance(const double dt)
         controller->update(dt);
     }
 
+    // Bounds of the colliding objects are computed again once in the frame
+    m_collisionBroadPhase->beginFrame();
+
     // Execute the computational graph
     if (m_taskGraphController != nullptr)
     {
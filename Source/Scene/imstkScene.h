@@ -39,6 +39,7 @@ class IBLProbe;
 class Light;
 class ObjectInteractionPair;
 class SceneObject;
+class SweepAndPrune;
 class TaskGraph;
 class TaskGraphController;
 class TrackingDeviceControl;
@@ -65,6 +66,10 @@ struct SceneConfig
 
     // If on, debug camera is positioned at scene bounding box
     bool debugCamBoundingBox = true;
+
+    // If on, collision detection of interactions whose object bounds are apart is skipped.
+    // Only objects with finite bounds (meshes, spheres, boxes, capsules, cylinders) take part
+    bool collisionBroadPhaseEnabled = false;
 };
 
 ///
@@ -102,6 +107,12 @@ public:
     ///
     void computeBoundingBox(Vec3d& lowerCorner, Vec3d& upperCorner, const double paddingPercent = 0.0);
 
+    ///
+    /// \brief Register the colliding objects of the interactions in the broad phase,
+    /// done on initialize when enabled in the config
+    ///
+    void initCollisionBroadPhase();
+
     ///
     /// \brief Setup the task graph, this completely rebuilds the graph
     ///
@@ -274,6 +285,12 @@ public:
     ///
     void unlockComputeTimes();
 
+    ///
+    /// \brief Get the sweep and prune over the bounds of the colliding objects, ie: to set
+    /// its margin
+    ///
+    std::shared_ptr<SweepAndPrune> getCollisionBroadPhase() const { return m_collisionBroadPhase; }
+
     ///
     /// \brief Get the configuration
     ///
@@ -296,6 +313,8 @@ protected:
     std::shared_ptr<TaskGraphController> m_taskGraphController   = nullptr;    ///> Controller for the computational graph
     std::function<void(Scene*)> m_postTaskGraphConfigureCallback = nullptr;
 
+    std::shared_ptr<SweepAndPrune> m_collisionBroadPhase; ///> Bounds of the colliding objects
+
     std::shared_ptr<ParallelUtils::SpinLock> m_computeTimesLock;
     std::unordered_map<std::string, double>  m_nodeComputeTimes; ///> Map of ComputeNode names to elapsed times for benchmarking
 
@@ -0,0 +1,140 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdPointPointConstraint.h"
+#include "imstkPbdSolver.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+///
+/// \brief Solves a chain of point to point constraints, every point but the ends is
+/// shared by two constraints
+/// \return positions after solve
+///
+static std::vector<Vec3d>
+solveChain(const PbdCollisionSolver::ExecutionMode mode, const size_t numIterations)
+{
+    const int          numPoints = 16;
+    std::vector<Vec3d> points(numPoints);
+    for (int i = 0; i < numPoints; i++)
+    {
+        points[i] = Vec3d(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0, 0.0);
+    }
+
+    std::vector<PbdPointPointConstraint> constraints(numPoints - 1);
+    std::vector<PbdCollisionConstraint*> constraintPtrs;
+    for (int i = 0; i < numPoints - 1; i++)
+    {
+        constraints[i].initConstraint(
+            { &points[i], 1.0, nullptr },
+            { &points[i + 1], 1.0, nullptr },
+            1.0, 1.0);
+        constraintPtrs.push_back(&constraints[i]);
+    }
+
+    PbdCollisionSolver solver;
+    solver.setExecutionMode(mode);
+    solver.setCollisionIterations(numIterations);
+    solver.addCollisionConstraints(&constraintPtrs);
+    solver.solve();
+
+    return points;
+}
+
+///
+/// \brief Largest distance of a point to the first one
+///
+static double
+getSpread(const std::vector<Vec3d>& points)
+{
+    double spread = 0.0;
+    for (const Vec3d& point : points)
+    {
+        spread = std::max(spread, (point - points[0]).norm());
+    }
+    return spread;
+}
+
+///
+/// \brief Test that every mode pulls all the points of the chain together
+///
+TEST(imstkPbdCollisionSolverTest, TestConvergence)
+{
+    const double initialSpread = getSpread(solveChain(PbdCollisionSolver::ExecutionMode::Sequential, 0));
+    EXPECT_GT(initialSpread, 10.0);
+
+    for (auto mode : { PbdCollisionSolver::ExecutionMode::Sequential,
+                       PbdCollisionSolver::ExecutionMode::Colored,
+                       PbdCollisionSolver::ExecutionMode::Jacobi })
+    {
+        EXPECT_LT(getSpread(solveChain(mode, 2000)), 1.0e-3);
+    }
+}
+
+///
+/// \brief Test that the parallel modes give the same result on every run
+///
+TEST(imstkPbdCollisionSolverTest, TestDeterminism)
+{
+    for (auto mode : { PbdCollisionSolver::ExecutionMode::Colored,
+                       PbdCollisionSolver::ExecutionMode::Jacobi })
+    {
+        const std::vector<Vec3d> results = solveChain(mode, 10);
+        for (int i = 0; i < 5; i++)
+        {
+            EXPECT_EQ(results, solveChain(mode, 10));
+        }
+    }
+}
+
+///
+/// \brief Test that infinite mass points do not move
+///
+TEST(imstkPbdCollisionSolverTest, TestStaticPoints)
+{
+    Vec3d a(0.0, 0.0, 0.0);
+    Vec3d b(0.0, 1.0, 0.0);
+    Vec3d c(0.0, 2.0, 0.0);
+
+    PbdPointPointConstraint constraint1;
+    PbdPointPointConstraint constraint2;
+    constraint1.initConstraint({ &a, 1.0, nullptr }, { &b, 0.0, nullptr }, 1.0, 1.0);
+    constraint2.initConstraint({ &c, 1.0, nullptr }, { &b, 0.0, nullptr }, 1.0, 1.0);
+    std::vector<PbdCollisionConstraint*> constraints = { &constraint1, &constraint2 };
+
+    for (auto mode : { PbdCollisionSolver::ExecutionMode::Colored,
+                       PbdCollisionSolver::ExecutionMode::Jacobi })
+    {
+        a = Vec3d(0.0, 0.0, 0.0);
+        c = Vec3d(0.0, 2.0, 0.0);
+
+        PbdCollisionSolver solver;
+        solver.setExecutionMode(mode);
+        solver.addCollisionConstraints(&constraints);
+        solver.solve();
+
+        EXPECT_EQ(Vec3d(0.0, 1.0, 0.0), b);
+        EXPECT_NEAR(1.0, a[1], 1.0e-10);
+        EXPECT_NEAR(1.0, c[1], 1.0e-10);
+    }
+}
@@ -0,0 +1,391 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdSolver.h"
+
+#include <gtest/gtest.h>
+#include <tbb/task_arena.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief A stretched cloth grid of distance constraints hanging from its first row
+///
+struct Cloth
+{
+    Cloth(const PbdConstraintContainer::StorageMode storageMode, const double stiffness = 1.0) :
+        m_positions(std::make_shared<VecDataArray<double, 3>>(dim * dim)),
+        m_invMasses(std::make_shared<DataArray<double>>(dim * dim)),
+        m_constraints(std::make_shared<PbdConstraintContainer>())
+    {
+        VecDataArray<double, 3>& vertices  = *m_positions;
+        DataArray<double>&       invMasses = *m_invMasses;
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++)
+            {
+                vertices[y * dim + x]  = Vec3d(x * 0.1, 0.0, y * 0.1);
+                invMasses[y * dim + x] = (y == 0) ? 0.0 : 1.0;
+            }
+        }
+
+        m_constraints->setStorageMode(storageMode);
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++)
+            {
+                const size_t a = y * dim + x;
+                if (x + 1 < dim)
+                {
+                    auto constraint = std::make_shared<PbdDistanceConstraint>();
+                    constraint->initConstraint(vertices, a, a + 1, stiffness);
+                    m_constraints->addConstraint(constraint);
+                }
+                if (y + 1 < dim)
+                {
+                    auto constraint = std::make_shared<PbdDistanceConstraint>();
+                    constraint->initConstraint(vertices, a, a + dim, stiffness);
+                    m_constraints->addConstraint(constraint);
+                }
+            }
+        }
+
+        // Stretch and perturb the free vertices
+        for (int i = 0; i < vertices.size(); i++)
+        {
+            if (invMasses[i] > 0.0)
+            {
+                vertices[i][2] *= 1.5;
+                vertices[i][1]  = 0.01 * ((i * 7) % 5);
+            }
+        }
+    }
+
+    ///
+    /// \brief Largest relative violation of the distance constraints
+    ///
+    double getError() const
+    {
+        const VecDataArray<double, 3>& vertices = *m_positions;
+        double                         error    = 0.0;
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++)
+            {
+                const int a = y * dim + x;
+                if (x + 1 < dim)
+                {
+                    error = std::max(error, std::abs((vertices[a + 1] - vertices[a]).norm() - 0.1) / 0.1);
+                }
+                if (y + 1 < dim)
+                {
+                    error = std::max(error, std::abs((vertices[a + dim] - vertices[a]).norm() - 0.1) / 0.1);
+                }
+            }
+        }
+        return error;
+    }
+
+    std::shared_ptr<PbdSolver> makeSolver(const PbdSolver::ExecutionMode mode, const size_t iterations,
+                                          const double relaxation = 1.0, const ScalarTypeId scalarType = IMSTK_DOUBLE)
+    {
+        auto solver = std::make_shared<PbdSolver>();
+        solver->setPositions(m_positions);
+        solver->setInvMasses(m_invMasses);
+        solver->setConstraints(m_constraints);
+        solver->setTimeStep(0.01);
+        solver->setSolverType(PbdConstraint::SolverType::PBD);
+        solver->setExecutionMode(mode);
+        solver->setIterations(iterations);
+        solver->setRelaxation(relaxation);
+        solver->setScalarType(scalarType);
+        return solver;
+    }
+
+    void solve(const PbdSolver::ExecutionMode mode, const size_t iterations, const double relaxation = 1.0,
+               const ScalarTypeId scalarType = IMSTK_DOUBLE)
+    {
+        makeSolver(mode, iterations, relaxation, scalarType)->solve();
+    }
+
+    static const int dim = 16;
+    std::shared_ptr<VecDataArray<double, 3>> m_positions;
+    std::shared_ptr<DataArray<double>>       m_invMasses;
+    std::shared_ptr<PbdConstraintContainer>  m_constraints;
+};
+}
+
+///
+/// \brief Test that the Jacobi mode satisfies the constraints, faster when over-relaxed
+///
+TEST(imstkPbdSolverTest, TestJacobiConvergence)
+{
+    for (auto storageMode : { PbdConstraintContainer::StorageMode::Polymorphic,
+                              PbdConstraintContainer::StorageMode::Batched })
+    {
+        Cloth        cloth(storageMode);
+        const double initialError = cloth.getError();
+        cloth.solve(PbdSolver::ExecutionMode::Jacobi, 2000);
+        EXPECT_LT(cloth.getError(), 0.1 * initialError);
+    }
+
+    Cloth cloth(PbdConstraintContainer::StorageMode::Batched);
+    cloth.solve(PbdSolver::ExecutionMode::Jacobi, 500);
+    Cloth relaxedCloth(PbdConstraintContainer::StorageMode::Batched);
+    relaxedCloth.solve(PbdSolver::ExecutionMode::Jacobi, 500, 1.5);
+    EXPECT_LT(relaxedCloth.getError(), cloth.getError());
+}
+
+///
+/// \brief Test that the Jacobi mode gives the same results for any number of threads
+/// and for either storage of the constraints
+///
+TEST(imstkPbdSolverTest, TestJacobiReproducibility)
+{
+    Cloth reference(PbdConstraintContainer::StorageMode::Polymorphic);
+    tbb::task_arena(1).execute([&]() { reference.solve(PbdSolver::ExecutionMode::Jacobi, 10); });
+
+    for (auto storageMode : { PbdConstraintContainer::StorageMode::Polymorphic,
+                              PbdConstraintContainer::StorageMode::Batched })
+    {
+        Cloth cloth(storageMode);
+        tbb::task_arena(4).execute([&]() { cloth.solve(PbdSolver::ExecutionMode::Jacobi, 10); });
+        for (int i = 0; i < cloth.m_positions->size(); i++)
+        {
+            EXPECT_EQ((*reference.m_positions)[i], (*cloth.m_positions)[i]);
+        }
+    }
+}
+
+///
+/// \brief Test that the Jacobi slots kept between solves are rebuilt once constraints
+/// are removed
+///
+TEST(imstkPbdSolverTest, TestJacobiConstraintsChange)
+{
+    for (auto storageMode : { PbdConstraintContainer::StorageMode::Polymorphic,
+                              PbdConstraintContainer::StorageMode::Batched })
+    {
+        Cloth                      cloth(storageMode);
+        Cloth                      reference(storageMode);
+        std::shared_ptr<PbdSolver> solver = cloth.makeSolver(PbdSolver::ExecutionMode::Jacobi, 5);
+        solver->solve();
+        reference.solve(PbdSolver::ExecutionMode::Jacobi, 5);
+
+        auto vertices = std::make_shared<std::unordered_set<size_t>>();
+        vertices->insert(Cloth::dim * Cloth::dim - 1);
+        cloth.m_constraints->removeConstraints(vertices);
+        reference.m_constraints->removeConstraints(vertices);
+
+        solver->solve();
+        reference.solve(PbdSolver::ExecutionMode::Jacobi, 5);
+        for (int i = 0; i < cloth.m_positions->size(); i++)
+        {
+            EXPECT_EQ((*reference.m_positions)[i], (*cloth.m_positions)[i]);
+        }
+    }
+}
+
+///
+/// \brief Test that the solver stops once the residual is below the tolerance and
+/// otherwise stops at the max number of iterations
+///
+TEST(imstkPbdSolverTest, TestResidualTolerance)
+{
+    for (auto mode : { PbdSolver::ExecutionMode::GaussSeidel, PbdSolver::ExecutionMode::Jacobi })
+    {
+        for (auto storageMode : { PbdConstraintContainer::StorageMode::Polymorphic,
+                                  PbdConstraintContainer::StorageMode::Batched })
+        {
+            Cloth     cloth(storageMode);
+            PbdSolver solver;
+            solver.setPositions(cloth.m_positions);
+            solver.setInvMasses(cloth.m_invMasses);
+            solver.setConstraints(cloth.m_constraints);
+            solver.setTimeStep(0.01);
+            solver.setSolverType(PbdConstraint::SolverType::PBD);
+            solver.setExecutionMode(mode);
+
+            // Residuals are only reported when asked for
+            solver.setIterations(5);
+            solver.setResidualCheckInterval(5);
+            solver.solve();
+            EXPECT_EQ(solver.getNumIterationsDone(), 5);
+            const double maxResidual = solver.getMaxResidual();
+            EXPECT_GT(maxResidual, 0.0);
+            EXPECT_GT(solver.getRmsResidual(), 0.0);
+            EXPECT_LE(solver.getRmsResidual(), maxResidual);
+
+            solver.setResidualTolerance(0.5 * maxResidual);
+            solver.setMaxIterations(5000);
+            solver.setResidualCheckInterval(0);
+            solver.solve();
+            EXPECT_LT(solver.getNumIterationsDone(), 5000);
+            EXPECT_LT(solver.getMaxResidual(), 0.5 * maxResidual);
+
+            // Unreachable tolerance, runs up to the max iterations
+            solver.setResidualTolerance(1.0e-300);
+            solver.setMaxIterations(20);
+            solver.setResidualCheckInterval(3);
+            solver.solve();
+            EXPECT_EQ(solver.getNumIterationsDone(), 20);
+        }
+    }
+}
+
+///
+/// \brief Test that solving in single precision gives the double precision result up to
+/// rounding, and falls back to double when constraints are not batched or with one iteration
+///
+TEST(imstkPbdSolverTest, TestSinglePrecision)
+{
+    Cloth reference(PbdConstraintContainer::StorageMode::Batched);
+    reference.m_constraints->partitionConstraints(1);
+    reference.solve(PbdSolver::ExecutionMode::GaussSeidel, 50);
+
+    Cloth cloth(PbdConstraintContainer::StorageMode::Batched);
+    cloth.m_constraints->partitionConstraints(1);
+    cloth.solve(PbdSolver::ExecutionMode::GaussSeidel, 50, 1.0, IMSTK_FLOAT);
+    for (int i = 0; i < cloth.m_positions->size(); i++)
+    {
+        EXPECT_NEAR(((*reference.m_positions)[i] - (*cloth.m_positions)[i]).norm(), 0.0, 1.0e-4);
+    }
+    EXPECT_NEAR(cloth.getError(), reference.getError(), 1.0e-3);
+
+    Cloth polymorphicReference(PbdConstraintContainer::StorageMode::Polymorphic);
+    polymorphicReference.solve(PbdSolver::ExecutionMode::GaussSeidel, 10);
+    Cloth polymorphicCloth(PbdConstraintContainer::StorageMode::Polymorphic);
+    polymorphicCloth.solve(PbdSolver::ExecutionMode::GaussSeidel, 10, 1.0, IMSTK_FLOAT);
+    for (int i = 0; i < polymorphicCloth.m_positions->size(); i++)
+    {
+        EXPECT_EQ((*polymorphicReference.m_positions)[i], (*polymorphicCloth.m_positions)[i]);
+    }
+
+    // A single iteration does not make up for the copies of the state, double is used
+    Cloth singleIterationCloth(PbdConstraintContainer::StorageMode::Batched);
+    singleIterationCloth.m_constraints->partitionConstraints(1);
+    std::shared_ptr<PbdSolver> solver = singleIterationCloth.makeSolver(PbdSolver::ExecutionMode::GaussSeidel, 1, 1.0, IMSTK_FLOAT);
+    solver->solve();
+    EXPECT_FALSE(solver->getSolvedSingle());
+}
+
+///
+/// \brief Test that the Chebyshev acceleration converges faster than the plain iterations,
+/// with a given or an estimated spectral radius
+///
+TEST(imstkPbdSolverTest, TestChebyshevAcceleration)
+{
+    for (auto mode : { PbdSolver::ExecutionMode::GaussSeidel, PbdSolver::ExecutionMode::Jacobi })
+    {
+        const size_t iterations = (mode == PbdSolver::ExecutionMode::Jacobi) ? 100 : 20;
+
+        Cloth reference(PbdConstraintContainer::StorageMode::Batched);
+        reference.m_constraints->partitionConstraints(1);
+        reference.solve(mode, iterations);
+
+        for (const double rho : { 0.0, 0.9 })
+        {
+            Cloth cloth(PbdConstraintContainer::StorageMode::Batched);
+            cloth.m_constraints->partitionConstraints(1);
+
+            PbdSolver solver;
+            solver.setPositions(cloth.m_positions);
+            solver.setInvMasses(cloth.m_invMasses);
+            solver.setConstraints(cloth.m_constraints);
+            solver.setTimeStep(0.01);
+            solver.setSolverType(PbdConstraint::SolverType::PBD);
+            solver.setExecutionMode(mode);
+            solver.setIterations(iterations);
+            solver.setChebyshevAcceleration(true);
+            solver.setChebyshevSpectralRadius(rho);
+            solver.solve();
+
+            if (rho > 0.0)
+            {
+                EXPECT_EQ(solver.getChebyshevSpectralRadiusUsed(), rho);
+            }
+            else
+            {
+                EXPECT_GT(solver.getChebyshevSpectralRadiusUsed(), 0.0);
+                EXPECT_LT(solver.getChebyshevSpectralRadiusUsed(), 1.0);
+            }
+            EXPECT_LT(cloth.getError(), reference.getError());
+
+            // Fixed vertices do not move
+            for (int i = 0; i < Cloth::dim; i++)
+            {
+                EXPECT_EQ((*cloth.m_positions)[i], Vec3d(i * 0.1, 0.0, 0.0));
+            }
+        }
+    }
+}
+
+///
+/// \brief Test that, under a sustained load, xPBD solves warm started from the multipliers
+/// of the previous solve reach the residual tolerance in fewer iterations
+///
+TEST(imstkPbdSolverTest, TestLambdaWarmStart)
+{
+    for (auto storageMode : { PbdConstraintContainer::StorageMode::Polymorphic,
+                              PbdConstraintContainer::StorageMode::Batched })
+    {
+        auto getIterations = [&](const double warmStart)
+                             {
+                                 Cloth cloth(storageMode, 1.0e4);
+                                 cloth.m_constraints->partitionConstraints(1);
+
+                                 PbdSolver solver;
+                                 solver.setPositions(cloth.m_positions);
+                                 solver.setInvMasses(cloth.m_invMasses);
+                                 solver.setConstraints(cloth.m_constraints);
+                                 solver.setTimeStep(0.01);
+                                 solver.setSolverType(PbdConstraint::SolverType::xPBD);
+                                 solver.setResidualTolerance(1.0e-6);
+                                 solver.setMaxIterations(5000);
+                                 solver.setLambdaWarmStart(warmStart);
+
+                                 // Quasi-static frames, gravity pulls the free vertices
+                                 // down from where the last solve left them
+                                 size_t numIterations = 0;
+                                 for (int frame = 0; frame < 20; frame++)
+                                 {
+                                     VecDataArray<double, 3>& positions = *cloth.m_positions;
+                                     for (int i = 0; i < positions.size(); i++)
+                                     {
+                                         if ((*cloth.m_invMasses)[i] > 0.0)
+                                         {
+                                             positions[i][1] -= 9.81 * 0.01 * 0.01;
+                                         }
+                                     }
+                                     solver.solve();
+                                     EXPECT_LT(solver.getNumIterationsDone(), 5000);
+                                     numIterations += (frame >= 10) ? solver.getNumIterationsDone() : 0;
+                                 }
+                                 return numIterations;
+                             };
+
+        EXPECT_LT(getIterations(1.0), getIterations(0.0));
+    }
+}
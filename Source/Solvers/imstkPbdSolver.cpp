@@ -20,11 +20,15 @@
 =========================================================================*/
 
 #include "imstkPbdSolver.h"
+#include "imstkGraph.h"
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
 #include "imstkPbdCollisionConstraint.h"
 #include "imstkPbdConstraintContainer.h"
 
+#include <algorithm>
+#include <numeric>
+
 namespace imstk
 {
 PbdSolver::PbdSolver() :
@@ -39,37 +43,295 @@ void
 PbdSolver::solve()
 {
     // Solve the constraints and partitioned constraints
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>&         batches = m_constraints->getBatches();
+
+    // Number of partitions shared by polymorphic and batched constraints
+    size_t numPartitions = partitionedConstraints.size();
+    for (const auto& batch : batches)
+    {
+        numPartitions = std::max(numPartitions, batch->getNumPartitions());
+    }
+
+    // Multipliers only carry over between xPBD solves
+    const bool warmStart = (m_lambdaWarmStart > 0.0 && m_solverType != PbdConstraint::SolverType::PBD);
+    initLambdas(warmStart ? std::min(m_lambdaWarmStart, 1.0) : 0.0);
+    if (warmStart)
+    {
+        applyLambdas(numPartitions);
+    }
+
+    if (m_executionMode == ExecutionMode::Jacobi)
+    {
+        initJacobi();
+    }
+
+    // With a tolerance the residual decides when to stop, up to the max number of iterations
+    const bool   isAdaptive    = (m_residualTolerance > 0.0);
+    const size_t maxIterations = (isAdaptive && m_maxIterations > 0) ? m_maxIterations : m_iterations;
+    const size_t checkInterval = (isAdaptive && m_residualCheckInterval == 0) ? 1 : m_residualCheckInterval;
+
+    m_solvedSingle = (m_scalarType == IMSTK_FLOAT) && canSolveSingle(maxIterations);
+    if (m_solvedSingle)
+    {
+        const VecDataArray<double, 3>& positions = *m_positions;
+        const DataArray<double>&       invMasses = *m_invMasses;
+        m_positionsSingle.resize(positions.size());
+        m_invMassesSingle.resize(invMasses.size());
+        ParallelUtils::parallelFor(positions.size(),
+            [&](const int i)
+            {
+                m_positionsSingle[i] = positions[i].cast<float>();
+            });
+        ParallelUtils::parallelFor(invMasses.size(),
+            [&](const int i)
+            {
+                m_invMassesSingle[i] = static_cast<float>(invMasses[i]);
+            });
+    }
+
+    if (m_chebyshevAcceleration)
+    {
+        const VecDataArray<double, 3>& positions = *m_positions;
+        m_chebyshevPrevPositions.resize(positions.size());
+        m_chebyshevCurrPositions.resize(positions.size());
+        ParallelUtils::parallelFor(positions.size(),
+            [&](const int i)
+            {
+                m_chebyshevCurrPositions[i] = m_chebyshevPrevPositions[i] = positions[i];
+            });
+        m_chebyshevRho   = m_chebyshevSpectralRadius;
+        m_chebyshevOmega = 1.0;
+        m_chebyshevLastUpdateNorm = 0.0;
+    }
+
+    m_numIterations = 0;
+    m_maxResidual   = 0.0;
+    m_rmsResidual   = 0.0;
+    while (m_numIterations < maxIterations)
+    {
+        if (m_executionMode == ExecutionMode::Jacobi)
+        {
+            projectJacobi();
+        }
+        else if (m_solvedSingle)
+        {
+            projectGaussSeidelSingle(numPartitions);
+        }
+        else
+        {
+            projectGaussSeidel(numPartitions);
+        }
+        m_numIterations++;
+
+        if (m_chebyshevAcceleration)
+        {
+            if (m_solvedSingle)
+            {
+                chebyshevStep(m_positionsSingle);
+            }
+            else
+            {
+                chebyshevStep(*m_positions);
+            }
+        }
+
+        if (checkInterval > 0 && (m_numIterations % checkInterval == 0 || m_numIterations == maxIterations))
+        {
+            computeResiduals();
+            if (isAdaptive && m_maxResidual < m_residualTolerance)
+            {
+                break;
+            }
+        }
+    }
+
+    if (m_solvedSingle)
+    {
+        VecDataArray<double, 3>& positions = *m_positions;
+        ParallelUtils::parallelFor(positions.size(),
+            [&](const int i)
+            {
+                positions[i] = m_positionsSingle[i].cast<double>();
+            });
+    }
+}
+
+template<typename T>
+void
+PbdSolver::chebyshevStep(VecDataArray<T, 3>& positions)
+{
+    const size_t delay = std::max<size_t>(m_chebyshevDelay, (m_chebyshevSpectralRadius > 0.0) ? 1 : 3);
+    if (m_numIterations < delay)
+    {
+        // Unaccelerated, the ratio of the last two updates estimates the spectral radius
+        m_chebyshevUpdateNorms.resize(positions.size());
+        ParallelUtils::parallelFor(positions.size(),
+            [&](const int i)
+            {
+                const Vec3d x = positions[i].template cast<double>();
+                m_chebyshevUpdateNorms[i]   = (x - m_chebyshevCurrPositions[i]).squaredNorm();
+                m_chebyshevPrevPositions[i] = m_chebyshevCurrPositions[i];
+                m_chebyshevCurrPositions[i] = x;
+            });
+        const double updateNorm = std::accumulate(m_chebyshevUpdateNorms.begin(), m_chebyshevUpdateNorms.end(), 0.0);
+        if (m_chebyshevSpectralRadius <= 0.0 && m_chebyshevLastUpdateNorm > 0.0)
+        {
+            m_chebyshevRho = std::min(std::sqrt(updateNorm / m_chebyshevLastUpdateNorm), 0.99);
+        }
+        m_chebyshevLastUpdateNorm = updateNorm;
+        return;
+    }
+
+    const double rho2 = m_chebyshevRho * m_chebyshevRho;
+    m_chebyshevOmega = (m_numIterations == delay) ? 2.0 / (2.0 - rho2) : 4.0 / (4.0 - rho2 * m_chebyshevOmega);
+    const double omega = m_chebyshevOmega;
+    ParallelUtils::parallelFor(positions.size(),
+        [&](const int i)
+        {
+            const Vec3d& prev = m_chebyshevPrevPositions[i];
+            const Vec3d  x    = omega * (positions[i].template cast<double>() - prev) + prev;
+            m_chebyshevPrevPositions[i] = m_chebyshevCurrPositions[i];
+            m_chebyshevCurrPositions[i] = x;
+            positions[i] = x.template cast<T>();
+        });
+}
+
+bool
+PbdSolver::canSolveSingle(const size_t maxIterations)
+{
+    const bool isBatched = m_executionMode == ExecutionMode::GaussSeidel
+                           && m_constraints->getConstraints().empty()
+                           && m_constraints->getPartitionedConstraints().empty();
+    // The state is copied to float and back every solve, a single iteration does not make up for it
+    const bool canSolve = isBatched && maxIterations > 1;
+    if (!canSolve && !m_warnedSingleUnusable)
+    {
+        if (!isBatched)
+        {
+            LOG(WARNING) << "PbdSolver: single precision only supports batched constraints solved Gauss-Seidel, solving in double";
+        }
+        else
+        {
+            LOG(WARNING) << "PbdSolver: single precision needs more than one iteration per solve, solving in double";
+        }
+        m_warnedSingleUnusable = true;
+    }
+    return canSolve;
+}
+
+void
+PbdSolver::initLambdas(const double scale)
+{
+    const std::vector<std::shared_ptr<PbdConstraint>>&              constraints = m_constraints->getConstraints();
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>&         batches = m_constraints->getBatches();
+
+    // One task per constraint list and per batch, the unpartitioned constraints being the first list
+    const size_t numLists = partitionedConstraints.size() + 1;
+    ParallelUtils::parallelFor(numLists + batches.size(),
+        [&](const size_t i)
+        {
+            if (i >= numLists)
+            {
+                if (scale == 0.0)
+                {
+                    batches[i - numLists]->zeroOutLambdas();
+                }
+                else
+                {
+                    batches[i - numLists]->scaleLambdas(scale);
+                }
+                return;
+            }
+            for (const auto& constraint : (i == 0) ? constraints : partitionedConstraints[i - 1])
+            {
+                if (scale == 0.0)
+                {
+                    constraint->zeroOutLambda();
+                }
+                else
+                {
+                    constraint->scaleLambda(scale);
+                }
+            }
+        });
+}
+
+void
+PbdSolver::applyLambdas(const size_t numPartitions)
+{
     VecDataArray<double, 3>& currPositions = *m_positions;
     const DataArray<double>& invMasses     = *m_invMasses;
 
     const std::vector<std::shared_ptr<PbdConstraint>>&              constraints = m_constraints->getConstraints();
     const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>&         batches = m_constraints->getBatches();
 
-    // zero out the Lagrange multiplier
+    // Same order as the projection, constraints of a partition share no vertex
     for (const auto& constraint : constraints)
     {
-        constraint->zeroOutLambda();
+        constraint->applyLambda(invMasses, currPositions);
     }
-
-    for (const auto& constraintPartition : partitionedConstraints)
+    for (const auto& batch : batches)
     {
-        ParallelUtils::parallelFor(constraintPartition.size(),
-            [&](const size_t idx)
-            {
-                constraintPartition[idx]->zeroOutLambda();
-            });
+        batch->applyLambdas(batch->getPartitionOffsets().back(), batch->size(), invMasses, currPositions);
     }
 
-    unsigned int i = 0;
-    while (i++ < m_iterations)
+    for (size_t p = 0; p < numPartitions; p++)
     {
-        for (const auto& constraint : constraints)
+        if (p < partitionedConstraints.size())
         {
-            constraint->projectConstraint(invMasses, m_dt, m_solverType, currPositions);
+            const std::vector<std::shared_ptr<PbdConstraint>>& constraintPartition = partitionedConstraints[p];
+            ParallelUtils::parallelFor(constraintPartition.size(),
+                [&](const size_t idx)
+                {
+                    constraintPartition[idx]->applyLambda(invMasses, currPositions);
+                });
+        }
+
+        for (const auto& batch : batches)
+        {
+            if (p < batch->getNumPartitions())
+            {
+                const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+                ParallelUtils::parallelForRange(offsets[p], offsets[p + 1],
+                    [&](const size_t begin, const size_t end)
+                    {
+                        batch->applyLambdas(begin, end, invMasses, currPositions);
+                    });
+            }
         }
+    }
+}
+
+void
+PbdSolver::projectGaussSeidel(const size_t numPartitions)
+{
+    VecDataArray<double, 3>& currPositions = *m_positions;
+    const DataArray<double>& invMasses     = *m_invMasses;
+
+    const std::vector<std::shared_ptr<PbdConstraint>>&              constraints = m_constraints->getConstraints();
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>&         batches = m_constraints->getBatches();
+
+    for (const auto& constraint : constraints)
+    {
+        constraint->projectConstraint(invMasses, m_dt, m_solverType, currPositions);
+    }
 
-        for (const auto& constraintPartition : partitionedConstraints)
+    // Batched constraints not partitioned
+    for (const auto& batch : batches)
+    {
+        batch->projectConstraints(batch->getPartitionOffsets().back(), batch->size(),
+            invMasses, m_dt, m_solverType, currPositions);
+    }
+
+    for (size_t p = 0; p < numPartitions; p++)
+    {
+        if (p < partitionedConstraints.size())
         {
+            const std::vector<std::shared_ptr<PbdConstraint>>& constraintPartition = partitionedConstraints[p];
             ParallelUtils::parallelFor(constraintPartition.size(),
                 [&](const size_t idx)
                 {
@@ -81,9 +343,262 @@ PbdSolver::solve()
             //    constraintPartition[k]->projectConstraint(invMasses, m_dt, m_solverType, currPositions);
             //}
         }
+
+        for (const auto& batch : batches)
+        {
+            if (p < batch->getNumPartitions())
+            {
+                const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+                ParallelUtils::parallelForRange(offsets[p], offsets[p + 1],
+                    [&](const size_t begin, const size_t end)
+                    {
+                        batch->projectConstraints(begin, end, invMasses, m_dt, m_solverType, currPositions);
+                    });
+            }
+        }
     }
 }
 
+void
+PbdSolver::projectGaussSeidelSingle(const size_t numPartitions)
+{
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>& batches = m_constraints->getBatches();
+
+    for (const auto& batch : batches)
+    {
+        batch->projectConstraints(batch->getPartitionOffsets().back(), batch->size(),
+            m_invMassesSingle, m_dt, m_solverType, m_positionsSingle);
+    }
+
+    for (size_t p = 0; p < numPartitions; p++)
+    {
+        for (const auto& batch : batches)
+        {
+            if (p < batch->getNumPartitions())
+            {
+                const std::vector<size_t>& offsets = batch->getPartitionOffsets();
+                ParallelUtils::parallelForRange(offsets[p], offsets[p + 1],
+                    [&](const size_t begin, const size_t end)
+                    {
+                        batch->projectConstraints(begin, end, m_invMassesSingle, m_dt, m_solverType, m_positionsSingle);
+                    });
+            }
+        }
+    }
+}
+
+void
+PbdSolver::initJacobi()
+{
+    // The slots only depend on the vertex ids of the constraints
+    const size_t numVertices = static_cast<size_t>(m_positions->size());
+    if (m_jacobiInitialized && m_jacobiModifiedCount == m_constraints->getModifiedCount()
+        && m_vertexSlotOffsets.size() == numVertices + 1)
+    {
+        return;
+    }
+    m_jacobiInitialized   = true;
+    m_jacobiModifiedCount = m_constraints->getModifiedCount();
+
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>& batches = m_constraints->getBatches();
+
+    // Gather the polymorphic constraints, partitions do not matter here
+    m_globalConstraints.clear();
+    m_jacobiConstraints.clear();
+    auto addConstraint = [&](const std::shared_ptr<PbdConstraint>& constraint)
+                         {
+                             if (constraint->getVertexIds().empty())
+                             {
+                                 m_globalConstraints.push_back(constraint.get());
+                             }
+                             else
+                             {
+                                 m_jacobiConstraints.push_back(constraint.get());
+                             }
+                         };
+    for (const auto& constraint : m_constraints->getConstraints())
+    {
+        addConstraint(constraint);
+    }
+    for (const auto& constraintPartition : m_constraints->getPartitionedConstraints())
+    {
+        for (const auto& constraint : constraintPartition)
+        {
+            addConstraint(constraint);
+        }
+    }
+
+    // Every vertex of every constraint gets a slot for its correction, polymorphic
+    // constraints first then the batches
+    const size_t numConstraints = m_jacobiConstraints.size();
+    m_slotOffsets.resize(numConstraints + batches.size() + 1);
+    m_slotOffsets[0] = 0;
+    for (size_t i = 0; i < numConstraints; i++)
+    {
+        m_slotOffsets[i + 1] = m_slotOffsets[i] + m_jacobiConstraints[i]->getVertexIds().size();
+    }
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        m_slotOffsets[numConstraints + i + 1] = m_slotOffsets[numConstraints + i] +
+                                                batches[i]->size() * batches[i]->getNumVertices();
+    }
+    m_corrections.resize(m_slotOffsets.back());
+
+    auto forEachSlot = [&](auto&& func)
+                       {
+                           for (size_t i = 0; i < numConstraints; i++)
+                           {
+                               const auto vertexIds = m_jacobiConstraints[i]->getVertexIds();
+                               for (size_t j = 0; j < vertexIds.size(); j++)
+                               {
+                                   func(m_slotOffsets[i] + j, vertexIds[j]);
+                               }
+                           }
+                           for (size_t i = 0; i < batches.size(); i++)
+                           {
+                               const PbdConstraintBatch& batch    = *batches[i];
+                               const size_t              numVerts = batch.getNumVertices();
+                               for (size_t j = 0; j < batch.size(); j++)
+                               {
+                                   const size_t* vertexIds = batch.getVertexIds(j);
+                                   for (size_t k = 0; k < numVerts; k++)
+                                   {
+                                       func(m_slotOffsets[numConstraints + i] + j * numVerts + k, vertexIds[k]);
+                                   }
+                               }
+                           }
+                       };
+
+    // Invert to the slots of every vertex, in increasing order such that the sums
+    // below do not depend on the number of threads
+    m_vertexSlotOffsets.assign(numVertices + 1, 0);
+    forEachSlot([&](const size_t, const size_t vertexId) { m_vertexSlotOffsets[vertexId + 1]++; });
+    std::partial_sum(m_vertexSlotOffsets.begin(), m_vertexSlotOffsets.end(), m_vertexSlotOffsets.begin());
+    m_vertexSlots.resize(m_vertexSlotOffsets.back());
+    std::vector<size_t> writeIdx(m_vertexSlotOffsets.begin(), m_vertexSlotOffsets.end() - 1);
+    forEachSlot([&](const size_t slot, const size_t vertexId) { m_vertexSlots[writeIdx[vertexId]++] = slot; });
+}
+
+void
+PbdSolver::projectJacobi()
+{
+    VecDataArray<double, 3>& currPositions = *m_positions;
+    const DataArray<double>& invMasses     = *m_invMasses;
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>& batches = m_constraints->getBatches();
+
+    const size_t numConstraints = m_jacobiConstraints.size();
+    const size_t numVertices    = m_vertexSlotOffsets.size() - 1;
+    Vec3d*       corrections    = m_corrections.data();
+
+    // Every constraint sees the positions of the previous iteration
+    ParallelUtils::parallelFor(numConstraints,
+        [&](const size_t j)
+        {
+            m_jacobiConstraints[j]->computePositionCorrections(invMasses, m_dt, m_solverType, currPositions,
+                corrections + m_slotOffsets[j]);
+        });
+    for (size_t j = 0; j < batches.size(); j++)
+    {
+        PbdConstraintBatch& batch      = *batches[j];
+        Vec3d*              batchSlots = corrections + m_slotOffsets[numConstraints + j];
+        ParallelUtils::parallelForRange(static_cast<size_t>(0), batch.size(),
+            [&](const size_t begin, const size_t end)
+            {
+                batch.computePositionCorrections(begin, end, invMasses, m_dt, m_solverType, currPositions,
+                    batchSlots + begin * batch.getNumVertices());
+            });
+    }
+
+    // Move every vertex by the (relaxed) average of its corrections
+    ParallelUtils::parallelFor(numVertices,
+        [&](const size_t j)
+        {
+            const size_t begin = m_vertexSlotOffsets[j];
+            const size_t end   = m_vertexSlotOffsets[j + 1];
+            if (begin == end || invMasses[j] == 0.0)
+            {
+                return;
+            }
+            Vec3d sum = Vec3d::Zero();
+            for (size_t k = begin; k < end; k++)
+            {
+                sum += corrections[m_vertexSlots[k]];
+            }
+            currPositions[j] += sum * (m_relaxation / static_cast<double>(end - begin));
+        });
+
+    for (PbdConstraint* constraint : m_globalConstraints)
+    {
+        constraint->projectConstraint(invMasses, m_dt, m_solverType, currPositions);
+    }
+}
+
+void
+PbdSolver::computeResiduals()
+{
+    const VecDataArray<double, 3>& currPositions = *m_positions;
+
+    const std::vector<std::shared_ptr<PbdConstraint>>&              constraints = m_constraints->getConstraints();
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    const std::vector<std::shared_ptr<PbdConstraintBatch>>&         batches = m_constraints->getBatches();
+
+    // One residual per constraint, reduced sequentially to not depend on the number of threads
+    size_t numResiduals = constraints.size();
+    for (const auto& constraintPartition : partitionedConstraints)
+    {
+        numResiduals += constraintPartition.size();
+    }
+    for (const auto& batch : batches)
+    {
+        numResiduals += batch->size();
+    }
+    m_residuals.resize(numResiduals);
+
+    double* residuals = m_residuals.data();
+    auto    computeConstraintResiduals = [&](const std::vector<std::shared_ptr<PbdConstraint>>& constraintList)
+                                         {
+                                             ParallelUtils::parallelFor(constraintList.size(),
+                                                 [&](const size_t idx)
+                                                 {
+                                                     // Global constraints (ie: constant density) are not evaluated
+                                                     residuals[idx] = constraintList[idx]->getVertexIds().empty() ? 0.0 :
+                                                                      constraintList[idx]->computeResidual(currPositions, m_dt, m_solverType);
+                                                 });
+                                             residuals += constraintList.size();
+                                         };
+    computeConstraintResiduals(constraints);
+    for (const auto& constraintPartition : partitionedConstraints)
+    {
+        computeConstraintResiduals(constraintPartition);
+    }
+    for (const auto& batch : batches)
+    {
+        ParallelUtils::parallelForRange(static_cast<size_t>(0), batch->size(),
+            [&](const size_t begin, const size_t end)
+            {
+                if (m_solvedSingle)
+                {
+                    batch->computeResiduals(begin, end, m_positionsSingle, m_dt, m_solverType, residuals + begin);
+                }
+                else
+                {
+                    batch->computeResiduals(begin, end, currPositions, m_dt, m_solverType, residuals + begin);
+                }
+            });
+        residuals += batch->size();
+    }
+
+    double maxResidual = 0.0;
+    double sumSquares  = 0.0;
+    for (const double residual : m_residuals)
+    {
+        maxResidual = std::max(maxResidual, residual);
+        sumSquares += residual * residual;
+    }
+    m_maxResidual = maxResidual;
+    m_rmsResidual = (numResiduals > 0) ? std::sqrt(sumSquares / static_cast<double>(numResiduals)) : 0.0;
+}
+
 PbdCollisionSolver::PbdCollisionSolver() :
     m_collisionConstraints(std::make_shared<std::list<std::vector<PbdCollisionConstraint*>*>>())
 {
@@ -92,7 +607,10 @@ PbdCollisionSolver::PbdCollisionSolver() :
 void
 PbdCollisionSolver::addCollisionConstraints(std::vector<PbdCollisionConstraint*>* constraints)
 {
-    m_collisionConstraints->push_back(constraints);
+    if (std::find(m_collisionConstraints->begin(), m_collisionConstraints->end(), constraints) == m_collisionConstraints->end())
+    {
+        m_collisionConstraints->push_back(constraints);
+    }
 }
 
 void
@@ -101,20 +619,202 @@ PbdCollisionSolver::solve()
     // Solve collision constraints
     if (m_collisionConstraints->size() > 0)
     {
-        unsigned int i = 0;
-        while (i++ < m_collisionIterations)
+        if (m_executionMode == ExecutionMode::Colored)
         {
-            for (auto constraintList : *m_collisionConstraints)
+            solveColored();
+        }
+        else if (m_executionMode == ExecutionMode::Jacobi)
+        {
+            solveJacobi();
+        }
+        else
+        {
+            unsigned int i = 0;
+            while (i++ < m_collisionIterations)
             {
-                const std::vector<PbdCollisionConstraint*>& constraints = *constraintList;
-                for (size_t j = 0; j < constraints.size(); j++)
+                for (auto constraintList : *m_collisionConstraints)
                 {
-                    constraints[j]->solvePosition();
+                    const std::vector<PbdCollisionConstraint*>& constraints = *constraintList;
+                    for (size_t j = 0; j < constraints.size(); j++)
+                    {
+                        constraints[j]->solvePosition();
+                    }
                 }
             }
         }
 
-        m_collisionConstraints->clear();
+        if (!m_retainConstraints)
+        {
+            m_collisionConstraints->clear();
+        }
+    }
+}
+
+void
+PbdCollisionSolver::gatherConstraints()
+{
+    m_constraints.clear();
+    m_slotOffsets.clear();
+    m_slotOffsets.push_back(0);
+    m_slotVertexIds.clear();
+    m_slotMovable.clear();
+    m_vertices.clear();
+    m_vertexMovable.clear();
+    m_vertexIds.clear();
+
+    auto addVertex = [&](const VertexMassPair& vertex)
+                     {
+                         const auto iter = m_vertexIds.emplace(vertex.vertex, static_cast<int>(m_vertices.size()));
+                         if (iter.second)
+                         {
+                             m_vertices.push_back(vertex.vertex);
+                             m_vertexMovable.push_back(false);
+                         }
+                         const bool movable = vertex.invMass > 0.0;
+                         m_slotVertexIds.push_back(iter.first->second);
+                         m_slotMovable.push_back(movable);
+                         m_vertexMovable[iter.first->second] |= movable;
+                     };
+    for (auto constraintList : *m_collisionConstraints)
+    {
+        for (PbdCollisionConstraint* constraint : *constraintList)
+        {
+            for (const VertexMassPair& vertex : constraint->getVertexIdsFirst())
+            {
+                addVertex(vertex);
+            }
+            for (const VertexMassPair& vertex : constraint->getVertexIdsSecond())
+            {
+                addVertex(vertex);
+            }
+            m_constraints.push_back(constraint);
+            m_slotOffsets.push_back(m_slotVertexIds.size());
+        }
+    }
+}
+
+void
+PbdCollisionSolver::solveColored()
+{
+    gatherConstraints();
+    const size_t numConstraints = m_constraints.size();
+
+    // Constraints sharing a vertex get different colors unless no constraint moves it, a
+    // constraint then never reads a vertex another one of its color moves, even a vertex
+    // it has infinite mass in
+    std::vector<size_t> vertexOffsets(numConstraints + 1, 0);
+    std::vector<size_t> vertexIds;
+    vertexIds.reserve(m_slotVertexIds.size());
+    for (size_t i = 0; i < numConstraints; i++)
+    {
+        for (size_t j = m_slotOffsets[i]; j < m_slotOffsets[i + 1]; j++)
+        {
+            if (m_vertexMovable[m_slotVertexIds[j]])
+            {
+                vertexIds.push_back(static_cast<size_t>(m_slotVertexIds[j]));
+            }
+        }
+        vertexOffsets[i + 1] = vertexIds.size();
+    }
+    Graph graph(numConstraints);
+    graph.setEdgesFromSharedKeys(vertexOffsets, vertexIds);
+    const auto coloring  = graph.doColoring(Graph::ColoringMethod::JonesPlassmann);
+    const auto numColors = static_cast<size_t>(coloring.second);
+
+    // Sort the constraints by color, keeping their order within a color
+    std::vector<size_t> colorOffsets(numColors + 1, 0);
+    for (const auto color : coloring.first)
+    {
+        colorOffsets[color + 1]++;
+    }
+    std::partial_sum(colorOffsets.begin(), colorOffsets.end(), colorOffsets.begin());
+    std::vector<PbdCollisionConstraint*> sortedConstraints(numConstraints);
+    std::vector<size_t>                  writeIdx(colorOffsets.begin(), colorOffsets.end() - 1);
+    for (size_t i = 0; i < numConstraints; i++)
+    {
+        sortedConstraints[writeIdx[coloring.first[i]]++] = m_constraints[i];
+    }
+
+    unsigned int i = 0;
+    while (i++ < m_collisionIterations)
+    {
+        for (size_t color = 0; color < numColors; color++)
+        {
+            ParallelUtils::parallelFor(colorOffsets[color], colorOffsets[color + 1],
+                [&](const size_t j)
+                {
+                    sortedConstraints[j]->solvePosition();
+                });
+        }
+    }
+}
+
+void
+PbdCollisionSolver::solveJacobi()
+{
+    gatherConstraints();
+    const size_t numConstraints = m_constraints.size();
+    const size_t numVertices    = m_vertices.size();
+    const size_t numSlots       = m_slotVertexIds.size();
+
+    // Invert to the slots of every vertex, a slot being a vertex of a constraint
+    std::vector<size_t> vertexSlotOffsets(numVertices + 1, 0);
+    for (size_t j = 0; j < numSlots; j++)
+    {
+        if (m_slotMovable[j])
+        {
+            vertexSlotOffsets[m_slotVertexIds[j] + 1]++;
+        }
+    }
+    std::partial_sum(vertexSlotOffsets.begin(), vertexSlotOffsets.end(), vertexSlotOffsets.begin());
+    std::vector<size_t> vertexSlots(vertexSlotOffsets.back());
+    std::vector<size_t> slotConstraints(numSlots);
+    std::vector<size_t> writeIdx(vertexSlotOffsets.begin(), vertexSlotOffsets.end() - 1);
+    for (size_t i = 0; i < numConstraints; i++)
+    {
+        for (size_t j = m_slotOffsets[i]; j < m_slotOffsets[i + 1]; j++)
+        {
+            slotConstraints[j] = i;
+            if (m_slotMovable[j])
+            {
+                vertexSlots[writeIdx[m_slotVertexIds[j]]++] = j;
+            }
+        }
+    }
+
+    std::vector<Vec3d> dx(numSlots);
+    std::vector<char>  isActive(numConstraints);
+    unsigned int       i = 0;
+    while (i++ < m_collisionIterations)
+    {
+        // Every constraint sees the positions of the previous iteration
+        ParallelUtils::parallelFor(numConstraints,
+            [&](const size_t j)
+            {
+                isActive[j] = m_constraints[j]->computePositionCorrections(&dx[m_slotOffsets[j]]);
+            });
+
+        // Each vertex moves by the average of its corrections, in the same order for
+        // any number of threads
+        ParallelUtils::parallelFor(numVertices,
+            [&](const size_t j)
+            {
+                Vec3d  sum   = Vec3d::Zero();
+                size_t count = 0;
+                for (size_t k = vertexSlotOffsets[j]; k < vertexSlotOffsets[j + 1]; k++)
+                {
+                    const size_t slot = vertexSlots[k];
+                    if (isActive[slotConstraints[slot]])
+                    {
+                        sum += dx[slot];
+                        count++;
+                    }
+                }
+                if (count > 0)
+                {
+                    *m_vertices[j] += sum / static_cast<double>(count);
+                }
+            });
     }
 }
 } // end namespace imstk
@@ -24,6 +24,8 @@
 #include "imstkPbdConstraint.h"
 #include "imstkSolverBase.h"
 
+#include <unordered_map>
+
 namespace imstk
 {
 class PbdCollisionConstraint;
@@ -58,6 +60,13 @@ struct CollisionConstraintData
 ///
 class PbdSolver : public SolverBase
 {
+public:
+    enum class ExecutionMode
+    {
+        GaussSeidel, ///> Sequential constraints then partitions one after the other, each in parallel
+        Jacobi       ///> Corrections of all constraints computed in parallel from the same positions then averaged per vertex
+    };
+
 public:
     ///
     /// \brief Constructors/Destructor
@@ -75,7 +84,11 @@ public:
     /// \brief Sets the constraints the solver should solve for
     /// These wil be solved sequentially
     ///
-    void setConstraints(std::shared_ptr<PbdConstraintContainer> constraints) { this->m_constraints = constraints; }
+    void setConstraints(std::shared_ptr<PbdConstraintContainer> constraints)
+    {
+        this->m_constraints = constraints;
+        m_jacobiInitialized = false;
+    }
 
     ///
     /// \brief Sets the positions the solver should solve with
@@ -102,12 +115,175 @@ public:
     ///
     void setSolverType(const PbdConstraint::SolverType& type) { m_solverType = type; }
 
+    ///
+    /// \brief Set/Get how the constraints are executed, Gauss-Seidel by default.
+    /// Jacobi does not need partitioning and gives the same result for any number of
+    /// threads, but converges slower. Global constraints (without vertex ids, ie:
+    /// constant density) are projected directly after the Jacobi pass
+    ///
+    void setExecutionMode(const ExecutionMode mode) { m_executionMode = mode; }
+    ExecutionMode getExecutionMode() const { return m_executionMode; }
+
+    ///
+    /// \brief Set/Get the relaxation of the averaged corrections in Jacobi mode,
+    /// values in (1, 2) over-relax to speed up convergence
+    ///
+    void setRelaxation(const double relaxation) { m_relaxation = relaxation; }
+    double getRelaxation() const { return m_relaxation; }
+
+    ///
+    /// \brief Set/Get the residual tolerance. When positive the solver stops as soon as
+    /// the max constraint residual falls below it, 0 (default) always does the set iterations
+    ///
+    void setResidualTolerance(const double tolerance) { m_residualTolerance = tolerance; }
+    double getResidualTolerance() const { return m_residualTolerance; }
+
+    ///
+    /// \brief Set/Get the max number of iterations with a residual tolerance,
+    /// 0 (default) uses the set iterations
+    ///
+    void setMaxIterations(const size_t maxIterations) { m_maxIterations = maxIterations; }
+    size_t getMaxIterations() const { return m_maxIterations; }
+
+    ///
+    /// \brief Set/Get the number of iterations between residual evaluations. 0 (default)
+    /// never evaluates it without a tolerance, and every iteration with one
+    ///
+    void setResidualCheckInterval(const size_t interval) { m_residualCheckInterval = interval; }
+    size_t getResidualCheckInterval() const { return m_residualCheckInterval; }
+
+    ///
+    /// \brief Get the number of iterations done in the last solve
+    ///
+    size_t getNumIterationsDone() const { return m_numIterations; }
+
+    ///
+    /// \brief Get the max/root mean square constraint residual of the last evaluation,
+    /// |C + alpha * lambda| for xPBD and |C| for PBD
+    ///
+    double getMaxResidual() const { return m_maxResidual; }
+    double getRmsResidual() const { return m_rmsResidual; }
+
+    ///
+    /// \brief Set/Get the precision of the positions and inverse masses while solving,
+    /// IMSTK_DOUBLE (default) or IMSTK_FLOAT. In single precision they are copied to float
+    /// arrays at the start of every solve and the positions back at its end, which adds a
+    /// pass over the state to every solve. The iterations in between read half the bytes
+    /// and use twice the simd lanes, so it only pays off with several iterations per solve,
+    /// with a single one (ie: substeps) double is used. Partitioned distance and dihedral
+    /// batches are then projected by their simd kernels in single precision, when the
+    /// instruction set has one. Their multiplier increments are computed in single precision
+    /// and accumulated in double. The other batches, the constraints left over by
+    /// the simd lanes and the unpartitioned ones are evaluated in double from the float
+    /// positions. Only batched constraints solved Gauss-Seidel are supported, otherwise
+    /// double is used
+    ///
+    void setScalarType(const ScalarTypeId type) { m_scalarType = type; }
+    ScalarTypeId getScalarType() const { return m_scalarType; }
+
+    ///
+    /// \brief Returns whether the last solve was done in single precision
+    ///
+    bool getSolvedSingle() const { return m_solvedSingle; }
+
+    ///
+    /// \brief Set/Get whether the iterations are accelerated by Chebyshev semi-iterations,
+    /// after Wang, "A Chebyshev Semi-Iterative Approach for Accelerating Projective and
+    /// Position-based Dynamics", 2015. Every iterate is blended with the two previous ones
+    /// according to the spectral radius of the iterations. Off by default. Meant for PBD,
+    /// in xPBD the Lagrange multipliers are not extrapolated with the positions
+    ///
+    void setChebyshevAcceleration(const bool accelerate) { m_chebyshevAcceleration = accelerate; }
+    bool getChebyshevAcceleration() const { return m_chebyshevAcceleration; }
+
+    ///
+    /// \brief Set/Get the spectral radius in [0, 1) used by the Chebyshev acceleration, the
+    /// closer to 1 the stronger the extrapolation. Too large values oscillate. 0 (default)
+    /// estimates it at every solve from the convergence of the first, unaccelerated, iterations
+    ///
+    void setChebyshevSpectralRadius(const double rho) { m_chebyshevSpectralRadius = rho; }
+    double getChebyshevSpectralRadius() const { return m_chebyshevSpectralRadius; }
+
+    ///
+    /// \brief Set/Get the number of unaccelerated iterations before the Chebyshev acceleration
+    /// starts, at least 3 when the spectral radius is estimated from them
+    ///
+    void setChebyshevDelay(const size_t delay) { m_chebyshevDelay = delay; }
+    size_t getChebyshevDelay() const { return m_chebyshevDelay; }
+
+    ///
+    /// \brief Get the spectral radius used by the Chebyshev acceleration in the last solve
+    ///
+    double getChebyshevSpectralRadiusUsed() const { return m_chebyshevRho; }
+
+    ///
+    /// \brief Set/Get the fraction in [0, 1] of the Lagrange multipliers of the previous solve
+    /// each xPBD solve starts from. 0 (default) starts every solve from zero. Otherwise the
+    /// scaled multipliers are kept and the positions first moved by their corrections, such
+    /// that constraints under a sustained load (ie: resting tissue) start close to their
+    /// solution and reach a residual tolerance in fewer iterations. Ignored in PBD
+    ///
+    void setLambdaWarmStart(const double scale) { m_lambdaWarmStart = scale; }
+    double getLambdaWarmStart() const { return m_lambdaWarmStart; }
+
     ///
     /// \brief Solve the non linear system of equations G(x)=0 using Newton's method.
     ///
     void solve() override;
 
 private:
+    ///
+    /// \brief Zero or scale, when warm started, the Lagrange multipliers of every constraint
+    /// in a single pass
+    ///
+    void initLambdas(const double scale);
+
+    ///
+    /// \brief Move the positions by the corrections of the warm started multipliers,
+    /// partition by partition
+    ///
+    void applyLambdas(const size_t numPartitions);
+
+    ///
+    /// \brief Project all constraints once, partition by partition
+    ///
+    void projectGaussSeidel(const size_t numPartitions);
+
+    ///
+    /// \brief Project all the batches once on the single precision copy of the positions
+    ///
+    void projectGaussSeidelSingle(const size_t numPartitions);
+
+    ///
+    /// \brief Whether the single precision path can be used for the constraints and number
+    /// of iterations, warns once if not
+    ///
+    bool canSolveSingle(const size_t maxIterations);
+
+    ///
+    /// \brief Gather the constraints and build the correction slots of every vertex,
+    /// only when the constraints or the number of vertices changed since the last solve
+    ///
+    void initJacobi();
+
+    ///
+    /// \brief Project all constraints against the same positions and move every vertex
+    /// by the average of its corrections
+    ///
+    void projectJacobi();
+
+    ///
+    /// \brief Evaluate the residual of every constraint and reduce it to the max and rms
+    ///
+    void computeResiduals();
+
+    ///
+    /// \brief Blend the positions just projected with the two previous iterates,
+    /// x_k+1 = omega * (x^ - x_k-1) + x_k-1, and update the Chebyshev weight omega
+    ///
+    template<typename T>
+    void chebyshevStep(VecDataArray<T, 3>& positions);
+
     size_t m_iterations = 20;                                         ///> Number of NL Gauss-Seidel iterations for regular constraints
     double m_dt;                                                      ///> time step
 
@@ -116,21 +292,75 @@ private:
     std::shared_ptr<VecDataArray<double, 3>> m_positions = nullptr;
     std::shared_ptr<DataArray<double>>       m_invMasses = nullptr;
     PbdConstraint::SolverType m_solverType = PbdConstraint::SolverType::xPBD;
+    ExecutionMode m_executionMode = ExecutionMode::GaussSeidel;
+    double        m_relaxation    = 1.0;
+
+    double m_residualTolerance     = 0.0;
+    size_t m_maxIterations         = 0;
+    size_t m_residualCheckInterval = 0;
+    size_t m_numIterations         = 0; ///> Iterations done in the last solve
+    double m_maxResidual = 0.0;
+    double m_rmsResidual = 0.0;
+    std::vector<double> m_residuals;
+
+    ScalarTypeId m_scalarType           = IMSTK_DOUBLE;
+    bool         m_solvedSingle         = false;
+    bool         m_warnedSingleUnusable = false;
+    VecDataArray<float, 3> m_positionsSingle; ///> Single precision copies used while solving
+    DataArray<float>       m_invMassesSingle;
+
+    double m_lambdaWarmStart = 0.0; ///> Fraction of the previous multipliers kept, 0 resets them
+
+    bool   m_chebyshevAcceleration   = false;
+    double m_chebyshevSpectralRadius = 0.0;      ///> 0 estimates it
+    size_t m_chebyshevDelay          = 3;
+    double m_chebyshevRho   = 0.0;               ///> Spectral radius used in the current solve
+    double m_chebyshevOmega = 1.0;
+    double m_chebyshevLastUpdateNorm = 0.0;      ///> Squared norm of the last unaccelerated update
+    std::vector<Vec3d> m_chebyshevPrevPositions; ///> x_k-1
+    std::vector<Vec3d> m_chebyshevCurrPositions; ///> x_k
+    std::vector<double> m_chebyshevUpdateNorms;  ///> Squared update norm of every vertex
+
+    // Jacobi scratch buffers, reused every solve
+    bool   m_jacobiInitialized   = false;
+    size_t m_jacobiModifiedCount = 0;                ///> Modified count of the constraints the slots were built for
+    std::vector<PbdConstraint*> m_jacobiConstraints;
+    std::vector<PbdConstraint*> m_globalConstraints; ///> Constraints without vertex ids, projected after the Jacobi pass
+    std::vector<size_t>         m_slotOffsets;       ///> Corrections of constraint i start at m_slotOffsets[i], batches follow
+    std::vector<size_t>         m_vertexSlotOffsets; ///> Slots of vertex i are m_vertexSlots[m_vertexSlotOffsets[i], m_vertexSlotOffsets[i + 1])
+    std::vector<size_t>         m_vertexSlots;
+    std::vector<Vec3d>          m_corrections;
 };
 
 ///
 /// \class PbdCollisionSolver
 ///
 /// \brief Position Based Dynamics collision solver
-/// This solver can sequentially solve constraints in a list
+/// This solver can solve constraints in a list sequentially, or in parallel
+/// either by colors of constraints not sharing a vertex or by averaging the
+/// corrections of all constraints (Jacobi)
 ///
 class PbdCollisionSolver : SolverBase
 {
+public:
+    enum class ExecutionMode
+    {
+        Sequential, ///> Gauss-Seidel in the order the constraints were added
+        Colored,    ///> Gauss-Seidel in parallel over groups of constraints not sharing a vertex, deterministic
+        Jacobi      ///> Corrections of all constraints computed in parallel then averaged per vertex
+    };
+
 public:
     PbdCollisionSolver();
     virtual ~PbdCollisionSolver() override = default;
 
 public:
+    ///
+    /// \brief Set/Get how the constraints are solved, sequential by default
+    ///
+    void setExecutionMode(const ExecutionMode mode) { m_executionMode = mode; }
+    ExecutionMode getExecutionMode() const { return m_executionMode; }
+
     ///
     /// \brief Get CollisionIterations
     ///
@@ -139,18 +369,51 @@ public:
     void setCollisionIterations(const size_t iterations) { m_collisionIterations = iterations; }
 
     ///
-    /// \brief Add the global collision contraints to this solver
+    /// \brief Add the global collision contraints to this solver, adding the same list twice has no effect
     ///
     void addCollisionConstraints(std::vector<PbdCollisionConstraint*>* constraints);
 
+    ///
+    /// \brief Remove all the collision constraints of this solver
+    ///
+    void clearCollisionConstraints() { m_collisionConstraints->clear(); }
+
+    ///
+    /// \brief Set/Get whether the constraints are kept after solving such that they can be
+    /// solved again (ie: in every substep), they are then removed by clearCollisionConstraints.
+    /// Off by default
+    ///
+    void setRetainConstraints(const bool retain) { m_retainConstraints = retain; }
+    bool getRetainConstraints() const { return m_retainConstraints; }
+
     ///
     /// \brief Solve the non linear system of equations G(x)=0 using Newton's method.
     ///
     void solve() override;
 
 private:
-    size_t m_collisionIterations = 5;                                                                   ///> Number of NL Gauss-Seidel iterations for collision constraints
+    ///
+    /// \brief Gather the constraints of all lists and their vertices. Vertices are numbered
+    /// by address, a vertex may have infinite mass in some constraints only
+    ///
+    void gatherConstraints();
+
+    void solveColored();
+    void solveJacobi();
+
+    size_t        m_collisionIterations = 5;                          ///> Number of NL Gauss-Seidel iterations for collision constraints
+    ExecutionMode m_executionMode       = ExecutionMode::Sequential;
+    bool          m_retainConstraints   = false;
 
     std::shared_ptr<std::list<std::vector<PbdCollisionConstraint*>*>> m_collisionConstraints = nullptr; ///< Collision contraints charged to this solver
+
+    // Scratch buffers, reused every solve
+    std::vector<PbdCollisionConstraint*> m_constraints;
+    std::vector<size_t>                  m_slotOffsets;   ///> Vertices of constraint i are [m_slotOffsets[i], m_slotOffsets[i + 1])
+    std::vector<int>                     m_slotVertexIds;
+    std::vector<char>                    m_slotMovable;   ///> Whether the vertex of the slot has finite mass in its constraint
+    std::vector<Vec3d*>                  m_vertices;      ///> Vertex of every id
+    std::vector<char>                    m_vertexMovable; ///> Whether any constraint moves the vertex
+    std::unordered_map<Vec3d*, int>      m_vertexIds;
 };
 } // imstk
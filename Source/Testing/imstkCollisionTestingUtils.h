@@ -0,0 +1,87 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkCollisionData.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkVecDataArray.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+///
+/// \brief Triangulated grid of n x n quads over [0, 1]^2 in the xz plane, facing -y, then
+/// rotated and translated
+///
+inline std::shared_ptr<SurfaceMesh>
+makeGrid(const int n, const Mat3d& rotation, const Vec3d& translation)
+{
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>((n + 1) * (n + 1));
+    auto indicesPtr  = std::make_shared<VecDataArray<int, 3>>(2 * n * n);
+    for (int i = 0; i <= n; i++)
+    {
+        for (int j = 0; j <= n; j++)
+        {
+            (*verticesPtr)[i * (n + 1) + j] = rotation * Vec3d(j / static_cast<double>(n), 0.0, i / static_cast<double>(n)) + translation;
+        }
+    }
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            const int a = i * (n + 1) + j;
+            (*indicesPtr)[2 * (i * n + j)]     = Vec3i(a, a + 1, a + n + 2);
+            (*indicesPtr)[2 * (i * n + j) + 1] = Vec3i(a, a + n + 2, a + n + 1);
+        }
+    }
+    auto surfMesh = std::make_shared<SurfaceMesh>();
+    surfMesh->initialize(verticesPtr, indicesPtr);
+    return surfMesh;
+}
+
+///
+/// \brief Cell ids of both sides of a contact
+///
+using Contact = std::pair<std::vector<int>, std::vector<int>>;
+
+///
+/// \brief Ids of every element pair, sorted, for comparisons independent of the order
+///
+inline std::vector<Contact>
+getContacts(const CollisionData& colData)
+{
+    std::vector<Contact> contacts;
+    for (size_t i = 0; i < colData.elementsA.size(); i++)
+    {
+        const CellIndexElement& elemA = colData.elementsA[i].m_element.m_CellIndexElement;
+        const CellIndexElement& elemB = colData.elementsB[i].m_element.m_CellIndexElement;
+        std::vector<int>        idsA(elemA.ids, elemA.ids + elemA.idCount);
+        std::vector<int>        idsB(elemB.ids, elemB.ids + elemB.idCount);
+        std::sort(idsA.begin(), idsA.end());
+        std::sort(idsB.begin(), idsB.end());
+        contacts.emplace_back(idsA, idsB);
+    }
+    std::sort(contacts.begin(), contacts.end());
+    return contacts;
+}
+} // imstk
@@ -0,0 +1,58 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \brief Positions of a chain of numVertices, spacing apart from the origin
+///
+inline std::shared_ptr<VecDataArray<double, 3>>
+makeChainVertices(const int numVertices, const Vec3d& spacing, const Vec3d& origin = Vec3d::Zero())
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(numVertices);
+    for (int i = 0; i < numVertices; i++)
+    {
+        (*vertices)[i] = origin + spacing * i;
+    }
+    return vertices;
+}
+
+///
+/// \brief Distance constraints between the consecutive vertices of a chain
+///
+inline std::vector<std::shared_ptr<PbdConstraint>>
+makeChainConstraints(const VecDataArray<double, 3>& vertices, const double stiffness)
+{
+    std::vector<std::shared_ptr<PbdConstraint>> constraints;
+    for (int i = 0; i < vertices.size() - 1; i++)
+    {
+        auto c = std::make_shared<PbdDistanceConstraint>();
+        c->initConstraint(vertices, i, i + 1, stiffness);
+        constraints.push_back(c);
+    }
+    return constraints;
+}
+}
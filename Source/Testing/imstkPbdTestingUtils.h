@@ -0,0 +1,64 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkLineMesh.h"
+#include "imstkPbdConstraintTestingUtils.h"
+#include "imstkPbdModel.h"
+
+#include <functional>
+
+namespace imstk
+{
+///
+/// \brief Hanging chain of numVertices fixed at its first vertex, with distance constraints
+/// and no damping. configure, if given, adjusts the config before the model is initialized
+///
+inline std::shared_ptr<PbdModel>
+makeChain(const int numVertices, const double stiffness, const Vec3d& spacing, const Vec3d& origin = Vec3d::Zero(),
+          std::function<void(PbdModelConfig&)> configure = nullptr)
+{
+    auto indices = std::make_shared<VecDataArray<int, 2>>(numVertices - 1);
+    for (int i = 0; i < numVertices - 1; i++)
+    {
+        (*indices)[i] = Vec2i(i, i + 1);
+    }
+    auto lineMesh = std::make_shared<LineMesh>();
+    lineMesh->initialize(makeChainVertices(numVertices, spacing, origin), indices);
+
+    auto config = std::make_shared<PbdModelConfig>();
+    config->enableConstraint(PbdModelConfig::ConstraintGenType::Distance, stiffness);
+    config->m_fixedNodeIds        = { 0 };
+    config->m_dt                  = 0.01;
+    config->m_viscousDampingCoeff = 0.0;
+    if (configure)
+    {
+        configure(*config);
+    }
+
+    auto model = std::make_shared<PbdModel>();
+    model->setModelGeometry(lineMesh);
+    model->configure(config);
+    model->initialize();
+    return model;
+}
+}
@@ -1,4 +1,6 @@
 %ignore imstk::PbdCollisionConstraint;
+%ignore imstk::PbdArrayView; /* views of the constraint storage, wrapped as copies instead */
+%ignore imstk::PbdConstraint::getVertexIds;
 /* %ignore imstk::PbdFEMConstraint; */
 %ignore imstk::PbdModel::getIntegratePositionNode();
 %ignore imstk::PbdModel::getUpdateCollisionGeometryNode();
@@ -290,6 +290,15 @@ namespace std
 /*
  * Constraint
  */
+%rename(getVertexIds) imstk::PbdConstraint::getVertexIdsVector;
+%extend imstk::PbdConstraint
+{
+    std::vector<std::size_t> getVertexIdsVector() const
+    {
+        const imstk::PbdArrayView<const std::size_t> vertexIds = $self->getVertexIds();
+        return std::vector<std::size_t>(vertexIds.begin(), vertexIds.end());
+    }
+};
 %include "../../Constraint/PbdConstraints/imstkPbdConstraint.h"
 %include "../../Constraint/PbdConstraints/imstkPbdCollisionConstraint.h"
 %include "../../Constraint/PbdConstraints/imstkPbdFEMConstraint.h"